@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "ImageSlice.hpp"
+
+static std::atomic<uint64_t> s_revision{ 0 };
+
+ImageSlice::ImageSlice(const til::size cellSize) noexcept :
+    _cellSize{ cellSize }
+{
+    _bumpRevision();
+}
+
+til::size ImageSlice::CellSize() const noexcept
+{
+    return _cellSize;
+}
+
+til::CoordType ImageSlice::ColumnOffset() const noexcept
+{
+    return _columnBegin;
+}
+
+til::CoordType ImageSlice::ColumnEnd() const noexcept
+{
+    return _columnEnd;
+}
+
+til::CoordType ImageSlice::PixelWidth() const noexcept
+{
+    return _pixelWidth;
+}
+
+uint64_t ImageSlice::Revision() const noexcept
+{
+    return _revision;
+}
+
+std::span<const uint32_t> ImageSlice::Pixels() const noexcept
+{
+    return _pixelBuffer;
+}
+
+// Routine Description:
+// - Returns a pointer to the top-left pixel of the given column range, growing the
+//   slice as needed. The caller writes CellSize().height lines of pixels with a
+//   stride of PixelWidth(), which may be larger than the requested range.
+// Arguments:
+// - columnBegin - The first column that will be written to.
+// - columnEnd - One past the last column that will be written to.
+// Return Value:
+// - A pointer into the pixel buffer.
+uint32_t* ImageSlice::MutablePixels(const til::CoordType columnBegin, const til::CoordType columnEnd)
+{
+    _bumpRevision();
+
+    if (_pixelBuffer.empty() || columnBegin < _columnBegin || columnEnd > _columnEnd)
+    {
+        const auto newColumnBegin = _pixelBuffer.empty() ? columnBegin : std::min(columnBegin, _columnBegin);
+        const auto newColumnEnd = _pixelBuffer.empty() ? columnEnd : std::max(columnEnd, _columnEnd);
+        const auto newPixelWidth = (newColumnEnd - newColumnBegin) * _cellSize.width;
+        std::vector<uint32_t> newPixelBuffer(gsl::narrow_cast<size_t>(newPixelWidth) * _cellSize.height);
+
+        if (!_pixelBuffer.empty())
+        {
+            const auto offset = (_columnBegin - newColumnBegin) * _cellSize.width;
+            for (auto y = 0; y < _cellSize.height; y++)
+            {
+                const auto src = _pixelBuffer.begin() + y * _pixelWidth;
+                const auto dst = newPixelBuffer.begin() + (y * newPixelWidth + offset);
+                std::copy_n(src, _pixelWidth, dst);
+            }
+        }
+
+        _pixelBuffer = std::move(newPixelBuffer);
+        _columnBegin = newColumnBegin;
+        _columnEnd = newColumnEnd;
+        _pixelWidth = newPixelWidth;
+    }
+
+    const auto offset = (columnBegin - _columnBegin) * _cellSize.width;
+    return _pixelBuffer.data() + offset;
+}
+
+// Routine Description:
+// - Clears the image content of the given column range, for instance
+//   because it got overwritten by text.
+// Arguments:
+// - columnBegin - The first column to erase.
+// - columnEnd - One past the last column to erase.
+// Return Value:
+// - true if the slice doesn't contain any image content anymore and can be discarded.
+bool ImageSlice::EraseCells(const til::CoordType columnBegin, const til::CoordType columnEnd) noexcept
+{
+    const auto eraseBegin = std::max(columnBegin, _columnBegin);
+    const auto eraseEnd = std::min(columnEnd, _columnEnd);
+    if (eraseBegin >= eraseEnd)
+    {
+        return _pixelBuffer.empty();
+    }
+    if (eraseBegin == _columnBegin && eraseEnd == _columnEnd)
+    {
+        return true;
+    }
+
+    _bumpRevision();
+
+    const auto offset = (eraseBegin - _columnBegin) * _cellSize.width;
+    const auto count = (eraseEnd - eraseBegin) * _cellSize.width;
+    for (auto y = 0; y < _cellSize.height; y++)
+    {
+        std::fill_n(_pixelBuffer.begin() + (y * _pixelWidth + offset), count, 0u);
+    }
+    return false;
+}
+
+void ImageSlice::_bumpRevision() noexcept
+{
+    _revision = s_revision.fetch_add(1, std::memory_order_relaxed) + 1;
+}
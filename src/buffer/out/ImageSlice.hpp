@@ -0,0 +1,49 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ImageSlice.hpp
+
+Abstract:
+- This is the image layer of a single ROW. Images (e.g. sixel graphics) are
+  split into row-high slices when they're written into the buffer, so that
+  they scroll, get copied and get erased together with the text they cover.
+- Pixels are stored as premultiplied BGRA (DXGI_FORMAT_B8G8R8A8_UNORM), where
+  a value of 0 is fully transparent. The slice only covers the range of
+  columns that actually contain image data.
+--*/
+
+#pragma once
+
+class ImageSlice
+{
+public:
+    using Pointer = std::unique_ptr<ImageSlice>;
+
+    ImageSlice(const ImageSlice& rhs) = default;
+    explicit ImageSlice(til::size cellSize) noexcept;
+
+    til::size CellSize() const noexcept;
+    til::CoordType ColumnOffset() const noexcept;
+    til::CoordType ColumnEnd() const noexcept;
+    til::CoordType PixelWidth() const noexcept;
+    uint64_t Revision() const noexcept;
+
+    std::span<const uint32_t> Pixels() const noexcept;
+    uint32_t* MutablePixels(til::CoordType columnBegin, til::CoordType columnEnd);
+    bool EraseCells(til::CoordType columnBegin, til::CoordType columnEnd) noexcept;
+
+private:
+    void _bumpRevision() noexcept;
+
+    std::vector<uint32_t> _pixelBuffer;
+    til::size _cellSize;
+    til::CoordType _columnBegin = 0;
+    til::CoordType _columnEnd = 0;
+    til::CoordType _pixelWidth = 0;
+    // Renderers cache the uploaded image by this value. It's unique across all slices
+    // and changes whenever the pixels do, but is preserved when a slice gets copied,
+    // so that scrolling or copying rows doesn't invalidate the cache.
+    uint64_t _revision = 0;
+};
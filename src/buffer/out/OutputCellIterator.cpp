@@ -203,6 +203,35 @@ size_t OutputCellIterator::Position() const noexcept
     return _pos;
 }
 
+// Routine Description:
+// - Fill-mode iterators yield the same cell over and over. As long as that cell is narrow,
+//   callers can write all of them at once instead of dereferencing the iterator cell by cell.
+// Return Value:
+// - The number of identical single-column cells left, SIZE_MAX if the fill is infinite,
+//   or 0 if this isn't a fill of single-column cells.
+size_t OutputCellIterator::GetFillCount() const noexcept
+{
+    if (_mode != Mode::Fill || _currentView.DbcsAttr() != DbcsAttribute::Single)
+    {
+        return 0;
+    }
+    return _fillLimit > 0 ? _fillLimit - _pos : SIZE_MAX;
+}
+
+// Routine Description:
+// - Advances a fill-mode iterator by the given number of cells at once.
+// Arguments:
+// - count - The number of cells to skip. Must not exceed GetFillCount().
+void OutputCellIterator::AdvanceFill(const size_t count) noexcept
+{
+    _distance += count;
+
+    if (_fillLimit > 0)
+    {
+        _pos += count;
+    }
+}
+
 // Routine Description:
 // - Advances the iterator one position over the underlying data source.
 // Return Value:
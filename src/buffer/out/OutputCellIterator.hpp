@@ -49,6 +49,8 @@ public:
     operator bool() const noexcept;
 
     size_t Position() const noexcept;
+    size_t GetFillCount() const noexcept;
+    void AdvanceFill(size_t count) noexcept;
     til::CoordType GetCellDistance(OutputCellIterator other) const noexcept;
     til::CoordType GetInputDistance(OutputCellIterator other) const noexcept;
     friend til::CoordType operator-(OutputCellIterator one, OutputCellIterator two) = delete;
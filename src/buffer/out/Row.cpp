@@ -82,6 +82,115 @@ constexpr OutIt copy_n_small(InIt first, Diff count, OutIt dest)
     return dest;
 }
 
+#pragma warning(push)
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+// Returns a pointer to the first character in [beg, end) that isn't a whitespace, or `end` if there's none.
+// Most rows are largely blank, which makes scanning them 8 characters at a time worthwhile.
+static const wchar_t* findNonSpace(const wchar_t* beg, const wchar_t* end) noexcept
+{
+    auto it = beg;
+
+#if defined(TIL_SSE_INTRINSICS)
+
+    const auto whitespace = _mm_set1_epi16(L' ');
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(wch, whitespace)) ^ 0xffff;
+        if (mask)
+        {
+            unsigned long offset;
+            _BitScanForward(&offset, mask);
+            return it + offset / 2;
+        }
+    }
+
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+
+    const auto whitespace = vdupq_n_u16(L' ');
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto wch = vld1q_u16(it);
+        const auto c = vreinterpretq_u64_u16(vmvnq_u16(vceqq_u16(wch, whitespace)));
+        unsigned long offset;
+
+        if (const auto mask = vgetq_lane_u64(c, 0))
+        {
+            _BitScanForward64(&offset, mask);
+            return it + offset / 16;
+        }
+        if (const auto mask = vgetq_lane_u64(c, 1))
+        {
+            _BitScanForward64(&offset, mask);
+            return it + 4 + offset / 16;
+        }
+    }
+
+#endif
+
+    for (; it != end && *it == L' '; ++it)
+    {
+    }
+    return it;
+}
+
+// Returns a pointer past the last character in [beg, end) that isn't a whitespace, or `beg` if there's none.
+static const wchar_t* findLastNonSpace(const wchar_t* beg, const wchar_t* end) noexcept
+{
+    auto it = end;
+
+#if defined(TIL_SSE_INTRINSICS)
+
+    const auto whitespace = _mm_set1_epi16(L' ');
+
+    for (; it - beg >= 8; it -= 8)
+    {
+        const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it - 8));
+        const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi16(wch, whitespace)) ^ 0xffff;
+        if (mask)
+        {
+            // Each character occupies 2 bits in the mask, so offset / 2 is its index within the 8 characters.
+            unsigned long offset;
+            _BitScanReverse(&offset, mask);
+            return it - 8 + offset / 2 + 1;
+        }
+    }
+
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+
+    const auto whitespace = vdupq_n_u16(L' ');
+
+    for (; it - beg >= 8; it -= 8)
+    {
+        const auto wch = vld1q_u16(it - 8);
+        const auto c = vreinterpretq_u64_u16(vmvnq_u16(vceqq_u16(wch, whitespace)));
+        unsigned long offset;
+
+        if (const auto mask = vgetq_lane_u64(c, 1))
+        {
+            _BitScanReverse64(&offset, mask);
+            return it - 4 + offset / 16 + 1;
+        }
+        if (const auto mask = vgetq_lane_u64(c, 0))
+        {
+            _BitScanReverse64(&offset, mask);
+            return it - 8 + offset / 16 + 1;
+        }
+    }
+
+#endif
+
+    for (; it != beg && it[-1] == L' '; --it)
+    {
+    }
+    return it;
+}
+
+#pragma warning(pop)
+
 CharToColumnMapper::CharToColumnMapper(const wchar_t* chars, const uint16_t* charOffsets, ptrdiff_t lastCharOffset, til::CoordType currentColumn) noexcept :
     _chars{ chars },
     _charOffsets{ charOffsets },
@@ -230,7 +339,8 @@ void ROW::Reset(const TextAttribute& attr) noexcept
     _lineRendition = LineRendition::SingleWidth;
     _wrapForced = false;
     _doubleBytePadded = false;
-    _promptData = std::nullopt;
+    _promptData.reset();
+    _imageSlice.reset();
     _init();
 }
 
@@ -349,6 +459,36 @@ void ROW::_init() noexcept
 #pragma warning(push)
 }
 
+// Returns the inline storage that was given to the constructor.
+// TextBuffer uses it to tell which slot of its allocation a ROW belongs to.
+const wchar_t* ROW::GetStorage() const noexcept
+{
+    return _charsBuffer;
+}
+
+// Exchanges the inline storage of two equally wide ROWs, while each of them keeps its contents.
+void ROW::SwapStorage(ROW& other) noexcept
+{
+    assert(_columnCount == other._columnCount);
+
+    const auto inlineChars = _chars.data() == _charsBuffer;
+    const auto otherInlineChars = other._chars.data() == other._charsBuffer;
+
+    std::swap_ranges(_charsBuffer, _charsBuffer + _columnCount, other._charsBuffer);
+    std::swap_ranges(_charOffsets.begin(), _charOffsets.end(), other._charOffsets.begin());
+    std::swap(_charsBuffer, other._charsBuffer);
+    std::swap(_charOffsets, other._charOffsets);
+
+    if (inlineChars)
+    {
+        _chars = { _charsBuffer, _chars.size() };
+    }
+    if (otherInlineChars)
+    {
+        other._chars = { other._charsBuffer, other._chars.size() };
+    }
+}
+
 void ROW::CopyFrom(const ROW& source)
 {
     _lineRendition = source._lineRendition;
@@ -362,6 +502,25 @@ void ROW::CopyFrom(const ROW& source)
 
     _attr = source.Attributes();
     _attr.resize_trailing_extent(_columnCount);
+
+    _imageSlice = source._imageSlice ? std::make_unique<ImageSlice>(*source._imageSlice) : nullptr;
+}
+
+// Releases any heap memory this row holds beyond what its current contents need.
+// Rows that once contained a lot of complex text or colors retain their larger
+// text and attribute buffers until they get Reset(), which for rows in a full
+// scrollback may take a long time. TextBuffer calls this for such "cold" rows.
+void ROW::TrimExcessCapacity()
+{
+    const auto length = _charSize();
+    if (_charsHeap && length <= _columnCount)
+    {
+        std::copy_n(_chars.begin(), length, _charsBuffer);
+        _chars = { _charsBuffer, _columnCount };
+        _charsHeap.reset();
+    }
+
+    _attr.runs().shrink_to_fit();
 }
 
 // Returns the previous possible cursor position, preceding the given column.
@@ -429,10 +588,56 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
     // If we're given a right-side column limit, use it. Otherwise, the write limit is the final column index available in the char row.
     const auto finalColumnInRow = limitRight.value_or(size() - 1);
 
+    // Fills (FillConsoleOutputCharacter/Attribute, erasing, etc.) repeat the same narrow cell over and over.
+    // Instead of going cell by cell, they're written with a single ReplaceText() and attribute replace().
+    // Just like WriteCharInfos(), this is limited to ASCII, because it's always exactly 1 column wide.
+    if (const auto fillCount = it.GetFillCount())
+    {
+        const auto behavior = it->TextAttrBehavior();
+        const auto writeText = behavior != TextAttributeBehavior::StoredOnly;
+        const auto& chars = it->Chars();
+
+        if (!writeText || (chars.size() == 1 && chars.front() < 0x80))
+        {
+            const auto columnEnd = finalColumnInRow + 1;
+            const auto available = gsl::narrow_cast<size_t>(std::max(0, columnEnd - columnBegin));
+            const auto count = gsl::narrow_cast<til::CoordType>(std::min(fillCount, available));
+
+            if (writeText)
+            {
+                til::small_vector<wchar_t, 256> text;
+                text.resize(gsl::narrow_cast<size_t>(count), chars.front());
+
+                RowWriteState state{
+                    .text = { text.data(), text.size() },
+                    .columnBegin = columnBegin,
+                    .columnLimit = columnBegin + count,
+                };
+                ReplaceText(state);
+
+                if (wrap.has_value() && columnBegin + count == columnEnd)
+                {
+                    SetWrapForced(*wrap);
+                }
+            }
+
+            if (behavior != TextAttributeBehavior::Current)
+            {
+                _attr.replace(gsl::narrow_cast<uint16_t>(columnBegin), gsl::narrow_cast<uint16_t>(columnBegin + count), it->TextAttr());
+            }
+
+            it.AdvanceFill(gsl::narrow_cast<size_t>(count));
+            return it;
+        }
+    }
+
     auto currentColor = it->TextAttr();
     uint16_t colorUses = 0;
     auto colorStarts = gsl::narrow_cast<uint16_t>(columnBegin);
     auto currentIndex = colorStarts;
+    // The color runs are collected and committed with a single replace() at the end.
+    // Replacing them one by one would rescan the row's runs from the start for each of them.
+    til::small_vector<RowAttributes::rle_type, 16> colorRuns;
 
     while (it && currentIndex <= finalColumnInRow)
     {
@@ -448,8 +653,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
             else
             {
                 // Otherwise, commit this color into the run and save off the new one.
-                // Now commit the new color runs into the attr row.
-                _attr.replace(colorStarts, currentIndex, currentColor);
+                colorRuns.emplace_back(currentColor, gsl::narrow_cast<uint16_t>(currentIndex - colorStarts));
                 currentColor = it->TextAttr();
                 colorUses = 1;
                 colorStarts = currentIndex;
@@ -526,15 +730,84 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
         ++currentIndex;
     }
 
-    // Now commit the final color into the attr row
+    // Now commit the final color and all the runs before it into the attr row
     if (colorUses)
     {
-        _attr.replace(colorStarts, currentIndex, currentColor);
+        colorRuns.emplace_back(currentColor, gsl::narrow_cast<uint16_t>(currentIndex - colorStarts));
+        _attr.replace(gsl::narrow_cast<uint16_t>(columnBegin), currentIndex, { colorRuns.data(), colorRuns.size() });
     }
 
     return it;
 }
 
+// Routine Description:
+// - A fast path for WriteCells() for the common case of writing a row of plain ASCII CHAR_INFOs,
+//   as used by WriteConsoleOutputW. Instead of generating an OutputCellView per cell, the text is written
+//   with a single ReplaceText() call and the attributes are committed as runs of identical WORDs.
+// Arguments:
+// - charInfos - The cells to write. They must fit into the row starting at columnBegin.
+// - columnBegin - The column to start writing at.
+// - wrap - Same as for WriteCells(): (un)sets the wrap flag if the last column got written.
+// Return Value:
+// - false if the cells contain anything but single-width ASCII (DBCS leading/trailing halves,
+//   or characters that may be wide), in which case the row remains unmodified and the
+//   caller should fall back to WriteCells().
+bool ROW::WriteCharInfos(const std::span<const CHAR_INFO> charInfos, const til::CoordType columnBegin, const std::optional<bool> wrap)
+{
+    THROW_HR_IF(E_INVALIDARG, columnBegin < 0 || columnBegin >= size());
+
+    const auto count = gsl::narrow_cast<til::CoordType>(charInfos.size());
+    if (count == 0 || count > size() - columnBegin)
+    {
+        return false;
+    }
+
+    til::small_vector<wchar_t, 256> text;
+    text.resize(charInfos.size());
+
+    auto out = text.begin();
+    for (const auto& ci : charInfos)
+    {
+        if (ci.Char.UnicodeChar >= 0x80 || WI_IsAnyFlagSet(ci.Attributes, COMMON_LVB_LEADING_BYTE | COMMON_LVB_TRAILING_BYTE))
+        {
+            return false;
+        }
+        *out++ = ci.Char.UnicodeChar;
+    }
+
+    RowWriteState state{
+        .text = { text.data(), text.size() },
+        .columnBegin = columnBegin,
+        .columnLimit = columnBegin + count,
+    };
+    ReplaceText(state);
+
+    // Commit the attributes in runs with a single replace(), the same way WriteCells() does.
+    til::small_vector<RowAttributes::rle_type, 16> attrRuns;
+    auto runBegin = gsl::narrow_cast<uint16_t>(columnBegin);
+    auto runAttr = charInfos.front().Attributes;
+    auto column = runBegin;
+    for (const auto& ci : charInfos)
+    {
+        if (ci.Attributes != runAttr)
+        {
+            attrRuns.emplace_back(TextAttribute{ runAttr }, gsl::narrow_cast<uint16_t>(column - runBegin));
+            runBegin = column;
+            runAttr = ci.Attributes;
+        }
+        ++column;
+    }
+    attrRuns.emplace_back(TextAttribute{ runAttr }, gsl::narrow_cast<uint16_t>(column - runBegin));
+    _attr.replace(gsl::narrow_cast<uint16_t>(columnBegin), column, { attrRuns.data(), attrRuns.size() });
+
+    if (wrap.has_value() && columnBegin + count == size())
+    {
+        SetWrapForced(*wrap);
+    }
+
+    return true;
+}
+
 void ROW::SetAttrToEnd(const til::CoordType columnBegin, const TextAttribute attr)
 {
     _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
@@ -646,6 +919,35 @@ catch (...)
     const auto end = it + std::min<size_t>(chars.size(), colLimit - colBeg);
     size_t ch = chBeg;
 
+#if defined(TIL_SSE_INTRINSICS)
+#pragma warning(push)
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    // Check 8 characters at a time for whether they're all ASCII and if they are,
+    // fill the corresponding char-offsets with successive numbers starting at `ch`.
+    // The remaining characters, or the first chunk that contains non-ASCII, are handled below.
+    {
+        const auto nonAsciiMask = _mm_set1_epi16(static_cast<short>(0xff80));
+        const auto increment = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+        const auto end8 = it + ((end - it) & ~ptrdiff_t{ 7 });
+
+        for (; it != end8; it += 8)
+        {
+            const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&*it));
+            const auto ascii = _mm_cmpeq_epi16(_mm_and_si128(wch, nonAsciiMask), _mm_setzero_si128());
+            if (_mm_movemask_epi8(ascii) != 0xffff)
+            {
+                break;
+            }
+
+            const auto offsets = _mm_add_epi16(increment, _mm_set1_epi16(gsl::narrow_cast<short>(ch)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row._charOffsets.data() + colEnd), offsets);
+            colEnd = gsl::narrow_cast<uint16_t>(colEnd + 8);
+            ch += 8;
+        }
+    }
+#pragma warning(pop)
+#endif
+
     while (it != end)
     {
         if (*it >= 0x80) [[unlikely]]
@@ -824,6 +1126,11 @@ catch (...)
 {
     colEndDirty = row._adjustForward(colEndDirty);
 
+    if (row._imageSlice && row._imageSlice->EraseCells(colBegDirty, colEndDirty))
+    {
+        row._imageSlice.reset();
+    }
+
     const uint16_t trailingSpaces = colEndDirty - colEnd;
     const auto chEndDirtyOld = row._uncheckedCharOffset(colEndDirty);
     const auto chEndDirty = chBegDirty + charsConsumed + leadingSpaces + trailingSpaces;
@@ -902,12 +1209,12 @@ void ROW::_resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDi
     }
 }
 
-til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() noexcept
+RowAttributes& ROW::Attributes() noexcept
 {
     return _attr;
 }
 
-const til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() const noexcept
+const RowAttributes& ROW::Attributes() const noexcept
 {
     return _attr;
 }
@@ -940,18 +1247,8 @@ uint16_t ROW::size() const noexcept
 til::CoordType ROW::GetLastNonSpaceColumn() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = end;
-
-    for (; it != beg; --it)
-    {
-        // it[-1] is safe as `it` is always greater than `beg` (loop invariant).
-        if (til::at(it, -1) != L' ')
-        {
-            break;
-        }
-    }
+    const auto end = text.data() + text.size();
+    const auto it = findLastNonSpace(text.data(), end);
 
     // We're supposed to return the measurement in cells and not characters
     // and therefore simply calculating `it - beg` would be wrong.
@@ -964,18 +1261,8 @@ til::CoordType ROW::GetLastNonSpaceColumn() const noexcept
 til::CoordType ROW::MeasureLeft() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = beg;
-
-    for (; it != end; ++it)
-    {
-        if (*it != L' ')
-        {
-            break;
-        }
-    }
-
+    const auto beg = text.data();
+    const auto it = findNonSpace(beg, beg + text.size());
     return gsl::narrow_cast<til::CoordType>(it - beg);
 }
 
@@ -999,19 +1286,8 @@ til::CoordType ROW::MeasureRight() const noexcept
 bool ROW::ContainsText() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = beg;
-
-    for (; it != end; ++it)
-    {
-        if (*it != L' ')
-        {
-            return true;
-        }
-    }
-
-    return false;
+    const auto end = text.data() + text.size();
+    return findNonSpace(text.data(), end) != end;
 }
 
 std::wstring_view ROW::GlyphAt(til::CoordType column) const noexcept
@@ -1097,6 +1373,46 @@ DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_v
     }
 }
 
+// Returns the first column, starting at `column` and moving towards `end`, whose
+// delimiter class isn't `delimiterClass`. Returns `end` if there's no such column.
+// This is a lot faster than calling DelimiterClassAt() for each column of a long run.
+til::CoordType ROW::SkipDelimiterClass(til::CoordType column, til::CoordType end, DelimiterClass delimiterClass, const std::wstring_view& wordDelimiters) const noexcept
+{
+    // Most delimiters are ASCII. Looking those up in a bitmap is
+    // cheaper than searching the wordDelimiters string for every glyph.
+    // Building it takes one pass over the few wordDelimiters, so it isn't worth
+    // caching per row (keyed on GetMutationId()) at the cost of memory in every ROW.
+    std::array<uint64_t, 2> asciiDelimiters{};
+    for (const auto ch : wordDelimiters)
+    {
+        if (ch < 128)
+        {
+            til::at(asciiDelimiters, ch >> 6) |= 1ULL << (ch & 63);
+        }
+    }
+
+    const auto classify = [&](const wchar_t glyph) noexcept {
+        if (glyph <= L' ')
+        {
+            return DelimiterClass::ControlChar;
+        }
+        const auto isDelimiter = glyph < 128 ? ((til::at(asciiDelimiters, glyph >> 6) >> (glyph & 63)) & 1) != 0 : wordDelimiters.find(glyph) != std::wstring_view::npos;
+        return isDelimiter ? DelimiterClass::DelimiterChar : DelimiterClass::RegularChar;
+    };
+
+    auto col = _clampedColumn(column);
+    const auto last = _clampedColumn(end);
+    const auto step = last >= col ? 1 : -1;
+
+    // Safety: col is [0, _columnCount).
+    while (col != last && classify(_uncheckedChar(_uncheckedCharOffset(col))) == delimiterClass)
+    {
+        col = gsl::narrow_cast<uint16_t>(col + step);
+    }
+
+    return col;
+}
+
 template<typename T>
 constexpr uint16_t ROW::_clampedColumn(T v) const noexcept
 {
@@ -1172,39 +1488,80 @@ CharToColumnMapper ROW::_createCharToColumnMapper(ptrdiff_t offset) const noexce
     return CharToColumnMapper{ _chars.data(), _charOffsets.data(), lastChar, guessedColumn };
 }
 
-const std::optional<ScrollbarData>& ROW::GetScrollbarData() const noexcept
+const ScrollbarData* ROW::GetScrollbarData() const noexcept
+{
+    return _promptData.get();
+}
+void ROW::SetScrollbarData(const ScrollbarData* data)
+{
+    if (!data)
+    {
+        _promptData.reset();
+    }
+    else if (_promptData)
+    {
+        *_promptData = *data;
+    }
+    else
+    {
+        _promptData = std::make_unique<ScrollbarData>(*data);
+    }
+}
+
+uint64_t ROW::GetMutationId() const noexcept
 {
-    return _promptData;
+    return _mutationId;
 }
-void ROW::SetScrollbarData(std::optional<ScrollbarData> data) noexcept
+
+void ROW::SetMutationId(uint64_t id) noexcept
 {
-    _promptData = data;
+    _mutationId = id;
 }
 
-void ROW::StartPrompt() noexcept
+// Returns the amount of heap memory this row uses in addition to its slot in the TextBuffer.
+// That's the case for rows with more text than fits into _charsBuffer (e.g. lots of combining marks)
+// or with more attribute runs than fit into RowAttributes' small buffer.
+size_t ROW::GetHeapBytes() const noexcept
 {
-    if (!_promptData.has_value())
+    size_t bytes = 0;
+    if (_charsHeap)
     {
-        // You'd be tempted to write:
-        //
-        // _promptData = ScrollbarData{
-        //     .category = MarkCategory::Prompt,
-        //     .color = std::nullopt,
-        //     .exitCode = std::nullopt,
-        // };
-        //
-        // But that's not very optimal! Read this thread for a breakdown of how
-        // weird std::optional can be some times:
-        //
-        // https://github.com/microsoft/terminal/pull/16937#discussion_r1553660833
+        bytes += _chars.size() * sizeof(wchar_t);
+    }
+    if (const auto& runs = _attr.runs(); !runs.is_small())
+    {
+        bytes += runs.capacity() * sizeof(RowAttributes::rle_type);
+    }
+    return bytes;
+}
 
-        _promptData.emplace(MarkCategory::Prompt);
+const ImageSlice* ROW::GetImageSlice() const noexcept
+{
+    return _imageSlice.get();
+}
+
+ImageSlice* ROW::GetMutableImageSlice() noexcept
+{
+    return _imageSlice.get();
+}
+
+ImageSlice* ROW::SetImageSlice(ImageSlice::Pointer imageSlice) noexcept
+{
+    _imageSlice = std::move(imageSlice);
+    return _imageSlice.get();
+}
+
+void ROW::StartPrompt()
+{
+    if (!_promptData)
+    {
+        _promptData = std::make_unique<ScrollbarData>(MarkCategory::Prompt);
     }
 }
 
 void ROW::EndOutput(std::optional<unsigned int> error) noexcept
 {
-    if (_promptData.has_value())
+    if (_promptData)
     {
         _promptData->exitCode = error;
         if (error.has_value())
@@ -5,6 +5,7 @@
 
 #include <til/rle.h>
 
+#include "ImageSlice.hpp"
 #include "LineRendition.hpp"
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
@@ -13,6 +14,11 @@
 class ROW;
 class TextBuffer;
 
+// The run-length-encoded attributes of a ROW. Colorful output like compiler diagnostics or "ls --color"
+// typically consists of rows like "default, colored, default". Storing up to 3 runs inline means that
+// such rows don't need a separate heap allocation, which also makes copying them (ROW::CopyFrom) cheaper.
+using RowAttributes = til::small_rle<TextAttribute, uint16_t, 3>;
+
 enum class DelimiterClass
 {
     ControlChar,
@@ -133,6 +139,9 @@ public:
 
     void Reset(const TextAttribute& attr) noexcept;
     void CopyFrom(const ROW& source);
+    void TrimExcessCapacity();
+    const wchar_t* GetStorage() const noexcept;
+    void SwapStorage(ROW& other) noexcept;
 
     til::CoordType NavigateToPrevious(til::CoordType column) const noexcept;
     til::CoordType NavigateToNext(til::CoordType column) const noexcept;
@@ -141,14 +150,15 @@ public:
 
     void ClearCell(til::CoordType column);
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
+    bool WriteCharInfos(std::span<const CHAR_INFO> charInfos, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt);
     void SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
     void ReplaceText(RowWriteState& state);
     void CopyTextFrom(RowCopyTextFromState& state);
 
-    til::small_rle<TextAttribute, uint16_t, 1>& Attributes() noexcept;
-    const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
+    RowAttributes& Attributes() noexcept;
+    const RowAttributes& Attributes() const noexcept;
     TextAttribute GetAttrByColumn(til::CoordType column) const;
     std::vector<uint16_t> GetHyperlinks() const;
     uint16_t size() const noexcept;
@@ -163,15 +173,24 @@ public:
     til::CoordType GetLeadingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
     til::CoordType GetTrailingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
     DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
+    til::CoordType SkipDelimiterClass(til::CoordType column, til::CoordType end, DelimiterClass delimiterClass, const std::wstring_view& wordDelimiters) const noexcept;
 
     auto AttrBegin() const noexcept { return _attr.begin(); }
     auto AttrEnd() const noexcept { return _attr.end(); }
 
-    const std::optional<ScrollbarData>& GetScrollbarData() const noexcept;
-    void SetScrollbarData(std::optional<ScrollbarData> data) noexcept;
-    void StartPrompt() noexcept;
+    const ScrollbarData* GetScrollbarData() const noexcept;
+    void SetScrollbarData(const ScrollbarData* data);
+    void StartPrompt();
     void EndOutput(std::optional<unsigned int> error) noexcept;
 
+    uint64_t GetMutationId() const noexcept;
+    size_t GetHeapBytes() const noexcept;
+    void SetMutationId(uint64_t id) noexcept;
+
+    const ImageSlice* GetImageSlice() const noexcept;
+    ImageSlice* GetMutableImageSlice() noexcept;
+    ImageSlice* SetImageSlice(ImageSlice::Pointer imageSlice) noexcept;
+
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
     friend class RowTests;
@@ -293,7 +312,7 @@ private:
     std::span<uint16_t> _charOffsets;
     // _attr is a run-length-encoded vector of TextAttribute with a decompressed
     // length equal to _columnCount (= 1 TextAttribute per column).
-    til::small_rle<TextAttribute, uint16_t, 1> _attr;
+    RowAttributes _attr;
     // The width of the row in visual columns.
     uint16_t _columnCount = 0;
     // Stores double-width/height (DECSWL/DECDWL/DECDHL) attributes.
@@ -303,7 +322,16 @@ private:
     // Occurs when the user runs out of text to support a double byte character and we're forced to the next line
     bool _doubleBytePadded = false;
 
-    std::optional<ScrollbarData> _promptData = std::nullopt;
+    // Less than 1% of all rows carry a shell integration mark, so it's stored on the heap.
+    // That way every row only pays for a pointer and not for a ScrollbarData.
+    std::unique_ptr<ScrollbarData> _promptData;
+
+    // The sixel/image content covering this row, if any. Text written
+    // into the row erases the image in the affected columns.
+    ImageSlice::Pointer _imageSlice;
+
+    // The TextBuffer::GetLastMutationId() at the time this row was last handed out for modification.
+    uint64_t _mutationId = 0;
 };
 
 #ifdef UNIT_TESTING
@@ -20,17 +20,69 @@ bool Search::Reset(Microsoft::Console::Render::IRenderData& renderData, const st
 {
     const auto& textBuffer = renderData.GetTextBuffer();
 
+    // If only the contents of the buffer changed, for instance because a process is tailing
+    // its output, we only need to search through the rows that changed since the last time.
+    // Needles with newlines may match across any number of rows, which makes this impractical.
+    const auto incremental = _renderData == &renderData &&
+                             _needle == needle &&
+                             _caseInsensitive == caseInsensitive &&
+                             needle.find(L'\n') == std::wstring_view::npos &&
+                             textBuffer.CanTrackMutationsSince(_lastMutationId);
+
     _renderData = &renderData;
     _needle = needle;
     _caseInsensitive = caseInsensitive;
-    _lastMutationId = textBuffer.GetLastMutationId();
 
-    _results = textBuffer.SearchText(needle, caseInsensitive);
+    if (incremental)
+    {
+        _updateResults(textBuffer);
+    }
+    else
+    {
+        _results = textBuffer.SearchText(needle, caseInsensitive);
+    }
+
+    _lastMutationId = textBuffer.GetLastMutationId();
+    _lastScrollCount = textBuffer.GetScrollCount();
     _index = reverse ? gsl::narrow_cast<ptrdiff_t>(_results.size()) - 1 : 0;
     _step = reverse ? -1 : 1;
     return true;
 }
 
+// Brings _results up to date with the text buffer by only searching through
+// the rows that were modified since _lastMutationId and _lastScrollCount.
+void Search::_updateResults(const TextBuffer& textBuffer)
+{
+    const auto scrolled = textBuffer.GetScrollCount() - _lastScrollCount;
+    if (scrolled >= gsl::narrow_cast<uint64_t>(textBuffer.GetSize().Height()))
+    {
+        _results = textBuffer.SearchText(_needle, _caseInsensitive);
+        return;
+    }
+
+    // Matches may span across wrapped rows, so we need to search through the entire logical line that
+    // contains the first modified row. This also ensures that we don't split a match in two.
+    auto rowBeg = textBuffer.GetFirstRowMutatedSince(_lastMutationId);
+    for (; rowBeg > 0 && textBuffer.GetRowByOffset(rowBeg - 1).WasWrapForced(); --rowBeg)
+    {
+    }
+
+    // Our results are in absolute coordinates which shifted up by 1 row for each IncrementCircularBuffer().
+    // Anything that scrolled out of the buffer is gone and anything in the modified rows will be searched again.
+    const auto delta = gsl::narrow_cast<til::CoordType>(scrolled);
+    for (auto& r : _results)
+    {
+        r.start.y -= delta;
+        r.end.y -= delta;
+    }
+    std::erase_if(_results, [&](const til::point_span& r) {
+        return r.start.y < 0 || r.end.y >= rowBeg;
+    });
+
+    const auto results = textBuffer.SearchText(_needle, _caseInsensitive, rowBeg, til::CoordTypeMax);
+    _results.insert(_results.end(), results.begin(), results.end());
+}
+
 void Search::MoveToCurrentSelection()
 {
     if (_renderData->IsSelectionActive())
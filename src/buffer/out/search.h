@@ -41,11 +41,14 @@ public:
     ptrdiff_t CurrentMatch() const noexcept;
 
 private:
+    void _updateResults(const TextBuffer& textBuffer);
+
     // _renderData is a pointer so that Search() is constexpr default constructable.
     Microsoft::Console::Render::IRenderData* _renderData = nullptr;
     std::wstring _needle;
     bool _caseInsensitive = false;
     uint64_t _lastMutationId = 0;
+    uint64_t _lastScrollCount = 0;
 
     std::vector<til::point_span> _results;
     ptrdiff_t _index = 0;
@@ -5,6 +5,8 @@
 
 #include "textBuffer.hpp"
 
+#include <future>
+
 #include <til/hash.h>
 #include <til/unicode.h>
 
@@ -30,6 +32,30 @@ constexpr bool allWhitespace(const std::wstring_view& text) noexcept
     return true;
 }
 
+// Returns true for the non-ASCII characters whose full case folding contains ASCII characters.
+// ICU may match them against an ASCII needle, for instance U+FB00 against "ff" or U+0130 against "i".
+constexpr bool foldsToAscii(const wchar_t ch) noexcept
+{
+    switch (ch)
+    {
+    case 0x00DF: // -> ss
+    case 0x0130: // -> i U+0307
+    case 0x0149: // -> U+02BC n
+    case 0x017F: // -> s
+    case 0x01F0: // -> j U+030C
+    case 0x1E96: // -> h U+0331
+    case 0x1E97: // -> t U+0308
+    case 0x1E98: // -> w U+030A
+    case 0x1E99: // -> y U+030A
+    case 0x1E9A: // -> a U+02BE
+    case 0x1E9E: // -> ss
+    case 0x212A: // -> k
+        return true;
+    default:
+        return ch >= 0xFB00 && ch <= 0xFB06; // The Latin ligatures ff, fi, fl, ffi, ffl, st and st.
+    }
+}
+
 static std::atomic<uint64_t> s_lastMutationIdInitialValue;
 
 // Routine Description:
@@ -145,6 +171,85 @@ void TextBuffer::_decommit() noexcept
     _destroy();
     VirtualFree(_buffer.get(), 0, MEM_DECOMMIT);
     _commitWatermark = _buffer.get();
+    _invalidateRowMutationIds();
+    _hasMarks = false;
+}
+
+// Destructs all ROWs starting at the given row offset and MEM_DECOMMITs the pages they occupied.
+// The page that's shared with the preceding ROW stays committed. That's fine, because
+// _commit() will simply MEM_COMMIT it again, which is a no-op for already committed pages.
+void TextBuffer::_decommitFrom(size_t offset) noexcept
+{
+    const auto available = gsl::narrow_cast<size_t>(_commitWatermark - _buffer.get()) / _bufferRowStride;
+    if (offset >= available)
+    {
+        return;
+    }
+
+    // The ROWs we keep must not refer to the storage we're about to decommit.
+    _restoreRowStorage();
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    const auto row = _buffer.get() + _bufferRowStride * offset;
+    for (auto it = row; it < _commitWatermark; it += _bufferRowStride)
+    {
+        std::destroy_at(reinterpret_cast<ROW*>(it));
+    }
+
+    // VirtualFree() decommits every page that's touched by the given range,
+    // so we must round up to not decommit the tail end of the preceding ROW.
+    static const auto pageSize = [] {
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return static_cast<uintptr_t>(info.dwPageSize);
+    }();
+    const auto pageBegin = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(row) + pageSize - 1) & ~(pageSize - 1));
+    if (pageBegin < _bufferEnd)
+    {
+        VirtualFree(pageBegin, gsl::narrow_cast<size_t>(_bufferEnd - pageBegin), MEM_DECOMMIT);
+    }
+#pragma warning(pop)
+
+    _commitWatermark = row;
+}
+
+// RotateRows() swaps ROWs between slots and so a ROW may end up using the inline storage of another slot.
+// This is fine as long as all slots get destroyed together, but anything that destroys only some of them
+// needs every ROW to own its slot's storage again. Each SwapStorage() call puts one ROW back into place.
+void TextBuffer::_restoreRowStorage() noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    {
+        const auto row = reinterpret_cast<ROW*>(it);
+        const auto storage = reinterpret_cast<const wchar_t*>(it + _bufferOffsetChars);
+
+        while (row->GetStorage() != storage)
+        {
+            const auto ownerOffset = reinterpret_cast<const std::byte*>(row->GetStorage()) - _bufferOffsetChars - _buffer.get();
+            row->SwapStorage(*reinterpret_cast<ROW*>(_buffer.get() + ownerOffset));
+        }
+    }
+#pragma warning(pop)
+}
+
+// Gives this TextBuffer a new, unique range of mutation IDs, just like the constructor does. This is necessary
+// whenever ROWs are recreated or remapped to new rows, since the mutation IDs stored in the ROWs would otherwise
+// be ambiguous. See CanTrackMutationsSince().
+void TextBuffer::_invalidateRowMutationIds() noexcept
+{
+    _lastMutationId = s_lastMutationIdInitialValue.fetch_add(0x100000000);
+
+    // Anything that caches per-row data keyed on ROW::GetMutationId() would otherwise
+    // mistake a row that was reset or remapped for one that hasn't changed.
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    {
+        reinterpret_cast<ROW*>(it)->SetMutationId(_lastMutationId);
+    }
 }
 
 // Constructs ROWs between [_commitWatermark,until).
@@ -156,6 +261,7 @@ void TextBuffer::_construct(const std::byte* until) noexcept
         const auto chars = reinterpret_cast<wchar_t*>(_commitWatermark + _bufferOffsetChars);
         const auto indices = reinterpret_cast<uint16_t*>(_commitWatermark + _bufferOffsetCharOffsets);
         std::construct_at(row, chars, indices, _width, _initialAttributes);
+        row->SetMutationId(_lastMutationId);
     }
 }
 
@@ -226,8 +332,9 @@ const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const
 // (what corresponds to the top row of the screen buffer).
 ROW& TextBuffer::GetMutableRowByOffset(const til::CoordType index)
 {
-    _lastMutationId++;
-    return _getRow(index);
+    auto& row = _getRow(index);
+    row.SetMutationId(++_lastMutationId);
+    return row;
 }
 
 // Returns a row filled with whitespace and the current attributes, for you to freely use.
@@ -564,6 +671,7 @@ til::point TextBuffer::NavigateCursor(til::point position, til::CoordType distan
 // You can continue calling the function on the same row as long as state.columnEnd < state.columnLimit.
 void TextBuffer::Replace(til::CoordType row, const TextAttribute& attributes, RowWriteState& state)
 {
+    const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::buffer };
     auto& r = GetMutableRowByOffset(row);
     r.ReplaceText(state);
     r.ReplaceAttributes(state.columnBegin, state.columnEnd, attributes);
@@ -572,6 +680,7 @@ void TextBuffer::Replace(til::CoordType row, const TextAttribute& attributes, Ro
 
 void TextBuffer::Insert(til::CoordType row, const TextAttribute& attributes, RowWriteState& state)
 {
+    const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::buffer };
     auto& r = GetMutableRowByOffset(row);
     auto& scratch = GetScratchpadRow();
 
@@ -739,6 +848,34 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Writes one line of CHAR_INFOs to the output buffer, bypassing OutputCellIterator.
+// - See ROW::WriteCharInfos() for the restrictions of this fast path.
+// Arguments:
+// - charInfos - The cells to write. They must fit into the row starting at target.
+// - target - Coordinate targeted within output buffer
+// - setWrap - change the wrap flag if we write the last column of the row.
+// Return Value:
+// - true if the cells were written. If false, nothing was written and the caller should use WriteLine().
+bool TextBuffer::WriteCharInfos(const std::span<const CHAR_INFO> charInfos,
+                                const til::point target,
+                                const std::optional<bool> setWrap)
+{
+    if (!GetSize().IsInBounds(target))
+    {
+        return false;
+    }
+
+    auto& row = GetMutableRowByOffset(target.y);
+    if (!row.WriteCharInfos(charInfos, target.x, setWrap))
+    {
+        return false;
+    }
+
+    TriggerRedraw(Viewport::FromDimensions(target, { gsl::narrow_cast<til::CoordType>(charInfos.size()), 1 }));
+    return true;
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -885,6 +1022,8 @@ void TextBuffer::NewlineCursor()
 // - true if we successfully incremented the buffer.
 void TextBuffer::IncrementCircularBuffer(const TextAttribute& fillAttributes)
 {
+    const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::buffer };
+
     // FirstRow is at any given point in time the array index in the circular buffer that corresponds
     // to the logical position 0 in the window (cursor coordinates and all other coordinates).
     if (_isActiveBuffer)
@@ -897,6 +1036,7 @@ void TextBuffer::IncrementCircularBuffer(const TextAttribute& fillAttributes)
 
     // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
     GetMutableRowByOffset(0).Reset(fillAttributes);
+    _scrollCount++;
     {
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
@@ -908,6 +1048,17 @@ void TextBuffer::IncrementCircularBuffer(const TextAttribute& fillAttributes)
             _firstRow = 0;
         }
     }
+
+    // Lastly, the row that just scrolled out of the "hot" area of the buffer may hold on to
+    // memory it doesn't need anymore. Trimming it is purely an optimization and may fail.
+    if (_height > _coldRowDistance)
+    {
+        try
+        {
+            _getRow(_height - 1 - _coldRowDistance).TrimExcessCapacity();
+        }
+        CATCH_LOG();
+    }
 }
 
 //Routine Description:
@@ -990,6 +1141,40 @@ const til::CoordType TextBuffer::GetFirstRowIndex() const noexcept
     return _firstRow;
 }
 
+// Returns the size of the virtual memory arena that backs this TextBuffer.
+size_t TextBuffer::GetReservedBytes() const noexcept
+{
+    return gsl::narrow_cast<size_t>(_bufferEnd - _buffer.get());
+}
+
+// Returns how much of the GetReservedBytes() arena is currently committed and holds ROWs.
+// This is an estimate: VirtualAlloc() works at page granularity and will commit slightly more.
+size_t TextBuffer::GetCommittedBytes() const noexcept
+{
+    return gsl::narrow_cast<size_t>(_commitWatermark - _buffer.get());
+}
+
+// Returns the heap memory used by the committed ROWs on top of GetCommittedBytes(). See ROW::GetHeapBytes().
+// This walks all committed rows and shouldn't be called in a hot path.
+size_t TextBuffer::GetRowHeapBytes() const noexcept
+{
+    size_t bytes = 0;
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    {
+        bytes += reinterpret_cast<const ROW*>(it)->GetHeapBytes();
+    }
+#pragma warning(pop)
+    return bytes;
+}
+
+size_t TextBuffer::GetHyperlinkCount() const noexcept
+{
+    return _hyperlinkMap.size();
+}
+
 const Viewport TextBuffer::GetSize() const noexcept
 {
     return Viewport::FromDimensions({ _width, _height });
@@ -998,6 +1183,7 @@ const Viewport TextBuffer::GetSize() const noexcept
 void TextBuffer::_SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept
 {
     _firstRow = FirstRowIndex;
+    _invalidateRowMutationIds();
 }
 
 void TextBuffer::ScrollRows(const til::CoordType firstRow, til::CoordType size, const til::CoordType delta)
@@ -1070,6 +1256,30 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, til::CoordType size,
     }
 }
 
+// Same as ScrollRows(), but instead of copying the contents of each row, the ROWs themselves get swapped.
+// This makes scrolling a margin area O(1) per row instead of O(width), but the rows vacated by the
+// scroll end up with the previous contents of the rows that were scrolled over. The caller is
+// expected to clear them, which is what happens for VT scrolling anyway.
+// Afterwards, ROWs may refer to the inline storage of other slots. See _restoreRowStorage().
+void TextBuffer::RotateRows(const til::CoordType firstRow, til::CoordType size, const til::CoordType delta)
+{
+    if (delta == 0)
+    {
+        return;
+    }
+
+    size = std::max(0, size);
+
+    // This walks through the rows in the same order as ScrollRows(), which ensures
+    // that each source row is still intact by the time it gets swapped into place.
+    const auto step = delta < 0 ? 1 : -1;
+    const auto end = delta < 0 ? firstRow + size : firstRow - 1;
+    for (auto y = delta < 0 ? firstRow : firstRow + size - 1; y != end; y += step)
+    {
+        std::swap(GetMutableRowByOffset(y + delta), GetMutableRowByOffset(y));
+    }
+}
+
 Cursor& TextBuffer::GetCursor() noexcept
 {
     return _cursor;
@@ -1085,6 +1295,35 @@ uint64_t TextBuffer::GetLastMutationId() const noexcept
     return _lastMutationId;
 }
 
+// Returns how often IncrementCircularBuffer() was called. Coordinates that were obtained at
+// a time when this returned N are off by exactly GetScrollCount() - N rows now.
+uint64_t TextBuffer::GetScrollCount() const noexcept
+{
+    return _scrollCount;
+}
+
+// Returns true if the given mutation ID was obtained from this TextBuffer via GetLastMutationId()
+// and the rows haven't been recreated or remapped since. If this returns true, then
+// GetFirstRowMutatedSince() can be used to find the rows that changed since then.
+bool TextBuffer::CanTrackMutationsSince(uint64_t mutationId) const noexcept
+{
+    // Each TextBuffer (and each call to _invalidateRowMutationIds()) gets
+    // a unique range of mutation IDs in the upper 32 bits of the counter.
+    return (mutationId >> 32) == (_lastMutationId >> 32) && mutationId <= _lastMutationId;
+}
+
+// Returns the first row that was handed out via GetMutableRowByOffset() since GetLastMutationId() returned the given
+// mutation ID. If no row was modified, this returns 1 past the last committed row. See CanTrackMutationsSince().
+til::CoordType TextBuffer::GetFirstRowMutatedSince(uint64_t mutationId) const
+{
+    const auto end = _estimateOffsetOfLastCommittedRow() + 1;
+    til::CoordType y = 0;
+    for (; y < end && _getRow(y).GetMutationId() <= mutationId; ++y)
+    {
+    }
+    return y;
+}
+
 const TextAttribute& TextBuffer::GetCurrentAttributes() const noexcept
 {
     return _currentAttributes;
@@ -1176,6 +1415,35 @@ void TextBuffer::Reset() noexcept
     _initialAttributes = _currentAttributes;
 }
 
+// Same as Reset(), but instead of decommitting the memory, all ROWs that have been constructed
+// so far are reset in place to the given attributes. This is meant for buffers that get recycled
+// frequently, like the alternate screen buffer, so that they don't have to be recommitted.
+void TextBuffer::ResetInPlace(const TextAttribute& attributes) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    {
+        reinterpret_cast<ROW*>(it)->Reset(attributes);
+    }
+#pragma warning(pop)
+
+    _firstRow = 0;
+    _invalidateRowMutationIds();
+    _initialAttributes = attributes;
+    _currentAttributes = attributes;
+
+    _hyperlinkMap.clear();
+    _hyperlinkCustomIdMap.clear();
+    _currentHyperlinkId = 1;
+    _hasMarks = false;
+
+    _cursor.SetPosition({});
+    _cursor.ResetDelayEOLWrap();
+    _cursor.SetIsDouble(false);
+}
+
 // Arguments:
 // - newFirstRow: The current y-position of the viewport. We'll clear up until here.
 // - rowsToKeep: the number of rows to keep in the buffer.
@@ -1204,12 +1472,12 @@ void TextBuffer::ClearScrollback(const til::CoordType newFirstRow, const til::Co
     const auto startAbsolute = _firstRow + newFirstRow;
     _firstRow = 0;
     ScrollRows(startAbsolute, rowsToKeep, -startAbsolute);
+    _invalidateRowMutationIds();
 
-    const auto end = _estimateOffsetOfLastCommittedRow();
-    for (auto y = rowsToKeep; y <= end; ++y)
-    {
-        GetMutableRowByOffset(y).Reset(_initialAttributes);
-    }
+    // Everything past the kept rows is blank now. Instead of resetting those rows, give their memory back,
+    // since a long-lived buffer might otherwise hold on to megabytes of memory it doesn't use anymore.
+    // The +1 accounts for the scratchpad row at offset 0. See GetScratchpadRow().
+    _decommitFrom(gsl::narrow_cast<size_t>(rowsToKeep) + 1);
 }
 
 // Routine Description:
@@ -1331,6 +1599,35 @@ DelimiterClass TextBuffer::_GetDelimiterClassAt(const til::point pos, const std:
     return GetRowByOffset(realPos.y).DelimiterClassAt(realPos.x, wordDelimiters);
 }
 
+// Method Description:
+// - Skips over a run of cells with the same delimiter class within a row
+// - used to speed up double click selection and uia word navigation across long runs
+// Arguments:
+// - pos: the buffer cell to start at
+// - endX: the column within the same row to stop at
+// - delimiterClass: the delimiter class to skip over
+// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// Return Value:
+// - the first column from pos.x towards endX that isn't of the given class, or endX
+til::CoordType TextBuffer::_SkipDelimiterClass(const til::point pos, const til::CoordType endX, const DelimiterClass delimiterClass, const std::wstring_view wordDelimiters) const
+{
+    const auto& row = GetRowByOffset(pos.y);
+    if (row.GetLineRendition() == LineRendition::SingleWidth)
+    {
+        return row.SkipDelimiterClass(pos.x, endX, delimiterClass, wordDelimiters);
+    }
+
+    // On double width rows each cell spans two screen columns, which
+    // _GetDelimiterClassAt() already knows how to map.
+    auto x = pos.x;
+    const auto step = endX >= x ? 1 : -1;
+    while (x != endX && _GetDelimiterClassAt({ x, pos.y }, wordDelimiters) == delimiterClass)
+    {
+        x += step;
+    }
+    return x;
+}
+
 // Method Description:
 // - Get the til::point for the beginning of the word you are on
 // Arguments:
@@ -1411,6 +1708,12 @@ til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, co
     // make sure we expand to the left boundary or the beginning of the word
     while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
     {
+        if (result.x > bufferSize.Left())
+        {
+            // skip the rest of the word within this row in one go
+            result.x = _SkipDelimiterClass(result, bufferSize.Left(), DelimiterClass::RegularChar, wordDelimiters);
+            continue;
+        }
         if (result == bufferSize.Origin())
         {
             // first char in buffer is a RegularChar
@@ -1444,6 +1747,13 @@ til::point TextBuffer::_GetWordStartForSelection(const til::point target, const
     // expand left until we hit the left boundary or a different delimiter class
     while (result != bufferSize.Origin() && _GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter)
     {
+        if (result.x > bufferSize.Left())
+        {
+            // skip the rest of the run within this row in one go
+            result.x = _SkipDelimiterClass(result, bufferSize.Left(), initialDelimiter, wordDelimiters);
+            continue;
+        }
+
         if (result.x == bufferSize.Left())
         {
             // Prevent wrapping to the previous line if the selection begins on whitespace
@@ -1541,7 +1851,13 @@ til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, cons
     {
         while (result != limit && result != bufferSize.BottomRightInclusive() && _GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
         {
-            // Iterate through readable text
+            // Iterate through readable text, skipping the rest of it within this row in one go
+            const auto endX = result.y == limit.y ? limit.x : bufferSize.RightInclusive();
+            if (result.x < endX)
+            {
+                result.x = _SkipDelimiterClass(result, endX, DelimiterClass::RegularChar, wordDelimiters);
+                continue;
+            }
             bufferSize.IncrementInBounds(result);
         }
 
@@ -1580,6 +1896,13 @@ til::point TextBuffer::_GetWordEndForSelection(const til::point target, const st
     // expand right until we hit the right boundary as a ControlChar or a different delimiter class
     while (result != bufferSize.BottomRightInclusive() && _GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter)
     {
+        if (result.x < bufferSize.RightInclusive())
+        {
+            // skip the rest of the run within this row in one go
+            result.x = _SkipDelimiterClass(result, bufferSize.RightInclusive(), initialDelimiter, wordDelimiters);
+            continue;
+        }
+
         if (result.x == bufferSize.RightInclusive())
         {
             // Prevent wrapping to the next line if the selection begins on whitespace
@@ -1614,43 +1937,59 @@ void TextBuffer::_PruneHyperlinks()
     // If there are any, search the entire buffer for the same reference
     // If the buffer does not contain the same reference, we can remove that hyperlink from our map
     // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = GetRowByOffset(0).GetHyperlinks();
+    // Get all the hyperlink references in the row we're erasing.
+    // A row rarely holds more than a handful of distinct links, so a small inline
+    // vector with a linear search beats hashing and avoids any heap allocation.
+    til::small_vector<uint16_t, 8> firstRowRefs;
+    for (const auto& run : GetRowByOffset(0).Attributes().runs())
+    {
+        if (run.value.IsHyperlink())
+        {
+            const auto id = run.value.GetHyperlinkId();
+            if (std::find(firstRowRefs.begin(), firstRowRefs.end(), id) == firstRowRefs.end())
+            {
+                firstRowRefs.emplace_back(id);
+            }
+        }
+    }
 
-    if (!hyperlinks.empty())
+    if (firstRowRefs.empty())
     {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
+        return;
+    }
 
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (til::CoordType i = 1; i < total; ++i)
+    const auto total = TotalRowCount();
+    // Loop through all the rows in the buffer except the first row -
+    // we have found all hyperlink references in the first row and put them in refs,
+    // now we need to search the rest of the buffer (i.e. all the rows except the first)
+    // to see if those references are anywhere else. This walks the attribute runs
+    // directly, because GetHyperlinks() would allocate a vector for every linked row.
+    for (til::CoordType i = 1; i < total && !firstRowRefs.empty(); ++i)
+    {
+        for (const auto& run : GetRowByOffset(i).Attributes().runs())
         {
-            const auto nextRowRefs = GetRowByOffset(i).GetHyperlinks();
-            for (auto id : nextRowRefs)
+            if (!run.value.IsHyperlink())
             {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
+                continue;
             }
-            if (firstRowRefs.empty())
+            const auto it = std::find(firstRowRefs.begin(), firstRowRefs.end(), run.value.GetHyperlinkId());
+            if (it != firstRowRefs.end())
             {
-                // No more hyperlink references left to search for, terminate early
-                break;
+                // Order doesn't matter, so swap-and-pop instead of shifting the tail.
+                *it = firstRowRefs.back();
+                firstRowRefs.pop_back();
+                if (firstRowRefs.empty())
+                {
+                    break;
+                }
             }
         }
+    }
 
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
-        {
-            RemoveHyperlinkFromMap(hyperlinkReference);
-        }
+    // Now delete obsolete references from our map
+    for (const auto hyperlinkReference : firstRowRefs)
+    {
+        RemoveHyperlinkFromMap(hyperlinkReference);
     }
 }
 
@@ -1856,6 +2195,14 @@ bool TextBuffer::MoveToPreviousGlyph(til::point& pos, std::optional<til::point>
 // Return Value:
 // - One or more rects corresponding to the selection area
 const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const
+{
+    return GetTextRects(start, end, blockSelection, bufferCoordinates, 0, til::CoordTypeMax);
+}
+
+// Same as above, but only returns the rects for the rows within [rowBeg,rowEnd] (inclusive).
+// The renderer only needs the selection within the viewport and this avoids
+// producing a rect for each of the thousands of rows a "select all" may span.
+const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates, til::CoordType rowBeg, til::CoordType rowEnd) const
 {
     std::vector<til::inclusive_rect> textRects;
 
@@ -1868,9 +2215,15 @@ const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start
                                                std::make_tuple(start, end) :
                                                std::make_tuple(end, start);
 
-    const auto textRectSize = 1 + lowerCoord.y - higherCoord.y;
-    textRects.reserve(textRectSize);
-    for (auto row = higherCoord.y; row <= lowerCoord.y; row++)
+    const auto rowFirst = std::max(higherCoord.y, rowBeg);
+    const auto rowLast = std::min(lowerCoord.y, rowEnd);
+    if (rowFirst > rowLast)
+    {
+        return textRects;
+    }
+
+    textRects.reserve(1 + rowLast - rowFirst);
+    for (auto row = rowFirst; row <= rowLast; row++)
     {
         til::inclusive_rect textRow;
 
@@ -2097,21 +2450,34 @@ std::wstring TextBuffer::GetPlainText(const CopyRequest& req) const
         return {};
     }
 
-    std::wstring selectedText;
+    // Calls func(text, addLineBreak) for each row in the request.
+    const auto forEachRow = [&](auto&& func) {
+        for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
+        {
+            const auto& row = GetRowByOffset(iRow);
+            const auto& [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
+            func(row.GetText(rowBeg, rowEnd), addLineBreak && iRow != req.end.y);
+        }
+    };
 
-    for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
-    {
-        const auto& row = GetRowByOffset(iRow);
-        const auto& [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
+    // Copying the entire buffer can easily result in megabytes of text. Instead of growing the
+    // string piecewise, we measure the text first, so that we only need to allocate it once.
+    // Since the row bounds are cheap to compute, it's faster to do it twice than to store them.
+    size_t length = 0;
+    forEachRow([&](const std::wstring_view& text, const bool addLineBreak) {
+        length += text.size() + (addLineBreak ? 2 : 0);
+    });
 
-        // save selected text
-        selectedText += row.GetText(rowBeg, rowEnd);
+    std::wstring selectedText;
+    selectedText.reserve(length);
 
-        if (addLineBreak && iRow != req.end.y)
+    forEachRow([&](const std::wstring_view& text, const bool addLineBreak) {
+        selectedText.append(text);
+        if (addLineBreak)
         {
-            selectedText += L"\r\n";
+            selectedText.append(L"\r\n");
         }
-    }
+    });
 
     return selectedText;
 }
@@ -2145,7 +2511,13 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
 
     try
     {
-        std::string htmlBuilder;
+        // once filled with values, there will be exactly 157 bytes in the clipboard header
+        constexpr size_t ClipboardHeaderSize = 157;
+
+        // The clipboard header depends on the final length of the HTML. We reserve space
+        // for it up front and fill it in at the end, instead of concatenating the two
+        // strings, which would copy the entire (potentially huge) HTML string once more.
+        std::string htmlBuilder(ClipboardHeaderSize, ' ');
 
         // First we have to add some standard HTML boiler plate required for
         // CF_HTML as part of the HTML Clipboard format
@@ -2173,6 +2545,8 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
             htmlBuilder += "\">";
         }
 
+        std::string unescapedText;
+
         for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
         {
             const auto& row = GetRowByOffset(iRow);
@@ -2251,7 +2625,6 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
                 htmlBuilder += "\">";
 
                 // text
-                std::string unescapedText;
                 THROW_IF_FAILED(til::u16u8(row.GetText(x, nextX), unescapedText));
                 for (const auto c : unescapedText)
                 {
@@ -2297,12 +2670,9 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
         constexpr std::string_view HtmlFooter = "</BODY></HTML>";
         htmlBuilder += HtmlFooter;
 
-        // once filled with values, there will be exactly 157 bytes in the clipboard header
-        constexpr size_t ClipboardHeaderSize = 157;
-
         // these values are byte offsets from start of clipboard
         const auto htmlStartPos = ClipboardHeaderSize;
-        const auto htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.length());
+        const auto htmlEndPos = htmlBuilder.length();
         const auto fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
         const auto fragEndPos = htmlEndPos - HtmlFooter.length();
 
@@ -2316,7 +2686,9 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
         fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartSelection:{:0>10}\r\n"), fragStartPos);
         fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndSelection:{:0>10}\r\n"), fragEndPos);
 
-        return clipHeaderBuilder + htmlBuilder;
+        assert(clipHeaderBuilder.size() == ClipboardHeaderSize);
+        std::copy_n(clipHeaderBuilder.begin(), std::min(clipHeaderBuilder.size(), ClipboardHeaderSize), htmlBuilder.begin());
+        return htmlBuilder;
     }
     catch (...)
     {
@@ -2507,10 +2879,13 @@ std::string TextBuffer::GenRTF(const CopyRequest& req,
         }
 
         // add color table to the final RTF
-        rtfBuilder += colorTableBuilder + "}";
+        rtfBuilder += colorTableBuilder;
+        rtfBuilder += "}";
 
         // add the text content to the final RTF
-        rtfBuilder += contentBuilder + "}";
+        rtfBuilder.reserve(rtfBuilder.size() + contentBuilder.size() + 1);
+        rtfBuilder += contentBuilder;
+        rtfBuilder += "}";
 
         return rtfBuilder;
     }
@@ -2552,7 +2927,9 @@ void TextBuffer::Serialize(const wchar_t* destination) const
     const wil::unique_handle file{ CreateFileW(destination, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
     THROW_LAST_ERROR_IF(!file);
 
-    static constexpr size_t writeThreshold = 32 * 1024;
+    // This is in characters, so each WriteFile() call writes about 1MiB.
+    // That's 16x fewer calls than with the previous threshold of 32K characters.
+    static constexpr size_t writeThreshold = 512 * 1024;
     std::wstring buffer;
     buffer.reserve(writeThreshold + writeThreshold / 2);
     buffer.push_back(L'\uFEFF');
@@ -2872,6 +3249,9 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
     auto mutableViewportTop = positionInfo ? positionInfo->mutableViewportTop : til::CoordTypeMax;
     auto visibleViewportTop = positionInfo ? positionInfo->visibleViewportTop : til::CoordTypeMax;
 
+    // The marks get copied over row by row below.
+    newBuffer._hasMarks |= oldBuffer._hasMarks;
+
     til::CoordType oldY = 0;
     til::CoordType newY = 0;
     til::CoordType newX = 0;
@@ -2943,6 +3323,49 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
             oldRowLimit = std::max(oldRowLimit, oldCursorPos.x + 1);
         }
 
+        // REFLOW_FAST_PATH:
+        // Most rows in a typical scrollback are short, explicitly newline-terminated lines.
+        // If such a row starts at the beginning of a new row and fits into the new width,
+        // it maps 1:1 onto a single new row, and we can skip the wrapping logic below,
+        // as well as the slicing of the attributes, which needs to allocate a new til::small_rle.
+        if (newX == 0 && oldRowLimit <= newWidth && !oldRow.WasWrapForced())
+        {
+            // See the comment marked with "REFLOW_RESET".
+            if (newY >= newHeight && newY >= newYLimit)
+            {
+                break;
+            }
+
+            auto& newRow = newBuffer.GetMutableRowByOffset(newY);
+            if (newY >= newHeight)
+            {
+                newRow.Reset(newBuffer._initialAttributes);
+            }
+
+            newRow.CopyFrom(oldRow);
+            newRow.SetScrollbarData(oldRow.GetScrollbarData());
+
+            if (oldY == oldCursorPos.y)
+            {
+                newCursorPos = { newRow.AdjustToGlyphStart(oldCursorPos.x), newY };
+                // See the comment in the main copy loop below.
+                newYLimit = newY + newHeight;
+            }
+            if (oldY >= mutableViewportTop)
+            {
+                positionInfo->mutableViewportTop = newY;
+                mutableViewportTop = til::CoordTypeMax;
+            }
+            if (oldY >= visibleViewportTop)
+            {
+                positionInfo->visibleViewportTop = newY;
+                visibleViewportTop = til::CoordTypeMax;
+            }
+
+            newY++;
+            continue;
+        }
+
         // Immediately copy this mark over to our new row. The positions of the
         // marks themselves will be preserved, since they're just text
         // attributes. But the "bookmark" needs to get moved to the new row too.
@@ -2950,7 +3373,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
         //   mark on the row it started on.
         // * If the second row of a wrapped row had a mark, and it de-flows onto a
         //   single row, that's fine! The mark was on that logical row.
-        if (oldRow.GetScrollbarData().has_value())
+        if (oldRow.GetScrollbarData())
         {
             newBuffer.GetMutableRowByOffset(newY).SetScrollbarData(oldRow.GetScrollbarData());
         }
@@ -3195,19 +3618,85 @@ std::vector<til::point_span> TextBuffer::SearchText(const std::wstring_view& nee
 {
     rowEnd = std::min(rowEnd, _estimateOffsetOfLastCommittedRow() + 1);
 
-    std::vector<til::point_span> results;
-
     // All whitespace strings would match the not-yet-written parts of the TextBuffer which would be weird.
     if (allWhitespace(needle) || rowBeg >= rowEnd)
     {
-        return results;
+        return {};
     }
 
-    auto text = ICU::UTextFromTextBuffer(*this, rowBeg, rowEnd);
-
     uint32_t flags = UREGEX_LITERAL;
     WI_SetFlagIf(flags, UREGEX_CASE_INSENSITIVE, caseInsensitive);
 
+    // Most needles are plain ASCII words, and for those we don't need ICU.
+    // Lines that contain one of the foldsToAscii() characters still go through ICU, see _searchTextRowsLiteral().
+    const auto literal = needle.find(L'\n') == std::wstring_view::npos &&
+                         (!caseInsensitive || std::ranges::all_of(needle, [](const wchar_t ch) {
+                              return ch < 0x80;
+                          }));
+    const auto search = [=, this](til::CoordType beg, til::CoordType end) {
+        return literal ? _searchTextRowsLiteral(needle, caseInsensitive, beg, end) : _searchTextRows(needle, flags, beg, end);
+    };
+
+    // Searching a large scrollback is split up into chunks of rows which are searched concurrently.
+    // Since UTextFromTextBuffer() joins rows with a newline unless they were wrapped, we can split the
+    // range up at any row that follows one which wasn't wrapped, as long as the needle has no newlines.
+    static constexpr til::CoordType minRowsPerChunk = 1024;
+    const auto rowCount = rowEnd - rowBeg;
+    const auto maxChunks = std::max(1u, std::thread::hardware_concurrency());
+    const auto chunkCount = std::min<til::CoordType>(rowCount / minRowsPerChunk, gsl::narrow_cast<til::CoordType>(maxChunks));
+
+    if (chunkCount <= 1 || needle.find(L'\n') != std::wstring_view::npos)
+    {
+        return search(rowBeg, rowEnd);
+    }
+
+    std::vector<std::future<std::vector<til::point_span>>> futures;
+    futures.reserve(chunkCount - 1);
+
+    const auto rowsPerChunk = rowCount / chunkCount;
+    auto chunkEnd = rowBeg;
+
+    for (til::CoordType i = 1; i < chunkCount; ++i)
+    {
+        const auto chunkBeg = chunkEnd;
+        chunkEnd = std::max(chunkBeg, rowBeg + i * rowsPerChunk);
+        // Don't split up wrapped lines. Searching across wrapped rows is what people expect.
+        for (; chunkEnd < rowEnd && GetRowByOffset(chunkEnd - 1).WasWrapForced(); ++chunkEnd)
+        {
+        }
+        if (chunkBeg < chunkEnd)
+        {
+            futures.emplace_back(std::async(std::launch::async, [=]() {
+                return search(chunkBeg, chunkEnd);
+            }));
+        }
+    }
+
+    // The last chunk is searched on this thread while the others are running.
+    auto last = search(chunkEnd, rowEnd);
+
+    std::vector<til::point_span> results;
+    for (auto& f : futures)
+    {
+        auto chunk = f.get();
+        results.insert(results.end(), chunk.begin(), chunk.end());
+    }
+    results.insert(results.end(), last.begin(), last.end());
+    return results;
+}
+
+// The single-threaded implementation of SearchText(). Searches through the rows [rowBeg,rowEnd).
+std::vector<til::point_span> TextBuffer::_searchTextRows(const std::wstring_view& needle, uint32_t flags, til::CoordType rowBeg, til::CoordType rowEnd) const
+{
+    std::vector<til::point_span> results;
+
+    if (rowBeg >= rowEnd)
+    {
+        return results;
+    }
+
+    auto text = ICU::UTextFromTextBuffer(*this, rowBeg, rowEnd);
+
     UErrorCode status = U_ZERO_ERROR;
     const auto re = ICU::CreateRegex(needle, flags, &status);
     uregex_setUText(re.get(), &text, &status);
@@ -3223,17 +3712,94 @@ std::vector<til::point_span> TextBuffer::SearchText(const std::wstring_view& nee
     return results;
 }
 
+// A faster alternative to _searchTextRows() for needles that don't need ICU's case folding. See SearchText().
+// Case-insensitive searches fall back to _searchTextRows() for lines containing foldsToAscii() characters.
+// Just like UTextFromTextBuffer() it joins wrapped rows into logical lines, which are then searched with
+// std::wstring_view::find(). It in turn uses a vectorized search for the needle's first character.
+std::vector<til::point_span> TextBuffer::_searchTextRowsLiteral(const std::wstring_view& needle, bool caseInsensitive, til::CoordType rowBeg, til::CoordType rowEnd) const
+{
+    std::vector<til::point_span> results;
+    std::wstring pattern{ needle };
+    std::wstring line;
+    // rowOffsets[i] is the offset in `line` at which the text of row `lineBeg + i` starts.
+    std::vector<size_t> rowOffsets;
+
+    const auto foldCase = [](std::wstring& str) {
+        for (auto& ch : str)
+        {
+            ch = til::tolower_ascii(ch);
+        }
+    };
+
+    if (caseInsensitive)
+    {
+        foldCase(pattern);
+    }
+
+    for (auto y = rowBeg; y < rowEnd;)
+    {
+        const auto lineBeg = y;
+        line.clear();
+        rowOffsets.clear();
+
+        for (;;)
+        {
+            const auto& row = GetRowByOffset(y++);
+            rowOffsets.emplace_back(line.size());
+            line.append(row.GetText());
+            if (!row.WasWrapForced() || y >= rowEnd)
+            {
+                break;
+            }
+        }
+
+        if (caseInsensitive)
+        {
+            // The ASCII-only fold below would miss matches like U+FB00 for "ff". Let ICU deal with those lines.
+            if (std::ranges::any_of(line, [](const wchar_t ch) { return foldsToAscii(ch); }))
+            {
+                auto icuResults = _searchTextRows(needle, UREGEX_LITERAL | UREGEX_CASE_INSENSITIVE, lineBeg, y);
+                results.insert(results.end(), icuResults.begin(), icuResults.end());
+                continue;
+            }
+
+            foldCase(line);
+        }
+
+        const auto pointAt = [&](size_t offset, bool trailing) {
+            const auto it = std::upper_bound(rowOffsets.begin(), rowOffsets.end(), offset) - 1;
+            const auto rowY = lineBeg + gsl::narrow_cast<til::CoordType>(it - rowOffsets.begin());
+            const auto& row = GetRowByOffset(rowY);
+            const auto rowOffset = gsl::narrow_cast<ptrdiff_t>(offset - *it);
+            const auto x = trailing ? row.GetTrailingColumnAtCharOffset(rowOffset) : row.GetLeadingColumnAtCharOffset(rowOffset);
+            return til::point{ x, rowY };
+        };
+
+        // Just like uregex_findNext() this doesn't return overlapping matches.
+        for (auto pos = line.find(pattern); pos != std::wstring::npos; pos = line.find(pattern, pos + pattern.size()))
+        {
+            results.emplace_back(pointAt(pos, false), pointAt(pos + pattern.size() - 1, true));
+        }
+    }
+
+    return results;
+}
+
 // Collect up all the rows that were marked, and the data marked on that row.
 // This is what should be used for hot paths, like updating the scrollbar.
 std::vector<ScrollMark> TextBuffer::GetMarkRows() const
 {
     std::vector<ScrollMark> marks;
+    if (!_hasMarks)
+    {
+        return marks;
+    }
+
     const auto bottom = _estimateOffsetOfLastCommittedRow();
     for (auto y = 0; y <= bottom; y++)
     {
         const auto& row = GetRowByOffset(y);
-        const auto& data{ row.GetScrollbarData() };
-        if (data.has_value())
+        if (const auto data = row.GetScrollbarData())
         {
             marks.emplace_back(y, *data);
         }
@@ -3251,7 +3817,7 @@ std::vector<ScrollMark> TextBuffer::GetMarkRows() const
 // limit=1 will just give you the "most recent mark").
 std::vector<MarkExtents> TextBuffer::GetMarkExtents(size_t limit) const
 {
-    if (limit == 0u)
+    if (limit == 0u || !_hasMarks)
     {
         return {};
     }
@@ -3262,8 +3828,8 @@ std::vector<MarkExtents> TextBuffer::GetMarkExtents(size_t limit) const
     for (auto promptY = bottom; promptY >= 0; promptY--)
     {
         const auto& currRow = GetRowByOffset(promptY);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (!rowPromptData.has_value())
+        const auto rowPromptData = currRow.GetScrollbarData();
+        if (!rowPromptData)
         {
             // This row didn't start a prompt, don't even look here.
             continue;
@@ -3313,7 +3879,7 @@ void TextBuffer::ClearMarksInRange(
     {
         auto& row = GetMutableRowByOffset(y);
         auto& runs = row.Attributes().runs();
-        row.SetScrollbarData(std::nullopt);
+        row.SetScrollbarData(nullptr);
         for (auto& [attr, length] : runs)
         {
             attr.SetMarkAttributes(MarkKind::None);
@@ -3323,6 +3889,7 @@ void TextBuffer::ClearMarksInRange(
 void TextBuffer::ClearAllMarks()
 {
     ClearMarksInRange({ 0, 0 }, { _width - 1, _height - 1 });
+    _hasMarks = false;
 }
 
 // Collect up the extent of the prompt and possibly command and output for the
@@ -3331,8 +3898,8 @@ MarkExtents TextBuffer::_scrollMarkExtentForRow(const til::CoordType rowOffset,
                                                 const til::CoordType bottomInclusive) const
 {
     const auto& startRow = GetRowByOffset(rowOffset);
-    const auto& rowPromptData = startRow.GetScrollbarData();
-    assert(rowPromptData.has_value());
+    const auto rowPromptData = startRow.GetScrollbarData();
+    assert(rowPromptData);
 
     MarkExtents mark{
         .data = *rowPromptData,
@@ -3479,8 +4046,8 @@ std::wstring TextBuffer::CurrentCommand() const
     for (; promptY >= 0; promptY--)
     {
         const auto& currRow = GetRowByOffset(promptY);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (!rowPromptData.has_value())
+        const auto rowPromptData = currRow.GetScrollbarData();
+        if (!rowPromptData)
         {
             // This row didn't start a prompt, don't even look here.
             continue;
@@ -3502,8 +4069,8 @@ std::vector<std::wstring> TextBuffer::Commands() const
     for (auto promptY = bottom; promptY >= 0; promptY--)
     {
         const auto& currRow = GetRowByOffset(promptY);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (!rowPromptData.has_value())
+        const auto rowPromptData = currRow.GetScrollbarData();
+        if (!rowPromptData)
         {
             // This row didn't start a prompt, don't even look here.
             continue;
@@ -3528,6 +4095,7 @@ void TextBuffer::StartPrompt()
     const auto currentRowOffset = GetCursor().GetPosition().y;
     auto& currentRow = GetMutableRowByOffset(currentRowOffset);
     currentRow.StartPrompt();
+    _hasMarks = true;
 
     _currentAttributes.SetMarkAttributes(MarkKind::Prompt);
 }
@@ -3574,6 +4142,7 @@ bool TextBuffer::_createPromptMarkIfNeeded()
 
     auto& row = GetMutableRowByOffset(GetCursor().GetPosition().y);
     row.StartPrompt();
+    _hasMarks = true;
     return true;
 }
 
@@ -3599,8 +4168,7 @@ void TextBuffer::EndCurrentCommand(std::optional<unsigned int> error)
     for (auto y = GetCursor().GetPosition().y; y >= 0; y--)
     {
         auto& currRow = GetMutableRowByOffset(y);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (rowPromptData.has_value())
+        if (currRow.GetScrollbarData())
         {
             currRow.EndOutput(error);
             return;
@@ -3611,7 +4179,8 @@ void TextBuffer::EndCurrentCommand(std::optional<unsigned int> error)
 void TextBuffer::SetScrollbarData(ScrollbarData mark, til::CoordType y)
 {
     auto& row = GetMutableRowByOffset(y);
-    row.SetScrollbarData(mark);
+    row.SetScrollbarData(&mark);
+    _hasMarks = true;
 }
 void TextBuffer::ManuallyMarkRowAsPrompt(til::CoordType y)
 {
@@ -120,6 +120,10 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<til::CoordType> limitRight = std::nullopt);
 
+    bool WriteCharInfos(std::span<const CHAR_INFO> charInfos,
+                        const til::point target,
+                        const std::optional<bool> setWrap = std::nullopt);
+
     void InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     void InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     void IncrementCursor();
@@ -134,11 +138,19 @@ public:
     const Cursor& GetCursor() const noexcept;
 
     uint64_t GetLastMutationId() const noexcept;
+    uint64_t GetScrollCount() const noexcept;
+    bool CanTrackMutationsSince(uint64_t mutationId) const noexcept;
+    til::CoordType GetFirstRowMutatedSince(uint64_t mutationId) const;
     const til::CoordType GetFirstRowIndex() const noexcept;
+    size_t GetReservedBytes() const noexcept;
+    size_t GetCommittedBytes() const noexcept;
+    size_t GetRowHeapBytes() const noexcept;
+    size_t GetHyperlinkCount() const noexcept;
 
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
 
     void ScrollRows(const til::CoordType firstRow, const til::CoordType size, const til::CoordType delta);
+    void RotateRows(const til::CoordType firstRow, const til::CoordType size, const til::CoordType delta);
 
     til::CoordType TotalRowCount() const noexcept;
 
@@ -158,6 +170,7 @@ public:
     til::point BufferToScreenPosition(const til::point position) const;
 
     void Reset() noexcept;
+    void ResetInPlace(const TextAttribute& attributes) noexcept;
     void ClearScrollback(const til::CoordType start, const til::CoordType height);
 
     void ResizeTraditional(const til::size newSize);
@@ -185,6 +198,7 @@ public:
     bool MoveToPreviousGlyph(til::point& pos, std::optional<til::point> limitOptional = std::nullopt) const;
 
     const std::vector<til::inclusive_rect> GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const;
+    const std::vector<til::inclusive_rect> GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates, til::CoordType rowBeg, til::CoordType rowEnd) const;
     std::vector<til::point_span> GetTextSpans(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const;
 
     void AddHyperlinkToMap(std::wstring_view uri, uint16_t id);
@@ -314,11 +328,16 @@ private:
     void _reserve(til::size screenBufferSize, const TextAttribute& defaultAttributes);
     void _commit(const std::byte* row);
     void _decommit() noexcept;
+    void _decommitFrom(size_t offset) noexcept;
+    void _restoreRowStorage() noexcept;
+    void _invalidateRowMutationIds() noexcept;
     void _construct(const std::byte* until) noexcept;
     void _destroy() const noexcept;
     ROW& _getRowByOffsetDirect(size_t offset);
     ROW& _getRow(til::CoordType y) const;
     til::CoordType _estimateOffsetOfLastCommittedRow() const noexcept;
+    std::vector<til::point_span> _searchTextRows(const std::wstring_view& needle, uint32_t flags, til::CoordType rowBeg, til::CoordType rowEnd) const;
+    std::vector<til::point_span> _searchTextRowsLiteral(const std::wstring_view& needle, bool caseInsensitive, til::CoordType rowBeg, til::CoordType rowEnd) const;
 
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
     til::point _GetPreviousFromCursor() const;
@@ -328,6 +347,7 @@ private:
     void _PrepareForDoubleByteSequence(const DbcsAttribute dbcsAttribute);
     void _ExpandTextRow(til::inclusive_rect& selectionRow) const;
     DelimiterClass _GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const;
+    til::CoordType _SkipDelimiterClass(const til::point pos, const til::CoordType endX, const DelimiterClass delimiterClass, const std::wstring_view wordDelimiters) const;
     til::point _GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const;
     til::point _GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
     til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
@@ -388,6 +408,10 @@ private:
     // There's probably a better metric than this. (This comment was written when ROW had both,
     // a _chars array containing text and a _charOffsets array contain column-to-text indices.)
     static constexpr size_t _commitReadAheadRowCount = 128;
+    // Rows this far above the bottom of the buffer are considered to be "cold": They're unlikely to be
+    // written to again and IncrementCircularBuffer() will trim any excess memory they hold on to.
+    // This value is larger than the height of any reasonable viewport.
+    static constexpr til::CoordType _coldRowDistance = 512;
     // Before TextBuffer was made to use virtual memory it initialized the entire memory arena with the initial
     // attributes right away. To ensure it continues to work the way it used to, this stores these initial attributes.
     TextAttribute _initialAttributes;
@@ -408,6 +432,10 @@ private:
     TextAttribute _currentAttributes;
     til::CoordType _firstRow = 0; // indexes top row (not necessarily 0)
     uint64_t _lastMutationId = 0;
+    uint64_t _scrollCount = 0;
+    // Set once any row in the buffer got a mark. Most buffers never see shell integration
+    // marks and this allows GetMarkRows() & co. to skip scanning all rows for them.
+    bool _hasMarks = false;
 
     Cursor _cursor;
     bool _isActiveBuffer = false;
@@ -415,5 +443,6 @@ private:
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
+    friend class UTextAdapterTests;
 #endif
 };
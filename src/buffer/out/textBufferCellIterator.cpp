@@ -356,3 +356,20 @@ til::point TextBufferCellIterator::Pos() const noexcept
 {
     return _pos;
 }
+
+// Routine Description:
+// - Provides the number of columns starting at the current position that share the current
+//   attribute, limited to the iterator's bounds on the current row. This allows callers to
+//   process an entire attribute run at once, instead of inspecting it cell by cell.
+// Return Value:
+// - The number of columns in the current attribute run, or 0 if the iterator is invalid.
+til::CoordType TextBufferCellIterator::AttrRunLength() const noexcept
+{
+    if (!*this)
+    {
+        return 0;
+    }
+
+    const auto remaining = gsl::narrow_cast<til::CoordType>(_attrIter.remaining_run_length());
+    return std::min(remaining, _bounds.RightExclusive() - _pos.x);
+}
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+// This makes til::alloc_tracking count all allocations in this test binary.
+TIL_ALLOC_TRACKING_DEFINE_OPERATORS()
+
+class AllocationTests
+{
+    TEST_CLASS(AllocationTests);
+
+    TEST_METHOD(SteadyStateLineOutputDoesNotAllocate);
+};
+
+void AllocationTests::SteadyStateLineOutputDoesNotAllocate()
+{
+    static constexpr til::CoordType width = 80;
+    static constexpr til::CoordType height = 30;
+    static constexpr std::wstring_view line{ L"The quick brown fox jumps over the lazy dog" };
+
+    DummyRenderer renderer;
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 0, false, renderer };
+    const TextAttribute attributes{ 0x0a };
+
+    // This is what printing a line at the bottom of the viewport boils down to.
+    const auto writeLine = [&]() {
+        buffer.IncrementCircularBuffer();
+        RowWriteState state{
+            .text = line,
+            .columnLimit = width,
+        };
+        buffer.Replace(height - 1, attributes, state);
+    };
+
+    // Scroll through the entire buffer once, so that every row is committed and has been written to.
+    for (til::CoordType i = 0; i < height; ++i)
+    {
+        writeLine();
+    }
+
+    til::alloc_tracking::reset();
+
+    for (til::CoordType i = 0; i < 4 * height; ++i)
+    {
+        writeLine();
+    }
+
+    const auto counters = til::alloc_tracking::get(til::alloc_tracking::category::buffer);
+    VERIFY_ARE_EQUAL(0u, counters.allocations);
+    VERIFY_ARE_EQUAL(0u, counters.bytes);
+}
@@ -5,6 +5,7 @@
 
 #include "WexTestClass.h"
 #include "../textBuffer.hpp"
+#include "../UTextAdapter.h"
 #include "../../renderer/inc/DummyRenderer.hpp"
 
 template<>
@@ -60,4 +61,95 @@ class UTextAdapterTests
         actual = buffer.SearchText(L"ネコ", false);
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(CaseInsensitiveFolding)
+    {
+        DummyRenderer renderer;
+        TextBuffer buffer{ til::size{ 24, 1 }, TextAttribute{}, 0, false, renderer };
+
+        RowWriteState state{
+            .text = L"\xFB00 ff FF \x0130 i",
+        };
+        buffer.Replace(0, TextAttribute{}, state);
+        VERIFY_IS_TRUE(state.text.empty());
+
+        static constexpr auto s = [](til::CoordType beg, til::CoordType end) -> til::point_span {
+            return { { beg, 0 }, { end, 0 } };
+        };
+
+        // U+FB00 folds to "ff", which the ASCII-only fast path must not miss.
+        auto expected = std::vector{ s(0, 0), s(2, 3), s(5, 6) };
+        auto actual = buffer.SearchText(L"ff", true);
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        expected = std::vector{ s(2, 3) };
+        actual = buffer.SearchText(L"ff", false);
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        // U+0130 folds to "i" followed by U+0307. Whether that counts as a match is up to ICU,
+        // but the plain "i" must still be found when the line takes the ICU path.
+        actual = buffer.SearchText(L"I", true);
+        VERIFY_IS_TRUE(std::ranges::find(actual, s(10, 10)) != actual.end());
+    }
+
+    TEST_METHOD(ConcurrentSearchMatchesSerialSearch)
+    {
+        // SearchText() splits ranges of 2048 rows or more into up to hardware_concurrency() chunks.
+        static constexpr til::CoordType width = 80;
+        static constexpr til::CoordType height = 8192;
+
+        if (std::thread::hardware_concurrency() < 2)
+        {
+            WEX::Logging::Log::Comment(L"This machine has a single core. SearchText() will take the serial path.");
+        }
+
+        DummyRenderer renderer;
+        TextBuffer buffer{ til::size{ width, height }, TextAttribute{}, 0, false, renderer };
+
+        for (til::CoordType y = 0; y < height; ++y)
+        {
+            // Chunks split at multiples of 1024 rows. Put a match that wraps across
+            // each of those rows, which mustn't be lost by splitting the wrapped line.
+            if (y % 1024 == 1023)
+            {
+                RowWriteState state{
+                    .text = L"ab",
+                    .columnBegin = width - 2,
+                };
+                buffer.Replace(y, TextAttribute{}, state);
+                buffer.SetWrapForced(y, true);
+                continue;
+            }
+
+            const auto text = std::wstring{ y % 1024 == 0 ? L"c" : L"" } + L" abc ABC aBc " + std::to_wstring(y);
+            RowWriteState state{
+                .text = text,
+            };
+            buffer.Replace(y, TextAttribute{}, state);
+        }
+
+        static constexpr std::array needles{ L"abc", L"ABC", L"c abc", L"\u00e4bc" };
+        for (const auto needle : needles)
+        {
+            for (const auto caseInsensitive : { false, true })
+            {
+                WEX::Logging::Log::Comment(WEX::Common::NoThrowString().Format(L"needle: \"%s\", caseInsensitive: %d", needle, caseInsensitive));
+
+                uint32_t flags = UREGEX_LITERAL;
+                WI_SetFlagIf(flags, UREGEX_CASE_INSENSITIVE, caseInsensitive);
+
+                const auto expected = buffer._searchTextRows(needle, flags, 0, height);
+                const auto actual = buffer.SearchText(needle, caseInsensitive);
+                VERIFY_ARE_EQUAL(expected, actual);
+            }
+        }
+
+        // Make sure that the matches across the chunk boundaries were actually tested.
+        const auto actual = buffer.SearchText(L"abc", false);
+        for (til::CoordType y = 1023; y < height; y += 1024)
+        {
+            const til::point_span wrapped{ { width - 2, y }, { 0, y + 1 } };
+            VERIFY_IS_TRUE(std::ranges::find(actual, wrapped) != actual.end());
+        }
+    }
 };
@@ -26,6 +26,7 @@ namespace TerminalAppLocalTests
         TEST_METHOD(VerifyWeight);
         TEST_METHOD(VerifyCompare);
         TEST_METHOD(VerifyCompareIgnoreCase);
+        TEST_METHOD(VerifyQuickReject);
     };
 
     void FilteredCommandTests::VerifyHighlighting()
@@ -229,4 +230,36 @@ namespace TerminalAppLocalTests
 
         VERIFY_SUCCEEDED(result);
     }
+
+    void FilteredCommandTests::VerifyQuickReject()
+    {
+        auto result = RunOnUIThread([]() {
+            const auto paletteItem{ winrt::make<winrt::TerminalApp::implementation::CommandLinePaletteItem>(L"Close Tab") };
+            const auto filteredCommand = winrt::make_self<winrt::TerminalApp::implementation::FilteredCommand>(paletteItem);
+            {
+                Log::Comment(L"Filters with characters that aren't part of the name are rejected early");
+                VERIFY_IS_FALSE(filteredCommand->_canMatch(L"xyz"));
+                filteredCommand->UpdateFilter(L"xyz");
+                VERIFY_ARE_EQUAL(0, filteredCommand->Weight());
+                auto segments = filteredCommand->HighlightedName().Segments();
+                VERIFY_ARE_EQUAL(segments.Size(), 1u);
+                VERIFY_ARE_EQUAL(segments.GetAt(0).TextSegment(), L"Close Tab");
+                VERIFY_IS_FALSE(segments.GetAt(0).IsHighlighted());
+            }
+            {
+                Log::Comment(L"Filters that may match still go through the regular matching");
+                VERIFY_IS_TRUE(filteredCommand->_canMatch(L"TC"));
+                filteredCommand->UpdateFilter(L"ct");
+                VERIFY_IS_GREATER_THAN(filteredCommand->Weight(), 0);
+            }
+            {
+                Log::Comment(L"Names with non-ASCII characters are never rejected early");
+                const auto otherItem{ winrt::make<winrt::TerminalApp::implementation::CommandLinePaletteItem>(L"\u00c9diter") };
+                const auto otherCommand = winrt::make_self<winrt::TerminalApp::implementation::FilteredCommand>(otherItem);
+                VERIFY_IS_TRUE(otherCommand->_canMatch(L"xyz"));
+            }
+        });
+
+        VERIFY_SUCCEEDED(result);
+    }
 }
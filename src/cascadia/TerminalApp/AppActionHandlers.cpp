@@ -1090,6 +1090,22 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    void TerminalPage::_HandleTraceBufferMemory(const IInspectable& /*sender*/,
+                                                const ActionEventArgs& args)
+    {
+        if (_settings.GlobalSettings().DebugFeaturesEnabled())
+        {
+            for (const auto& tab : _tabs)
+            {
+                if (const auto terminalTab{ _GetTerminalTabImpl(tab) })
+                {
+                    terminalTab->TraceBufferMemory();
+                }
+            }
+            args.Handled(true);
+        }
+    }
+
     void TerminalPage::_HandleSearchForText(const IInspectable& /*sender*/,
                                             const ActionEventArgs& args)
     {
@@ -1192,14 +1208,14 @@ namespace winrt::TerminalApp::implementation
             {
                 if (const auto& realArgs = args.ActionArgs().try_as<ExportBufferArgs>())
                 {
-                    _ExportTab(*activeTab, realArgs.Path());
+                    _ExportTab(activeTab, realArgs.Path());
                     args.Handled(true);
                     return;
                 }
             }
 
             // If we didn't have args, or the args weren't ExportBufferArgs (somehow)
-            _ExportTab(*activeTab, L"");
+            _ExportTab(activeTab, L"");
             if (args)
             {
                 args.Handled(true);
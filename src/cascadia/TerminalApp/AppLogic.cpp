@@ -207,8 +207,12 @@ namespace winrt::TerminalApp::implementation
 
         try
         {
+            TIL_TRACE_STARTUP_PHASE(g_hTerminalAppProvider, "SettingsLoadStarted");
+
             auto newSettings = CascadiaSettings::LoadAll();
 
+            TIL_TRACE_STARTUP_PHASE(g_hTerminalAppProvider, "SettingsLoadCompleted");
+
             if (newSettings.GetLoadingError())
             {
                 _settingsLoadExceptionText = _GetErrorText(newSettings.GetLoadingError().Value());
@@ -65,6 +65,7 @@ namespace winrt::Microsoft::TerminalApp::implementation
             StateChanged.raise(*this, nullptr);
         });
         _wrappedConnection = wrappedConnection;
+        _OpenRecording();
     }
 
     DebugTapConnection::~DebugTapConnection() = default;
@@ -75,6 +76,11 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
         // This is explained in the comment for GH#11282 above.
         _start.count_down();
+
+        if (_recording)
+        {
+            TerminalOutput.raise(fmt::format(FMT_COMPILE(L"\x1b[93mRecording output to {}\x1b[m\r\n"), _recordingPath));
+        }
     }
 
     void DebugTapConnection::WriteInput(const hstring& data)
@@ -119,6 +125,8 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
     void DebugTapConnection::_OutputHandler(const hstring str)
     {
+        _Record(str);
+
         auto output = til::visualize_control_codes(str);
         // To make the output easier to read, we introduce a line break whenever
         // an LF control is encountered. But at this point, the LF would have
@@ -130,6 +138,64 @@ namespace winrt::Microsoft::TerminalApp::implementation
         TerminalOutput.raise(output);
     }
 
+    // Opens a file in the temp directory that receives the raw output of the wrapped connection,
+    // so that it can be replayed later on with the original timing (see RecordingMagic).
+    // Recording is off unless the WT_DEBUGTAP_RECORDING environment variable is set to a non-empty
+    // value, because the output may contain anything (including secrets) and files would pile up.
+    // The tap works just fine without it, which is why failures are only logged.
+    void DebugTapConnection::_OpenRecording()
+    try
+    {
+        if (wil::TryGetEnvironmentVariableW<std::wstring>(L"WT_DEBUGTAP_RECORDING").empty())
+        {
+            return;
+        }
+
+        std::wstring path(MAX_PATH + 1, L'\0');
+        const auto length = GetTempPathW(gsl::narrow_cast<DWORD>(path.size()), path.data());
+        THROW_LAST_ERROR_IF(length == 0 || length >= path.size());
+        path.resize(length);
+        path.append(fmt::format(FMT_COMPILE(L"wt-{}-{}.vtrec"), GetCurrentProcessId(), GetTickCount64()));
+
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+        DWORD written = 0;
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), RecordingMagic.data(), gsl::narrow_cast<DWORD>(RecordingMagic.size()), &written, nullptr));
+
+        _recording = std::move(file);
+        _recordingPath = std::move(path);
+        _recordingStart = std::chrono::steady_clock::now();
+    }
+    CATCH_LOG()
+
+    void DebugTapConnection::_Record(const hstring& str)
+    try
+    {
+        if (!_recording)
+        {
+            return;
+        }
+
+        const auto timestamp = gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _recordingStart).count());
+
+        // The header and payload are assembled in a single buffer, so that each record takes a single WriteFile().
+        _recordingScratch.resize(sizeof(uint64_t) + sizeof(uint32_t));
+        _recordingScratch.append(til::u16u8(str));
+
+        const auto size = gsl::narrow_cast<uint32_t>(_recordingScratch.size() - sizeof(uint64_t) - sizeof(uint32_t));
+        memcpy(_recordingScratch.data(), &timestamp, sizeof(timestamp));
+        memcpy(_recordingScratch.data() + sizeof(timestamp), &size, sizeof(size));
+
+        DWORD written = 0;
+        if (!WriteFile(_recording.get(), _recordingScratch.data(), gsl::narrow_cast<DWORD>(_recordingScratch.size()), &written, nullptr))
+        {
+            // Don't spam the log for every chunk of output if the disk is full, etc.
+            LOG_LAST_ERROR();
+            _recording.reset();
+        }
+    }
+    CATCH_LOG()
+
     // Called by the DebugInputTapConnection to print user input
     void DebugTapConnection::_PrintInput(const hstring& str)
     {
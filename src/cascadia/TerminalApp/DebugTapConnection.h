@@ -29,9 +29,18 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
         til::typed_event<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, winrt::Windows::Foundation::IInspectable> StateChanged;
 
+        // Recordings start with this magic, followed by a sequence of records that each consist of:
+        // * uint64_t: microseconds since the recording started
+        // * uint32_t: size of the payload in bytes
+        // * the payload: the connection output as UTF-8
+        // All integers are little endian. See the -t option in src/tools/benchcat, which replays them.
+        static constexpr std::string_view RecordingMagic{ "WTVTREC1" };
+
     private:
         void _PrintInput(const hstring& data);
         void _OutputHandler(const hstring str);
+        void _OpenRecording();
+        void _Record(const hstring& str);
 
         winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection::TerminalOutput_revoker _outputRevoker;
         winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection::StateChanged_revoker _stateChangedRevoker;
@@ -40,6 +49,11 @@ namespace winrt::Microsoft::TerminalApp::implementation
 
         til::latch _start{ 1 };
 
+        wil::unique_hfile _recording;
+        std::wstring _recordingPath;
+        std::chrono::steady_clock::time_point _recordingStart;
+        std::string _recordingScratch;
+
         friend class DebugInputTapConnection;
     };
 }
@@ -27,12 +27,14 @@ namespace winrt::TerminalApp::implementation
         _Weight(0)
     {
         _HighlightedName = _computeHighlightedName();
+        _updateNameIndex();
 
         // Recompute the highlighted name if the item name changes
         _itemChangedRevoker = _Item.PropertyChanged(winrt::auto_revoke, [weakThis{ get_weak() }](auto& /*sender*/, auto& e) {
             auto filteredCommand{ weakThis.get() };
             if (filteredCommand && e.PropertyName() == L"Name")
             {
+                filteredCommand->_updateNameIndex();
                 filteredCommand->HighlightedName(filteredCommand->_computeHighlightedName());
                 filteredCommand->Weight(filteredCommand->_computeWeight());
             }
@@ -46,11 +48,82 @@ namespace winrt::TerminalApp::implementation
         if (filter != _Filter)
         {
             Filter(filter);
+
+            // Most items in a large palette don't match the filter at all. Reject them
+            // before doing the expensive work of building the HighlightedText segments.
+            if (!_canMatch(filter))
+            {
+                HighlightedName(_unmatchedName);
+                Weight(0);
+                return;
+            }
+
             HighlightedName(_computeHighlightedName());
             Weight(_computeWeight());
         }
     }
 
+    // Maps ASCII letters (case-insensitively) and digits to the bits 0-35 of a mask, and anything else to -1.
+    static int _asciiCharBit(const wchar_t ch) noexcept
+    {
+        if (ch >= L'0' && ch <= L'9')
+        {
+            return ch - L'0';
+        }
+        const auto lower = til::tolower_ascii(ch);
+        if (lower >= L'a' && lower <= L'z')
+        {
+            return 10 + (lower - L'a');
+        }
+        return -1;
+    }
+
+    // Method Description:
+    // - Precomputes the data used by _canMatch() for the current item name.
+    void FilteredCommand::_updateNameIndex()
+    {
+        const std::wstring_view name{ _Item.Name() };
+        uint64_t mask = 0;
+
+        for (const auto ch : name)
+        {
+            // lstrcmpi() compares linguistically and may consider non-ASCII
+            // characters equal to ASCII ones. We can't rule anything out then.
+            if (ch >= 0x80)
+            {
+                mask = UINT64_MAX;
+                break;
+            }
+            if (const auto bit = _asciiCharBit(ch); bit >= 0)
+            {
+                mask |= uint64_t{ 1 } << bit;
+            }
+        }
+
+        _nameCharMask = mask;
+
+        const auto segments = winrt::single_threaded_observable_vector<winrt::TerminalApp::HighlightedTextSegment>();
+        segments.Append(winrt::make<HighlightedTextSegment>(_Item.Name(), false));
+        _unmatchedName = winrt::make<HighlightedText>(segments);
+    }
+
+    // Method Description:
+    // - Returns false if the filter is guaranteed to not match the item name,
+    //   because it contains an ASCII letter or digit that the name doesn't.
+    //   A return value of true doesn't imply a match.
+    bool FilteredCommand::_canMatch(const winrt::hstring& filter) const noexcept
+    {
+        uint64_t mask = 0;
+        for (const auto ch : filter)
+        {
+            if (const auto bit = _asciiCharBit(ch); bit >= 0)
+            {
+                mask |= uint64_t{ 1 } << bit;
+            }
+        }
+        return (mask & ~_nameCharMask) == 0;
+    }
+
     // Method Description:
     // - Looks up the filter characters within the item name.
     // Iterating through the filter and the item name it tries to associate the next filter character
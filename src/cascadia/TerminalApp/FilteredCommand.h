@@ -32,6 +32,14 @@ namespace winrt::TerminalApp::implementation
     private:
         winrt::TerminalApp::HighlightedText _computeHighlightedName();
         int _computeWeight();
+        void _updateNameIndex();
+        bool _canMatch(const winrt::hstring& filter) const noexcept;
+
+        // Bitmask of the ASCII letters and digits in the item name. See _canMatch().
+        uint64_t _nameCharMask = 0;
+        // The HighlightedText for when the filter doesn't match. It's shared between all
+        // calls to UpdateFilter(), so that rejecting an item doesn't allocate anything.
+        winrt::TerminalApp::HighlightedText _unmatchedName{ nullptr };
         Windows::UI::Xaml::Data::INotifyPropertyChanged::PropertyChanged_revoker _itemChangedRevoker;
 
         friend class TerminalAppLocalTests::FilteredCommandTests;
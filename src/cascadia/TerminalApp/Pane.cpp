@@ -2832,20 +2832,33 @@ Size Pane::_GetMinSize() const
 // Method Description:
 // - Builds a tree of LayoutSizeNode that matches the tree of panes. Each node
 //   has minimum size that the corresponding pane can have.
+// - The tree is built bottom-up, so that each parent derives its minimum size
+//   from its already computed children, instead of calling _GetMinSize() at
+//   every level, which would walk the entire subtree again each time.
 // Arguments:
 // - widthOrHeight: if true operates on width, otherwise on height
 // Return Value:
 // - Root node of built tree that matches this pane.
 Pane::LayoutSizeNode Pane::_CreateMinSizeTree(const bool widthOrHeight) const
 {
-    const auto size = _GetMinSize();
-    LayoutSizeNode node(widthOrHeight ? size.Width : size.Height);
-    if (!_IsLeaf())
+    if (_IsLeaf())
     {
-        node.firstChild = std::make_unique<LayoutSizeNode>(_firstChild->_CreateMinSizeTree(widthOrHeight));
-        node.secondChild = std::make_unique<LayoutSizeNode>(_secondChild->_CreateMinSizeTree(widthOrHeight));
+        const auto size = _GetMinSize();
+        return LayoutSizeNode(widthOrHeight ? size.Width : size.Height);
     }
 
+    auto firstChild = std::make_unique<LayoutSizeNode>(_firstChild->_CreateMinSizeTree(widthOrHeight));
+    auto secondChild = std::make_unique<LayoutSizeNode>(_secondChild->_CreateMinSizeTree(widthOrHeight));
+
+    // This mirrors the logic in _GetMinSize(): Children placed next to each other
+    // along the given axis add up, otherwise the larger one of the two wins.
+    const auto minDimension = _splitState == (widthOrHeight ? SplitState::Vertical : SplitState::Horizontal) ?
+                                  firstChild->size + secondChild->size :
+                                  std::max(firstChild->size, secondChild->size);
+
+    LayoutSizeNode node(minDimension);
+    node.firstChild = std::move(firstChild);
+    node.secondChild = std::move(secondChild);
     return node;
 }
 
@@ -2962,15 +2975,18 @@ void Pane::BroadcastKey(const winrt::Microsoft::Terminal::Control::TermControl&
                         const winrt::Microsoft::Terminal::Core::ControlKeyStates modifiers,
                         const bool keyDown)
 {
+    std::vector<winrt::Microsoft::Terminal::Control::TermControl> targets;
     WalkTree([&](const auto& pane) {
         if (const auto& termControl{ pane->GetTerminalControl() })
         {
             if (termControl != sourceControl && !termControl.ReadOnly())
             {
-                termControl.RawWriteKeyEvent(vkey, scanCode, modifiers, keyDown);
+                targets.emplace_back(termControl);
             }
         }
     });
+    // Let the controls translate the key only once per distinct input mode set.
+    winrt::Microsoft::Terminal::Control::TermControl::BroadcastKeyEvent(winrt::single_threaded_vector(std::move(targets)).GetView(), vkey, scanCode, modifiers, keyDown);
 }
 
 void Pane::BroadcastChar(const winrt::Microsoft::Terminal::Control::TermControl& sourceControl,
@@ -758,27 +758,19 @@ namespace winrt::TerminalApp::implementation
 
     void SuggestionsControl::SetCommands(const Collections::IVector<Command>& actions)
     {
-        _allCommands.Clear();
+        std::vector<winrt::TerminalApp::FilteredCommand> commands;
+        commands.reserve(actions.Size());
         for (const auto& action : actions)
         {
             auto actionPaletteItem{ winrt::make<winrt::TerminalApp::implementation::ActionPaletteItem>(action) };
-            auto filteredCommand{ winrt::make<FilteredCommand>(actionPaletteItem) };
-            _allCommands.Append(filteredCommand);
+            commands.emplace_back(winrt::make<FilteredCommand>(actionPaletteItem));
         }
+        _allCommands.ReplaceAll(commands);
 
-        if (Visibility() == Visibility::Visible)
-        {
-            _updateFilteredActions();
-        }
-        else // THIS BRANCH IS NEW
-        {
-            auto actions = _collectFilteredActions();
-            _filteredActions.Clear();
-            for (const auto& action : actions)
-            {
-                _filteredActions.Append(action);
-            }
-        }
+        // All of these items are new, so there's nothing the Insert/Remove diffing in
+        // _updateFilteredActions() could animate. Shell completions can contain thousands
+        // of entries, and a single Reset notification is much cheaper than one per item.
+        _filteredActions.ReplaceAll(_collectFilteredActions());
     }
 
     void SuggestionsControl::_switchToMode()
@@ -867,6 +859,13 @@ namespace winrt::TerminalApp::implementation
     {
         auto actions = _collectFilteredActions();
 
+        // There's nothing to animate if the list was empty before (for instance after _switchToMode()).
+        if (_filteredActions.Size() == 0)
+        {
+            _filteredActions.ReplaceAll(actions);
+            return;
+        }
+
         // Make _filteredActions look identical to actions, using only Insert and Remove.
         // This allows WinUI to nicely animate the ListView as it changes.
         for (uint32_t i = 0; i < _filteredActions.Size() && i < actions.size(); i++)
@@ -326,7 +326,7 @@ namespace winrt::TerminalApp::implementation
     // - Exports the content of the Terminal Buffer inside the tab
     // Arguments:
     // - tab: tab to export
-    winrt::fire_and_forget TerminalPage::_ExportTab(const TerminalTab& tab, winrt::hstring filepath)
+    winrt::fire_and_forget TerminalPage::_ExportTab(winrt::com_ptr<TerminalTab> tab, winrt::hstring filepath)
     {
         // This will be used to set up the file picker "filter", to select .txt
         // files by default.
@@ -341,7 +341,7 @@ namespace winrt::TerminalApp::implementation
 
         try
         {
-            if (const auto control{ tab.GetActiveTerminalControl() })
+            if (const auto control{ tab->GetActiveTerminalControl() })
             {
                 auto path = filepath;
 
@@ -350,7 +350,7 @@ namespace winrt::TerminalApp::implementation
                     // GH#11356 - we can't use the UWP apis for writing the file,
                     // because they don't work elevated (shocker) So just use the
                     // shell32 file picker manually.
-                    std::wstring filename{ tab.Title() };
+                    std::wstring filename{ tab->Title() };
                     filename = til::clean_filename(filename);
                     path = co_await SaveFilePicker(*_hostingHwnd, [filename = std::move(filename)](auto&& dialog) {
                         THROW_IF_FAILED(dialog->SetClientGuid(clientGuidExportFile));
@@ -380,8 +380,22 @@ namespace winrt::TerminalApp::implementation
 
                 if (!path.empty())
                 {
-                    const auto buffer = control.ReadEntireBuffer();
-                    CascadiaSettings::ExportFile(path, buffer);
+                    const auto exportId = tab->BeginExportProgress();
+                    const auto endProgress = wil::scope_exit([&]() {
+                        tab->EndExportProgress(exportId);
+                    });
+
+                    auto operation = control.ExportBufferToFile(path);
+                    // The progress is reported from a background thread.
+                    operation.Progress([dispatcher = Dispatcher(), weakTab = tab->get_weak(), exportId](auto&&, const double progress) {
+                        dispatcher.RunAsync(CoreDispatcherPriority::Low, [weakTab, exportId, progress]() {
+                            if (const auto strongTab = weakTab.get())
+                            {
+                                strongTab->SetExportProgress(exportId, progress);
+                            }
+                        });
+                    });
+                    co_await operation;
                 }
             }
         }
@@ -161,6 +161,8 @@ namespace winrt::TerminalApp::implementation
 
     void TerminalPage::Create()
     {
+        TIL_TRACE_STARTUP_PHASE(g_hTerminalAppProvider, "TerminalPageCreated");
+
         // Hookup the key bindings
         _HookupKeyBindings(_settings.ActionMap());
 
@@ -500,6 +502,24 @@ namespace winrt::TerminalApp::implementation
         {
             _startupState = StartupState::InStartup;
 
+            // When restoring a layout with many panes, their OpenConsole processes would otherwise be spawned one
+            // after another, as each pane gets initialized. The first pane will create its own, so skip that one.
+            if (_startupActions)
+            {
+                uint32_t panes = 0;
+                for (const auto& action : _startupActions)
+                {
+                    if (_canUsePrewarmedPseudoConsole(action))
+                    {
+                        ++panes;
+                    }
+                }
+                if (panes > 1)
+                {
+                    ConptyConnection::PrewarmPseudoConsoles(panes - 1);
+                }
+            }
+
             ProcessStartupActions(_startupActions, true);
 
             // If we were told that the COM server needs to be started to listen for incoming
@@ -1200,6 +1220,56 @@ namespace winrt::TerminalApp::implementation
         return Utils::EvaluateStartingDirectory(_WindowProperties.VirtualWorkingDirectory(), path);
     }
 
+    // Method Description:
+    // - Returns true if the given startup action opens a pane whose connection could claim a
+    //   pseudoconsole from ConptyConnection::PrewarmPseudoConsoles(). Elevated profiles open in
+    //   another window and in-proc Azure connections don't use a pseudoconsole at all.
+    bool TerminalPage::_canUsePrewarmedPseudoConsole(const ActionAndArgs& action) const
+    {
+        NewTerminalArgs newTerminalArgs{ nullptr };
+
+        switch (action.Action())
+        {
+        case ShortcutAction::NewTab:
+            if (const auto& args{ action.Args().try_as<NewTabArgs>() })
+            {
+                newTerminalArgs = args.ContentArgs().try_as<NewTerminalArgs>();
+            }
+            break;
+        case ShortcutAction::SplitPane:
+            if (const auto& args{ action.Args().try_as<SplitPaneArgs>() })
+            {
+                newTerminalArgs = args.ContentArgs().try_as<NewTerminalArgs>();
+            }
+            break;
+        default:
+            return false;
+        }
+
+        const auto profile{ _settings.GetProfileForArgs(newTerminalArgs) };
+        if (!profile)
+        {
+            return false;
+        }
+
+        const auto elevateOverride = newTerminalArgs ? newTerminalArgs.Elevate() : nullptr;
+        const auto elevate = elevateOverride ? elevateOverride.Value() : profile.Elevate();
+        if (elevate && !IsRunningElevated())
+        {
+            return false;
+        }
+
+        if constexpr (Feature_AzureConnectionInProc::IsEnabled())
+        {
+            if (profile.ConnectionType() == TerminalConnection::AzureConnection::ConnectionType())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     // Method Description:
     // - Creates a new connection based on the profile settings
     // Arguments:
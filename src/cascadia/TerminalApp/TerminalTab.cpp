@@ -29,6 +29,11 @@ namespace winrt
 
 #define ASSERT_UI_THREAD() assert(TabViewItem().Dispatcher().HasThreadAccess())
 
+// The minimum delay between updating the tab's title in response to title changes of its panes.
+// Shells may set the title on every prompt or even every command they run, and each update
+// touches the header control, the tooltip and the automation properties of the tab.
+constexpr const auto UpdateTitleInterval = std::chrono::milliseconds(50);
+
 namespace winrt::TerminalApp::implementation
 {
     TerminalTab::TerminalTab(std::shared_ptr<Pane> rootPane)
@@ -80,6 +85,16 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void TerminalTab::_Setup()
     {
+        _updateTitle = std::make_shared<ThrottledFuncTrailing<>>(
+            DispatcherQueue::GetForCurrentThread(),
+            UpdateTitleInterval,
+            [weakThis = get_weak()]() {
+                if (auto tab{ weakThis.get() }; tab && tab->_GetActiveTitle() != tab->Title())
+                {
+                    tab->UpdateTitle();
+                }
+            });
+
         _rootClosedToken = _rootPane->Closed([=](auto&& /*s*/, auto&& /*e*/) {
             Closed.raise(nullptr, nullptr);
         });
@@ -975,19 +990,13 @@ namespace winrt::TerminalApp::implementation
 
         events.TitleChanged = content.TitleChanged(
             winrt::auto_revoke,
-            [dispatcher, weakThis](auto&&, auto&&) -> winrt::fire_and_forget {
-                // The lambda lives in the `std::function`-style container owned by `control`. That is, when the
-                // `control` gets destroyed the lambda struct also gets destroyed. In other words, we need to
-                // copy `weakThis` onto the stack, because that's the only thing that gets captured in coroutines.
-                // See: https://devblogs.microsoft.com/oldnewthing/20211103-00/?p=105870
-                const auto weakThisCopy = weakThis;
-                co_await wil::resume_foreground(dispatcher);
-                // Check if Tab's lifetime has expired
-                if (auto tab{ weakThisCopy.get() })
+            [updateTitle = std::weak_ptr{ _updateTitle }](auto&&, auto&&) {
+                // The title of the control changed, but not necessarily the title of the tab.
+                // _updateTitle coalesces bursts of these and then sets the tab's text
+                // to the active panes' text on the UI thread, if it actually changed.
+                if (const auto func = updateTitle.lock())
                 {
-                    // The title of the control changed, but not necessarily the title of the tab.
-                    // Set the tab's text to the active panes' text.
-                    tab->UpdateTitle();
+                    func->Run();
                 }
             });
 
@@ -1136,6 +1145,16 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void TerminalTab::_UpdateProgressState()
     {
+        // A running buffer export takes precedence over the progress of the panes.
+        if (_exportProgress)
+        {
+            _tabStatus.IsProgressRingIndeterminate(false);
+            _tabStatus.ProgressValue(*_exportProgress);
+            HideIcon(true);
+            _tabStatus.IsProgressRingActive(true);
+            return;
+        }
+
         const auto state{ GetCombinedTaskbarState() };
 
         const auto taskbarState = state.State();
@@ -1171,6 +1190,51 @@ namespace winrt::TerminalApp::implementation
         TaskbarProgressChanged.raise(nullptr, nullptr);
     }
 
+    // Method Description:
+    // - Shows the progress of a buffer export in the tab's progress ring, until
+    //   EndExportProgress() is called with the returned ID.
+    // - These should be called on the UI thread.
+    // Return Value:
+    // - An ID that SetExportProgress() and EndExportProgress() need to be called with.
+    uint32_t TerminalTab::BeginExportProgress()
+    {
+        ASSERT_UI_THREAD();
+
+        _exportProgress = 0;
+        _UpdateProgressState();
+        return ++_exportId;
+    }
+
+    // Method Description:
+    // - Updates the progress (in the range [0,1]) of the export with the given ID.
+    // - Progress reports are marshalled to the UI thread asynchronously, and so some may only arrive after the
+    //   export has ended (or a new one has begun). Those are ignored, so that they don't leave the ring visible.
+    void TerminalTab::SetExportProgress(const uint32_t exportId, const double progress)
+    {
+        ASSERT_UI_THREAD();
+
+        if (exportId != _exportId || !_exportProgress)
+        {
+            return;
+        }
+
+        _exportProgress = gsl::narrow_cast<uint32_t>(std::clamp(progress, 0.0, 1.0) * 100.0);
+        _UpdateProgressState();
+    }
+
+    void TerminalTab::EndExportProgress(const uint32_t exportId)
+    {
+        ASSERT_UI_THREAD();
+
+        if (exportId != _exportId)
+        {
+            return;
+        }
+
+        _exportProgress.reset();
+        _UpdateProgressState();
+    }
+
     // Method Description:
     // - Set an indicator on the tab if any pane is in a closed connection state.
     // - Show/hide the Restart Connection context menu entry depending on active pane's state.
@@ -1539,6 +1603,18 @@ namespace winrt::TerminalApp::implementation
             Automation::AutomationProperties::SetHelpText(restartConnectionMenuItem, restartConnectionToolTip);
         }
 
+        // "Scrollback memory (tab total): {0} MB"
+        // This is a purely informational item. Its text is updated whenever the menu opens.
+        Controls::MenuFlyoutItem bufferMemoryMenuItem;
+        {
+            bufferMemoryMenuItem.IsEnabled(false);
+
+            const auto bufferMemoryToolTip = RS_(L"BufferMemoryUsageToolTip");
+
+            WUX::Controls::ToolTipService::SetToolTip(bufferMemoryMenuItem, box_value(bufferMemoryToolTip));
+            Automation::AutomationProperties::SetHelpText(bufferMemoryMenuItem, bufferMemoryToolTip);
+        }
+
         // Build the menu
         Controls::MenuFlyout contextMenuFlyout;
         Controls::MenuFlyoutSeparator menuSeparator;
@@ -1574,6 +1650,15 @@ namespace winrt::TerminalApp::implementation
         auto closeSubMenu = _AppendCloseMenuItems(contextMenuFlyout);
         closeSubMenu.Items().Append(closePaneMenuItem);
 
+        contextMenuFlyout.Items().Append(Controls::MenuFlyoutSeparator{});
+        contextMenuFlyout.Items().Append(bufferMemoryMenuItem);
+        contextMenuFlyout.Opening([weakThis, bufferMemoryMenuItem](auto&&, auto&&) {
+            if (auto tab{ weakThis.get() })
+            {
+                bufferMemoryMenuItem.Text(tab->_bufferMemoryUsageText());
+            }
+        });
+
         TabViewItem().ContextFlyout(contextMenuFlyout);
     }
 
@@ -1777,6 +1862,39 @@ namespace winrt::TerminalApp::implementation
         return nullptr;
     }
 
+    // Method Description:
+    // - Returns the text of the context menu item that shows how much memory
+    //   the text buffers of all panes in this tab use.
+    // - See TraceBufferMemory() for a breakdown by pane.
+    winrt::hstring TerminalTab::_bufferMemoryUsageText() const
+    {
+        uint64_t bytes = 0;
+        _rootPane->WalkTree([&](const auto& p) {
+            if (const auto& control{ _termControlFromPane(p) })
+            {
+                bytes += control.BufferMemoryUsage();
+            }
+        });
+
+        const auto megabytes = fmt::format(L"{:.1f}", bytes / (1024.0 * 1024.0));
+        return winrt::hstring{ fmt::format(std::wstring_view{ RS_(L"BufferMemoryUsageText") }, megabytes) };
+    }
+
+    // Method Description:
+    // - Emits the memory usage of the text buffers of each pane in this tab
+    //   as an ETW event. Does nothing unless a trace is running.
+    void TerminalTab::TraceBufferMemory() const
+    {
+        ASSERT_UI_THREAD();
+
+        _rootPane->WalkTree([&](const auto& p) {
+            if (const auto& control{ _termControlFromPane(p) })
+            {
+                control.TraceMemoryDiagnostics();
+            }
+        });
+    }
+
     // Method Description:
     // - Toggle read-only mode on the active pane
     // - If a parent pane is selected, this will ensure that all children have
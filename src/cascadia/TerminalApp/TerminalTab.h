@@ -7,6 +7,8 @@
 #include "TabBase.h"
 #include "TerminalTab.g.h"
 
+#include <ThrottledFunc.h>
+
 // fwdecl unittest classes
 namespace TerminalAppLocalTests
 {
@@ -46,6 +48,9 @@ namespace winrt::TerminalApp::implementation
         void HideIcon(const bool hide);
 
         void ShowBellIndicator(const bool show);
+        uint32_t BeginExportProgress();
+        void SetExportProgress(const uint32_t exportId, const double progress);
+        void EndExportProgress(const uint32_t exportId);
         void ActivateBellIndicatorTimer();
 
         float CalcSnappedDimension(const bool widthOrHeight, const float dimension) const;
@@ -84,6 +89,7 @@ namespace winrt::TerminalApp::implementation
         int GetLeafPaneCount() const noexcept;
 
         void TogglePaneReadOnly();
+        void TraceBufferMemory() const;
         void SetPaneReadOnly(const bool readOnlyState);
         void ToggleBroadcastInput();
 
@@ -119,6 +125,7 @@ namespace winrt::TerminalApp::implementation
         std::optional<winrt::Windows::UI::Color> _runtimeTabColor{};
         winrt::TerminalApp::TabHeaderControl _headerControl{};
         winrt::TerminalApp::TerminalTabStatus _tabStatus{};
+        std::shared_ptr<ThrottledFuncTrailing<>> _updateTitle;
 
         winrt::TerminalApp::ColorPickupFlyout _tabColorPickup{ nullptr };
         winrt::event_token _colorSelectedToken;
@@ -181,9 +188,12 @@ namespace winrt::TerminalApp::implementation
         void _RecalculateAndApplyReadOnly();
 
         void _UpdateProgressState();
+        std::optional<uint32_t> _exportProgress;
+        uint32_t _exportId = 0;
 
         void _UpdateConnectionClosedState();
         void _RestartActivePaneConnection();
+        winrt::hstring _bufferMemoryUsageText() const;
 
         void _DuplicateTab();
 
@@ -193,8 +193,22 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         if (_state == AzureState::TermConnected)
         {
-            auto buff{ winrt::to_string(data) };
-            WinHttpWebSocketSend(_webSocket.get(), WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE, buff.data(), gsl::narrow<DWORD>(buff.size()));
+            // WinHttpWebSocketSend() blocks until the frame was sent, so we must not hold
+            // _inputMutex across it. Instead we borrow the reusable buffer while holding the
+            // lock and give it back afterwards. A concurrent caller simply gets an empty one.
+            std::string buffer;
+            {
+                std::lock_guard<std::mutex> lock{ _inputMutex };
+                buffer.swap(_u8Input);
+            }
+            if (SUCCEEDED(til::u16u8(data, buffer)))
+            {
+                WinHttpWebSocketSend(_webSocket.get(), WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE, buffer.data(), gsl::narrow<DWORD>(buffer.size()));
+            }
+            {
+                std::lock_guard<std::mutex> lock{ _inputMutex };
+                _u8Input.swap(buffer);
+            }
             return;
         }
 
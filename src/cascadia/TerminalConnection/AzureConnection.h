@@ -99,7 +99,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         til::u8state _u8State{};
         std::wstring _u16Str;
-        std::array<char, 4096> _buffer{};
+        // Large enough to receive a whole burst of output in one read, so that
+        // we don't raise TerminalOutput (and lock the terminal) for every 4K of it.
+        std::array<char, 64 * 1024> _buffer{};
+        // Reused for every WriteInput() call once we're connected.
+        std::string _u8Input;
 
         static winrt::hstring _ParsePreferredShellType(const winrt::Windows::Data::Json::JsonObject& settingsResponse);
     };
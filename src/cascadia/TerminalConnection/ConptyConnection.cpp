@@ -5,6 +5,7 @@
 #include "ConptyConnection.h"
 
 #include <conpty-static.h>
+#include <til/mutex.h>
 #include <til/string.h>
 #include <winternl.h>
 
@@ -20,6 +21,13 @@ using namespace std::string_view_literals;
 // Format is: "DecimalResult (HexadecimalForm)"
 static constexpr auto _errorFormat = L"{0} ({0:#010x})"sv;
 
+// The flags Start() uses for a regular (non-inheriting) connection. Only those can use a prewarmed pseudoconsole.
+static constexpr DWORD warmPseudoConsoleFlags = PSEUDOCONSOLE_RESIZE_QUIRK;
+// More than this would just leave idle OpenConsole processes around.
+static constexpr uint32_t maxWarmPseudoConsoles = 8;
+// Prewarmed pseudoconsoles that weren't claimed within this time are closed again.
+static constexpr auto warmPseudoConsoleLifetime = std::chrono::seconds{ 30 };
+
 // Notes:
 // There is a number of ways that the Conpty connection can be terminated (voluntarily or not):
 // 1. The connection is Close()d
@@ -314,7 +322,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         // If we do not have pipes already, then this is a fresh connection... not an inbound one that is a received
         // handoff from an already-started PTY process.
-        if (!_inPipe)
+        const auto launchClient = !_inPipe;
+        if (launchClient)
         {
             DWORD flags = PSEUDOCONSOLE_RESIZE_QUIRK;
 
@@ -328,7 +337,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 flags |= PSEUDOCONSOLE_INHERIT_CURSOR;
             }
 
-            THROW_IF_FAILED(_CreatePseudoConsoleAndPipes(til::unwrap_coord_size(dimensions), flags, &_inPipe, &_outPipe, &_hPC));
+            // Claiming a prewarmed pseudoconsole skips spawning a new OpenConsole.exe and waiting for it to initialize.
+            if (flags != warmPseudoConsoleFlags || !_claimWarmPseudoConsole(dimensions))
+            {
+                THROW_IF_FAILED(_CreatePseudoConsoleAndPipes(til::unwrap_coord_size(dimensions), flags, &_inPipe, &_outPipe, &_hPC));
+            }
 
             if (_initialParentHwnd != 0)
             {
@@ -340,8 +353,6 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             {
                 THROW_IF_FAILED(ConptyShowHidePseudoConsole(_hPC.get(), _initialVisibility));
             }
-
-            THROW_IF_FAILED(_LaunchAttachedClient());
         }
         // But if it was an inbound handoff... attempt to synchronize the size of it with what our connection
         // window is expecting it to be on the first layout.
@@ -366,8 +377,6 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             }
         }
 
-        THROW_IF_FAILED(ConptyReleasePseudoConsole(_hPC.get()));
-
         _startTime = std::chrono::high_resolution_clock::now();
 
         // Create our own output handling thread
@@ -392,13 +401,70 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
 
-        _transitionToState(ConnectionState::Connected);
+        if (launchClient)
+        {
+            // Spawning the client (and building its environment block) is the most expensive part of
+            // starting a connection. When restoring a layout with many panes, doing it in the background
+            // allows all of them to start concurrently, instead of one after another on the UI thread.
+            _launchAttachedClientAsync();
+        }
+        else
+        {
+            THROW_IF_FAILED(ConptyReleasePseudoConsole(_hPC.get()));
+            _transitionToState(ConnectionState::Connected);
+        }
     }
     catch (...)
     {
         // EXIT POINT
-        const auto hr = wil::ResultFromCaughtException();
+        _indicateStartFailure(wil::ResultFromCaughtException());
+
+        // Tear down any state we may have accumulated.
+        _hPC.reset();
+    }
+
+    // Method Description:
+    // - The second half of Start() for fresh connections: Launches the client
+    //   on a background thread and then transitions us into the Connected state.
+    winrt::fire_and_forget ConptyConnection::_launchAttachedClientAsync()
+    {
+        auto strongThis{ get_strong() };
+
+        co_await winrt::resume_background();
+
+        // Close() holds this lock while tearing down _hPC. If it got called before we got here, we're done.
+        const std::lock_guard launchLock{ _launchMutex };
+        if (_isStateAtOrBeyond(ConnectionState::Closing))
+        {
+            co_return;
+        }
+
+        auto hr = _LaunchAttachedClient();
+        if (SUCCEEDED(hr))
+        {
+            hr = ConptyReleasePseudoConsole(_hPC.get());
+        }
+
+        if (SUCCEEDED(hr))
+        {
+            _transitionToState(ConnectionState::Connected);
+        }
+        else
+        {
+            // EXIT POINT
+            // Unlike in Start() we don't reset _hPC, because the UI thread may concurrently be using it.
+            // It's torn down by Close() instead, like it is for all other failures after the connection started.
+            _indicateStartFailure(hr);
+        }
+    }
 
+    // Method Description:
+    // - Prints a message about why we failed to start and transitions into the Failed state.
+    // Arguments:
+    // - hr: the reason for the failure.
+    void ConptyConnection::_indicateStartFailure(const HRESULT hr) noexcept
+    try
+    {
         // GH#11556 - make sure to format the error code to this string as an UNSIGNED int
         winrt::hstring failureText{ fmt::format(std::wstring_view{ RS_(L"ProcessFailedToLaunch") },
                                                 fmt::format(_errorFormat, static_cast<unsigned int>(hr)),
@@ -415,9 +481,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         }
 
         _transitionToState(ConnectionState::Failed);
-
-        // Tear down any state we may have accumulated.
-        _hPC.reset();
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        _transitionToState(ConnectionState::Failed);
     }
 
     // Method Description:
@@ -457,7 +525,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
     void ConptyConnection::WriteInput(const hstring& data)
     {
-        if (!_isConnected())
+        if (!_hasPseudoConsole())
         {
             return;
         }
@@ -474,17 +542,25 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         _rows = rows;
         _cols = columns;
 
-        if (_isConnected())
+        if (_hasPseudoConsole())
         {
             THROW_IF_FAILED(ConptyResizePseudoConsole(_hPC.get(), { Utils::ClampToShortMax(columns, 1), Utils::ClampToShortMax(rows, 1) }));
         }
     }
 
+    // Method Description:
+    // - Returns whether _hPC can be used. Unlike _isConnected() this includes the time during which
+    //   the client is still being launched in the background by _launchAttachedClientAsync().
+    bool ConptyConnection::_hasPseudoConsole() const noexcept
+    {
+        return _isStateOneOf(ConnectionState::Connecting, ConnectionState::Connected) && _hPC;
+    }
+
     void ConptyConnection::ClearBuffer()
     {
         // If we haven't connected yet, then we really don't need to do
         // anything. The connection should already start clear!
-        if (_isConnected())
+        if (_hasPseudoConsole())
         {
             THROW_IF_FAILED(ConptyClearPseudoConsole(_hPC.get()));
         }
@@ -493,7 +569,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     void ConptyConnection::ShowHide(const bool show)
     {
         // If we haven't connected yet, then stash for when we do connect.
-        if (_isConnected())
+        if (_hasPseudoConsole())
         {
             THROW_IF_FAILED(ConptyShowHidePseudoConsole(_hPC.get(), show));
         }
@@ -513,7 +589,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // Otherwise, just inform the conpty of the new owner window handle.
         // This shouldn't be hittable until GH#5000 / GH#1256, when it's
         // possible to reparent terminals to different windows.
-        else if (_isConnected())
+        else if (_hasPseudoConsole())
         {
             THROW_IF_FAILED(ConptyReparentPseudoConsole(_hPC.get(), reinterpret_cast<HWND>(newParent)));
         }
@@ -524,6 +600,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     {
         _transitionToState(ConnectionState::Closing);
 
+        // Wait for _launchAttachedClientAsync() in case it's still using _hPC.
+        const std::lock_guard launchLock{ _launchMutex };
+
         // .reset()ing either of these two will signal ConPTY to send out a CTRL_CLOSE_EVENT to all attached clients.
         // FYI: The other members of this class are concurrently read by the _hOutputThread
         // thread running in the background and so they're not safe to be .reset().
@@ -603,6 +682,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // won't wait for us, and the known exit points _do_.
         auto strongThis{ get_strong() };
 
+        // Anything the output handlers don't attribute to another category is counted as I/O.
+        const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::conpty };
+
         // process the data of the output pipe in a loop
         while (true)
         {
@@ -647,6 +729,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 return 0;
             }
 
+            _adjustReadSize(read);
+
             if (!_receivedFirstByte)
             {
                 const auto now = std::chrono::high_resolution_clock::now();
@@ -670,6 +754,39 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         return 0;
     }
 
+    // Doubles the size of the read buffer whenever a read filled it up completely and halves it again
+    // after a number of consecutive reads that used less than a quarter of it.
+    void ConptyConnection::_adjustReadSize(const DWORD read) noexcept
+    try
+    {
+        static constexpr size_t smallReadsUntilShrink = 16;
+
+        const auto size = _buffer.size();
+
+        if (read >= size)
+        {
+            _smallReadCount = 0;
+            if (size < maxReadSize)
+            {
+                _buffer.resize(size * 2);
+            }
+        }
+        else if (read < size / 4 && size > minReadSize)
+        {
+            if (++_smallReadCount >= smallReadsUntilShrink)
+            {
+                _smallReadCount = 0;
+                _buffer.resize(size / 2);
+                _buffer.shrink_to_fit();
+            }
+        }
+        else
+        {
+            _smallReadCount = 0;
+        }
+    }
+    CATCH_LOG()
+
     static winrt::event<NewConnectionHandler> _newConnectionHandlers;
 
     winrt::event_token ConptyConnection::NewConnection(const NewConnectionHandler& handler) { return _newConnectionHandlers.add(handler); };
@@ -699,6 +816,114 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         THROW_IF_FAILED(CTerminalHandoff::s_StopListening());
     }
 
+    // Function Description:
+    // - Spawns up to `count` pseudoconsoles in the background, which subsequent calls to Start() will claim
+    //   instead of spawning their own. This is meant for when many panes are about to be opened at once
+    //   (like when restoring a startup layout), because otherwise each of their OpenConsole.exe processes
+    //   is only spawned and initialized once the respective pane gets initialized on the UI thread.
+    // Arguments:
+    // - count: The number of pseudoconsoles that are expected to be needed soon.
+    void ConptyConnection::PrewarmPseudoConsoles(uint32_t count)
+    {
+        if (count != 0)
+        {
+            _prewarmPseudoConsolesAsync(std::min(count, maxWarmPseudoConsoles));
+        }
+    }
+
+    til::shared_mutex<std::vector<ConptyConnection::WarmPseudoConsole>>& ConptyConnection::_warmPseudoConsoles()
+    {
+        static til::shared_mutex<std::vector<WarmPseudoConsole>> pool;
+        return pool;
+    }
+
+    winrt::fire_and_forget ConptyConnection::_prewarmPseudoConsolesAsync(uint32_t count)
+    {
+        co_await winrt::resume_background();
+
+        // Whatever this call created and nobody claimed gets closed once warmPseudoConsoleLifetime has passed.
+        // This runs even if creating one of them fails below, as the others need to be cleaned up regardless.
+        const auto cleanup = wil::scope_exit([]() {
+            _expireWarmPseudoConsolesAsync();
+        });
+
+        for (uint32_t i = 0; i < count && _warmPseudoConsoles().lock_shared()->size() < maxWarmPseudoConsoles; ++i)
+        {
+            HANDLE inPipe = nullptr;
+            HANDLE outPipe = nullptr;
+            HPCON hPC = nullptr;
+
+            // The size doesn't matter, because _claimWarmPseudoConsole() will resize it anyway.
+            if (FAILED_LOG(_CreatePseudoConsoleAndPipes({ 80, 25 }, warmPseudoConsoleFlags, &inPipe, &outPipe, &hPC)))
+            {
+                co_return;
+            }
+
+            _warmPseudoConsoles().lock()->emplace_back(WarmPseudoConsole{
+                .inPipe = wil::unique_hfile{ inPipe },
+                .outPipe = wil::unique_hfile{ outPipe },
+                .hPC = unique_hpcon{ hPC },
+                .expiry = std::chrono::steady_clock::now() + warmPseudoConsoleLifetime,
+            });
+        }
+    }
+
+    winrt::fire_and_forget ConptyConnection::_expireWarmPseudoConsolesAsync()
+    {
+        co_await winrt::resume_after(warmPseudoConsoleLifetime);
+
+        // Destroy the expired ones outside of the lock, since closing them calls into conpty.
+        std::vector<WarmPseudoConsole> expired;
+        {
+            const auto pool = _warmPseudoConsoles().lock();
+            const auto now = std::chrono::steady_clock::now();
+            const auto it = std::stable_partition(pool->begin(), pool->end(), [&](const auto& warm) {
+                return warm.expiry > now;
+            });
+            expired.insert(expired.end(), std::make_move_iterator(it), std::make_move_iterator(pool->end()));
+            pool->erase(it, pool->end());
+        }
+    }
+
+    // Function Description:
+    // - Takes a pseudoconsole prewarmed by PrewarmPseudoConsoles(), if any, and resizes it to `dimensions`.
+    // Arguments:
+    // - dimensions: The size of this connection.
+    // Return Value:
+    // - true if one was claimed and _inPipe, _outPipe and _hPC have been populated.
+    bool ConptyConnection::_claimWarmPseudoConsole(const til::size dimensions) noexcept
+    try
+    {
+        while (true)
+        {
+            WarmPseudoConsole warm;
+
+            {
+                const auto pool = _warmPseudoConsoles().lock();
+                if (pool->empty())
+                {
+                    return false;
+                }
+                warm = std::move(pool->back());
+                pool->pop_back();
+            }
+
+            // If the OpenConsole.exe process has died in the meantime, this will fail and we'll try the next one.
+            if (SUCCEEDED_LOG(ConptyResizePseudoConsole(warm.hPC.get(), til::unwrap_coord_size(dimensions))))
+            {
+                _inPipe = std::move(warm.inPipe);
+                _outPipe = std::move(warm.outPipe);
+                _hPC = std::move(warm.hPC);
+                return true;
+            }
+        }
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return false;
+    }
+
     // Function Description:
     // - This function will be called (by C++/WinRT) after the final outstanding reference to
     //   any given connection instance is released.
@@ -42,6 +42,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         static void StartInboundListener();
         static void StopInboundListener();
+        static void PrewarmPseudoConsoles(uint32_t count);
 
         static winrt::event_token NewConnection(const NewConnectionHandler& handler);
         static void NewConnection(const winrt::event_token& token);
@@ -61,10 +62,29 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
     private:
         static void closePseudoConsoleAsync(HPCON hPC) noexcept;
+        using unique_hpcon = wil::unique_any<HPCON, decltype(closePseudoConsoleAsync), closePseudoConsoleAsync>;
+
+        // A pseudoconsole created ahead of time by PrewarmPseudoConsoles(), waiting to be claimed by Start().
+        struct WarmPseudoConsole
+        {
+            wil::unique_hfile inPipe;
+            wil::unique_hfile outPipe;
+            unique_hpcon hPC;
+            std::chrono::steady_clock::time_point expiry;
+        };
+
+        static til::shared_mutex<std::vector<WarmPseudoConsole>>& _warmPseudoConsoles();
+        static winrt::fire_and_forget _prewarmPseudoConsolesAsync(uint32_t count);
+        static winrt::fire_and_forget _expireWarmPseudoConsolesAsync();
+        bool _claimWarmPseudoConsole(const til::size dimensions) noexcept;
+
         static HRESULT NewHandoff(HANDLE in, HANDLE out, HANDLE signal, HANDLE ref, HANDLE server, HANDLE client, TERMINAL_STARTUP_INFO startupInfo) noexcept;
         static winrt::hstring _commandlineFromProcess(HANDLE process);
 
         HRESULT _LaunchAttachedClient() noexcept;
+        winrt::fire_and_forget _launchAttachedClientAsync();
+        void _indicateStartFailure(const HRESULT hr) noexcept;
+        bool _hasPseudoConsole() const noexcept;
         void _indicateExitWithStatus(unsigned int status) noexcept;
         void _LastConPtyClientDisconnected() noexcept;
 
@@ -85,11 +105,19 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile _outPipe; // The pipe for reading output from
         wil::unique_handle _hOutputThread;
         wil::unique_process_information _piClient;
-        wil::unique_any<HPCON, decltype(closePseudoConsoleAsync), closePseudoConsoleAsync> _hPC;
+        unique_hpcon _hPC;
+        std::mutex _launchMutex; // Held by _launchAttachedClientAsync() while it uses _hPC.
 
         til::u8state _u8State{};
         std::wstring _u16Str{};
-        std::array<char, 4096> _buffer{};
+        // ReadFile() returns as soon as any data is available, so a large buffer doesn't add latency.
+        // During floods of output it does however cut down on the number of TerminalOutput events,
+        // each of which allocates an hstring and acquires the terminal lock. The buffer grows while
+        // reads keep filling it up and shrinks again once the output turns interactive. See _OutputThread().
+        static constexpr size_t minReadSize = 4 * 1024;
+        static constexpr size_t maxReadSize = 1024 * 1024;
+        std::vector<char> _buffer = std::vector<char>(minReadSize);
+        size_t _smallReadCount = 0;
         bool _inheritCursor{ false };
 
         til::env _initialEnv{};
@@ -105,6 +133,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         } _startupInfo{};
 
         DWORD _OutputThread();
+        void _adjustReadSize(DWORD read) noexcept;
     };
 }
 
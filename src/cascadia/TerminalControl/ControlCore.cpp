@@ -4,12 +4,15 @@
 #include "pch.h"
 #include "ControlCore.h"
 
+#include <filesystem>
+
 // MidiAudio
 #include <mmeapi.h>
 #include <dsound.h>
 
 #include <DefaultSettings.h>
 #include <LibraryResources.h>
+#include <til/unicode.h>
 #include <unicode.hpp>
 #include <utils.hpp>
 #include <WinUser.h>
@@ -31,6 +34,13 @@ using namespace winrt::Windows::ApplicationModel::DataTransfer;
 
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
+    // Pastes larger than this are filtered and written to the connection piece by piece.
+    static constexpr size_t PasteChunkSize = 64 * 1024;
+    // Output larger than this is parsed piece by piece, so that we can let go of the
+    // terminal lock every OutputLockHoldTime and let the renderer and input get a turn.
+    static constexpr size_t OutputChunkSize = 4 * 1024;
+    static constexpr auto OutputLockHoldTime = std::chrono::milliseconds{ 2 };
+
     static winrt::Microsoft::Terminal::Core::OptionalColor OptionalFromColor(const til::color& c) noexcept
     {
         Core::OptionalColor result;
@@ -53,6 +63,41 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    static bool fontMapsEqual(const IFontFeatureMap& lhs, const IFontFeatureMap& rhs)
+    {
+        const auto lhsSize = lhs ? lhs.Size() : 0;
+        const auto rhsSize = rhs ? rhs.Size() : 0;
+        if (lhsSize != rhsSize)
+        {
+            return false;
+        }
+        if (lhsSize == 0)
+        {
+            return true;
+        }
+        for (const auto& [tag, param] : lhs)
+        {
+            if (!rhs.HasKey(tag) || rhs.Lookup(tag) != param)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns true if both settings result in the same font, apart from its size.
+    static bool fontSettingsEqual(const ControlSettings& lhs, const ControlSettings& rhs)
+    {
+        return lhs.FontFace() == rhs.FontFace() &&
+               lhs.FontWeight().Weight == rhs.FontWeight().Weight &&
+               lhs.EnableBuiltinGlyphs() == rhs.EnableBuiltinGlyphs() &&
+               lhs.EnableColorGlyphs() == rhs.EnableColorGlyphs() &&
+               lhs.CellWidth() == rhs.CellWidth() &&
+               lhs.CellHeight() == rhs.CellHeight() &&
+               fontMapsEqual(lhs.FontFeatures(), rhs.FontFeatures()) &&
+               fontMapsEqual(lhs.FontAxes(), rhs.FontAxes());
+    }
+
     TextColor SelectionColor::AsTextColor() const noexcept
     {
         if (IsIndex16())
@@ -130,6 +175,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _renderer->SetBackgroundColorChangedCallback([this]() { _rendererBackgroundColorChanged(); });
             _renderer->SetFrameColorChangedCallback([this]() { _rendererTabColorChanged(); });
             _renderer->SetRendererEnteredErrorStateCallback([this]() { RendererEnteredErrorState.raise(nullptr, nullptr); });
+            _renderer->SetFramePresentedCallback([this](auto frameStart) { _rendererFramePresented(frameStart); });
 
             THROW_IF_FAILED(localPointerToThread->Initialize(_renderer.get()));
         }
@@ -184,6 +230,29 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                     core->ScrollPositionChanged.raise(*core, update);
                 }
             });
+
+        // Applications like progress bars in shell prompts may change the title or the
+        // taskbar progress thousands of times per second. Only the latest state matters,
+        // so we coalesce them and let the listeners re-query the current value.
+        shared->updateTitle = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            std::chrono::milliseconds{ 50 },
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; core && !core->_IsClosing())
+                {
+                    core->TitleChanged.raise(*core, winrt::make<TitleChangedEventArgs>(core->Title()));
+                }
+            });
+
+        shared->updateTaskbarProgress = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            std::chrono::milliseconds{ 50 },
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; core && !core->_IsClosing())
+                {
+                    core->TaskbarProgressChanged.raise(*core, nullptr);
+                }
+            });
     }
 
     ControlCore::~ControlCore()
@@ -206,6 +275,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const auto shared = _shared.lock();
         shared->outputIdle.reset();
         shared->updateScrollBar.reset();
+        shared->updateTitle.reset();
+        shared->updateTaskbarProgress.reset();
     }
 
     void ControlCore::AttachToNewControl(const Microsoft::Terminal::Control::IKeyBindings& keyBindings)
@@ -385,8 +456,42 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         if (_initializedTerminal.load(std::memory_order_relaxed))
         {
-            const auto lock = _terminal->LockForWriting();
-            _renderer->EnablePainting();
+            int viewTop;
+            int viewHeight;
+            int bufferHeight;
+
+            {
+                const auto lock = _terminal->LockForWriting();
+                _renderer->EnablePainting();
+                viewTop = _terminal->GetScrollOffset();
+                viewHeight = _terminal->GetViewport().Height();
+                bufferHeight = _terminal->GetBufferHeight();
+            }
+
+            // Catch up on everything we skipped while we were in the background.
+            if (_backgrounded.exchange(false, std::memory_order_relaxed))
+            {
+                _terminalScrollPositionChanged(viewTop, viewHeight, bufferHeight);
+
+                const auto shared = _shared.lock_shared();
+                if (shared->outputIdle)
+                {
+                    (*shared->outputIdle)();
+                }
+            }
+        }
+    }
+
+    // Method Description:
+    // - Tell the renderer to stop painting until EnablePainting() is called again.
+    //   Output is still processed and invalidations are retained, so the next
+    //   frame after re-enabling will be up to date.
+    void ControlCore::DisablePainting()
+    {
+        if (_initializedTerminal.load(std::memory_order_relaxed))
+        {
+            _backgrounded.store(true, std::memory_order_relaxed);
+            _renderer->DisablePainting();
         }
     }
 
@@ -418,6 +523,55 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Returns the current time if a key press should be traced for the "InputLatency" event, or a
+    // default constructed time_point otherwise. The return value is passed to _inputLatencyInputSent().
+    std::chrono::steady_clock::time_point ControlCore::_inputLatencyKeyReceived() noexcept
+    {
+        if (!TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+        {
+            return {};
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+
+        // Not every key press gets echoed (for instance while typing a password). Give up on a
+        // key press after a while, or else the next unrelated output would be attributed to it.
+        // inputSent is only ever written by this thread, which makes it safe to read here.
+        uint8_t expected = 1;
+        if (_inputLatency.stage.load(std::memory_order_relaxed) == 1 && now - _inputLatency.inputSent > std::chrono::seconds{ 1 })
+        {
+            _inputLatency.stage.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+        }
+
+        return now;
+    }
+
+    // Must be called right before the translated key press is written to the connection,
+    // as its echo may arrive on the connection's thread before WriteInput() returns.
+    void ControlCore::_inputLatencyInputSent(const std::chrono::steady_clock::time_point keyReceived) noexcept
+    {
+        if (keyReceived == std::chrono::steady_clock::time_point{} || _inputLatency.stage.load(std::memory_order_acquire) != 0)
+        {
+            return;
+        }
+
+        // The other threads only access the time points after observing the stage change.
+        _inputLatency.keyReceived = keyReceived;
+        _inputLatency.inputSent = std::chrono::steady_clock::now();
+        _inputLatency.stage.store(1, std::memory_order_release);
+    }
+
+    // Must be called while holding the terminal lock after writing the output into the buffer,
+    // so that _rendererFramePresented() can tell whether a frame includes the output.
+    void ControlCore::_inputLatencyOutputReceived() noexcept
+    {
+        if (_inputLatency.stage.load(std::memory_order_acquire) == 1)
+        {
+            _inputLatency.outputReceived = std::chrono::steady_clock::now();
+            _inputLatency.stage.store(2, std::memory_order_release);
+        }
+    }
+
     // Method Description:
     // - Writes the given sequence as input to the active terminal connection,
     // Arguments:
@@ -457,6 +611,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _handleControlC();
         }
 
+        const auto keyReceived = _inputLatencyKeyReceived();
         TerminalInput::OutputType out;
         {
             const auto lock = _terminal->LockForReading();
@@ -464,6 +619,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         if (out)
         {
+            _inputLatencyInputSent(keyReceived);
             _sendInputToConnection(*out);
             return true;
         }
@@ -575,12 +731,35 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                       const WORD scanCode,
                                       const ControlKeyStates modifiers,
                                       const bool keyDown)
+    {
+        return _trySendKeyEvent(vkey, scanCode, modifiers, keyDown, nullptr);
+    }
+
+    // Method Description:
+    // - Same as TrySendKeyEvent, but for broadcast input. The key is only
+    //   translated if none of the previous targets in `translations` had the
+    //   same input modes. Otherwise their translation is sent as-is.
+    bool ControlCore::TrySendBroadcastKeyEvent(const WORD vkey,
+                                               const WORD scanCode,
+                                               const ControlKeyStates modifiers,
+                                               const bool keyDown,
+                                               std::vector<BroadcastKeyTranslation>& translations)
+    {
+        return _trySendKeyEvent(vkey, scanCode, modifiers, keyDown, &translations);
+    }
+
+    bool ControlCore::_trySendKeyEvent(const WORD vkey,
+                                       const WORD scanCode,
+                                       const ControlKeyStates modifiers,
+                                       const bool keyDown,
+                                       std::vector<BroadcastKeyTranslation>* translations)
     {
         if (!vkey)
         {
             return true;
         }
 
+        const auto keyReceived = keyDown ? _inputLatencyKeyReceived() : std::chrono::steady_clock::time_point{};
         TerminalInput::OutputType out;
         {
             const auto lock = _terminal->LockForWriting();
@@ -618,10 +797,31 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // If the terminal translated the key, mark the event as handled.
             // This will prevent the system from trying to get the character out
             // of it and sending us a CharacterReceived event.
-            out = _terminal->SendKeyEvent(vkey, scanCode, modifiers, keyDown);
+            if (!translations)
+            {
+                out = _terminal->SendKeyEvent(vkey, scanCode, modifiers, keyDown);
+            }
+            else
+            {
+                const auto translationState = _terminal->GetKeyTranslationState();
+                const auto it = std::find_if(translations->begin(), translations->end(), [&](const auto& t) {
+                    return t.translationState == translationState;
+                });
+                if (it != translations->end())
+                {
+                    _terminal->ReplayKeyEvent(vkey, scanCode, keyDown, it->trackingState);
+                    out = it->output;
+                }
+                else
+                {
+                    out = _terminal->SendKeyEvent(vkey, scanCode, modifiers, keyDown);
+                    translations->push_back({ translationState, out, _terminal->GetKeyTrackingState() });
+                }
+            }
         }
         if (out)
         {
+            _inputLatencyInputSent(keyReceived);
             _sendInputToConnection(*out);
             return true;
         }
@@ -649,15 +849,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::UserScrollViewport(const int viewTop)
     {
+        bool patternsCleared;
         {
             // This is a scroll event that wasn't initiated by the terminal
             //      itself - it was initiated by the mouse wheel, or the scrollbar.
             const auto lock = _terminal->LockForWriting();
-            _terminal->UserScrollViewport(viewTop);
+            patternsCleared = _terminal->UserScrollViewport(viewTop);
         }
 
+        // Only restart the debounced pattern update if the scroll cleared the patterns. That's the case if the
+        // viewport actually moved, but also for every scroll in the alt buffer, where no output may follow to rebuild them.
         const auto shared = _shared.lock_shared();
-        if (shared->outputIdle)
+        if (patternsCleared && shared->outputIdle)
         {
             (*shared->outputIdle)();
         }
@@ -780,11 +983,29 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             {
                 const auto lock = _terminal->LockForWriting();
 
+                // Cells with the same hyperlink ID may be anywhere in the viewport,
+                // but an auto-detected pattern only covers its own interval. Moving
+                // across dense output full of URLs thus only invalidates the 2 links.
+                if (newId != _lastHoveredId)
+                {
+                    _renderer->TriggerRedrawAll();
+                }
+                else
+                {
+                    if (_lastHoveredInterval)
+                    {
+                        _terminal->InvalidateHyperlinkInterval(*_lastHoveredInterval);
+                    }
+                    if (newInterval)
+                    {
+                        _terminal->InvalidateHyperlinkInterval(*newInterval);
+                    }
+                }
+
                 _lastHoveredId = newId;
                 _lastHoveredInterval = newInterval;
                 _renderer->UpdateHyperlinkHoveredId(newId);
                 _renderer->UpdateLastHoveredInterval(newInterval);
-                _renderer->TriggerRedrawAll();
             }
 
             HoveredHyperlinkChanged.raise(*this, nullptr);
@@ -819,7 +1040,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - INVARIANT: This method can only be called if the caller DOES NOT HAVE writing lock on the terminal.
     void ControlCore::UpdateSettings(const IControlSettings& settings, const IControlAppearance& newAppearance)
     {
-        _settings = winrt::make_self<implementation::ControlSettings>(settings, newAppearance);
+        const auto oldSettings = std::exchange(_settings, winrt::make_self<implementation::ControlSettings>(settings, newAppearance));
 
         const auto lock = _terminal->LockForWriting();
 
@@ -833,7 +1054,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Manually turn off acrylic if they turn off transparency.
         _runtimeUseAcrylic = _settings->Opacity() < 1.0 && _settings->UseAcrylic();
 
-        const auto sizeChanged = _setFontSizeUnderLock(_settings->FontSize());
+        // A settings reload calls this function for every pane, whether its profile changed or not.
+        // Resolving the font and rebuilding the renderer's glyph atlas is expensive, so we skip it if none
+        // of the font settings changed and the font size is still the configured one (= the user didn't zoom).
+        const auto fontUnchanged = _initializedTerminal.load(std::memory_order_relaxed) &&
+                                   oldSettings &&
+                                   _desiredFont.GetFontSize() == std::max(_settings->FontSize(), 1.0f) &&
+                                   fontSettingsEqual(*oldSettings, *_settings);
+        const auto sizeChanged = !fontUnchanged && _setFontSizeUnderLock(_settings->FontSize());
 
         // Update the terminal core with its new Core settings
         _terminal->UpdateSettings(*_settings);
@@ -1384,15 +1612,50 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         using namespace ::Microsoft::Console::Utils;
 
-        auto filtered = FilterStringForPaste(hstr, CarriageReturnNewline | ControlCodes);
-        if (BracketedPasteEnabled())
+        // Huge pastes are filtered and sent in chunks, instead of creating a filtered copy of the entire clipboard
+        // contents upfront. Since writing to the connection blocks until the other side has read the data,
+        // this also limits how much of the paste is buffered at any point in time.
+        const auto bracketedPaste = BracketedPasteEnabled();
+        std::wstring_view remaining{ hstr };
+        auto first = true;
+
+        do
         {
-            filtered.insert(0, L"\x1b[200~");
-            filtered.append(L"\x1b[201~");
-        }
+            auto count = std::min(remaining.size(), PasteChunkSize);
+            if (count < remaining.size())
+            {
+                // Don't split surrogate pairs, because each write is converted to UTF-8 separately.
+                if (til::is_leading_surrogate(til::at(remaining, count - 1)))
+                {
+                    ++count;
+                }
+                // Don't split CRLF pairs either, or the filter would turn them into two CRs. The chunk may end in the
+                // middle of a longer run like "\r\r\n", so we keep extending it until it doesn't end in a line break.
+                while (count < remaining.size() && til::at(remaining, count - 1) == L'\r' && (til::at(remaining, count) == L'\r' || til::at(remaining, count) == L'\n'))
+                {
+                    ++count;
+                }
+            }
 
-        // It's important to not hold the terminal lock while calling this function as sending the data may take a long time.
-        _sendInputToConnection(filtered);
+            auto filtered = FilterStringForPaste(remaining.substr(0, count), CarriageReturnNewline | ControlCodes);
+            remaining = remaining.substr(count);
+
+            if (bracketedPaste)
+            {
+                if (first)
+                {
+                    filtered.insert(0, L"\x1b[200~");
+                }
+                if (remaining.empty())
+                {
+                    filtered.append(L"\x1b[201~");
+                }
+            }
+
+            // It's important to not hold the terminal lock while calling this function as sending the data may take a long time.
+            _sendInputToConnection(filtered);
+            first = false;
+        } while (!remaining.empty());
 
         const auto lock = _terminal->LockForWriting();
         _terminal->ClearSelection();
@@ -1520,6 +1783,47 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _terminal->GetBufferHeight();
     }
 
+    uint64_t ControlCore::BufferMemoryUsage() const
+    {
+        const auto lock = _terminal->LockForReading();
+        return _terminal->GetBufferMemoryUsage();
+    }
+
+    // Method Description:
+    // - Emits a breakdown of the memory used by this control's text buffers as an ETW event,
+    //   so that the footprint of a process can be attributed to individual panes.
+    //   Walking the rows isn't free, which is why nothing is gathered unless a trace is running.
+    void ControlCore::TraceMemoryDiagnostics() const
+    {
+        if (!TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+        {
+            return;
+        }
+
+        const auto lock = _terminal->LockForReading();
+        using DiagnosticsBuffer = ::Microsoft::Terminal::Core::Terminal::DiagnosticsBuffer;
+        const auto main = _terminal->GetBufferMemoryDiagnostics(DiagnosticsBuffer::Main);
+        const auto alt = _terminal->GetBufferMemoryDiagnostics(DiagnosticsBuffer::Alternate);
+        const auto recycled = _terminal->GetBufferMemoryDiagnostics(DiagnosticsBuffer::RecycledAlternate);
+
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "MemoryDiagnostics",
+                          TraceLoggingDescription("Emitted on request with the memory usage of a control's text buffers"),
+                          TraceLoggingUInt64(main.reservedBytes, "mainReservedBytes", "Size of the main buffer's virtual memory arena"),
+                          TraceLoggingUInt64(main.committedBytes, "mainCommittedBytes", "Committed part of the main buffer's arena"),
+                          TraceLoggingUInt64(main.rowHeapBytes, "mainRowHeapBytes", "Heap memory of the main buffer's rows (long text and attribute runs)"),
+                          TraceLoggingUInt64(main.hyperlinks, "mainHyperlinks", "Number of hyperlinks stored by the main buffer"),
+                          TraceLoggingUInt64(alt.reservedBytes, "altReservedBytes", "Size of the alternate buffer's virtual memory arena"),
+                          TraceLoggingUInt64(alt.committedBytes, "altCommittedBytes", "Committed part of the alternate buffer's arena"),
+                          TraceLoggingUInt64(alt.rowHeapBytes, "altRowHeapBytes", "Heap memory of the alternate buffer's rows (long text and attribute runs)"),
+                          TraceLoggingUInt64(alt.hyperlinks, "altHyperlinks", "Number of hyperlinks stored by the alternate buffer"),
+                          TraceLoggingUInt64(recycled.reservedBytes, "recycledAltReservedBytes", "Size of the arena of the alternate buffer that's kept around for reuse"),
+                          TraceLoggingUInt64(recycled.committedBytes, "recycledAltCommittedBytes", "Committed part of the recycled alternate buffer's arena"),
+                          TraceLoggingUInt64(recycled.rowHeapBytes, "recycledAltRowHeapBytes", "Heap memory of the recycled alternate buffer's rows"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
     void ControlCore::_terminalWarningBell()
     {
         // Since this can only ever be triggered by output from the connection,
@@ -1542,7 +1846,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Since this can only ever be triggered by output from the connection,
         // then the Terminal already has the write lock when calling this
         // callback.
-        TitleChanged.raise(*this, winrt::make<TitleChangedEventArgs>(winrt::hstring{ wstr }));
+        if (_inUnitTests) [[unlikely]]
+        {
+            TitleChanged.raise(*this, winrt::make<TitleChangedEventArgs>(winrt::hstring{ wstr }));
+        }
+        else
+        {
+            const auto shared = _shared.lock_shared();
+            if (shared->updateTitle)
+            {
+                shared->updateTitle->Run();
+            }
+        }
     }
 
     // Method Description:
@@ -1559,7 +1874,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                      const int viewHeight,
                                                      const int bufferSize)
     {
-        if (!_initializedTerminal.load(std::memory_order_relaxed))
+        if (!_initializedTerminal.load(std::memory_order_relaxed) || _backgrounded.load(std::memory_order_relaxed))
         {
             return;
         }
@@ -1585,7 +1900,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::_terminalTaskbarProgressChanged()
     {
-        TaskbarProgressChanged.raise(*this, nullptr);
+        if (_inUnitTests) [[unlikely]]
+        {
+            TaskbarProgressChanged.raise(*this, nullptr);
+        }
+        else
+        {
+            const auto shared = _shared.lock_shared();
+            if (shared->updateTaskbarProgress)
+            {
+                shared->updateTaskbarProgress->Run();
+            }
+        }
     }
 
     void ControlCore::_terminalShowWindowChanged(bool showOrHide)
@@ -1602,6 +1928,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - duration - How long the note should be sustained (in microseconds).
     void ControlCore::_terminalPlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration)
     {
+        // DECPS holds up the output until each note has finished playing, so that the
+        // text stays in sync with the music. Nobody can see a background pane's output
+        // though, and a tune shouldn't stall it for minutes. Drop its notes instead.
+        if (_backgrounded.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
         // The UI thread might try to acquire the console lock from time to time.
         // --> Unlock it, so the UI doesn't hang while we're busy.
         const auto suspension = _terminal->SuspendLock();
@@ -1665,7 +1999,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             if (searchInvalidated)
             {
-                oldResults = _searcher.ExtractResults();
+                // Reset() reuses the previous results if it can, so we need to copy them.
+                oldResults = _searcher.Results();
                 _searcher.Reset(*_terminal.get(), text, !caseSensitive, !goForward);
 
                 if (SnapSearchResultToSelection())
@@ -1795,7 +2130,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             message = fmt::format(FMT_COMPILE(L"\x1b[100;37m  [{} {} {}]\x1b[K\x1b[m\r\n\x1b[2J"), msg, date, time);
         }
 
-        wchar_t buffer[32 * 1024];
+        // Every chunk is a separate ProcessString() call under the write lock, after which the
+        // renderer gets to draw the partially restored buffer. Large chunks keep both to a minimum.
+        // TextBuffer::Serialize() writes the file in chunks of the same size.
+        static constexpr DWORD bufferSize = 1024 * 1024;
+        const auto buffer = std::make_unique_for_overwrite<wchar_t[]>(bufferSize / sizeof(wchar_t));
         DWORD read = 0;
 
         // Ensure the text file starts with a UTF-16 BOM.
@@ -1806,7 +2145,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         for (;;)
         {
-            if (!ReadFile(file.get(), &buffer[0], sizeof(buffer), &read, nullptr))
+            if (!ReadFile(file.get(), &buffer[0], bufferSize, &read, nullptr))
             {
                 break;
             }
@@ -1814,7 +2153,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             const auto lock = _terminal->LockForWriting();
             _terminal->Write({ &buffer[0], read / 2 });
 
-            if (read < sizeof(buffer))
+            if (read < bufferSize)
             {
                 break;
             }
@@ -1862,6 +2201,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
             // `this` is safe to use now
 
+            // The swap chain is created during the first frame, right before it's presented.
+            TIL_TRACE_STARTUP_PHASE(g_hTerminalControlProvider, "SwapChainCreated");
+
             _lastSwapChainHandle = std::move(duplicatedHandle);
             // Now bubble the event up to the control.
             SwapChainChanged.raise(*this, winrt::box_value<uint64_t>(reinterpret_cast<uint64_t>(_lastSwapChainHandle.get())));
@@ -1878,6 +2220,33 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TabColorChanged.raise(*this, nullptr);
     }
 
+    // Called on the render thread. Completes the tracking of a key press started in _inputLatencyInputSent().
+    void ControlCore::_rendererFramePresented(const std::chrono::steady_clock::time_point frameStart)
+    {
+        if (_inputLatency.stage.load(std::memory_order_acquire) != 2 || frameStart < _inputLatency.outputReceived)
+        {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto us = [](auto duration) {
+            return gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+        };
+
+        // Each stage is recorded separately so that WPA can show a histogram for each of them.
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "InputLatency",
+                          TraceLoggingDescription("Emitted when the first frame showing the echo of a key press was presented"),
+                          TraceLoggingUInt64(us(_inputLatency.inputSent - _inputLatency.keyReceived), "translateTimeUs", "Key press to writing the input to the connection"),
+                          TraceLoggingUInt64(us(_inputLatency.outputReceived - _inputLatency.inputSent), "echoTimeUs", "Writing the input to receiving output from the connection"),
+                          TraceLoggingUInt64(us(now - _inputLatency.outputReceived), "renderTimeUs", "Receiving the output to presenting it"),
+                          TraceLoggingUInt64(us(now - _inputLatency.keyReceived), "totalTimeUs", "Key press to presenting its echo"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
+        _inputLatency.stage.store(0, std::memory_order_release);
+    }
+
     void ControlCore::BlinkAttributeTick()
     {
         const auto lock = _terminal->LockForWriting();
@@ -2015,7 +2384,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const auto cursorPos{ _terminal->GetCursorPosition() };
 
         // Does the current buffer line have a mark on it?
-        const auto& marks{ _terminal->GetMarkExtents() };
+        // We only need the most recent mark. GetMarkExtents() scans from the bottom up,
+        // so limiting it avoids computing the extents of every mark in the buffer on each click.
+        const auto& marks{ _terminal->GetMarkExtents(1) };
         if (!marks.empty())
         {
             const auto& last{ marks.back() };
@@ -2136,8 +2507,45 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         try
         {
             {
-                const auto lock = _terminal->LockForWriting();
-                _terminal->Write(hstr);
+                auto lock = _terminal->LockForWriting();
+                std::wstring_view remaining{ hstr };
+                auto lockedAt = std::chrono::steady_clock::now();
+
+                while (remaining.size() > OutputChunkSize)
+                {
+                    // Don't split surrogate pairs. The state machine doesn't care about
+                    // anything else, since it already has to handle sequences that
+                    // straddle two reads from the connection.
+                    auto count = OutputChunkSize;
+                    if (til::is_leading_surrogate(til::at(remaining, count - 1)))
+                    {
+                        ++count;
+                    }
+
+                    _terminal->Write(remaining.substr(0, count));
+                    remaining = remaining.substr(count);
+
+                    // The lock is fair, so anyone who's been waiting for it gets it now.
+                    if (const auto now = std::chrono::steady_clock::now(); now - lockedAt >= OutputLockHoldTime)
+                    {
+                        lock.unlock();
+                        lock.lock();
+                        lockedAt = std::chrono::steady_clock::now();
+                    }
+                }
+
+                _terminal->Write(remaining);
+                _inputLatencyOutputReceived();
+            }
+
+            // Lets the render thread reduce the frame rate while we're flooded with output.
+            _renderer->NotifyOutput(hstr.size());
+
+            // Nobody can see the hyperlinks of a background pane.
+            // EnablePainting() will update them once we're visible again.
+            if (_backgrounded.load(std::memory_order_relaxed))
+            {
+                return;
             }
 
             // Start the throttled update of where our hyperlinks are.
@@ -2200,15 +2608,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
-    hstring ControlCore::ReadEntireBuffer() const
+    // Appends the text of the rows [beg, end) to the given string, with trailing whitespace
+    // trimmed off, and CRLF line endings for every row that didn't get wrapped.
+    void ControlCore::_appendBufferRows(const TextBuffer& textBuffer, til::CoordType beg, til::CoordType end, std::wstring& str)
     {
-        const auto lock = _terminal->LockForWriting();
-
-        const auto& textBuffer = _terminal->GetTextBuffer();
-
-        std::wstring str;
-        const auto lastRow = textBuffer.GetLastNonSpaceCharacter().y;
-        for (auto rowIndex = 0; rowIndex <= lastRow; rowIndex++)
+        for (auto rowIndex = beg; rowIndex < end; rowIndex++)
         {
             const auto& row = textBuffer.GetRowByOffset(rowIndex);
             const auto rowText = row.GetText();
@@ -2223,10 +2627,110 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 str.append(L"\r\n");
             }
         }
+    }
+
+    hstring ControlCore::ReadEntireBuffer() const
+    {
+        const auto lock = _terminal->LockForWriting();
+
+        const auto& textBuffer = _terminal->GetTextBuffer();
+
+        std::wstring str;
+        const auto lastRow = textBuffer.GetLastNonSpaceCharacter().y;
+        _appendBufferRows(textBuffer, 0, lastRow + 1, str);
 
         return hstring{ str };
     }
 
+    // Method Description:
+    // - Writes the buffer's text to the given file as UTF-8, just like ReadEntireBuffer() would return it.
+    // - Unlike ReadEntireBuffer(), this runs on a background thread and only holds the terminal lock
+    //   while copying a chunk of rows at a time. This way exporting a large scrollback doesn't freeze
+    //   the pane and we never hold the entire buffer's text in memory (let alone twice).
+    // - Output that arrives while the export is ongoing may scroll the buffer. The rows that are yet to be
+    //   exported move up accordingly, which is tracked via GetScrollCount(), so that no row is written twice or skipped.
+    //   Rows that scrolled out of the scrollback before we got to them are lost, of course.
+    // Arguments:
+    // - path: the file to write to. It'll be overwritten if it exists.
+    // Return Value:
+    // - An action that reports the progress in the range [0, 1].
+    Windows::Foundation::IAsyncActionWithProgress<double> ControlCore::ExportBufferToFile(hstring path)
+    {
+        // Short enough to not be noticeable for the output thread, and yet large enough
+        // that the 2 syscalls per chunk (lock and WriteFile) aren't the bottleneck.
+        static constexpr til::CoordType chunkRows = 1024;
+
+        const auto strongThis{ get_strong() };
+        const auto progress{ co_await winrt::get_progress_token() };
+
+        co_await winrt::resume_background();
+
+        // The buffer is written to a temporary file next to the target first, and only moved over it once complete.
+        // That way a failed or cancelled export doesn't leave a truncated file behind (or clobber an existing one).
+        const std::filesystem::path target{ std::wstring_view{ path } };
+        const auto directory = target.has_parent_path() ? target.parent_path() : std::filesystem::path{ L"." };
+        std::array<wchar_t, MAX_PATH> tempPath{};
+        THROW_LAST_ERROR_IF(GetTempFileNameW(directory.c_str(), L"wt", 0, tempPath.data()) == 0);
+        auto deleteTempFile = wil::scope_exit([&]() {
+            DeleteFileW(tempPath.data());
+        });
+
+        wil::unique_hfile file{ CreateFileW(tempPath.data(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        til::CoordType rowCount;
+        uint64_t scrollCount;
+        {
+            const auto lock = _terminal->LockForReading();
+            const auto& textBuffer = _terminal->GetTextBuffer();
+            rowCount = textBuffer.GetLastNonSpaceCharacter().y + 1;
+            scrollCount = textBuffer.GetScrollCount();
+        }
+
+        const auto totalRows = rowCount;
+        til::CoordType exportedRows = 0;
+        til::CoordType beg = 0;
+        std::wstring wide;
+        std::string utf8;
+
+        for (;;)
+        {
+            wide.clear();
+            {
+                const auto lock = _terminal->LockForReading();
+                const auto& textBuffer = _terminal->GetTextBuffer();
+
+                // If the buffer scrolled since the last chunk, the remaining rows are now that many rows further up.
+                const auto newScrollCount = textBuffer.GetScrollCount();
+                const auto scrolled = gsl::narrow_cast<til::CoordType>(std::min<uint64_t>(newScrollCount - scrollCount, rowCount));
+                scrollCount = newScrollCount;
+                beg = std::max(0, beg - scrolled);
+                rowCount -= scrolled;
+
+                if (beg >= rowCount)
+                {
+                    break;
+                }
+
+                const auto end = std::min(beg + chunkRows, rowCount);
+                _appendBufferRows(textBuffer, beg, end, wide);
+                exportedRows += end - beg;
+                beg = end;
+            }
+
+            THROW_IF_FAILED(til::u16u8(wide, utf8));
+
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), utf8.data(), gsl::narrow<DWORD>(utf8.size()), &written, nullptr));
+
+            progress(std::min(1.0, static_cast<double>(exportedRows) / totalRows));
+        }
+
+        file.reset();
+        THROW_IF_WIN32_BOOL_FALSE(MoveFileExW(tempPath.data(), path.c_str(), MOVEFILE_REPLACE_EXISTING));
+        deleteTempFile.release();
+    }
+
     // Get all of our recent commands. This will only really work if the user has enabled shell integration.
     Control::CommandHistoryContext ControlCore::CommandHistory() const
     {
@@ -2479,6 +2983,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return winrt::single_threaded_vector(std::move(v));
     }
 
+    // The same as ScrollMarks(), but without the overhead of a WinRT collection.
+    // TermControl calls this to draw the scrollbar marks, potentially for thousands of them.
+    std::vector<std::pair<til::CoordType, til::color>> ControlCore::ScrollMarkRows() const
+    {
+        const auto lock = _terminal->LockForReading();
+        const auto& markRows = _terminal->GetMarkRows();
+        std::vector<std::pair<til::CoordType, til::color>> v;
+
+        v.reserve(markRows.size());
+
+        for (const auto& mark : markRows)
+        {
+            v.emplace_back(mark.row, _terminal->GetColorForMark(mark.data));
+        }
+
+        return v;
+    }
+
     void ControlCore::AddMark(const Control::ScrollMark& mark)
     {
         const auto lock = _terminal->LockForReading();
@@ -87,6 +87,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                         const float actualHeight,
                         const float compositionScale);
         void EnablePainting();
+        void DisablePainting();
 
         void Detach();
 
@@ -166,6 +167,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         int ScrollOffset();
         int ViewHeight() const;
         int BufferHeight() const;
+        uint64_t BufferMemoryUsage() const;
+        void TraceMemoryDiagnostics() const;
 
         bool HasSelection() const;
         bool HasMultiLineSelection() const;
@@ -187,10 +190,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 #pragma endregion
 
 #pragma region ITerminalInput
+        // A key translated by one of the broadcast targets, shared with all
+        // other targets that have the same Terminal::GetKeyTranslationState().
+        struct BroadcastKeyTranslation
+        {
+            uint64_t translationState = 0;
+            ::Microsoft::Console::VirtualTerminal::TerminalInput::OutputType output;
+            ::Microsoft::Console::VirtualTerminal::TerminalInput::KeyTrackingState trackingState;
+        };
+
         bool TrySendKeyEvent(const WORD vkey,
                              const WORD scanCode,
                              const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
                              const bool keyDown);
+        bool TrySendBroadcastKeyEvent(const WORD vkey,
+                                      const WORD scanCode,
+                                      const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
+                                      const bool keyDown,
+                                      std::vector<BroadcastKeyTranslation>& translations);
         bool SendCharEvent(const wchar_t ch,
                            const WORD scanCode,
                            const ::Microsoft::Terminal::Core::ControlKeyStates modifiers);
@@ -221,6 +238,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         SearchResults Search(const std::wstring_view& text, bool goForward, bool caseSensitive, bool reset);
         const std::vector<til::point_span>& SearchResultRows() const noexcept;
+        std::vector<std::pair<til::CoordType, til::color>> ScrollMarkRows() const;
         void ClearSearch();
         void SnapSearchResultToSelection(bool snap) noexcept;
         bool SnapSearchResultToSelection() const noexcept;
@@ -240,6 +258,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void SetReadOnlyMode(const bool readOnlyState);
 
         hstring ReadEntireBuffer() const;
+        Windows::Foundation::IAsyncActionWithProgress<double> ExportBufferToFile(hstring path);
         Control::CommandHistoryContext CommandHistory() const;
 
         void AdjustOpacity(const float opacity, const bool relative);
@@ -295,9 +314,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
             std::unique_ptr<til::debounced_func_trailing<>> outputIdle;
             std::shared_ptr<ThrottledFuncTrailing<Control::ScrollPositionChangedArgs>> updateScrollBar;
+            std::shared_ptr<ThrottledFuncTrailing<>> updateTitle;
+            std::shared_ptr<ThrottledFuncTrailing<>> updateTaskbarProgress;
         };
 
         std::atomic<bool> _initializedTerminal{ false };
+        // Set while painting is disabled (i.e. the control isn't in the visual tree).
+        // Output is still parsed, but pattern scans and scrollbar updates are
+        // deferred until EnablePainting() is called again.
+        std::atomic<bool> _backgrounded{ false };
         bool _closing{ false };
 
         TerminalConnection::ITerminalConnection _connection{ nullptr };
@@ -352,6 +377,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         til::point _contextMenuBufferPosition{ 0, 0 };
 
+        // While tracing is enabled, this follows a single key press at a time, from the moment we
+        // receive it, through its echo from the connection, until the first frame showing it is presented.
+        // The stage is the handoff between the UI, connection and render thread: 0 = idle,
+        // 1 = input sent (waiting for output), 2 = output received (waiting for a frame).
+        struct InputLatency
+        {
+            std::atomic<uint8_t> stage{ 0 };
+            std::chrono::steady_clock::time_point keyReceived;
+            std::chrono::steady_clock::time_point inputSent;
+            std::chrono::steady_clock::time_point outputReceived;
+        };
+        InputLatency _inputLatency;
+
         void _setupDispatcherAndCallbacks();
 
         bool _setFontSizeUnderLock(float fontSize);
@@ -359,9 +397,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _refreshSizeUnderLock();
         void _updateSelectionUI();
         bool _shouldTryUpdateSelection(const WORD vkey);
+        bool _trySendKeyEvent(const WORD vkey,
+                              const WORD scanCode,
+                              const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
+                              const bool keyDown,
+                              std::vector<BroadcastKeyTranslation>* translations);
 
         void _handleControlC();
         void _sendInputToConnection(std::wstring_view wstr);
+        std::chrono::steady_clock::time_point _inputLatencyKeyReceived() noexcept;
+        void _inputLatencyInputSent(std::chrono::steady_clock::time_point keyReceived) noexcept;
+        void _inputLatencyOutputReceived() noexcept;
 
 #pragma region TerminalCoreCallbacks
         void _terminalCopyToClipboard(wil::zwstring_view wstr);
@@ -380,6 +426,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
 #pragma endregion
 
+        static void _appendBufferRows(const TextBuffer& textBuffer, til::CoordType beg, til::CoordType end, std::wstring& str);
+
         MidiAudio _midiAudio;
         winrt::Windows::System::DispatcherQueueTimer _midiAudioSkipTimer{ nullptr };
 
@@ -388,6 +436,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::fire_and_forget _renderEngineSwapChainChanged(const HANDLE handle);
         void _rendererBackgroundColorChanged();
         void _rendererTabColorChanged();
+        void _rendererFramePresented(std::chrono::steady_clock::time_point frameStart);
 #pragma endregion
 
         void _raiseReadOnlyWarning();
@@ -260,6 +260,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else if (_canSendVTMouseInput(modifiers))
         {
+            _sendPendingMouseMove();
             _sendMouseEventHelper(terminalPosition, pointerUpdateKind, modifiers, 0, buttonState);
         }
         else if (WI_IsFlagSet(buttonState, MouseButtonState::IsLeftButtonDown))
@@ -341,7 +342,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Short-circuit isReadOnly check to avoid warning dialog
         if (focused && !_core->IsInReadOnlyMode() && _canSendVTMouseInput(modifiers))
         {
-            _sendMouseEventHelper(terminalPosition, pointerUpdateKind, modifiers, 0, buttonState);
+            _queueMouseMove(terminalPosition, pointerUpdateKind, modifiers, buttonState);
         }
         // GH#4603 - don't modify the selection if the pointer press didn't
         // actually start _in_ the control bounds. Case in point - someone drags
@@ -426,6 +427,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Short-circuit isReadOnly check to avoid warning dialog
         if (!_core->IsInReadOnlyMode() && _canSendVTMouseInput(modifiers))
         {
+            _sendPendingMouseMove();
             _sendMouseEventHelper(terminalPosition, pointerUpdateKind, modifiers, 0, buttonState);
             return;
         }
@@ -485,6 +487,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // here with a PointerPoint. However, as of #979, we don't have a
             // PointerPoint to work with. So, we're just going to do a
             // mousewheel event manually
+            _sendPendingMouseMove();
             return _sendMouseEventHelper(terminalPosition,
                                          WM_MOUSEWHEEL,
                                          modifiers,
@@ -527,10 +530,36 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     //   event.
     // Arguments:
     // - mouseDelta: the mouse wheel delta that triggered this event.
-    void ControlInteractivity::_mouseZoomHandler(const int32_t mouseDelta) const
+    void ControlInteractivity::_mouseZoomHandler(const int32_t mouseDelta)
     {
         const auto fontDelta = mouseDelta < 0 ? -1.0f : 1.0f;
-        _core->AdjustFontSize(fontDelta);
+
+        if (!_applyFontSizeDelta)
+        {
+            // Without a dispatcher on this thread (e.g. in unit tests) we apply the change immediately.
+            const auto dispatcher = DispatcherQueue::GetForCurrentThread();
+            if (!dispatcher)
+            {
+                _core->AdjustFontSize(fontDelta);
+                return;
+            }
+
+            _applyFontSizeDelta = std::make_shared<ThrottledFuncTrailing<>>(
+                dispatcher,
+                std::chrono::milliseconds{ 32 },
+                [weakThis = get_weak()]() {
+                    if (const auto self{ weakThis.get() })
+                    {
+                        if (const auto delta = std::exchange(self->_pendingFontSizeDelta, 0.0f))
+                        {
+                            self->_core->AdjustFontSize(delta);
+                        }
+                    }
+                });
+        }
+
+        _pendingFontSizeDelta += fontDelta;
+        _applyFontSizeDelta->Run();
     }
 
     // Method Description:
@@ -691,6 +720,58 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return false;
     }
 
+    // Method Description:
+    // - Sends a pointer move to the terminal, but coalesces motion-only events so that at most one
+    //   of them is sent per frame. Only the latest one is sent, and TerminalInput drops it if it's
+    //   still in the same cell as the previous report. Button transitions are sent right away by
+    //   our callers, after flushing any pending move, so that the order of events is preserved.
+    // - Without a dispatcher on this thread (e.g. in unit tests), events are sent immediately.
+    void ControlInteractivity::_queueMouseMove(const til::point terminalPosition,
+                                               const unsigned int pointerUpdateKind,
+                                               const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
+                                               Control::MouseButtonState buttonState)
+    {
+        // Pointer moves may still carry a button transition (e.g. pressing
+        // a second button during a drag), which shouldn't be delayed.
+        if (pointerUpdateKind != WM_MOUSEMOVE)
+        {
+            _sendPendingMouseMove();
+            _sendMouseEventHelper(terminalPosition, pointerUpdateKind, modifiers, 0, buttonState);
+            return;
+        }
+
+        if (!_flushMouseMove)
+        {
+            const auto dispatcher = DispatcherQueue::GetForCurrentThread();
+            if (!dispatcher)
+            {
+                _sendMouseEventHelper(terminalPosition, pointerUpdateKind, modifiers, 0, buttonState);
+                return;
+            }
+
+            _flushMouseMove = std::make_shared<ThrottledFuncTrailing<>>(
+                dispatcher,
+                std::chrono::milliseconds{ 8 },
+                [weakThis = get_weak()]() {
+                    if (const auto self{ weakThis.get() })
+                    {
+                        self->_sendPendingMouseMove();
+                    }
+                });
+        }
+
+        _pendingMouseMove = PendingMouseMove{ terminalPosition, pointerUpdateKind, modifiers, buttonState };
+        _flushMouseMove->Run();
+    }
+
+    void ControlInteractivity::_sendPendingMouseMove()
+    {
+        if (const auto pending = std::exchange(_pendingMouseMove, std::nullopt))
+        {
+            _sendMouseEventHelper(pending->terminalPosition, pending->pointerUpdateKind, pending->modifiers, 0, pending->buttonState);
+        }
+    }
+
     // Method Description:
     // - Creates an automation peer for the Terminal Control, enabling
     //   accessibility on our control.
@@ -142,11 +142,28 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         uint64_t _id;
         static std::atomic<uint64_t> _nextId;
 
+        // High polling rate mice generate far more pointer moves than any application could use.
+        // Motion reports are thus queued up and sent at most once per frame. See _queueMouseMove().
+        struct PendingMouseMove
+        {
+            til::point terminalPosition;
+            unsigned int pointerUpdateKind;
+            ::Microsoft::Terminal::Core::ControlKeyStates modifiers;
+            Control::MouseButtonState buttonState;
+        };
+        std::optional<PendingMouseMove> _pendingMouseMove;
+        std::shared_ptr<ThrottledFuncTrailing<>> _flushMouseMove;
+
+        // Every font size change rebuilds the glyph atlas and reflows the buffer.
+        // Ctrl+Scroll zooming accumulates its wheel notches here and applies them at a capped rate.
+        float _pendingFontSizeDelta{ 0 };
+        std::shared_ptr<ThrottledFuncTrailing<>> _applyFontSizeDelta;
+
         unsigned int _numberOfClicks(Core::Point clickPos, Timestamp clickTime);
         void _updateSystemParameterSettings() noexcept;
 
         void _mouseTransparencyHandler(const int32_t mouseDelta) const;
-        void _mouseZoomHandler(const int32_t mouseDelta) const;
+        void _mouseZoomHandler(const int32_t mouseDelta);
         void _mouseScrollHandler(const int32_t mouseDelta,
                                  const Core::Point terminalPosition,
                                  const bool isLeftButtonPressed);
@@ -162,6 +179,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                    const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
                                    const SHORT wheelDelta,
                                    Control::MouseButtonState buttonState);
+        void _queueMouseMove(const til::point terminalPosition,
+                             const unsigned int pointerUpdateKind,
+                             const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
+                             Control::MouseButtonState buttonState);
+        void _sendPendingMouseMove();
 
         friend class ControlUnitTests::ControlCoreTests;
         friend class ControlUnitTests::ControlInteractivityTests;
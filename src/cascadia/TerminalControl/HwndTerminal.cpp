@@ -171,6 +171,7 @@ HwndTerminal::HwndTerminal(HWND parentHwnd) noexcept :
     _uiaProvider{ nullptr },
     _currentDpi{ USER_DEFAULT_SCREEN_DPI },
     _pfnWriteCallback{ nullptr },
+    _pfnWriteCallbackWithLength{ nullptr },
     _multiClickTime{ 500 } // this will be overwritten by the windows system double-click time
 {
     auto hInstance = wil::GetModuleInstanceHandle();
@@ -272,7 +273,24 @@ void HwndTerminal::RegisterScrollCallback(std::function<void(int, int, int)> cal
 
 void HwndTerminal::_WriteTextToConnection(const std::wstring_view input) noexcept
 {
-    if (input.empty() || !_pfnWriteCallback)
+    if (input.empty())
+    {
+        return;
+    }
+
+    // The length-prefixed callback borrows our buffer for the duration of the
+    // call, which saves us from allocating a copy for every single write.
+    if (_pfnWriteCallbackWithLength)
+    {
+        try
+        {
+            _pfnWriteCallbackWithLength(input.data(), input.size());
+        }
+        CATCH_LOG();
+        return;
+    }
+
+    if (!_pfnWriteCallback)
     {
         return;
     }
@@ -290,6 +308,11 @@ void HwndTerminal::RegisterWriteCallback(const void _stdcall callback(wchar_t*))
     _pfnWriteCallback = callback;
 }
 
+void HwndTerminal::RegisterWriteCallbackWithLength(void _stdcall callback(const wchar_t*, size_t))
+{
+    _pfnWriteCallbackWithLength = callback;
+}
+
 ::Microsoft::Console::Render::IRenderData* HwndTerminal::GetRenderData() const noexcept
 {
     return _terminal.get();
@@ -387,6 +410,18 @@ void HwndTerminal::SendOutput(std::wstring_view data)
     _terminal->Write(data);
 }
 
+void HwndTerminal::SendOutputUtf8(std::string_view data)
+{
+    if (!_terminal)
+    {
+        return;
+    }
+    const auto lock = _terminal->LockForWriting();
+    // The conversion state and buffer are shared between calls, so they're protected by the lock as well.
+    THROW_IF_FAILED(til::u8u16(data, _u16Buffer, _u8State));
+    _terminal->Write(_u16Buffer);
+}
+
 HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal)
 {
     auto publicTerminal = std::make_unique<HwndTerminal>(parentHwnd);
@@ -415,6 +450,21 @@ try
 }
 CATCH_LOG()
 
+/// <summary>
+/// Registers a callback for the terminal's input, which receives a pointer and a length
+/// instead of a string the callee has to free. The data is only valid during the call.
+/// If registered, it's used instead of the callback given to TerminalRegisterWriteCallback.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="callback">The callback, or nullptr to unregister it.</param>
+void _stdcall TerminalRegisterWriteCallbackWithLength(void* terminal, void __stdcall callback(const wchar_t*, size_t))
+try
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->RegisterWriteCallbackWithLength(callback);
+}
+CATCH_LOG()
+
 void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data)
 try
 {
@@ -423,6 +473,21 @@ try
 }
 CATCH_LOG()
 
+/// <summary>
+/// Writes a batch of UTF-8 encoded output to the terminal. Unlike TerminalSendOutput,
+/// the data doesn't need to be null-terminated and may end in the middle of a character.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="data">The UTF-8 encoded output.</param>
+/// <param name="length">The length of data in bytes.</param>
+void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, size_t length)
+try
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->SendOutputUtf8({ data, length });
+}
+CATCH_LOG()
+
 /// <summary>
 /// Triggers a terminal resize using the new width and height in pixel.
 /// </summary>
@@ -37,6 +37,12 @@ constexpr const auto TsfRedrawInterval = std::chrono::milliseconds(8);
 // The minimum delay between updating the locations of regex patterns
 constexpr const auto UpdatePatternLocationsInterval = std::chrono::milliseconds(500);
 
+// The minimum delay between resizing the buffer and the connection while the
+// control is being resized. Each resize reflows the entire buffer and resizes
+// the pseudoconsole, which is far too expensive to do for every
+// intermediate size while the user is dragging the window border.
+constexpr const auto ResizeUpdateInterval = std::chrono::milliseconds(33);
+
 // The minimum delay between emitting warning bells
 constexpr const auto TerminalWarningBellInterval = std::chrono::milliseconds(1000);
 
@@ -223,6 +229,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _revokers.PasteFromClipboard = _interactivity.PasteFromClipboard(winrt::auto_revoke, { get_weak(), &TermControl::_bubblePasteFromClipboard });
 
+        // Background tabs are removed from the visual tree. There's no point in
+        // waking up the render thread for them, so we pause painting while
+        // we're unloaded. The buffer keeps receiving output in the meantime.
+        _loadedRevoker = Loaded(winrt::auto_revoke, { get_weak(), &TermControl::_loadedHandler });
+        _unloadedRevoker = Unloaded(winrt::auto_revoke, { get_weak(), &TermControl::_unloadedHandler });
+
         // Initialize the terminal only once the swapchainpanel is loaded - that
         //      way, we'll be able to query the real pixel size it got on layout
         _layoutUpdatedRevoker = SwapChainPanel().LayoutUpdated(winrt::auto_revoke, [this](auto /*s*/, auto /*e*/) {
@@ -264,6 +276,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+        // Until this fires, the swap chain will continue to be presented at
+        // its previous size (clipped or with a blank margin). The trailing edge
+        // always gets the most recent size, so the final size is exact.
+        _updateSize = std::make_shared<ThrottledFuncTrailing<float, float>>(
+            dispatcher,
+            ResizeUpdateInterval,
+            [weakThis = get_weak()](const float width, const float height) {
+                if (auto control{ weakThis.get() }; control && !control->_IsClosing())
+                {
+                    control->_core.SizeChanged(width, height);
+                }
+            });
+
         // These events might all be triggered by the connection, but that
         // should be drained and closed before we complete destruction. So these
         // are safe.
@@ -482,14 +507,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             memset(data, 0, buffer.Length());
 
-            if (const auto marks = _core.ScrollMarks())
             {
-                for (const auto& m : marks)
+                const auto core = winrt::get_self<ControlCore>(_core);
+                // With many thousands of marks, most of them end up on the same pixel row as their
+                // predecessor. The marks are sorted by row, so skipping repeats is sufficient.
+                const uint8_t* lastBase = nullptr;
+                til::color lastColor;
+
+                for (const auto& [row, color] : core->ScrollMarkRows())
                 {
-                    const auto row = m.Row;
-                    const til::color color{ m.Color.Color };
                     const auto base = dataAt(row);
-                    drawPip(base, color);
+                    if (base != lastBase || color != lastColor)
+                    {
+                        drawPip(base, color);
+                        lastBase = base;
+                        lastColor = color;
+                    }
                 }
             }
 
@@ -1199,6 +1232,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             {
                 _core.Connection().Start();
             }
+
+            TIL_TRACE_STARTUP_PHASE(g_hTerminalControlProvider, "ConnectionStarted");
         }
         else
         {
@@ -1252,7 +1287,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // Create a timer
             _blinkTimer.Interval(std::chrono::milliseconds(blinkTime));
             _blinkTimer.Tick({ get_weak(), &TermControl::_BlinkTimerTick });
-            _blinkTimer.Start();
+            // Just like the cursor timer, this is started once we're focused.
+            // Otherwise every unfocused pane would wake up twice a second for nothing.
+            if (_focused)
+            {
+                _blinkTimer.Start();
+            }
         }
         else
         {
@@ -1631,8 +1671,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                        const winrt::Microsoft::Terminal::Core::ControlKeyStates modifiers,
                                        const bool keyDown)
     {
-        const auto window = CoreWindow::GetForCurrentThread();
-
         // If the terminal translated the key, mark the event as handled.
         // This will prevent the system from trying to get the character out
         // of it and sending us a CharacterReceived event.
@@ -1642,7 +1680,40 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                        modifiers,
                                                        keyDown) :
                                  true;
+        _rawKeyEventSent(vkey, keyDown);
+        return handled;
+    }
+
+    // Method Description:
+    // - Writes the key event to each of the targets, like RawWriteKeyEvent.
+    //   The key is only translated once per distinct set of input modes
+    //   among the targets and the resulting sequence is sent to all of them.
+    // Arguments:
+    // - targets: The controls to write the key event to.
+    // - vkey: The vkey of the key pressed.
+    // - scanCode: The scan code of the key pressed.
+    // - modifiers: The Microsoft::Terminal::Core::ControlKeyStates representing the modifier key states.
+    // - keyDown: If true, the key was pressed, otherwise the key was released.
+    void TermControl::BroadcastKeyEvent(const Windows::Foundation::Collections::IVectorView<Control::TermControl>& targets,
+                                        const WORD vkey,
+                                        const WORD scanCode,
+                                        const winrt::Microsoft::Terminal::Core::ControlKeyStates modifiers,
+                                        const bool keyDown)
+    {
+        std::vector<ControlCore::BroadcastKeyTranslation> translations;
+        for (const auto& target : targets)
+        {
+            const auto control = get_self<TermControl>(target);
+            if (vkey)
+            {
+                get_self<ControlCore>(control->_core)->TrySendBroadcastKeyEvent(vkey, scanCode, modifiers, keyDown, translations);
+            }
+            control->_rawKeyEventSent(vkey, keyDown);
+        }
+    }
 
+    void TermControl::_rawKeyEventSent(const WORD vkey, const bool keyDown)
+    {
         if (vkey && keyDown && _automationPeer)
         {
             get_self<TermControlAutomationPeer>(_automationPeer)->RecordKeyEvent(vkey);
@@ -1655,8 +1726,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _core.CursorOn(_core.SelectionMode() != SelectionInteractionMode::Mark);
             _cursorTimer.Start();
         }
-
-        return handled;
     }
 
     // Method Description:
@@ -2200,7 +2269,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         const auto newSize = e.NewSize();
-        _core.SizeChanged(newSize.Width, newSize.Height);
+        _updateSize->Run(newSize.Width, newSize.Height);
 
         if (_automationPeer)
         {
@@ -2485,6 +2554,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _core.BufferHeight();
     }
 
+    uint64_t TermControl::BufferMemoryUsage() const
+    {
+        return _core.BufferMemoryUsage();
+    }
+
+    void TermControl::TraceMemoryDiagnostics() const
+    {
+        _core.TraceMemoryDiagnostics();
+    }
+
     // Function Description:
     // - Determines how much space (in pixels) an app would need to reserve to
     //   create a control with the settings stored in the settings param. This
@@ -2682,6 +2761,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - Forwards window visibility changing event down into the control core
     //   to eventually let the hosting PTY know whether the window is visible or
     //   not (which can be relevant to `::GetConsoleWindow()` calls.)
+    // - Also pauses rendering while the window is hidden.
     // Arguments:
     // - showOrHide: Show is true; hide is false.
     // Return Value:
@@ -2689,6 +2769,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     void TermControl::WindowVisibilityChanged(const bool showOrHide)
     {
         _core.WindowVisibilityChanged(showOrHide);
+
+        // Nobody can see what we'd present while the window is minimized. The output
+        // still gets processed and the first frame after restoring catches up on it.
+        if (_initializedTerminal && !_IsClosing())
+        {
+            if (!showOrHide)
+            {
+                _core.DisablePainting();
+            }
+            else if (IsLoaded())
+            {
+                _core.EnablePainting();
+            }
+        }
     }
 
     // Method Description:
@@ -3546,6 +3640,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         return _core.ReadEntireBuffer();
     }
+    Windows::Foundation::IAsyncActionWithProgress<double> TermControl::ExportBufferToFile(const hstring& path) const
+    {
+        return _core.ExportBufferToFile(path);
+    }
     Control::CommandHistoryContext TermControl::CommandHistory() const
     {
         return _core.CommandHistory();
@@ -3640,6 +3738,45 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    void TermControl::_loadedHandler(const IInspectable& /*sender*/, const RoutedEventArgs& /*args*/)
+    {
+        // The first time around, _InitializeTerminal() enables painting itself.
+        if (_initializedTerminal && !_IsClosing())
+        {
+            _core.EnablePainting();
+
+            if (_cursorTimer && (_focused || _displayCursorWhileBlurred()))
+            {
+                _cursorTimer.Start();
+            }
+            if (_blinkTimer && _focused)
+            {
+                _blinkTimer.Start();
+            }
+        }
+    }
+
+    void TermControl::_unloadedHandler(const IInspectable& /*sender*/, const RoutedEventArgs& /*args*/)
+    {
+        // XAML raises Loaded for the new parent before Unloaded for the old one
+        // when an element is reparented (for instance when a pane gets split).
+        // IsLoaded() tells us whether we're actually still in the tree.
+        if (_initializedTerminal && !_IsClosing() && !IsLoaded())
+        {
+            _core.DisablePainting();
+
+            // There's no point in blinking anything while we're not in the tree.
+            if (_cursorTimer)
+            {
+                _cursorTimer.Stop();
+            }
+            if (_blinkTimer)
+            {
+                _blinkTimer.Stop();
+            }
+        }
+    }
+
     void TermControl::_coreOutputIdle(const IInspectable& /*sender*/, const IInspectable& /*args*/)
     {
         _refreshSearch();
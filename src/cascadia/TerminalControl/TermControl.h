@@ -51,6 +51,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TermControl(IControlSettings settings, Control::IControlAppearance unfocusedAppearance, TerminalConnection::ITerminalConnection connection);
 
         static Control::TermControl NewControlByAttachingContent(Control::ControlInteractivity content, const Microsoft::Terminal::Control::IKeyBindings& keyBindings);
+        static void BroadcastKeyEvent(const Windows::Foundation::Collections::IVectorView<Control::TermControl>& targets, const WORD vkey, const WORD scanCode, const winrt::Microsoft::Terminal::Core::ControlKeyStates modifiers, const bool keyDown);
 
         winrt::fire_and_forget UpdateControlSettings(Control::IControlSettings settings);
         winrt::fire_and_forget UpdateControlSettings(Control::IControlSettings settings, Control::IControlAppearance unfocusedAppearance);
@@ -93,6 +94,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         int ScrollOffset() const;
         int ViewHeight() const;
         int BufferHeight() const;
+        uint64_t BufferMemoryUsage() const;
+        void TraceMemoryDiagnostics() const;
 
         bool HasSelection() const;
         bool HasMultiLineSelection() const;
@@ -166,6 +169,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         static Windows::UI::Xaml::Thickness ParseThicknessFromPadding(const hstring padding);
 
         hstring ReadEntireBuffer() const;
+        Windows::Foundation::IAsyncActionWithProgress<double> ExportBufferToFile(const hstring& path) const;
         Control::CommandHistoryContext CommandHistory() const;
 
         winrt::Microsoft::Terminal::Core::Scheme ColorScheme() const noexcept;
@@ -254,6 +258,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         };
 
         std::shared_ptr<ThrottledFuncTrailing<ScrollBarUpdate>> _updateScrollBar;
+        std::shared_ptr<ThrottledFuncTrailing<float, float>> _updateSize;
 
         bool _isInternalScrollBarUpdate;
 
@@ -273,6 +278,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         SafeDispatcherTimer _blinkTimer;
 
         winrt::Windows::UI::Xaml::Controls::SwapChainPanel::LayoutUpdated_revoker _layoutUpdatedRevoker;
+        winrt::Windows::UI::Xaml::FrameworkElement::Loaded_revoker _loadedRevoker;
+        winrt::Windows::UI::Xaml::FrameworkElement::Unloaded_revoker _unloadedRevoker;
         winrt::hstring _restorePath;
         bool _showMarksInScrollbar{ false };
 
@@ -365,6 +372,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool _TryHandleKeyBinding(const WORD vkey, const WORD scanCode, ::Microsoft::Terminal::Core::ControlKeyStates modifiers) const;
         static void _ClearKeyboardState(const WORD vkey, const WORD scanCode) noexcept;
         bool _TrySendKeyEvent(const WORD vkey, const WORD scanCode, ::Microsoft::Terminal::Core::ControlKeyStates modifiers, const bool keyDown);
+        void _rawKeyEventSent(const WORD vkey, const bool keyDown);
 
         til::point _toControlOrigin(const til::point terminalPosition);
         const til::point _toTerminalOrigin(winrt::Windows::Foundation::Point cursorPosition);
@@ -386,6 +394,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _coreWarningBell(const IInspectable& sender, const IInspectable& args);
         void _coreOutputIdle(const IInspectable& sender, const IInspectable& args);
 
+        void _loadedHandler(const IInspectable& sender, const winrt::Windows::UI::Xaml::RoutedEventArgs& args);
+        void _unloadedHandler(const IInspectable& sender, const winrt::Windows::UI::Xaml::RoutedEventArgs& args);
+
         til::point _toPosInDips(const Core::Point terminalCellPos);
         void _throttledUpdateScrollbar(const ScrollBarUpdate& update);
 
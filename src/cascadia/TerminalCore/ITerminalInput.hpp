@@ -22,7 +22,7 @@ namespace Microsoft::Terminal::Core
         [[nodiscard]] virtual ::Microsoft::Console::VirtualTerminal::TerminalInput::OutputType FocusChanged(const bool focused) = 0;
 
         [[nodiscard]] virtual HRESULT UserResize(const til::size size) noexcept = 0;
-        virtual void UserScrollViewport(const int viewTop) = 0;
+        virtual bool UserScrollViewport(const int viewTop) = 0;
         virtual int GetScrollOffset() = 0;
 
         virtual void TrySnapOnInput() = 0;
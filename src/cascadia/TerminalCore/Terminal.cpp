@@ -166,6 +166,7 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
     {
         renderSettings.SetColorTableEntry(i, til::color{ appearance.GetColorTableEntry(i) });
     }
+    renderSettings.PrecomputePerceivableColors();
 
     auto cursorShape = CursorType::VerticalBar;
     switch (appearance.CursorShape())
@@ -560,6 +561,17 @@ std::optional<PointTree::interval> Terminal::GetHyperlinkIntervalFromViewportPos
     return std::nullopt;
 }
 
+// Method description:
+// - Invalidates the cells covered by an interval returned by GetHyperlinkIntervalFromViewportPosition
+// Arguments:
+// - The interval, relative to the viewport
+void Terminal::InvalidateHyperlinkInterval(const PointTree::interval& interval)
+{
+    _assertLocked();
+    const auto vis = _VisibleStartIndex();
+    _InvalidateFromCoords({ interval.start.x, interval.start.y + vis }, { interval.stop.x, interval.stop.y + vis });
+}
+
 // Method Description:
 // - Send this particular (non-character) key event to the terminal.
 // - The terminal will translate the key and the modifiers pressed into the
@@ -586,16 +598,7 @@ TerminalInput::OutputType Terminal::SendKeyEvent(const WORD vkey,
                                                  const ControlKeyStates states,
                                                  const bool keyDown)
 {
-    // GH#6423 - don't snap on this key if the key that was pressed was a
-    // modifier key. We'll wait for a real keystroke to snap to the bottom.
-    // GH#6481 - Additionally, make sure the key was actually pressed. This
-    // check will make sure we behave the same as before GH#6309
-    if (IsInputKey(vkey) && keyDown)
-    {
-        TrySnapOnInput();
-    }
-
-    _StoreKeyEvent(vkey, scanCode);
+    _prepareKeyEvent(vkey, scanCode, keyDown);
 
     // Certain applications like AutoHotKey and its keyboard remapping feature,
     // send us key events using SendInput() whose values are outside of the valid range.
@@ -647,6 +650,47 @@ TerminalInput::OutputType Terminal::SendKeyEvent(const WORD vkey,
     return _getTerminalInput().HandleKey(keyEv);
 }
 
+// Returns a value that is equal for two terminals whenever SendKeyEvent() would
+// translate the same key event identically, given the same GetKeyTrackingState().
+uint64_t Terminal::GetKeyTranslationState() const noexcept
+{
+    return uint64_t{ _getTerminalInput().GetKeyModes() } << 1 | uint64_t{ _altGrAliasing };
+}
+
+TerminalInput::KeyTrackingState Terminal::GetKeyTrackingState() const noexcept
+{
+    return _getTerminalInput().GetKeyTrackingState();
+}
+
+// Method Description:
+// - Applies the side effects of SendKeyEvent() without translating the key.
+//   Used for broadcast input, where another terminal with the same
+//   GetKeyTranslationState() already translated it.
+// Arguments:
+// - vkey: The vkey of the last pressed key.
+// - scanCode: The scan code of the last pressed key.
+// - keyDown: If true, the key was pressed, otherwise the key was released.
+// - state: The GetKeyTrackingState() of the terminal that translated the key.
+void Terminal::ReplayKeyEvent(const WORD vkey, const WORD scanCode, const bool keyDown, const TerminalInput::KeyTrackingState& state)
+{
+    _prepareKeyEvent(vkey, scanCode, keyDown);
+    _getTerminalInput().SetKeyTrackingState(state);
+}
+
+void Terminal::_prepareKeyEvent(const WORD vkey, const WORD scanCode, const bool keyDown)
+{
+    // GH#6423 - don't snap on this key if the key that was pressed was a
+    // modifier key. We'll wait for a real keystroke to snap to the bottom.
+    // GH#6481 - Additionally, make sure the key was actually pressed. This
+    // check will make sure we behave the same as before GH#6309
+    if (IsInputKey(vkey) && keyDown)
+    {
+        TrySnapOnInput();
+    }
+
+    _StoreKeyEvent(vkey, scanCode);
+}
+
 // Method Description:
 // - Send this particular mouse event to the terminal. The terminal will translate
 //   the button and the modifiers pressed into the appropriate VT sequence for that
@@ -966,6 +1010,41 @@ til::CoordType Terminal::GetBufferHeight() const noexcept
     return _GetMutableViewport().BottomExclusive();
 }
 
+// Returns an estimate of the memory used by the main and alternate buffer in bytes.
+// This includes the alternate buffer that's kept around for reuse after leaving it,
+// as well as the heap memory of the rows, which means that all rows are walked.
+// It's only meant to be called on demand, like when the tab context menu opens.
+size_t Terminal::GetBufferMemoryUsage() const noexcept
+{
+    size_t bytes = 0;
+    for (const auto buffer : { _mainBuffer.get(), _altBuffer.get(), _recycledAltBuffer.get() })
+    {
+        if (buffer)
+        {
+            bytes += buffer->GetCommittedBytes() + buffer->GetRowHeapBytes();
+        }
+    }
+    return bytes;
+}
+
+// Returns a detailed breakdown of the memory used by one of the buffers.
+Terminal::BufferMemoryDiagnostics Terminal::GetBufferMemoryDiagnostics(const DiagnosticsBuffer which) const noexcept
+{
+    const auto& buffer = which == DiagnosticsBuffer::Main      ? _mainBuffer :
+                         which == DiagnosticsBuffer::Alternate ? _altBuffer :
+                                                                 _recycledAltBuffer;
+    if (!buffer)
+    {
+        return {};
+    }
+    return {
+        .reservedBytes = buffer->GetReservedBytes(),
+        .committedBytes = buffer->GetCommittedBytes(),
+        .rowHeapBytes = buffer->GetRowHeapBytes(),
+        .hyperlinks = buffer->GetHyperlinkCount(),
+    };
+}
+
 // ViewStartIndex is also the length of the scrollback
 int Terminal::ViewStartIndex() const noexcept
 {
@@ -1037,27 +1116,39 @@ void Terminal::_PreserveUserScrollOffset(const int viewportDelta) noexcept
     }
 }
 
-void Terminal::UserScrollViewport(const int viewTop)
+// Returns true if the URL patterns were cleared and UpdatePatternsUnderLock() needs to be called.
+bool Terminal::UserScrollViewport(const int viewTop)
 {
-    // Clear the regex pattern tree so the renderer does not try to render them while scrolling
-    _clearPatternTree();
-
     if (_inAltBuffer())
     {
-        return;
+        // Clear the regex pattern tree so the renderer does not try to render them while scrolling
+        _clearPatternTree();
+        return true;
     }
 
     const auto clampedNewTop = std::max(0, viewTop);
     const auto realTop = ViewStartIndex();
     const auto newDelta = realTop - clampedNewTop;
     // if viewTop > realTop, we want the offset to be 0.
+    const auto newScrollOffset = std::max(0, newDelta);
 
-    _scrollOffset = std::max(0, newDelta);
+    // Precision touchpads keep sending scroll events with inertia, even once we've
+    // reached the top or bottom of the buffer. There's nothing to do for those.
+    if (newScrollOffset == _scrollOffset)
+    {
+        return false;
+    }
+
+    // Clear the regex pattern tree so the renderer does not try to render them while scrolling
+    _clearPatternTree();
+
+    _scrollOffset = newScrollOffset;
 
     // We can use the void variant of TriggerScroll here because
     // we adjusted the viewport so it can detect the difference
     // from the previous frame drawn.
     _activeBuffer().TriggerScroll();
+    return true;
 }
 
 int Terminal::GetScrollOffset() noexcept
@@ -1165,11 +1256,91 @@ void Terminal::SetCursorOn(const bool isOn) noexcept
 // - INVARIANT: this function can only be called if the caller has the writing lock on the terminal
 void Terminal::UpdatePatternsUnderLock()
 {
+    const auto& textBuffer = _activeBuffer();
+    const auto beg = _VisibleStartIndex();
+    const auto end = _VisibleEndIndex();
+
+    // Rows that didn't change since the last call, and which are still visible, keep their previous matches.
+    // Everything else (rows that were written to or scrolled into view) gets scanned again.
+    auto keepBeg = beg;
+    auto keepEnd = beg - 1;
+
+    if (_patternCacheBuffer == &textBuffer && textBuffer.CanTrackMutationsSince(_patternCacheMutationId))
+    {
+        // Our cache is in buffer coordinates which shifted up by 1 row for each IncrementCircularBuffer().
+        const auto scrolled = textBuffer.GetScrollCount() - _patternCacheScrollCount;
+        if (scrolled < gsl::narrow_cast<uint64_t>(textBuffer.GetSize().Height()))
+        {
+            const auto delta = gsl::narrow_cast<til::CoordType>(scrolled);
+            keepBeg = std::max(beg, _patternCacheBeg - delta);
+            keepEnd = std::min({ end, _patternCacheEnd - delta, textBuffer.GetFirstRowMutatedSince(_patternCacheMutationId) - 1 });
+
+            // Matches may span across wrapped rows. The kept range must consist of entire logical lines,
+            // because the previous scan may have cut a line in half at the edges of the old viewport.
+            for (; keepBeg <= keepEnd && keepBeg > 0 && textBuffer.GetRowByOffset(keepBeg - 1).WasWrapForced(); ++keepBeg)
+            {
+            }
+            for (; keepEnd >= keepBeg && textBuffer.GetRowByOffset(keepEnd).WasWrapForced(); --keepEnd)
+            {
+            }
+
+            if (keepBeg <= keepEnd)
+            {
+                for (auto& i : _patternCache)
+                {
+                    i.start.y -= delta;
+                    i.stop.y -= delta;
+                }
+                std::erase_if(_patternCache, [&](const PointTree::interval& i) {
+                    return i.start.y < keepBeg || i.stop.y > keepEnd;
+                });
+            }
+        }
+    }
+
+    if (keepBeg > keepEnd)
+    {
+        _patternCache.clear();
+        keepBeg = end + 1;
+        keepEnd = end;
+    }
+
+    if (beg < keepBeg)
+    {
+        _findPatterns(beg, keepBeg - 1, _patternCache);
+    }
+    if (keepEnd < end)
+    {
+        _findPatterns(keepEnd + 1, end, _patternCache);
+    }
+
+    _patternCacheBuffer = &textBuffer;
+    _patternCacheMutationId = textBuffer.GetLastMutationId();
+    _patternCacheScrollCount = textBuffer.GetScrollCount();
+    _patternCacheBeg = beg;
+    _patternCacheEnd = end;
+
+    // PointTree uses viewport-relative coordinates.
+    auto intervals = _patternCache;
+    for (auto& i : intervals)
+    {
+        i.start.y -= beg;
+        i.stop.y -= beg;
+    }
+
     _InvalidatePatternTree();
-    _patternIntervalTree = _getPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    _patternIntervalTree = PointTree{ std::move(intervals) };
     _InvalidatePatternTree();
 }
 
+// Method Description:
+// - Drops the matches cached by UpdatePatternsUnderLock(), so that the next call scans the entire viewport.
+void Terminal::_invalidatePatternCache() noexcept
+{
+    _patternCache.clear();
+    _patternCacheBuffer = nullptr;
+}
+
 // Method Description:
 // - Clears and invalidates the interval pattern tree
 // - This is called to prevent the renderer from rendering patterns while the
@@ -1302,6 +1473,7 @@ void Terminal::ApplyScheme(const Scheme& colorScheme)
     renderSettings.SetColorTableEntry(TextColor::BRIGHT_WHITE, til::color{ colorScheme.BrightWhite });
 
     renderSettings.SetColorTableEntry(TextColor::CURSOR_COLOR, til::color{ colorScheme.CursorColor });
+    renderSettings.PrecomputePerceivableColors();
 
     // Tell the control that the scrollbar has somehow changed. Used as a
     // workaround to force the control to redraw any scrollbar marks whose color
@@ -1322,6 +1494,10 @@ TextBuffer& Terminal::_activeBuffer() const noexcept
 
 void Terminal::_updateUrlDetection()
 {
+    // Whether URLs are detected decides the set of patterns we search for.
+    // Matches found with a different set of patterns can't be reused.
+    _invalidatePatternCache();
+
     if (_detectURLs)
     {
         UpdatePatternsUnderLock();
@@ -1400,6 +1576,22 @@ private:
 static URegularExpressionInterner uregexInterner;
 
 PointTree Terminal::_getPatterns(til::CoordType beg, til::CoordType end) const
+{
+    PointTree::interval_vector intervals;
+    _findPatterns(beg, end, intervals);
+
+    // PointTree uses viewport-relative coordinates.
+    for (auto& i : intervals)
+    {
+        i.start.y -= beg;
+        i.stop.y -= beg;
+    }
+
+    return PointTree{ std::move(intervals) };
+}
+
+// Appends the pattern matches in the rows [beg,end] to the given vector, in buffer coordinates.
+void Terminal::_findPatterns(til::CoordType beg, til::CoordType end, PointTree::interval_vector& intervals) const
 {
     static constexpr std::array<std::wstring_view, 1> patterns{
         LR"(\b(?:https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])",
@@ -1407,7 +1599,6 @@ PointTree Terminal::_getPatterns(til::CoordType beg, til::CoordType end) const
 
     auto text = ICU::UTextFromTextBuffer(_activeBuffer(), beg, end + 1);
     UErrorCode status = U_ZERO_ERROR;
-    PointTree::interval_vector intervals;
 
     for (size_t i = 0; i < patterns.size(); ++i)
     {
@@ -1419,16 +1610,12 @@ PointTree Terminal::_getPatterns(til::CoordType beg, til::CoordType end) const
             do
             {
                 auto range = ICU::BufferRangeFromMatch(&text, re.get());
-                // PointTree uses half-open ranges and viewport-relative coordinates.
-                range.start.y -= beg;
-                range.end.y -= beg;
+                // PointTree uses half-open ranges.
                 range.end.x++;
                 intervals.push_back(PointTree::interval(range.start, range.end, 0));
             } while (uregex_findNext(re.get(), &status));
         }
     }
-
-    return PointTree{ std::move(intervals) };
 }
 
 // NOTE: This is the version of AddMark that comes from the UI. The VT api call into this too.
@@ -1481,11 +1668,11 @@ std::vector<ScrollMark> Terminal::GetMarkRows() const
     // hide them.
     return _inAltBuffer() ? std::vector<ScrollMark>{} : _activeBuffer().GetMarkRows();
 }
-std::vector<MarkExtents> Terminal::GetMarkExtents() const
+std::vector<MarkExtents> Terminal::GetMarkExtents(size_t limit) const
 {
     // We want to return _no_ marks when we're in the alt buffer, to effectively
     // hide them.
-    return _inAltBuffer() ? std::vector<MarkExtents>{} : _activeBuffer().GetMarkExtents();
+    return _inAltBuffer() ? std::vector<MarkExtents>{} : _activeBuffer().GetMarkExtents(limit);
 }
 
 til::color Terminal::GetColorForMark(const ScrollbarData& markData) const
@@ -110,6 +110,22 @@ public:
     til::recursive_ticket_lock_suspension SuspendLock() noexcept;
 
     til::CoordType GetBufferHeight() const noexcept;
+    size_t GetBufferMemoryUsage() const noexcept;
+
+    enum class DiagnosticsBuffer
+    {
+        Main,
+        Alternate,
+        RecycledAlternate,
+    };
+    struct BufferMemoryDiagnostics
+    {
+        size_t reservedBytes = 0;
+        size_t committedBytes = 0;
+        size_t rowHeapBytes = 0;
+        size_t hyperlinks = 0;
+    };
+    BufferMemoryDiagnostics GetBufferMemoryDiagnostics(DiagnosticsBuffer which) const noexcept;
 
     int ViewStartIndex() const noexcept;
     int ViewEndIndex() const noexcept;
@@ -118,7 +134,7 @@ public:
     const RenderSettings& GetRenderSettings() const noexcept;
 
     std::vector<ScrollMark> GetMarkRows() const;
-    std::vector<MarkExtents> GetMarkExtents() const;
+    std::vector<MarkExtents> GetMarkExtents(size_t limit = SIZE_T_MAX) const;
     void AddMarkFromUI(ScrollbarData mark, til::CoordType y);
 
     til::property<bool> AlwaysNotifyOnBufferRotation;
@@ -172,7 +188,7 @@ public:
     [[nodiscard]] ::Microsoft::Console::VirtualTerminal::TerminalInput::OutputType FocusChanged(const bool focused) override;
 
     [[nodiscard]] HRESULT UserResize(const til::size viewportSize) noexcept override;
-    void UserScrollViewport(const int viewTop) override;
+    bool UserScrollViewport(const int viewTop) override;
     int GetScrollOffset() noexcept override;
 
     void TrySnapOnInput() override;
@@ -183,8 +199,13 @@ public:
     std::wstring GetHyperlinkAtBufferPosition(const til::point bufferPos);
     uint16_t GetHyperlinkIdAtViewportPosition(const til::point viewportPos);
     std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> GetHyperlinkIntervalFromViewportPosition(const til::point viewportPos);
+    void InvalidateHyperlinkInterval(const interval_tree::IntervalTree<til::point, size_t>::interval& interval);
 #pragma endregion
 
+    uint64_t GetKeyTranslationState() const noexcept;
+    ::Microsoft::Console::VirtualTerminal::TerminalInput::KeyTrackingState GetKeyTrackingState() const noexcept;
+    void ReplayKeyEvent(const WORD vkey, const WORD scanCode, const bool keyDown, const ::Microsoft::Console::VirtualTerminal::TerminalInput::KeyTrackingState& state);
+
 #pragma region IRenderData
     Microsoft::Console::Types::Viewport GetViewport() noexcept override;
     til::point GetTextBufferEndPosition() const noexcept override;
@@ -394,6 +415,8 @@ private:
 
     std::unique_ptr<TextBuffer> _mainBuffer;
     std::unique_ptr<TextBuffer> _altBuffer;
+    // The previous alt buffer, or null. See UseAlternateScreenBuffer().
+    std::unique_ptr<TextBuffer> _recycledAltBuffer;
     Microsoft::Console::Types::Viewport _mutableViewport;
     til::CoordType _scrollbackLines = 0;
     bool _detectURLs = false;
@@ -418,6 +441,15 @@ private:
     //      Either way, we should make this behavior controlled by a setting.
 
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
+    // The matches for the rows [_patternCacheBeg,_patternCacheEnd] of _patternCacheBuffer in buffer coordinates.
+    // It allows UpdatePatternsUnderLock() to only scan the rows that changed or scrolled into view.
+    interval_tree::IntervalTree<til::point, size_t>::interval_vector _patternCache;
+    const TextBuffer* _patternCacheBuffer = nullptr;
+    uint64_t _patternCacheMutationId = 0;
+    uint64_t _patternCacheScrollCount = 0;
+    til::CoordType _patternCacheBeg = 0;
+    til::CoordType _patternCacheEnd = -1;
+    void _invalidatePatternCache() noexcept;
     void _clearPatternTree();
     void _InvalidatePatternTree();
     void _InvalidateFromCoords(const til::point start, const til::point end);
@@ -436,6 +468,7 @@ private:
     static wchar_t _CharacterFromKeyEvent(const WORD vkey, const WORD scanCode, const ControlKeyStates states) noexcept;
 
     void _StoreKeyEvent(const WORD vkey, const WORD scanCode) noexcept;
+    void _prepareKeyEvent(const WORD vkey, const WORD scanCode, const bool keyDown);
     WORD _TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept;
 
     Console::VirtualTerminal::TerminalInput& _getTerminalInput() noexcept;
@@ -455,6 +488,7 @@ private:
     TextBuffer& _activeBuffer() const noexcept;
     void _updateUrlDetection();
     interval_tree::IntervalTree<til::point, size_t> _getPatterns(til::CoordType beg, til::CoordType end) const;
+    void _findPatterns(til::CoordType beg, til::CoordType end, interval_tree::IntervalTree<til::point, size_t>::interval_vector& intervals) const;
 
 #pragma region TextSelection
     // These methods are defined in TerminalSelection.cpp
@@ -206,12 +206,23 @@ void Terminal::UseAlternateScreenBuffer(const TextAttribute& attrs)
 
     ClearSelection();
 
-    // Create a new alt buffer
-    _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
-                                              attrs,
-                                              cursorSize,
-                                              true,
-                                              _mainBuffer->GetRenderer());
+    // Pagers and the like switch between the main and alt buffer all the time. Instead of
+    // creating a new alt buffer every time, we reuse the previous one if the size still fits.
+    if (_recycledAltBuffer && _recycledAltBuffer->GetSize().Dimensions() == _altBufferSize)
+    {
+        _altBuffer = std::move(_recycledAltBuffer);
+        _altBuffer->ResetInPlace(attrs);
+        _altBuffer->SetAsActiveBuffer(true);
+    }
+    else
+    {
+        _recycledAltBuffer.reset();
+        _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
+                                                  attrs,
+                                                  cursorSize,
+                                                  true,
+                                                  _mainBuffer->GetRenderer());
+    }
     _mainBuffer->SetAsActiveBuffer(false);
 
     // Copy our cursor state to the new buffer's cursor
@@ -251,8 +262,8 @@ void Terminal::UseMainScreenBuffer()
     // To make UserResize() work as if we're back in the main buffer, we first need to unset
     // _altBuffer, which is used throughout this class as an indicator via _inAltBuffer().
     //
-    // We delay destroying the alt buffer instance to get a valid altBuffer->GetCursor() reference below.
-    const auto altBuffer = std::exchange(_altBuffer, nullptr);
+    // We delay recycling the alt buffer instance to get a valid altBuffer->GetCursor() reference below.
+    auto altBuffer = std::exchange(_altBuffer, nullptr);
     if (!altBuffer)
     {
         return;
@@ -286,6 +297,10 @@ void Terminal::UseMainScreenBuffer()
         mainCursor.SetPosition(tgtCursorPos);
     }
 
+    // Keep the alt buffer around for the next UseAlternateScreenBuffer() call.
+    altBuffer->SetAsActiveBuffer(false);
+    _recycledAltBuffer = std::move(altBuffer);
+
     // update all the hyperlinks on the screen
     _updateUrlDetection();
 
@@ -132,7 +132,17 @@ try
 {
     std::vector<Viewport> result;
 
-    for (const auto& lineRect : _GetSelectionRects())
+    if (!IsSelectionActive())
+    {
+        return result;
+    }
+
+    // The renderer only paints the visible rows, so there's no need to produce a rect
+    // for all the other rows of a large selection. See Terminal::_GetSelectionRects().
+    const auto rects = _activeBuffer().GetTextRects(_selection->start, _selection->end, _blockSelection, false, _VisibleStartIndex(), _VisibleEndIndex());
+    result.reserve(rects.size());
+
+    for (const auto& lineRect : rects)
     {
         result.emplace_back(Viewport::FromInclusive(lineRect));
     }
@@ -432,6 +432,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _NameMapCache = nullptr;
         _GlobalHotkeysCache = nullptr;
         _KeyBindingMapCache = nullptr;
+        _KeyChordTableCache.store(nullptr);
 
         // Handle nested commands
         const auto cmdImpl{ get_self<Command>(cmd) };
@@ -628,7 +629,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             const auto conflictingCmdImpl{ get_self<implementation::Command>(conflictingCmd) };
             conflictingCmdImpl->EraseKey(keys);
         }
-        else if (const auto& conflictingCmd{ GetActionByKeyChord(keys) })
+        else if (const auto& conflictingCmd{ _GetActionByKeyChordInternal(keys).value_or(nullptr) })
         {
             // Collision with ancestor: The key chord was already in use, but by an action in another layer
             //
@@ -698,7 +699,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // We use the fact that the ..Internal call returns nullptr for explicitly unbound
         // key chords, and nullopt for keychord that are not bound - it allows us to distinguish
         // between unbound and lack of binding.
-        return _GetActionByKeyChordInternal(keys) == nullptr;
+        return _GetActionByKeyChordCached(keys) == nullptr;
     }
 
     // Method Description:
@@ -710,7 +711,121 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - nullptr if the key chord doesn't exist
     Model::Command ActionMap::GetActionByKeyChord(const Control::KeyChord& keys) const
     {
-        return _GetActionByKeyChordInternal(keys).value_or(nullptr);
+        return _GetActionByKeyChordCached(keys).value_or(nullptr);
+    }
+
+    // Method Description:
+    // - Same as _GetActionByKeyChordInternal(), but uses the flattened _KeyChordTableCache.
+    //   This function is called for every key press and must be fast.
+    // - Only AddAction() invalidates the table. That's fine since parents aren't modified after
+    //   settings are loaded, but it means internal code should use _GetActionByKeyChordInternal().
+    std::optional<Model::Command> ActionMap::_GetActionByKeyChordCached(const Control::KeyChord& keys) const
+    {
+        auto table = _KeyChordTableCache.load(std::memory_order_acquire);
+        if (!table)
+        {
+            // If two threads race to get here, they'll both build an identical table. That's harmless.
+            table = _BuildKeyChordTable();
+            _KeyChordTableCache.store(table, std::memory_order_release);
+        }
+
+        if (const auto entry = table->find(_PackKeyChord(keys)))
+        {
+            return entry->cmd;
+        }
+        return std::nullopt;
+    }
+
+    // Packs a KeyChord into an integer which can be compared in the same way as KeyChord::Equals().
+    // Chords with a vkey are identified by the vkey, others by their scan code. The result is never 0.
+    uint64_t ActionMap::_PackKeyChord(const Control::KeyChord& keys)
+    {
+        const auto vkey = static_cast<uint32_t>(keys.Vkey());
+        const auto key = vkey ? vkey : (static_cast<uint32_t>(keys.ScanCode()) | 0x80000000);
+        return (static_cast<uint64_t>(keys.Modifiers()) << 32) | key;
+    }
+
+    const ActionMap::KeyChordTable::Entry* ActionMap::KeyChordTable::find(const uint64_t key) const noexcept
+    {
+        if (entries.empty())
+        {
+            return nullptr;
+        }
+
+        // Fibonacci hashing: The upper bits of the product are well distributed.
+        const auto mask = entries.size() - 1;
+        auto index = gsl::narrow_cast<size_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> shift);
+
+        // The table is never full, so this loop is guaranteed to hit an unused entry.
+        for (;;)
+        {
+            const auto& entry = til::at(entries, index);
+            if (entry.key == key)
+            {
+                return &entry;
+            }
+            if (entry.key == 0)
+            {
+                return nullptr;
+            }
+            index = (index + 1) & mask;
+        }
+    }
+
+    std::shared_ptr<const ActionMap::KeyChordTable> ActionMap::_BuildKeyChordTable() const
+    {
+        std::vector<std::pair<uint64_t, std::optional<Model::Command>>> flattened;
+        std::unordered_set<uint64_t> visited;
+        _PopulateKeyChordTable(flattened, visited);
+
+        auto table = std::make_shared<KeyChordTable>();
+        if (flattened.empty())
+        {
+            return table;
+        }
+
+        // Keep the load factor at or below 50% so that probe sequences stay short.
+        size_t capacity = 16;
+        int shift = 60;
+        for (; capacity < flattened.size() * 2; capacity <<= 1, --shift)
+        {
+        }
+        table->entries.resize(capacity);
+        table->shift = shift;
+
+        for (auto& [key, cmd] : flattened)
+        {
+            auto index = gsl::narrow_cast<size_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> table->shift);
+            while (til::at(table->entries, index).key != 0)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+            auto& entry = til::at(table->entries, index);
+            entry.key = key;
+            entry.cmd = std::move(cmd);
+        }
+
+        return table;
+    }
+
+    // Method Description:
+    // - Collects the key chords of this layer and its parents in the same order that
+    //   _GetActionByKeyChordInternal() visits them. The first layer that binds a chord wins.
+    void ActionMap::_PopulateKeyChordTable(std::vector<std::pair<uint64_t, std::optional<Model::Command>>>& entries, std::unordered_set<uint64_t>& visited) const
+    {
+        for (const auto& [keys, actionID] : _KeyMap)
+        {
+            const auto key = _PackKeyChord(keys);
+            if (visited.emplace(key).second)
+            {
+                entries.emplace_back(key, _GetActionByID(actionID));
+            }
+        }
+
+        for (const auto& parent : _parents)
+        {
+            parent->_PopulateKeyChordTable(entries, visited);
+        }
     }
 
     // Method Description:
@@ -823,7 +938,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - true, if successful. False, otherwise.
     bool ActionMap::RebindKeys(const Control::KeyChord& oldKeys, const Control::KeyChord& newKeys)
     {
-        const auto& cmd{ GetActionByKeyChord(oldKeys) };
+        const auto& cmd{ _GetActionByKeyChordInternal(oldKeys).value_or(nullptr) };
         if (!cmd)
         {
             // oldKeys must be bound. Otherwise, we don't know what action to bind.
@@ -907,15 +1022,22 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         return leftName.compare(rightName) < 0;
     }
 
+    // Method Description:
+    // - Sets the profiles and schemes that iterable commands get expanded on.
+    //   The expansion happens lazily on the next call to ExpandedCommands(),
+    //   because most of the time nobody asks for the expanded commands at all
+    //   and expanding them may create thousands of Command objects.
     void ActionMap::ExpandCommands(const IVectorView<Model::Profile>& profiles,
                                    const IMapView<winrt::hstring, Model::ColorScheme>& schemes)
     {
-        // TODO in review - It's a little weird to stash the expanded commands
-        // into a separate map. Is it possible to just replace the name map with
-        // the post-expanded commands?
-        //
-        // WHILE also making sure that upon re-saving the commands, we don't
-        // actually serialize the results of the expansion. I don't think it is.
+        // Take a snapshot of the arguments, so that the expansion
+        // reflects the settings at the time of this call.
+        std::vector<Model::Profile> profilesCopy;
+        profilesCopy.reserve(profiles.Size());
+        for (const auto& profile : profiles)
+        {
+            profilesCopy.push_back(profile);
+        }
 
         std::vector<Model::ColorScheme> sortedSchemes;
         sortedSchemes.reserve(schemes.Size());
@@ -928,6 +1050,21 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                   sortedSchemes.end(),
                   _compareSchemeNames);
 
+        const std::lock_guard guard{ _expandedCommandsMutex };
+        _expansionProfiles = std::move(profilesCopy);
+        _expansionSchemes = std::move(sortedSchemes);
+        _ExpandedCommandsCache = nullptr;
+    }
+
+    void ActionMap::_expandCommands()
+    {
+        // TODO in review - It's a little weird to stash the expanded commands
+        // into a separate map. Is it possible to just replace the name map with
+        // the post-expanded commands?
+        //
+        // WHILE also making sure that upon re-saving the commands, we don't
+        // actually serialize the results of the expansion. I don't think it is.
+
         auto copyOfCommands = winrt::single_threaded_map<winrt::hstring, Model::Command>();
 
         const auto& commandsToExpand{ NameMap() };
@@ -937,8 +1074,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
 
         implementation::Command::ExpandCommands(copyOfCommands,
-                                                profiles,
-                                                winrt::param::vector_view<Model::ColorScheme>{ sortedSchemes });
+                                                winrt::param::vector_view<Model::Profile>{ *_expansionProfiles },
+                                                winrt::param::vector_view<Model::ColorScheme>{ _expansionSchemes });
 
         _ExpandedCommandsCache = winrt::single_threaded_vector<Model::Command>();
         for (const auto& [_, command] : copyOfCommands)
@@ -948,6 +1085,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     }
     IVector<Model::Command> ActionMap::ExpandedCommands()
     {
+        const std::lock_guard guard{ _expandedCommandsMutex };
+        if (!_ExpandedCommandsCache && _expansionProfiles)
+        {
+            _expandCommands();
+        }
         return _ExpandedCommandsCache;
     }
 
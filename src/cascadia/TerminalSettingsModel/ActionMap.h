@@ -85,6 +85,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     private:
         std::optional<Model::Command> _GetActionByID(const InternalActionID actionID) const;
         std::optional<Model::Command> _GetActionByKeyChordInternal(const Control::KeyChord& keys) const;
+        std::optional<Model::Command> _GetActionByKeyChordCached(const Control::KeyChord& keys) const;
 
         void _RefreshKeyBindingCaches();
         void _PopulateAvailableActionsWithStandardCommands(std::unordered_map<hstring, Model::ActionAndArgs>& availableActions, std::unordered_set<InternalActionID>& visitedActionIDs) const;
@@ -98,6 +99,28 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void _TryUpdateKeyChord(const Model::Command& cmd, const Model::Command& oldCmd, const Model::Command& consolidatedCmd);
 
         void _recursiveUpdateCommandKeybindingLabels();
+        void _expandCommands();
+
+        // A flattened copy of the _KeyMap of this and all parent layers, which GetActionByKeyChord()
+        // uses instead of walking the layers and hashing KeyChord objects on every key press.
+        // It's an open-addressing hash table with linear probing, keyed by _PackKeyChord().
+        struct KeyChordTable
+        {
+            struct Entry
+            {
+                uint64_t key = 0; // 0 means unused
+                std::optional<Model::Command> cmd;
+            };
+
+            std::vector<Entry> entries;
+            int shift = 64;
+
+            const Entry* find(uint64_t key) const noexcept;
+        };
+
+        static uint64_t _PackKeyChord(const Control::KeyChord& keys);
+        std::shared_ptr<const KeyChordTable> _BuildKeyChordTable() const;
+        void _PopulateKeyChordTable(std::vector<std::pair<uint64_t, std::optional<Model::Command>>>& entries, std::unordered_set<uint64_t>& visited) const;
 
         Windows::Foundation::Collections::IMap<hstring, Model::ActionAndArgs> _AvailableActionsCache{ nullptr };
         Windows::Foundation::Collections::IMap<hstring, Model::Command> _NameMapCache{ nullptr };
@@ -105,6 +128,15 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _KeyBindingMapCache{ nullptr };
 
         Windows::Foundation::Collections::IVector<Model::Command> _ExpandedCommandsCache{ nullptr };
+        // Atomic, because the same settings (and thus ActionMap) are shared between the UI threads of all windows.
+        mutable std::atomic<std::shared_ptr<const KeyChordTable>> _KeyChordTableCache;
+        // The arguments of the last ExpandCommands() call. The expansion itself is deferred
+        // until ExpandedCommands() gets called, since it may create thousands of Commands.
+        // Just like _KeyChordTableCache, the expansion may be requested by multiple windows concurrently.
+        // _expandedCommandsMutex guards these two members and _ExpandedCommandsCache.
+        std::mutex _expandedCommandsMutex;
+        std::optional<std::vector<Model::Profile>> _expansionProfiles;
+        std::vector<Model::ColorScheme> _expansionSchemes;
 
         std::unordered_map<winrt::hstring, Model::Command> _NestedCommands;
         std::vector<Model::Command> _IterableCommands;
@@ -19,6 +19,14 @@ static constexpr std::string_view InitialPositionKey{ "initialPosition" };
 static constexpr std::string_view InitialSizeKey{ "initialSize" };
 static constexpr std::string_view LaunchModeKey{ "launchMode" };
 
+// Returns true if the file at `path` was last written at `expected`.
+static bool lastWriteTimeEquals(const std::filesystem::path& path, const FILETIME& expected) noexcept
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    return GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) &&
+           CompareFileTime(&data.ftLastWriteTime, &expected) == 0;
+}
+
 namespace Microsoft::Terminal::Settings::Model::JsonUtils
 {
     using namespace winrt::Microsoft::Terminal::Settings::Model;
@@ -130,6 +138,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         LOG_LAST_ERROR_IF(!DeleteFile(_sharedPath.c_str()));
         LOG_LAST_ERROR_IF(!DeleteFile(_elevatedPath.c_str()));
         *_state.lock() = {};
+        *_localSnapshot.lock() = {};
     }
     CATCH_LOG()
 
@@ -143,8 +152,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         std::string errs;
         std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder{}.newCharReader() };
 
+        const auto elevated = ::Microsoft::Console::Utils::IsRunningElevated();
+
         // First get shared state out of `state.json`.
-        const auto sharedData = _readSharedContents().value_or(std::string{});
+        // If we're unelevated, then that's also our Local state file.
+        FILETIME sharedLastWriteTime{};
+        auto sharedData = _readSharedContents(&sharedLastWriteTime).value_or(std::string{});
         if (!sharedData.empty())
         {
             Json::Value root;
@@ -157,13 +170,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             //   from state.json. We'll then load the Local props from
             //   `elevated-state.json`
             // - If we're unelevated, then load _everything_ from state.json.
-            if (::Microsoft::Console::Utils::IsRunningElevated())
+            if (elevated)
             {
                 // Only load shared properties if we're elevated
                 FromJson(root, FileSource::Shared);
 
                 // Then, try and get anything in elevated-state
-                if (const auto localData{ _readLocalContents().value_or(std::string{}) }; !localData.empty())
+                FILETIME localLastWriteTime{};
+                if (auto localData{ _readLocalContents(&localLastWriteTime).value_or(std::string{}) }; !localData.empty())
                 {
                     Json::Value root;
                     if (!reader->parse(localData.data(), localData.data() + localData.size(), &root, &errs))
@@ -171,12 +185,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                         throw winrt::hresult_error(WEB_E_INVALID_JSON_STRING, winrt::to_hstring(errs));
                     }
                     FromJson(root, FileSource::Local);
+                    *_localSnapshot.lock() = { std::move(localData), localLastWriteTime };
                 }
             }
             else
             {
                 // If we're unelevated, then load everything.
                 FromJson(root, FileSource::Shared | FileSource::Local);
+                *_localSnapshot.lock() = { std::move(sharedData), sharedLastWriteTime };
             }
         }
     }
@@ -223,8 +239,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                 }
             }
             // Layer our shared properties on top of the blob from state.json,
-            // and write it back out.
-            _writeSharedContents(Json::writeString(wbuilder, _toJsonWithBlob(root, FileSource::Shared)));
+            // and write it back out, unless that didn't change anything.
+            const auto content = Json::writeString(wbuilder, _toJsonWithBlob(root, FileSource::Shared));
+            if (content != sharedData)
+            {
+                _writeSharedContents(content);
+            }
 
             // Finally, write our Local properties back to elevated-state.json
             _writeLocalContents(Json::writeString(wbuilder, ToJson(FileSource::Local)));
@@ -332,9 +352,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - Read the contents of our "shared" state - state that should be shared
     //   for elevated and unelevated instances. This is things like the list of
     //   generated profiles, the command palette commandlines.
-    std::optional<std::string> ApplicationState::_readSharedContents() const
+    std::optional<std::string> ApplicationState::_readSharedContents(FILETIME* lastWriteTime) const
     {
-        return ReadUTF8FileIfExists(_sharedPath);
+        return ReadUTF8FileIfExists(_sharedPath, false, lastWriteTime);
     }
 
     // Method Description:
@@ -344,11 +364,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     //   those don't matter when unelevated).
     // - When elevated, this will DELETE `elevated-state.json` if it has bad
     //   permissions, so we don't potentially read malicious data.
-    std::optional<std::string> ApplicationState::_readLocalContents() const
+    std::optional<std::string> ApplicationState::_readLocalContents(FILETIME* lastWriteTime) const
     {
         return ::Microsoft::Console::Utils::IsRunningElevated() ?
-                   ReadUTF8FileIfExists(_elevatedPath, true) :
-                   ReadUTF8FileIfExists(_sharedPath, false);
+                   ReadUTF8FileIfExists(_elevatedPath, true, lastWriteTime) :
+                   ReadUTF8FileIfExists(_sharedPath, false, lastWriteTime);
     }
 
     // Method Description:
@@ -365,9 +385,24 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     //   separate files for elevated and unelevated instances. When elevated,
     //   this will write to `elevated-state.json`, and when unelevated, this
     //   will atomically write to `user-state.json`
+    // - The write is skipped if neither our serialized state nor the file
+    //   changed since we last read or wrote it. Most throttled writes are
+    //   triggered by setters that don't end up changing anything.
     void ApplicationState::_writeLocalContents(const std::string_view content) const
     {
-        if (::Microsoft::Console::Utils::IsRunningElevated())
+        const auto elevated = ::Microsoft::Console::Utils::IsRunningElevated();
+        const auto& path = elevated ? _elevatedPath : _sharedPath;
+
+        {
+            const auto snapshot = _localSnapshot.lock_shared();
+            if (snapshot->content == content && lastWriteTimeEquals(path, snapshot->lastWriteTime))
+            {
+                return;
+            }
+        }
+
+        FILETIME lastWriteTime{};
+        if (elevated)
         {
             // DON'T use WriteUTF8FileAtomic, which will write to a temporary file
             // then rename that file to the final filename. That actually lets us
@@ -378,12 +413,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             // We're not worried about someone else doing that though, if they do
             // that with the wrong permissions, then we'll just ignore the file and
             // start over.
-            WriteUTF8File(_elevatedPath, content, true);
+            WriteUTF8File(_elevatedPath, content, true, &lastWriteTime);
         }
         else
         {
-            WriteUTF8FileAtomic(_sharedPath, content);
+            WriteUTF8FileAtomic(_sharedPath, content, &lastWriteTime);
         }
+
+        *_localSnapshot.lock() = { std::string{ content }, lastWriteTime };
     }
 
 }
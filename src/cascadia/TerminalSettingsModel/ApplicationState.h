@@ -85,7 +85,15 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             MTSM_APPLICATION_STATE_FIELDS(MTSM_APPLICATION_STATE_GEN)
 #undef MTSM_APPLICATION_STATE_GEN
         };
+        // The contents of the Local state file as we last read or wrote it.
+        // Used by _writeLocalContents() to skip rewriting an unchanged file.
+        struct file_snapshot_t
+        {
+            std::string content;
+            FILETIME lastWriteTime{};
+        };
         til::shared_mutex<state_t> _state;
+        til::shared_mutex<file_snapshot_t> _localSnapshot;
         std::filesystem::path _sharedPath;
         std::filesystem::path _elevatedPath;
         til::throttled_func_trailing<> _throttler;
@@ -95,9 +103,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         Json::Value _toJsonWithBlob(Json::Value& root, FileSource parseSource) const noexcept;
 
-        std::optional<std::string> _readSharedContents() const;
+        std::optional<std::string> _readSharedContents(FILETIME* lastWriteTime = nullptr) const;
         void _writeSharedContents(const std::string_view content) const;
-        std::optional<std::string> _readLocalContents() const;
+        std::optional<std::string> _readLocalContents(FILETIME* lastWriteTime = nullptr) const;
         void _writeLocalContents(const std::string_view content) const;
     };
 }
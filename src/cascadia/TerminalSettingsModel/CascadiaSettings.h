@@ -57,6 +57,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static SettingsLoader Default(const std::string_view& userJSON, const std::string_view& inboxJSON);
         SettingsLoader(const std::string_view& userJSON, const std::string_view& inboxJSON);
 
+        void StartFragmentExtensionDiscovery();
         void GenerateProfiles();
         void ApplyRuntimeInitialSettings();
         void MergeInboxIntoUserSettings();
@@ -72,9 +73,18 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         bool duplicateProfile = false;
 
     private:
+        // The result of StartFragmentExtensionDiscovery(). Filled in on the thread pool and
+        // shared with it, so that it remains valid even if the loader is destroyed early.
+        struct FragmentExtensionDiscovery
+        {
+            til::latch latch{ 1 };
+            std::vector<std::pair<winrt::hstring, std::filesystem::path>> folders;
+        };
+
         struct JsonSettings
         {
-            Json::Value root;
+            // Shared, because the parsed inbox settings are cached across loads. See _parseInboxJson().
+            std::shared_ptr<const Json::Value> root;
             const Json::Value& colorSchemes;
             const Json::Value& profileDefaults;
             const Json::Value& profilesList;
@@ -89,13 +99,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void _parse(const OriginTag origin, const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings);
         void _parseFragment(const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings);
         static JsonSettings _parseJson(const std::string_view& content);
+        static JsonSettings _parseInboxJson(const std::string_view& content);
+        static JsonSettings _makeJsonSettings(std::shared_ptr<const Json::Value> root);
         static winrt::com_ptr<implementation::Profile> _parseProfile(const OriginTag origin, const winrt::hstring& source, const Json::Value& profileJson);
         void _appendProfile(winrt::com_ptr<Profile>&& profile, const winrt::guid& guid, ParsedSettings& settings);
         void _addUserProfileParent(const winrt::com_ptr<implementation::Profile>& profile);
         void _addOrMergeUserColorScheme(const winrt::com_ptr<implementation::ColorScheme>& colorScheme);
-        void _executeGenerator(const IDynamicProfileGenerator& generator);
+        void _appendGeneratedProfiles(const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>& profiles);
 
         std::unordered_set<std::wstring_view> _ignoredNamespaces;
+        std::shared_ptr<FragmentExtensionDiscovery> _fragmentExtensionDiscovery;
         // See _getNonUserOriginProfiles().
         size_t _userProfileCount = 0;
     };
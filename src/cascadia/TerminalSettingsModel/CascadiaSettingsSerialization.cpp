@@ -69,28 +69,6 @@ static constexpr std::wstring_view AppExtensionHostName{ L"com.microsoft.windows
 static constexpr winrt::guid DEFAULT_WINDOWS_POWERSHELL_GUID{ 0x61c54bbd, 0xc2c6, 0x5271, { 0x96, 0xe7, 0x00, 0x9a, 0x87, 0xff, 0x44, 0xbf } };
 static constexpr winrt::guid DEFAULT_COMMAND_PROMPT_GUID{ 0x0caa0dad, 0x35be, 0x5f56, { 0xa8, 0xff, 0xaf, 0xce, 0xee, 0xaa, 0x61, 0x01 } };
 
-// Function Description:
-// - Extracting the value from an async task (like talking to the app catalog) when we are on the
-//   UI thread causes C++/WinRT to complain quite loudly (and halt execution!)
-//   This templated function extracts the result from a task with chicanery.
-template<typename TTask>
-static auto extractValueFromTaskWithoutMainThreadAwait(TTask&& task) -> decltype(task.get())
-{
-    std::optional<decltype(task.get())> finalVal;
-    til::latch latch{ 1 };
-
-    const auto _ = [&]() -> winrt::fire_and_forget {
-        const auto cleanup = wil::scope_exit([&]() {
-            latch.count_down();
-        });
-        co_await winrt::resume_background();
-        finalVal.emplace(co_await task);
-    }();
-
-    latch.wait();
-    return finalVal.value();
-}
-
 // Concatenates the two given strings (!) and returns them as a path.
 // You better make sure there's a path separator at the end of lhs or at the start of rhs.
 static std::filesystem::path buildPath(const std::wstring_view& lhs, const std::wstring_view& rhs)
@@ -156,17 +134,135 @@ SettingsLoader::SettingsLoader(const std::string_view& userJSON, const std::stri
     _userProfileCount = userSettings.profiles.size();
 }
 
+// Querying the app extension catalog for settings fragments (and each extension's public folder) is by far the slowest
+// part of FindFragmentsAndMergeIntoUserSettings(). It doesn't depend on any of the settings however, so this kicks it off
+// on the thread pool, allowing it to overlap with GenerateProfiles(). FindFragmentsAndMergeIntoUserSettings() picks up the result.
+void SettingsLoader::StartFragmentExtensionDiscovery()
+{
+    _fragmentExtensionDiscovery = std::make_shared<FragmentExtensionDiscovery>();
+
+    [](std::shared_ptr<FragmentExtensionDiscovery> discovery) -> winrt::fire_and_forget {
+        const auto cleanup = wil::scope_exit([&]() {
+            discovery->latch.count_down();
+        });
+        co_await winrt::resume_background();
+
+        // GH#12305: Open() can throw an 0x80070490 "Element not found.".
+        // It's unclear to me under which circumstances this happens as no one on the team
+        // was able to reproduce the user's issue, even if the application was run unpackaged.
+        // The error originates from `CallerIdentity::GetCallingProcessAppId` which returns E_NOT_SET.
+        // A comment can be found, reading:
+        // > Gets the "strong" AppId from the process token. This works for UWAs and Centennial apps,
+        // > strongly named processes where the AppId is stored securely in the process token. [...]
+        // > E_NOT_SET is returned for processes without strong AppIds.
+        IVectorView<AppExtension> extensions;
+        try
+        {
+            const auto catalog = AppExtensionCatalog::Open(AppExtensionHostName);
+            extensions = co_await catalog.FindAllAsync();
+        }
+        CATCH_LOG();
+
+        if (!extensions)
+        {
+            co_return;
+        }
+
+        for (const auto& ext : extensions)
+        {
+            try
+            {
+                const auto packageName = ext.Package().Id().FamilyName();
+
+                // Likewise, getting the public folder from an extension is an async operation.
+                const auto foundFolder = co_await ext.GetPublicFolderAsync();
+                if (!foundFolder)
+                {
+                    continue;
+                }
+
+                // the StorageFolder class has its own methods for obtaining the files within the folder
+                // however, all those methods are Async methods
+                // so for now we will just take the folder path and access the files that way
+                auto path = buildPath(foundFolder.Path(), FragmentsSubDirectory);
+
+                if (std::filesystem::is_directory(path))
+                {
+                    discovery->folders.emplace_back(packageName, std::move(path));
+                }
+            }
+            CATCH_LOG();
+        }
+    }(_fragmentExtensionDiscovery);
+}
+
 // Generate dynamic profiles and add them to the list of "inbox" profiles
 // (meaning profiles specified by the application rather by the user).
 void SettingsLoader::GenerateProfiles()
 {
-    _executeGenerator(PowershellCoreProfileGenerator{});
-    _executeGenerator(WslDistroGenerator{});
-    _executeGenerator(AzureCloudShellGenerator{});
-    _executeGenerator(VisualStudioGenerator{});
+    TIL_TRACE_STARTUP_PHASE(g_hSettingsModelProvider, "ProfileGenerationStarted");
+
+    const PowershellCoreProfileGenerator powershellCoreGenerator;
+    const WslDistroGenerator wslDistroGenerator;
+    const AzureCloudShellGenerator azureCloudShellGenerator;
+    const VisualStudioGenerator visualStudioGenerator;
 #if TIL_FEATURE_DYNAMICSSHPROFILES_ENABLED
-    _executeGenerator(SshHostGenerator{});
+    const SshHostGenerator sshHostGenerator;
 #endif
+
+    const IDynamicProfileGenerator* generators[]{
+        &powershellCoreGenerator,
+        &wslDistroGenerator,
+        &azureCloudShellGenerator,
+        &visualStudioGenerator,
+#if TIL_FEATURE_DYNAMICSSHPROFILES_ENABLED
+        &sshHostGenerator,
+#endif
+    };
+
+    // Some generators take a noticeable amount of time, because they enumerate installations (registry keys, VS setup
+    // instances, etc.). They're independent of each other however, so we run them concurrently on the thread pool.
+    // Their results are merged in the order above afterwards, so that the list of profiles remains deterministic.
+    std::vector<winrt::com_ptr<implementation::Profile>> results[std::size(generators)];
+    til::latch latch{ static_cast<ptrdiff_t>(std::size(generators)) };
+
+    for (size_t i = 0; i < std::size(generators); ++i)
+    {
+        const auto& generator = *til::at(generators, i);
+
+        if (_ignoredNamespaces.count(generator.GetNamespace()))
+        {
+            latch.count_down();
+            continue;
+        }
+
+        // Everything is passed as a parameter, because the lambda (and its captures)
+        // doesn't outlive this statement, while the coroutine frame does.
+        [](const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>& profiles, til::latch& latch) -> winrt::fire_and_forget {
+            const auto cleanup = wil::scope_exit([&]() {
+                latch.count_down();
+            });
+            co_await winrt::resume_background();
+
+            try
+            {
+                // Some generators use COM (the VisualStudioGenerator queries the VS setup configuration for instance),
+                // but a thread pool thread is only in the MTA implicitly, if at all. Don't rely on that.
+                const auto coUninitialize = wil::CoInitializeEx(COINIT_MULTITHREADED);
+                generator.GenerateProfiles(profiles);
+            }
+            CATCH_LOG_MSG("Dynamic Profile Namespace: \"%.*s\"", gsl::narrow<int>(generator.GetNamespace().size()), generator.GetNamespace().data())
+        }(generator, til::at(results, i), latch);
+    }
+
+    latch.wait();
+
+    for (size_t i = 0; i < std::size(generators); ++i)
+    {
+        _appendGeneratedProfiles(*til::at(generators, i), til::at(results, i));
+    }
+
+    TIL_TRACE_STARTUP_PHASE(g_hSettingsModelProvider, "ProfileGenerationCompleted");
 }
 
 // A new settings.json gets a special treatment:
@@ -267,51 +363,17 @@ void SettingsLoader::FindFragmentsAndMergeIntoUserSettings()
 
     // Search through app extensions.
     // Gets the catalog of extensions with the name "com.microsoft.windows.terminal.settings".
-    //
-    // GH#12305: Open() can throw an 0x80070490 "Element not found.".
-    // It's unclear to me under which circumstances this happens as no one on the team
-    // was able to reproduce the user's issue, even if the application was run unpackaged.
-    // The error originates from `CallerIdentity::GetCallingProcessAppId` which returns E_NOT_SET.
-    // A comment can be found, reading:
-    // > Gets the "strong" AppId from the process token. This works for UWAs and Centennial apps,
-    // > strongly named processes where the AppId is stored securely in the process token. [...]
-    // > E_NOT_SET is returned for processes without strong AppIds.
-    IVectorView<AppExtension> extensions;
-    try
+    // See StartFragmentExtensionDiscovery().
+    if (!_fragmentExtensionDiscovery)
     {
-        const auto catalog = AppExtensionCatalog::Open(AppExtensionHostName);
-        extensions = extractValueFromTaskWithoutMainThreadAwait(catalog.FindAllAsync());
+        StartFragmentExtensionDiscovery();
     }
-    CATCH_LOG();
 
-    if (!extensions)
-    {
-        return;
-    }
+    _fragmentExtensionDiscovery->latch.wait();
 
-    for (const auto& ext : extensions)
+    for (const auto& [packageName, path] : _fragmentExtensionDiscovery->folders)
     {
-        const auto packageName = ext.Package().Id().FamilyName();
-        if (_ignoredNamespaces.count(std::wstring_view{ packageName }))
-        {
-            continue;
-        }
-
-        // Likewise, getting the public folder from an extension is an async operation.
-        auto foundFolder = extractValueFromTaskWithoutMainThreadAwait(ext.GetPublicFolderAsync());
-        if (!foundFolder)
-        {
-            continue;
-        }
-
-        // the StorageFolder class has its own methods for obtaining the files within the folder
-        // however, all those methods are Async methods
-        // you may have noticed that we need to resort to clunky implementations for async operations
-        // (they are in extractValueFromTaskWithoutMainThreadAwait)
-        // so for now we will just take the folder path and access the files that way
-        const auto path = buildPath(foundFolder.Path(), FragmentsSubDirectory);
-
-        if (std::filesystem::is_directory(path))
+        if (!_ignoredNamespaces.count(std::wstring_view{ packageName }))
         {
             parseAndLayerFragmentFiles(path, packageName);
         }
@@ -345,7 +407,7 @@ void SettingsLoader::FinalizeLayering()
     if (userSettings.globals->EnableColorSelection())
     {
         const auto json = _parseJson(LoadStringResource(IDR_ENABLE_COLOR_SELECTION));
-        const auto globals = GlobalAppSettings::FromJson(json.root, OriginTag::InBox);
+        const auto globals = GlobalAppSettings::FromJson(*json.root, OriginTag::InBox);
         userSettings.globals->AddLeastImportantParent(globals);
     }
 
@@ -567,9 +629,16 @@ void SettingsLoader::_rethrowSerializationExceptionWithLocationInfo(const JsonUt
 // Simply parses the given content to a Json::Value.
 Json::Value SettingsLoader::_parseJSON(const std::string_view& content)
 {
+    // By default JsonCpp retains every comment and attaches it to the nearby Json::Value,
+    // which costs an allocation per comment. We never serialize the DOM back (ToJson()
+    // builds a new one from the model) so this is pure overhead for heavily commented files.
+    // Parse errors still have their location info, as that doesn't depend on this setting.
+    Json::CharReaderBuilder builder;
+    builder["collectComments"] = false;
+    const std::unique_ptr<Json::CharReader> reader{ builder.newCharReader() };
+
     Json::Value json;
     std::string errs;
-    const std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder{}.newCharReader() };
 
     if (!reader->parse(content.data(), content.data() + content.size(), &json, &errs))
     {
@@ -610,12 +679,12 @@ std::span<const winrt::com_ptr<Profile>> SettingsLoader::_getNonUserOriginProfil
 // This function is to be used for user settings files.
 void SettingsLoader::_parse(const OriginTag origin, const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings)
 {
-    const auto json = _parseJson(content);
+    const auto json = origin == OriginTag::InBox ? _parseInboxJson(content) : _parseJson(content);
 
     settings.clear();
 
     {
-        settings.globals = GlobalAppSettings::FromJson(json.root, origin);
+        settings.globals = GlobalAppSettings::FromJson(*json.root, origin);
 
         for (const auto& schemeJson : json.colorSchemes)
         {
@@ -703,7 +772,7 @@ void SettingsLoader::_parseFragment(const winrt::hstring& source, const std::str
         // Parse out actions from the fragment. Manually opt-out of keybinding
         // parsing - fragments shouldn't be allowed to bind actions to keys
         // directly. We may want to revisit circa GH#2205
-        settings.globals->LayerActionsFrom(json.root, OriginTag::Fragment, false);
+        settings.globals->LayerActionsFrom(*json.root, OriginTag::Fragment, false);
     }
 
     {
@@ -761,10 +830,42 @@ void SettingsLoader::_parseFragment(const winrt::hstring& source, const std::str
 
 SettingsLoader::JsonSettings SettingsLoader::_parseJson(const std::string_view& content)
 {
-    auto root = content.empty() ? Json::Value{ Json::ValueType::objectValue } : _parseJSON(content);
-    const auto& colorSchemes = _getJSONValue(root, SchemesKey);
-    const auto& themes = _getJSONValue(root, ThemesKey);
-    const auto& profilesObject = _getJSONValue(root, ProfilesKey);
+    return _makeJsonSettings(std::make_shared<const Json::Value>(content.empty() ? Json::Value{ Json::ValueType::objectValue } : _parseJSON(content)));
+}
+
+// The inbox settings (defaults.json) don't change during the lifetime of the process, but LoadAll() runs
+// on every settings reload. This caches the parsed document of the most recent inbox JSON, so that
+// subsequent loads only need to deserialize it. The document is immutable once it's in the cache.
+SettingsLoader::JsonSettings SettingsLoader::_parseInboxJson(const std::string_view& content)
+{
+    static wil::srwlock lock;
+    static std::string cachedContent;
+    static std::shared_ptr<const Json::Value> cachedRoot;
+
+    {
+        const auto guard = lock.lock_shared();
+        if (cachedRoot && cachedContent == content)
+        {
+            return _makeJsonSettings(cachedRoot);
+        }
+    }
+
+    auto json = _parseJson(content);
+
+    {
+        const auto guard = lock.lock_exclusive();
+        cachedContent = content;
+        cachedRoot = json.root;
+    }
+
+    return json;
+}
+
+SettingsLoader::JsonSettings SettingsLoader::_makeJsonSettings(std::shared_ptr<const Json::Value> root)
+{
+    const auto& colorSchemes = _getJSONValue(*root, SchemesKey);
+    const auto& themes = _getJSONValue(*root, ThemesKey);
+    const auto& profilesObject = _getJSONValue(*root, ProfilesKey);
     const auto& profileDefaults = _getJSONValue(profilesObject, DefaultSettingsKey);
     const auto& profilesList = profilesObject.isArray() ? profilesObject : _getJSONValue(profilesObject, ProfilesListKey);
     return JsonSettings{ std::move(root), colorSchemes, profileDefaults, profilesList, themes };
@@ -889,33 +990,22 @@ void SettingsLoader::_addOrMergeUserColorScheme(const winrt::com_ptr<implementat
 
 // As the name implies it executes a generator.
 // Generated profiles are added to .inboxSettings. Used by GenerateProfiles().
-void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator)
+void SettingsLoader::_appendGeneratedProfiles(const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>& profiles)
 {
-    const auto generatorNamespace = generator.GetNamespace();
-    if (_ignoredNamespaces.count(generatorNamespace))
+    if (profiles.empty())
     {
         return;
     }
 
-    const auto previousSize = inboxSettings.profiles.size();
-
-    try
-    {
-        generator.GenerateProfiles(inboxSettings.profiles);
-    }
-    CATCH_LOG_MSG("Dynamic Profile Namespace: \"%.*s\"", gsl::narrow<int>(generatorNamespace.size()), generatorNamespace.data())
-
     // If the generator produced some profiles we're going to give them default attributes.
     // By setting the Origin/Source/etc. here, we deduplicate some code and ensure they aren't missing accidentally.
-    if (inboxSettings.profiles.size() > previousSize)
-    {
-        const winrt::hstring source{ generatorNamespace };
+    const winrt::hstring source{ generator.GetNamespace() };
 
-        for (const auto& profile : std::span(inboxSettings.profiles).subspan(previousSize))
-        {
-            profile->Origin(OriginTag::Generated);
-            profile->Source(source);
-        }
+    for (auto& profile : profiles)
+    {
+        profile->Origin(OriginTag::Generated);
+        profile->Source(source);
+        inboxSettings.profiles.emplace_back(std::move(profile));
     }
 }
 
@@ -976,6 +1066,9 @@ try
 
     SettingsLoader loader{ settingsStringView, LoadStringResource(IDR_DEFAULTS) };
 
+    // Looking up fragment extensions takes a while, but can run concurrently with the profile generators.
+    loader.StartFragmentExtensionDiscovery();
+
     // Generate dynamic profiles and add them as parents of user profiles.
     // That way the user profiles will get appropriate defaults from the generators (like icons and such).
     loader.GenerateProfiles();
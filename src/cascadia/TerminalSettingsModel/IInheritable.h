@@ -114,26 +114,35 @@ public:                                                                     \
 private:                                                                    \
     storageType _##name{ std::nullopt };                                    \
                                                                             \
-    storageType _get##name##Impl() const                                    \
+    /* Returns a pointer to the closest set value in the hierarchy */       \
+    /* Compared to returning a copy, this avoids copying the value */       \
+    /* (like hstrings or vectors) once for every level of the hierarchy. */ \
+    const storageType* _find##name() const                                  \
     {                                                                       \
         /*return user set value*/                                           \
         if (_##name)                                                        \
         {                                                                   \
-            return _##name;                                                 \
+            return &_##name;                                                \
         }                                                                   \
                                                                             \
         /*user set value was not set*/                                      \
         /*iterate through parents to find a value*/                         \
         for (const auto& parent : _parents)                                 \
         {                                                                   \
-            if (auto val{ parent->_get##name##Impl() })                     \
+            if (const auto val{ parent->_find##name() })                    \
             {                                                               \
                 return val;                                                 \
             }                                                               \
         }                                                                   \
                                                                             \
         /*no value was found*/                                              \
-        return std::nullopt;                                                \
+        return nullptr;                                                     \
+    }                                                                       \
+                                                                            \
+    storageType _get##name##Impl() const                                    \
+    {                                                                       \
+        const auto val{ _find##name() };                                    \
+        return val ? *val : std::nullopt;                                   \
     }                                                                       \
                                                                             \
     projectedType _get##name##OverrideSourceImpl() const                    \
@@ -175,8 +184,8 @@ public:                                                                      \
     /* fallback: user set value --> inherited value --> system set value */  \
     type name() const                                                        \
     {                                                                        \
-        const auto val{ _get##name##Impl() };                                \
-        return val ? *val : type{ __VA_ARGS__ };                             \
+        const auto val{ _find##name() };                                     \
+        return val ? **val : type{ __VA_ARGS__ };                            \
     }                                                                        \
                                                                              \
     /* Overwrite the user set value */                                       \
@@ -196,12 +205,12 @@ public:                                                                        \
     /* fallback: user set value --> inherited value --> system set value */    \
     winrt::Windows::Foundation::IReference<type> name() const                  \
     {                                                                          \
-        const auto val{ _get##name##Impl() };                                  \
+        const auto val{ _find##name() };                                       \
         if (val)                                                               \
         {                                                                      \
-            if (*val)                                                          \
+            if (const auto& inner{ **val })                                    \
             {                                                                  \
-                return **val;                                                  \
+                return *inner;                                                 \
             }                                                                  \
             return nullptr;                                                    \
         }                                                                      \
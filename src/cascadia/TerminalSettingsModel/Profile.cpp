@@ -365,8 +365,8 @@ void Profile::Icon(const winrt::hstring& value)
 }
 winrt::hstring Profile::Icon() const
 {
-    const auto val{ _getIconImpl() };
-    return val ? *val : hstring{ L"\uE756" };
+    const auto val{ _findIcon() };
+    return val ? **val : hstring{ L"\uE756" };
 }
 
 winrt::hstring Profile::EvaluatedIcon()
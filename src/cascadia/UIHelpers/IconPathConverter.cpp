@@ -219,9 +219,9 @@ namespace winrt::Microsoft::Terminal::UI::implementation
         return softwareBitmap;
     }
 
-    static SoftwareBitmap _getBitmapFromIconFileAsync(const winrt::hstring& iconPath,
-                                                      int32_t iconIndex,
-                                                      uint32_t iconSize)
+    static SoftwareBitmap _extractBitmapFromIconFile(const winrt::hstring& iconPath,
+                                                     int32_t iconIndex,
+                                                     uint32_t iconSize)
     {
         wil::unique_hicon hicon;
         LOG_IF_FAILED(SHDefExtractIcon(iconPath.c_str(), iconIndex, 0, &hicon, nullptr, iconSize));
@@ -240,6 +240,52 @@ namespace winrt::Microsoft::Terminal::UI::implementation
                                         wicImagingFactory.get());
     }
 
+    // Method Description:
+    // - Same as _extractBitmapFromIconFile(), but the decoded bitmaps are cached.
+    //   Extracting icons out of binaries is fairly expensive (it has to load the
+    //   file's resources and round-trip through WIC), and the same handful of
+    //   icons are requested over and over again by the new tab dropdown, the
+    //   tab headers and the command palette. The cache is keyed by the path,
+    //   the icon index and size, and the last write time of the file, so that
+    //   an updated binary will have its icon extracted anew.
+    static SoftwareBitmap _getBitmapFromIconFile(const winrt::hstring& iconPath,
+                                                 int32_t iconIndex,
+                                                 uint32_t iconSize)
+    {
+        struct CachedBitmap
+        {
+            FILETIME lastWriteTime{};
+            SoftwareBitmap bitmap{ nullptr };
+        };
+
+        static std::mutex cacheMutex;
+        static std::unordered_map<std::wstring, CachedBitmap> cache;
+
+        WIN32_FILE_ATTRIBUTE_DATA attributes{};
+        if (!GetFileAttributesExW(iconPath.c_str(), GetFileExInfoStandard, &attributes))
+        {
+            // The file may not exist (yet). Don't remember anything about it.
+            return _extractBitmapFromIconFile(iconPath, iconIndex, iconSize);
+        }
+
+        auto key = std::wstring{ iconPath };
+        key.append(L"|").append(std::to_wstring(iconIndex)).append(L"|").append(std::to_wstring(iconSize));
+
+        {
+            const std::lock_guard lock{ cacheMutex };
+            if (const auto it = cache.find(key); it != cache.end() && CompareFileTime(&it->second.lastWriteTime, &attributes.ftLastWriteTime) == 0)
+            {
+                return it->second.bitmap;
+            }
+        }
+
+        auto bitmap = _extractBitmapFromIconFile(iconPath, iconIndex, iconSize);
+
+        const std::lock_guard lock{ cacheMutex };
+        cache.insert_or_assign(std::move(key), CachedBitmap{ attributes.ftLastWriteTime, bitmap });
+        return bitmap;
+    }
+
     // Method Description:
     // - Attempt to get the icon index from the icon path provided
     // Arguments:
@@ -292,7 +338,7 @@ namespace winrt::Microsoft::Terminal::UI::implementation
         // * C:\Program Files\PowerShell\6-preview\pwsh.exe, 0 (this doesn't exist for me)
         // * C:\Program Files\PowerShell\7\pwsh.exe, 0
 
-        const auto swBitmap{ _getBitmapFromIconFileAsync(winrt::hstring{ iconPathWithoutIndex }, index, 32) };
+        const auto swBitmap{ _getBitmapFromIconFile(winrt::hstring{ iconPathWithoutIndex }, index, 32) };
         if (swBitmap == nullptr)
         {
             return nullptr;
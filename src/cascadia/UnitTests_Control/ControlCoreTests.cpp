@@ -37,6 +37,8 @@ namespace ControlUnitTests
         TEST_METHOD(TestClearScreen);
         TEST_METHOD(TestClearAll);
         TEST_METHOD(TestReadEntireBuffer);
+        TEST_METHOD(TestExportBufferToFile);
+        TEST_METHOD(TestPasteTextChunkBoundary);
 
         TEST_METHOD(TestSelectCommandSimple);
         TEST_METHOD(TestSelectOutputSimple);
@@ -371,6 +373,61 @@ namespace ControlUnitTests
         VERIFY_ARE_EQUAL(L"This is some text\r\nwith varying amounts\r\nof whitespace\r\n",
                          core->ReadEntireBuffer());
     }
+
+    void ControlCoreTests::TestExportBufferToFile()
+    {
+        auto [settings, conn] = _createSettingsAndConnection();
+        Log::Comment(L"Create ControlCore object");
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        Log::Comment(L"Print some text");
+        conn->WriteInput(L"This is some text     \r\n");
+        conn->WriteInput(L"with varying amounts  \r\n");
+        conn->WriteInput(L"of whitespace         \r\n");
+
+        Log::Comment(L"Export the buffer and check the file contents");
+        const auto path = std::filesystem::temp_directory_path() / L"ControlCoreTests_TestExportBufferToFile.txt";
+        core->ExportBufferToFile(winrt::hstring{ path.native() }).get();
+
+        std::string content;
+        {
+            std::ifstream file{ path, std::ios::binary };
+            content.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+        }
+        std::filesystem::remove(path);
+
+        VERIFY_ARE_EQUAL(L"This is some text\r\nwith varying amounts\r\nof whitespace\r\n",
+                         winrt::hstring{ til::u8u16(content) });
+    }
+
+    void ControlCoreTests::TestPasteTextChunkBoundary()
+    {
+        // Must match PasteChunkSize in ControlCore.cpp.
+        static constexpr size_t pasteChunkSize = 64 * 1024;
+
+        auto [settings, conn] = _createSettingsAndConnection();
+        Log::Comment(L"Create ControlCore object");
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        // The MockConnection echoes everything written to it.
+        std::wstring sent;
+        conn->TerminalOutput([&](const winrt::hstring& str) {
+            sent.append(str);
+        });
+
+        Log::Comment(L"Paste a \\r\\r\\n whose first \\r is the last character of the first chunk");
+        std::wstring text(pasteChunkSize - 1, L'a');
+        text.append(L"\r\r\nb");
+        core->PasteText(winrt::hstring{ text });
+
+        std::wstring expected(pasteChunkSize - 1, L'a');
+        expected.append(L"\r\rb");
+        VERIFY_ARE_EQUAL(expected, sent);
+    }
     void _writePrompt(const winrt::com_ptr<MockConnection>& conn, const auto& path)
     {
         conn->WriteInput(L"\x1b]133;D\x7");
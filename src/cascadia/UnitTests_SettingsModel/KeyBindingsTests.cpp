@@ -31,6 +31,7 @@ namespace SettingsModelUnitTests
         TEST_METHOD(UnbindKeybindings);
         TEST_METHOD(LayerScancodeKeybindings);
         TEST_METHOD(TestExplicitUnbind);
+        TEST_METHOD(TestLayeredKeyChordLookup);
         TEST_METHOD(TestArbitraryArgs);
         TEST_METHOD(TestSplitPaneArgs);
         TEST_METHOD(TestStringOverload);
@@ -281,6 +282,65 @@ namespace SettingsModelUnitTests
         VERIFY_IS_FALSE(actionMap->IsKeyChordExplicitlyUnbound(keyChord));
     }
 
+    void KeyBindingsTests::TestLayeredKeyChordLookup()
+    {
+        // Enough bindings to make the flattened lookup table grow past its initial size.
+        std::string parentString{ "[" };
+        for (auto ch = 'a'; ch <= 't'; ++ch)
+        {
+            parentString += R"({ "command": "copy", "keys": ["ctrl+)";
+            parentString += ch;
+            parentString += R"("] },)";
+        }
+        parentString += R"({ "command": "paste", "keys": ["sc(41)"] } ])";
+        const std::string childString{ R"([
+            { "command": "unbound", "keys": ["ctrl+c"] },
+            { "command": "paste", "keys": ["ctrl+z"] }
+        ])" };
+
+        const auto parentJson = VerifyParseSucceeded(parentString);
+        const auto childJson = VerifyParseSucceeded(childString);
+
+        const auto parent = winrt::make_self<implementation::ActionMap>();
+        parent->LayerJson(parentJson, OriginTag::InBox);
+        const auto child = winrt::make_self<implementation::ActionMap>();
+        child->AddLeastImportantParent(parent);
+        child->LayerJson(childJson, OriginTag::User);
+
+        for (auto ch = 'A'; ch <= 'T'; ++ch)
+        {
+            const KeyChord keyChord{ VirtualKeyModifiers::Control, static_cast<int32_t>(ch), 0 };
+            const auto cmd = child->GetActionByKeyChord(keyChord);
+            if (ch == 'C')
+            {
+                VERIFY_IS_NULL(cmd);
+                VERIFY_IS_TRUE(child->IsKeyChordExplicitlyUnbound(keyChord));
+            }
+            else
+            {
+                VERIFY_IS_NOT_NULL(cmd);
+                VERIFY_ARE_EQUAL(ShortcutAction::CopyText, cmd.ActionAndArgs().Action());
+            }
+        }
+
+        const auto paste = child->GetActionByKeyChord({ VirtualKeyModifiers::Control, static_cast<int32_t>('Z'), 0 });
+        VERIFY_IS_NOT_NULL(paste);
+        VERIFY_ARE_EQUAL(ShortcutAction::PasteText, paste.ActionAndArgs().Action());
+
+        Log::Comment(L"Scan code bindings must not collide with vkey bindings of the same value");
+        VERIFY_IS_NULL(child->GetActionByKeyChord({ VirtualKeyModifiers::None, 41, 0 }));
+        VERIFY_IS_NOT_NULL(child->GetActionByKeyChord({ VirtualKeyModifiers::None, 0, 41 }));
+
+        Log::Comment(L"Chords that aren't bound anywhere aren't explicitly unbound either");
+        const KeyChord unboundChord{ VirtualKeyModifiers::Control | VirtualKeyModifiers::Shift, static_cast<int32_t>('A'), 0 };
+        VERIFY_IS_NULL(child->GetActionByKeyChord(unboundChord));
+        VERIFY_IS_FALSE(child->IsKeyChordExplicitlyUnbound(unboundChord));
+
+        Log::Comment(L"Adding an action invalidates the lookup table");
+        child->LayerJson(VerifyParseSucceeded(R"([ { "command": "paste", "keys": ["ctrl+a"] } ])"), OriginTag::User);
+        VERIFY_ARE_EQUAL(ShortcutAction::PasteText, child->GetActionByKeyChord({ VirtualKeyModifiers::Control, static_cast<int32_t>('A'), 0 }).ActionAndArgs().Action());
+    }
+
     void KeyBindingsTests::TestArbitraryArgs()
     {
         const std::string bindings0String{ R"([
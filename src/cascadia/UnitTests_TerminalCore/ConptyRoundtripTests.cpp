@@ -4372,8 +4372,8 @@ void ConptyRoundtripTests::SimplePromptRegions()
 
         const auto& row0 = tb.GetRowByOffset(0);
         const auto& row4 = tb.GetRowByOffset(4);
-        VERIFY_IS_TRUE(row0.GetScrollbarData().has_value());
-        VERIFY_IS_TRUE(row4.GetScrollbarData().has_value());
+        VERIFY_IS_NOT_NULL(row0.GetScrollbarData());
+        VERIFY_IS_NOT_NULL(row4.GetScrollbarData());
 
         const auto marks = tb.GetMarkExtents();
         VERIFY_ARE_EQUAL(2u, marks.size());
@@ -4469,8 +4469,8 @@ void ConptyRoundtripTests::MultilinePromptRegions()
 
         const auto& row0 = tb.GetRowByOffset(0);
         const auto& row5 = tb.GetRowByOffset(5);
-        VERIFY_IS_TRUE(row0.GetScrollbarData().has_value());
-        VERIFY_IS_TRUE(row5.GetScrollbarData().has_value());
+        VERIFY_IS_NOT_NULL(row0.GetScrollbarData());
+        VERIFY_IS_NOT_NULL(row5.GetScrollbarData());
 
         const auto marks = tb.GetMarkExtents();
         VERIFY_ARE_EQUAL(2u, marks.size());
@@ -51,6 +51,8 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestGetReverseTab);
 
+    TEST_METHOD(TestPatternCache);
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         // STEP 1: Set up the Terminal
@@ -70,6 +72,8 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 private:
     void _SetTabStops(std::list<til::CoordType> columns, bool replace);
     std::list<til::CoordType> _GetTabStops();
+    std::vector<std::pair<til::point, til::point>> _GetPatterns();
+    void _VerifyPatterns(const std::vector<std::pair<til::point, til::point>>& expected);
 
     std::unique_ptr<DummyRenderer> emptyRenderer;
     std::unique_ptr<Terminal> term;
@@ -594,3 +598,63 @@ void TerminalBufferTests::TestGetReverseTab()
                          L"Cursor adjusted to last item in the sample list from position beyond end.");
     }
 }
+
+std::vector<std::pair<til::point, til::point>> TerminalBufferTests::_GetPatterns()
+{
+    std::vector<std::pair<til::point, til::point>> patterns;
+    term->_patternIntervalTree.visit_all([&](const auto& interval) {
+        patterns.emplace_back(interval.start, interval.stop);
+    });
+    std::ranges::sort(patterns);
+    return patterns;
+}
+
+void TerminalBufferTests::_VerifyPatterns(const std::vector<std::pair<til::point, til::point>>& expected)
+{
+    const auto actual = _GetPatterns();
+    VERIFY_ARE_EQUAL(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        VERIFY_ARE_EQUAL(expected[i].first, actual[i].first);
+        VERIFY_ARE_EQUAL(expected[i].second, actual[i].second);
+    }
+}
+
+void TerminalBufferTests::TestPatternCache()
+{
+    auto& termSm = *term->_stateMachine;
+
+    term->_detectURLs = true;
+    termSm.ProcessString(L"https://example.com/a\r\nno url here\r\nhttps://example.com/b");
+    term->UpdatePatternsUnderLock();
+
+    // The intervals are viewport-relative and half-open.
+    std::vector<std::pair<til::point, til::point>> expected{
+        { { 0, 0 }, { 21, 0 } },
+        { { 0, 2 }, { 21, 2 } },
+    };
+    _VerifyPatterns(expected);
+
+    Log::Comment(L"Nothing changed: The cached matches should be returned as is.");
+    VERIFY_IS_NOT_NULL(term->_patternCacheBuffer);
+    VERIFY_ARE_EQUAL(2u, term->_patternCache.size());
+    term->UpdatePatternsUnderLock();
+    _VerifyPatterns(expected);
+
+    Log::Comment(L"Only the changed row should be scanned again, while the others keep their matches.");
+    termSm.ProcessString(L"\x1b[2;1Hhttps://example.com/c");
+    term->UpdatePatternsUnderLock();
+    expected.insert(expected.begin() + 1, { { 0, 1 }, { 21, 1 } });
+    _VerifyPatterns(expected);
+
+    Log::Comment(L"Changing the set of patterns must drop the cache.");
+    term->_detectURLs = false;
+    term->_updateUrlDetection();
+    VERIFY_IS_NULL(term->_patternCacheBuffer);
+    VERIFY_ARE_EQUAL(0u, term->_patternCache.size());
+    _VerifyPatterns({});
+
+    term->_detectURLs = true;
+    term->_updateUrlDetection();
+    _VerifyPatterns(expected);
+}
@@ -277,6 +277,8 @@ void AppHost::Initialize()
     // You aren't allowed to do ANY XAML before this line!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     _window->Initialize();
 
+    TIL_TRACE_STARTUP_PHASE(g_hWindowsTerminalProvider, "XamlIslandInitialized");
+
     if (auto withWindow{ _windowLogic.try_as<IInitializeWithWindow>() })
     {
         // You aren't allowed to do anything with the TerminalPage before this line!!!!!!!
@@ -24,6 +24,8 @@ extern "C" IMAGE_DOS_HEADER __ImageBase;
 WindowEmperor::WindowEmperor() noexcept :
     _app{}
 {
+    TIL_TRACE_STARTUP_PHASE(g_hWindowsTerminalProvider, "WindowEmperorCreated");
+
     _manager.FindTargetWindowRequested([this](const winrt::Windows::Foundation::IInspectable& /*sender*/,
                                               const winrt::Microsoft::Terminal::Remoting::FindTargetWindowArgs& findWindowArgs) {
         {
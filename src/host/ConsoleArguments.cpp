@@ -20,6 +20,7 @@ const std::wstring_view ConsoleArguments::WIDTH_ARG = L"--width";
 const std::wstring_view ConsoleArguments::HEIGHT_ARG = L"--height";
 const std::wstring_view ConsoleArguments::INHERIT_CURSOR_ARG = L"--inheritcursor";
 const std::wstring_view ConsoleArguments::RESIZE_QUIRK = L"--resizeQuirk";
+const std::wstring_view ConsoleArguments::ADAPTIVE_FRAME_PACING_ARG = L"--adaptiveFramePacing";
 const std::wstring_view ConsoleArguments::FEATURE_ARG = L"--feature";
 const std::wstring_view ConsoleArguments::FEATURE_PTY_ARG = L"pty";
 const std::wstring_view ConsoleArguments::COM_SERVER_ARG = L"-Embedding";
@@ -507,6 +508,12 @@ void ConsoleArguments::s_ConsumeArg(_Inout_ std::vector<std::wstring>& args, _In
             s_ConsumeArg(args, i);
             hr = S_OK;
         }
+        else if (arg == ADAPTIVE_FRAME_PACING_ARG)
+        {
+            _adaptiveFramePacing = true;
+            s_ConsumeArg(args, i);
+            hr = S_OK;
+        }
         else if (arg == CLIENT_COMMANDLINE_ARG)
         {
             // Everything after this is the explicit commandline
@@ -658,6 +665,10 @@ bool ConsoleArguments::IsResizeQuirkEnabled() const
 {
     return _resizeQuirk;
 }
+bool ConsoleArguments::IsAdaptiveFramePacingEnabled() const
+{
+    return _adaptiveFramePacing;
+}
 
 #ifdef UNIT_TESTING
 // Method Description:
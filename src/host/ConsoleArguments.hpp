@@ -54,6 +54,7 @@ public:
     short GetHeight() const;
     bool GetInheritCursor() const;
     bool IsResizeQuirkEnabled() const;
+    bool IsAdaptiveFramePacingEnabled() const;
 
 #ifdef UNIT_TESTING
     void EnableConptyModeForTests();
@@ -72,6 +73,7 @@ public:
     static const std::wstring_view HEIGHT_ARG;
     static const std::wstring_view INHERIT_CURSOR_ARG;
     static const std::wstring_view RESIZE_QUIRK;
+    static const std::wstring_view ADAPTIVE_FRAME_PACING_ARG;
     static const std::wstring_view FEATURE_ARG;
     static const std::wstring_view FEATURE_PTY_ARG;
     static const std::wstring_view COM_SERVER_ARG;
@@ -109,6 +111,7 @@ private:
         _signalHandle(signalHandle),
         _inheritCursor(inheritCursor),
         _resizeQuirk(false),
+        _adaptiveFramePacing(false),
         _runAsComServer{ runAsComServer }
     {
     }
@@ -137,6 +140,7 @@ private:
     DWORD _signalHandle;
     bool _inheritCursor;
     bool _resizeQuirk{ false };
+    bool _adaptiveFramePacing{ false };
 
     [[nodiscard]] HRESULT _GetClientCommandline(_Inout_ std::vector<std::wstring>& args,
                                                 const size_t index,
@@ -126,6 +126,7 @@ void VtInputThread::SetLookingForDSR(const bool looking) noexcept
 //      InputStateMachineEngine.
 void VtInputThread::_InputThread()
 {
+    const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::conpty };
     while (DoReadInput())
     {
     }
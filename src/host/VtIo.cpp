@@ -69,6 +69,7 @@ VtIo::VtIo() :
 {
     _lookingForCursorPosition = pArgs->GetInheritCursor();
     _resizeQuirk = pArgs->IsResizeQuirkEnabled();
+    _adaptiveFramePacing = pArgs->IsAdaptiveFramePacingEnabled();
 
     // If we were already given VT handles, set up the VT IO engine to use those.
     if (pArgs->InConptyMode())
@@ -185,6 +186,7 @@ VtIo::VtIo() :
             {
                 _pVtRenderEngine->SetTerminalOwner(this);
                 _pVtRenderEngine->SetResizeQuirk(_resizeQuirk);
+                _pVtRenderEngine->SetAdaptiveFramePacing(_adaptiveFramePacing);
             }
         }
     }
@@ -108,6 +108,158 @@ static void AdjustCursorPosition(SCREEN_INFORMATION& screenInfo, _In_ til::point
     LOG_IF_FAILED(screenInfo.SetCursorPosition(coordCursor, false));
 }
 
+// Disable vectorization-unfriendly warnings.
+#pragma warning(push)
+#pragma warning(disable : 26429) // Symbol '...' is never tested for nullness, it can be marked as not_null (f.23).
+#pragma warning(disable : 26472) // Don't use a static_cast for arithmetic conversions. Use brace initialization, gsl::narrow_cast or gsl::narrow (type.1).
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+[[msvc::forceinline]] static size_t findNonGlyphCharPlain(const wchar_t* beg, const wchar_t* end, const wchar_t* it) noexcept
+{
+#pragma loop(no_vector)
+    for (; it < end && IS_GLYPH_CHAR(*it); ++it)
+    {
+    }
+    return it - beg;
+}
+
+// Returns the offset of the first character in `data` for which IS_GLYPH_CHAR() is false, or `count` if there's none.
+// Legacy (non-VT) clients tend to write long printable runs, so this is worth vectorizing just like
+// findActionableFromGround() in the VT parser is.
+static size_t findNonGlyphChar(const wchar_t* data, size_t count) noexcept
+{
+#if defined(TIL_SSE_INTRINSICS)
+
+    auto it = data;
+
+    for (const auto end = data + (count & ~size_t{ 7 }); it < end; it += 8)
+    {
+        const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+
+        // Check for (wch < 0x20) via "max(0, wch - 0x1f) == 0". See findActionableFromGround() for more details.
+        const auto a = _mm_cmpeq_epi16(_mm_subs_epu16(wch, _mm_set1_epi16(0x1f)), _mm_setzero_si128());
+        // Check for (wch == 0x7f).
+        const auto b = _mm_cmpeq_epi16(wch, _mm_set1_epi16(0x7f));
+
+        const auto mask = _mm_movemask_epi8(_mm_or_si128(a, b));
+        if (mask)
+        {
+            unsigned long offset;
+            _BitScanForward(&offset, mask);
+            it += offset / 2;
+            return it - data;
+        }
+    }
+
+    return findNonGlyphCharPlain(data, data + count, it);
+
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+
+    auto it = data;
+    uint64_t mask;
+
+    for (const auto end = data + (count & ~size_t{ 7 }); it < end;)
+    {
+        const auto wch = vld1q_u16(it);
+        const auto a = vcleq_u16(wch, vdupq_n_u16(0x1f));
+        const auto b = vceqq_u16(wch, vdupq_n_u16(0x7f));
+        const auto c = vreinterpretq_u64_u16(vorrq_u16(a, b));
+
+        mask = vgetq_lane_u64(c, 0);
+        if (mask)
+        {
+            goto exitWithMask;
+        }
+        it += 4;
+
+        mask = vgetq_lane_u64(c, 1);
+        if (mask)
+        {
+            goto exitWithMask;
+        }
+        it += 4;
+    }
+
+    return findNonGlyphCharPlain(data, data + count, it);
+
+exitWithMask:
+    unsigned long offset;
+    _BitScanForward64(&offset, mask);
+    it += offset / 16;
+    return it - data;
+
+#else
+
+    return findNonGlyphCharPlain(data, data + count, data);
+
+#endif
+}
+
+// Maps every byte of a single-byte codepage (like 437 or 1252) to its UTF-16 code unit.
+struct SingleByteCodepageTable
+{
+    UINT codepage = 0;
+    bool valid = false;
+    // Most single-byte codepages are ASCII supersets, but EBCDIC based ones (like 037) are not.
+    bool asciiCompatible = false;
+    std::array<wchar_t, 256> table{};
+};
+
+// Returns the lookup table for the given codepage, or nullptr if the codepage isn't a single-byte one.
+// The table of the last used codepage is cached. This is safe, because we're called with the console lock held.
+static const SingleByteCodepageTable* getSingleByteCodepageTable(const UINT codepage, const CPINFO& cpInfo) noexcept
+{
+    static SingleByteCodepageTable sbcs;
+
+    if (cpInfo.MaxCharSize != 1)
+    {
+        return nullptr;
+    }
+
+    if (sbcs.codepage != codepage)
+    {
+        char bytes[256];
+        for (int i = 0; i < 256; ++i)
+        {
+            bytes[i] = static_cast<char>(i);
+        }
+
+        sbcs.codepage = codepage;
+        sbcs.valid = MultiByteToWideChar(codepage, 0, &bytes[0], 256, sbcs.table.data(), 256) == 256;
+        sbcs.asciiCompatible = true;
+        for (int i = 0; i < 128; ++i)
+        {
+            sbcs.asciiCompatible &= sbcs.table[i] == static_cast<wchar_t>(i);
+        }
+    }
+
+    return sbcs.valid ? &sbcs : nullptr;
+}
+
+// Converts `length` bytes in `in` to exactly as many UTF-16 code units in `out`.
+// Output tends to be mostly ASCII, which is why we vectorize that part just like til::u8u16 does.
+static void convertSingleByteCodepage(const SingleByteCodepageTable& sbcs, const char* in, const int length, wchar_t* out) noexcept
+{
+    int i = 0;
+
+    while (i < length)
+    {
+        if (sbcs.asciiCompatible)
+        {
+            i += til::details::u8u16AsciiPrefix(in + i, length - i, out + i);
+        }
+
+        // Convert the run of non-ASCII characters (or all of them for non-ASCII codepages) up to the next ASCII one.
+        for (; i < length && (!sbcs.asciiCompatible || static_cast<uint8_t>(in[i]) >= 0x80); ++i)
+        {
+            out[i] = til::at(sbcs.table, static_cast<uint8_t>(in[i]));
+        }
+    }
+}
+
+#pragma warning(pop)
+
 // As the name implies, this writes text without processing its control characters.
 void _writeCharsLegacyUnprocessed(SCREEN_INFORMATION& screenInfo, const std::wstring_view& text, til::CoordType* psScrollY)
 {
@@ -185,7 +337,8 @@ void WriteCharsLegacy(SCREEN_INFORMATION& screenInfo, const std::wstring_view& t
 
     while (it != end)
     {
-        const auto nextControlChar = std::find_if(it, end, [](const auto& wch) { return !IS_GLYPH_CHAR(wch); });
+        // This pushes the entire printable run up to the next control character into the buffer at once.
+        const auto nextControlChar = it + findNonGlyphChar(&*it, gsl::narrow_cast<size_t>(end - it));
         if (nextControlChar != it)
         {
             _writeCharsLegacyUnprocessed(screenInfo, { it, nextControlChar }, psScrollY);
@@ -410,6 +563,7 @@ NT_CATCH_RETURN()
         auto leadByteConsumed{ false };
         std::wstring wstr{};
         static til::u8state u8State{};
+        const auto sbcs{ codepage == CP_UTF8 ? nullptr : getSingleByteCodepageTable(codepage, consoleInfo.OutputCPInfo) };
 
         // Convert our input parameters to Unicode
         if (codepage == CP_UTF8)
@@ -417,6 +571,19 @@ NT_CATCH_RETURN()
             RETURN_IF_FAILED(til::u8u16(buffer, wstr, u8State));
             read = buffer.size();
         }
+        else if (sbcs)
+        {
+            // Single-byte codepages have no lead bytes and map each byte to exactly one
+            // UTF-16 code unit. We can skip all of the DBCS handling below as a result.
+            u8State.reset();
+            screenInfo.WriteConsoleDbcsLeadByte[0] = 0;
+
+            int length{};
+            RETURN_IF_FAILED(SizeTToInt(buffer.size(), &length));
+
+            wstr.resize(buffer.size());
+            convertSingleByteCodepage(*sbcs, buffer.data(), length, wstr.data());
+        }
         else
         {
             // In case the codepage changes from UTF-8 to another,
@@ -505,7 +672,11 @@ NT_CATCH_RETURN()
         {
             // Calculate how many bytes of the original A buffer were consumed in the W version of the call to satisfy mbBufferRead.
             // For UTF-8 conversions, we've already returned this information above.
-            if (CP_UTF8 != codepage)
+            if (sbcs)
+            {
+                read = wcBufferWritten;
+            }
+            else if (CP_UTF8 != codepage)
             {
                 size_t mbBufferRead{};
 
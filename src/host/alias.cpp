@@ -901,18 +901,32 @@ std::wstring Alias::s_MatchAndCopyAlias(std::wstring_view sourceText, std::wstri
     std::wstring buffer;
     size_t lines = 0;
 
+    // In the common case each argument is referenced at most once, so this
+    // avoids having to grow the buffer repeatedly while we fill it.
+    buffer.reserve(target.size() + sourceText.size() + 2);
+
     for (auto it = target.begin(), end = target.end(); it != end;)
     {
-        auto ch = *it++;
-        if (ch != L'$' || it == end)
+        // Copy the literal text up to the next escape sequence in one go.
+        const auto escape = std::find(it, end, L'$');
+        buffer.append(it, escape);
+        it = escape;
+
+        if (it == end)
         {
-            buffer.push_back(ch);
-            continue;
+            break;
+        }
+
+        // A trailing $ without a subsequent character is copied verbatim.
+        if (++it == end)
+        {
+            buffer.push_back(L'$');
+            break;
         }
 
         // $ is our "escape character" and this code handles the escape
         // sequence consisting of a single subsequent character.
-        ch = *it++;
+        const auto ch = *it++;
         const auto chLower = til::tolower_ascii(ch);
         if (chLower >= L'1' && chLower <= L'9')
         {
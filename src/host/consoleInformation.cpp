@@ -18,6 +18,9 @@
 using Microsoft::Console::Interactivity::ServiceLocator;
 using Microsoft::Console::VirtualTerminal::VtIo;
 
+// The total time the current thread spent waiting for other threads to release the console lock.
+static thread_local std::chrono::steady_clock::duration s_lockWaitTime{};
+
 bool CONSOLE_INFORMATION::IsConsoleLocked() const noexcept
 {
     return _lock.is_locked();
@@ -26,7 +29,13 @@ bool CONSOLE_INFORMATION::IsConsoleLocked() const noexcept
 #pragma prefast(suppress : 26135, "Adding lock annotation spills into entire project. Future work.")
 void CONSOLE_INFORMATION::LockConsole() noexcept
 {
-    _lock.lock();
+    // The clock is only read if the lock is contended, which keeps the common case fast.
+    if (!_lock.try_lock())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        _lock.lock();
+        s_lockWaitTime += std::chrono::steady_clock::now() - start;
+    }
 }
 
 #pragma prefast(suppress : 26135, "Adding lock annotation spills into entire project. Future work.")
@@ -45,6 +54,14 @@ ULONG CONSOLE_INFORMATION::GetCSRecursionCount() const noexcept
     return _lock.recursion_depth();
 }
 
+// Routine Description:
+// - Returns the total time the calling thread spent waiting for the console lock so far.
+//   The difference between two calls is the time spent waiting in between.
+std::chrono::steady_clock::duration CONSOLE_INFORMATION::GetLockWaitTime() noexcept
+{
+    return s_lockWaitTime;
+}
+
 // Routine Description:
 // - This routine allocates and initialized a console and its associated
 //   data - input buffer and screen buffer.
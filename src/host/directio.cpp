@@ -686,9 +686,14 @@ CATCH_RETURN();
             // Convert to a CHAR_INFO view to fit into the iterator
             const auto charInfos = std::span<const CHAR_INFO>(subspan.data(), subspan.size());
 
-            // Make the iterator and write to the target position.
-            OutputCellIterator it(charInfos);
-            storageBuffer.Write(it, target);
+            // Plain ASCII rows can be written in bulk. Anything else takes the per-cell path,
+            // which knows how to deal with DBCS leading/trailing halves.
+            if (!storageBuffer.WriteCharInfos(charInfos, target, true))
+            {
+                // Make the iterator and write to the target position.
+                OutputCellIterator it(charInfos);
+                storageBuffer.Write(it, target);
+            }
         }
 
         // Since we've managed to write part of the request, return the clamped part that we actually used.
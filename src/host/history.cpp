@@ -106,33 +106,38 @@ void CommandHistory::_Reset()
                         newCommand.cbegin(),
                         newCommand.cend()))
         {
-            std::wstring reuse{};
+            // Duplicates are most likely to be recent commands, so we search backwards.
+            const auto duplicate = suppressDuplicates ? std::find(_commands.rbegin(), _commands.rend(), newCommand) : _commands.rend();
 
-            if (suppressDuplicates)
+            if (duplicate != _commands.rend())
             {
-                Index index;
-                if (FindMatchingCommand(newCommand, LastDisplayed, index, CommandHistory::MatchOptions::ExactMatch))
+                // Moving the existing entry to the back is equivalent to Remove()
+                // followed by an insertion, but shifts the other entries only once
+                // and doesn't need to allocate a copy of the command.
+                const auto index = gsl::narrow_cast<Index>(_commands.rend() - duplicate - 1);
+                std::rotate(_commands.begin() + index, _commands.begin() + index + 1, _commands.end());
+
+                if (LastDisplayed == index)
                 {
-                    reuse = Remove(index);
+                    LastDisplayed = -1;
+                }
+                else if (LastDisplayed > index)
+                {
+                    _Dec(LastDisplayed);
                 }
-            }
-
-            // find free record.  if all records are used, free the lru one.
-            if (GetNumberOfCommands() == _maxCommands)
-            {
-                _commands.erase(_commands.cbegin());
-                // move LastDisplayed back one in order to stay synced with the
-                // command it referred to before erasing the lru one
-                --LastDisplayed;
-            }
-
-            // add newCommand to array
-            if (!reuse.empty())
-            {
-                _commands.emplace_back(reuse);
             }
             else
             {
+                // find free record.  if all records are used, free the lru one.
+                if (GetNumberOfCommands() == _maxCommands)
+                {
+                    _commands.erase(_commands.cbegin());
+                    // move LastDisplayed back one in order to stay synced with the
+                    // command it referred to before erasing the lru one
+                    --LastDisplayed;
+                }
+
+                // add newCommand to array
                 _commands.emplace_back(newCommand);
             }
 
@@ -170,6 +170,51 @@ void HandleGenericKeyEvent(INPUT_RECORD event, const bool generateBreak)
     }
 }
 
+// Routine Description:
+// - Returns true if HandleGenericKeyEvent() might not simply write the
+//   given event to the input buffer (Ctrl+C, Ctrl+Break, Ctrl/Alt+Esc).
+static bool _MayNeedSpecialHandling(const INPUT_RECORD& event) noexcept
+{
+    if (event.EventType != KEY_EVENT)
+    {
+        return false;
+    }
+
+    const auto& keyEvent = event.Event.KeyEvent;
+    if (!keyEvent.bKeyDown || WI_AreAllFlagsClear(keyEvent.dwControlKeyState, CTRL_PRESSED | ALT_PRESSED))
+    {
+        return false;
+    }
+
+    const auto vkey = keyEvent.wVirtualKeyCode;
+    return vkey == 'C' || vkey == VK_CANCEL || vkey == VK_ESCAPE;
+}
+
+// Routine Description:
+// - Same as calling HandleGenericKeyEvent() for each of the given events,
+//   but runs of ordinary keys are written to the input buffer in one go,
+//   so that waiting readers are only woken up once per run.
+// Arguments:
+// - events - the key events to process.
+void HandleGenericKeyEvents(const std::span<const INPUT_RECORD> events)
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    size_t runBeg = 0;
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto& event = til::at(events, i);
+        if (_MayNeedSpecialHandling(event))
+        {
+            gci.pInputBuffer->Write(events.subspan(runBeg, i - runBeg));
+            HandleGenericKeyEvent(event, false);
+            runBeg = i + 1;
+        }
+    }
+
+    gci.pInputBuffer->Write(events.subspan(runBeg));
+}
+
 #ifdef DBG
 // set to true with a debugger to temporarily disable focus events getting written to the InputBuffer
 volatile bool DisableFocusEvents = false;
@@ -74,6 +74,7 @@ void HandleMenuEvent(const DWORD wParam);
 void HandleFocusEvent(const BOOL fSetFocus);
 void HandleCtrlEvent(const DWORD EventType);
 void HandleGenericKeyEvent(INPUT_RECORD event, const bool generateBreak);
+void HandleGenericKeyEvents(const std::span<const INPUT_RECORD> events);
 
 void ProcessCtrlEvents();
 
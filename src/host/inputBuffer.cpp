@@ -168,14 +168,12 @@ size_t InputBuffer::ConsumeCached(bool isUnicode, size_t count, InputEventQueue&
 {
     _switchReadingMode(isUnicode ? ReadingMode::InputEventsW : ReadingMode::InputEventsA);
 
-    size_t i = 0;
+    const auto i = std::min(count, _cachedInputEvents.size());
+    const auto beg = _cachedInputEvents.begin();
+    const auto end = beg + i;
 
-    while (i < count && !_cachedInputEvents.empty())
-    {
-        target.push_back(std::move(_cachedInputEvents.front()));
-        _cachedInputEvents.pop_front();
-        i++;
-    }
+    target.insert(target.end(), beg, end);
+    _cachedInputEvents.erase_front(end);
 
     return i;
 }
@@ -209,10 +207,7 @@ void InputBuffer::Cache(bool isUnicode, InputEventQueue& source, size_t expected
 
     if (source.size() > expectedSourceSize)
     {
-        _cachedInputEvents.insert(
-            _cachedInputEvents.end(),
-            std::make_move_iterator(source.begin() + expectedSourceSize),
-            std::make_move_iterator(source.end()));
+        _cachedInputEvents.append({ source.begin() + expectedSourceSize, source.end() });
         source.resize(expectedSourceSize);
     }
 }
@@ -233,7 +228,7 @@ void InputBuffer::_switchReadingModeSlowPath(ReadingMode mode)
     _cachedTextW = std::wstring{};
     _cachedTextReaderW = {};
 
-    _cachedInputEvents = std::deque<INPUT_RECORD>{};
+    _cachedInputEvents.clear();
 
     _readingMode = mode;
 }
@@ -350,7 +345,7 @@ void InputBuffer::FlushAllButKeys()
     auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const INPUT_RECORD& event) {
         return event.EventType != KEY_EVENT;
     });
-    _storage.erase(newEnd, _storage.end());
+    _storage.erase_back(newEnd);
 }
 
 // Routine Description:
@@ -455,7 +450,7 @@ try
 
     if (!Peek)
     {
-        _storage.erase(_storage.begin(), it);
+        _storage.erase_front(it);
     }
 
     Cache(Unicode, OutEvents, AmountToRead);
@@ -501,7 +496,7 @@ size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD>& inEvents)
         // this way to handle any coalescing that might occur.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<INPUT_RECORD> existingStorage;
+        InputRecordQueue existingStorage;
         existingStorage.swap(_storage);
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
@@ -515,10 +510,7 @@ size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD>& inEvents)
         _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(unusedWaitStatus));
 
-        for (const auto& event : existingStorage)
-        {
-            _storage.push_back(event);
-        }
+        _storage.append({ existingStorage.begin(), existingStorage.end() });
 
         // We need to set the wait event if there were 0 events in the
         // input queue when we started.
@@ -863,6 +855,10 @@ void InputBuffer::_HandleTerminalInputCallback(const TerminalInput::StringType&
 
 void InputBuffer::_writeString(const std::wstring_view& text)
 {
+    // Every character turns into exactly one record. Reserving them
+    // upfront avoids repeated reallocations while pasting large texts.
+    _storage.reserve_back(text.size());
+
     for (const auto& wch : text)
     {
         if (wch == UNICODE_NULL)
@@ -10,14 +10,118 @@
 #include "../server/ObjectHeader.h"
 #include "../terminal/input/terminalInput.hpp"
 
-#include <deque>
-
 namespace Microsoft::Console::Render
 {
     class Renderer;
     class VtEngine;
 }
 
+// A FIFO of INPUT_RECORDs stored in a single contiguous allocation.
+// std::deque<INPUT_RECORD> allocates a separate block per record in our STL (they're larger than 16 bytes),
+// which is costly when pasting large amounts of text. Here, consumed records at the front are merely skipped
+// via _head and only compacted away when the vector would otherwise have to grow.
+class InputRecordQueue
+{
+public:
+    using iterator = std::vector<INPUT_RECORD>::iterator;
+    using const_iterator = std::vector<INPUT_RECORD>::const_iterator;
+
+    bool empty() const noexcept { return _head == _buffer.size(); }
+    size_t size() const noexcept { return _buffer.size() - _head; }
+
+    iterator begin() noexcept { return _buffer.begin() + _head; }
+    iterator end() noexcept { return _buffer.end(); }
+    const_iterator begin() const noexcept { return _buffer.begin() + _head; }
+    const_iterator end() const noexcept { return _buffer.end(); }
+
+    INPUT_RECORD& front() noexcept { return til::at(_buffer, _head); }
+    INPUT_RECORD& back() noexcept { return _buffer.back(); }
+    INPUT_RECORD& operator[](size_t i) noexcept { return til::at(_buffer, _head + i); }
+    const INPUT_RECORD& front() const noexcept { return til::at(_buffer, _head); }
+    const INPUT_RECORD& back() const noexcept { return _buffer.back(); }
+    const INPUT_RECORD& operator[](size_t i) const noexcept { return til::at(_buffer, _head + i); }
+
+    // Ensures that `count` more records can be pushed without reallocating.
+    void reserve_back(size_t count)
+    {
+        if (_buffer.capacity() - _buffer.size() >= count)
+        {
+            return;
+        }
+        _compact();
+        if (_buffer.capacity() - _buffer.size() < count)
+        {
+            // Grow geometrically, so that many small reservations don't result in a reallocation each.
+            _buffer.reserve(std::max(_buffer.size() + count, _buffer.capacity() * 2));
+        }
+    }
+
+    void push_back(const INPUT_RECORD& record)
+    {
+        reserve_back(1);
+        _buffer.push_back(record);
+    }
+
+    void append(const std::span<const INPUT_RECORD>& records)
+    {
+        reserve_back(records.size());
+        _buffer.insert(_buffer.end(), records.begin(), records.end());
+    }
+
+    // Removes all records in the range [begin(), last).
+    void erase_front(const_iterator last) noexcept
+    {
+        _head = gsl::narrow_cast<size_t>(last - _buffer.cbegin());
+        if (_head == _buffer.size())
+        {
+            clear();
+        }
+    }
+
+    // Removes all records in the range [first, end()).
+    void erase_back(const_iterator first) noexcept
+    {
+        _buffer.erase(first, _buffer.cend());
+        if (empty())
+        {
+            clear();
+        }
+    }
+
+    void clear() noexcept
+    {
+        // Don't hold onto the memory of a huge paste once it has been read.
+        if (_buffer.capacity() > shrinkThreshold)
+        {
+            _buffer = std::vector<INPUT_RECORD>{};
+        }
+        _buffer.clear();
+        _head = 0;
+    }
+
+    void swap(InputRecordQueue& other) noexcept
+    {
+        _buffer.swap(other._buffer);
+        std::swap(_head, other._head);
+    }
+
+private:
+    static constexpr size_t shrinkThreshold = 4096;
+
+    void _compact() noexcept
+    {
+        // Moving the records is only worth it if it frees up a significant portion of the buffer.
+        if (_head != 0 && _head >= _buffer.size() / 2)
+        {
+            _buffer.erase(_buffer.begin(), _buffer.begin() + _head);
+            _head = 0;
+        }
+    }
+
+    std::vector<INPUT_RECORD> _buffer;
+    size_t _head = 0;
+};
+
 class InputBuffer final : public ConsoleObjectHeader
 {
 public:
@@ -77,10 +181,10 @@ private:
     std::string_view _cachedTextReaderA;
     std::wstring _cachedTextW;
     std::wstring_view _cachedTextReaderW;
-    std::deque<INPUT_RECORD> _cachedInputEvents;
+    InputRecordQueue _cachedInputEvents;
     ReadingMode _readingMode = ReadingMode::StringA;
 
-    std::deque<INPUT_RECORD> _storage;
+    InputRecordQueue _storage;
     INPUT_RECORD _writePartialByteSequence{};
     bool _writePartialByteSequenceAvailable = false;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
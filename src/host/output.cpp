@@ -116,6 +116,14 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
     }
 }
 
+// Returns the number of cells between the given position and the end of the buffer.
+static size_t _countCellsUntilEnd(const Viewport& bufferSize, const til::point pos) noexcept
+{
+    const auto width = gsl::narrow_cast<size_t>(bufferSize.Width());
+    const auto rows = gsl::narrow_cast<size_t>(bufferSize.BottomExclusive() - pos.y);
+    return rows * width - gsl::narrow_cast<size_t>(pos.x - bufferSize.Left());
+}
+
 // Routine Description:
 // - This routine reads a sequence of attributes from the screen buffer.
 // Arguments:
@@ -135,39 +143,57 @@ std::vector<WORD> ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
     }
 
     // Short circuit, if reading out of bounds, leave early.
-    if (!screenInfo.GetBufferSize().IsInBounds(coordRead))
+    const auto bufferSize = screenInfo.GetBufferSize();
+    if (!bufferSize.IsInBounds(coordRead))
     {
         return {};
     }
 
-    // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
-    // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
-    // Prepare the return value string.
+    const auto& textBuffer = screenInfo.GetTextBuffer();
+    const auto width = bufferSize.Width();
+    const auto amount = std::min(amountToRead, _countCellsUntilEnd(bufferSize, coordRead));
+
     std::vector<WORD> retVal;
-    // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
-    retVal.reserve(amountToRead);
+    retVal.reserve(amount);
 
-    // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
+    // Instead of walking the buffer cell by cell with a TextBufferCellIterator, which has to look up
+    // the attributes of each cell individually, we copy entire runs of attributes out of each row.
+    auto x = coordRead.x;
+    for (auto y = coordRead.y; retVal.size() < amount; ++y, x = 0)
     {
-        const auto legacyAttributes = it->TextAttr().GetLegacyAttributes();
+        const auto& row = textBuffer.GetRowByOffset(y);
+        const auto end = gsl::narrow_cast<til::CoordType>(std::min<size_t>(width, x + (amount - retVal.size())));
+        til::CoordType runBeg = 0;
 
-        // If the first thing we read is trailing, pad with a space.
-        // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
-        {
-            retVal.push_back(legacyAttributes);
-        }
-        else
+        for (const auto& run : row.Attributes().runs())
         {
-            retVal.push_back(legacyAttributes | GeneratePublicApiAttributeFormat(it->DbcsAttr()));
-        }
+            const auto runEnd = runBeg + run.length;
+            const auto legacyAttributes = run.value.GetLegacyAttributes();
+
+            for (auto col = std::max(runBeg, x); col < std::min(runEnd, end); ++col)
+            {
+                const auto dbcsAttr = row.DbcsAttrAt(col);
+                const auto amountRead = retVal.size();
 
-        amountRead++;
-        it++;
+                // If the first thing we read is trailing, pad with a space.
+                // OR If the last thing we read is leading, pad with a space.
+                if ((amountRead == 0 && dbcsAttr == DbcsAttribute::Trailing) ||
+                    (amountRead == (amountToRead - 1) && dbcsAttr == DbcsAttribute::Leading))
+                {
+                    retVal.push_back(legacyAttributes);
+                }
+                else
+                {
+                    retVal.push_back(legacyAttributes | GeneratePublicApiAttributeFormat(dbcsAttr));
+                }
+            }
+
+            runBeg = runEnd;
+            if (runBeg >= end)
+            {
+                break;
+            }
+        }
     }
 
     return retVal;
@@ -192,37 +218,45 @@ std::wstring ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
     }
 
     // Short circuit, if reading out of bounds, leave early.
-    if (!screenInfo.GetBufferSize().IsInBounds(coordRead))
+    const auto bufferSize = screenInfo.GetBufferSize();
+    if (!bufferSize.IsInBounds(coordRead))
     {
         return {};
     }
 
-    // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
-
-    // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
+    const auto& textBuffer = screenInfo.GetTextBuffer();
+    const auto width = bufferSize.Width();
+    const auto amount = std::min(amountToRead, _countCellsUntilEnd(bufferSize, coordRead));
 
     // Prepare the return value string.
     std::wstring retVal;
-    retVal.reserve(amountToRead); // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
+    retVal.reserve(amount); // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
+
+    // Count up the number of cells we've attempted to read.
+    size_t amountRead = 0;
 
-    // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
+    // Same as in ReadOutputAttributes(): Reading straight from each ROW avoids the overhead of TextBufferCellIterator.
+    auto x = coordRead.x;
+    for (auto y = coordRead.y; amountRead < amount; ++y, x = 0)
     {
-        // If the first thing we read is trailing, pad with a space.
-        // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
-        {
-            retVal += UNICODE_SPACE;
-        }
-        else
+        const auto& row = textBuffer.GetRowByOffset(y);
+        const auto end = gsl::narrow_cast<til::CoordType>(std::min<size_t>(width, x + (amount - amountRead)));
+
+        for (auto col = x; col < end; ++col, ++amountRead)
         {
+            const auto dbcsAttr = row.DbcsAttrAt(col);
+
+            // If the first thing we read is trailing, pad with a space.
+            // OR If the last thing we read is leading, pad with a space.
+            if ((amountRead == 0 && dbcsAttr == DbcsAttribute::Trailing) ||
+                (amountRead == (amountToRead - 1) && dbcsAttr == DbcsAttribute::Leading))
+            {
+                retVal += UNICODE_SPACE;
+            }
             // Otherwise, add anything that isn't a trailing cell. (Trailings are duplicate copies of the leading.)
-            if (it->DbcsAttr() != DbcsAttribute::Trailing)
+            else if (dbcsAttr != DbcsAttribute::Trailing)
             {
-                auto chars = it->Chars();
+                auto chars = row.GlyphAt(col);
                 if (chars.size() > 1)
                 {
                     chars = { &UNICODE_REPLACEMENT, 1 };
@@ -230,9 +264,6 @@ std::wstring ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
                 retVal += chars;
             }
         }
-
-        amountRead++;
-        it++;
     }
 
     return retVal;
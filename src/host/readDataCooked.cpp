@@ -191,6 +191,7 @@ COOKED_READ_DATA::COOKED_READ_DATA(_In_ InputBuffer* const pInputBuffer,
         const auto beg = textBuffer.NavigateCursor(end, distance);
         _distanceCursor = (end.y - beg.y) * textBuffer.GetSize().Width() + end.x - beg.x;
         _distanceEnd = _distanceCursor;
+        _flushedCursor = npos;
     }
 }
 
@@ -313,6 +314,7 @@ void COOKED_READ_DATA::EraseBeforeResize()
         _offsetCursorPosition(-_distanceEnd);
         _distanceCursor = 0;
         _distanceEnd = 0;
+        _flushedCursor = npos;
     }
 }
 
@@ -834,9 +836,21 @@ void COOKED_READ_DATA::_flushBuffer()
         // the relative "distance" to the current actual cursor position. That way _measureChars()
         // can still figure out what the logical cursor position is, when it handles tabs, etc.
         auto dirtyBegDistance = -_distanceCursor;
+        auto unmodifiedBeforeCursor = _buffer.GetUnmodifiedTextBeforeCursor();
 
-        distanceBeforeCursor = _measureChars(_buffer.GetUnmodifiedTextBeforeCursor(), dirtyBegDistance);
-        dirtyBegDistance += distanceBeforeCursor;
+        // If the text up to the previously flushed cursor position is still unmodified, we already know
+        // its distance and only need to measure what follows. While typing this skips re-measuring
+        // the entire prompt on every keystroke, which is what made long input lines quadratic.
+        if (_flushedCursor <= unmodifiedBeforeCursor.size())
+        {
+            unmodifiedBeforeCursor = unmodifiedBeforeCursor.substr(_flushedCursor);
+            distanceBeforeCursor = _distanceCursor;
+            dirtyBegDistance = 0;
+        }
+
+        const auto distance = _measureChars(unmodifiedBeforeCursor, dirtyBegDistance);
+        distanceBeforeCursor += distance;
+        dirtyBegDistance += distance;
         distanceAfterCursor = _measureChars(_buffer.GetUnmodifiedTextAfterCursor(), dirtyBegDistance);
         dirtyBegDistance += distanceAfterCursor;
 
@@ -858,6 +872,7 @@ void COOKED_READ_DATA::_flushBuffer()
     _buffer.MarkAsClean();
     _distanceCursor = distanceBeforeCursor;
     _distanceEnd = distanceEnd;
+    _flushedCursor = _buffer.GetCursorPosition();
 }
 
 // This is just a small helper to fill the next N cells starting at the current cursor position with whitespace.
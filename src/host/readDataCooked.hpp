@@ -189,6 +189,9 @@ private:
     // _distanceEnd is the distance between the start of the prompt and its last
     // glyph at the end in columns (including wide glyph padding columns).
     ptrdiff_t _distanceEnd = 0;
+    // _flushedCursor is the _buffer cursor position at the time _distanceCursor was
+    // last computed by _flushBuffer(), or npos if that relationship isn't known.
+    size_t _flushedCursor = npos;
     bool _insertMode = false;
     State _state = State::Accumulating;
 
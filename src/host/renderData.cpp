@@ -69,7 +69,9 @@ std::vector<Viewport> RenderData::GetSelectionRects() noexcept
 
     try
     {
-        for (const auto& select : Selection::Instance().GetSelectionRects())
+        // Only the rows within the viewport get painted.
+        const auto viewport = GetViewport();
+        for (const auto& select : Selection::Instance().GetSelectionRects(viewport.Top(), viewport.BottomInclusive()))
         {
             result.emplace_back(Viewport::FromInclusive(select));
         }
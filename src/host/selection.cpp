@@ -42,6 +42,14 @@ Selection& Selection::Instance()
 // - Returns empty vector if no rows are selected.
 // - Throws exceptions for out of memory issues
 std::vector<til::inclusive_rect> Selection::GetSelectionRects() const
+{
+    return GetSelectionRects(0, til::CoordTypeMax);
+}
+
+// Routine Description:
+// - Same as above, but limited to the rows within [rowBeg,rowEnd] (inclusive).
+//   Used for rendering, which only needs the rows within the viewport.
+std::vector<til::inclusive_rect> Selection::GetSelectionRects(til::CoordType rowBeg, til::CoordType rowEnd) const
 {
     if (!_fSelectionVisible)
     {
@@ -58,7 +66,7 @@ std::vector<til::inclusive_rect> Selection::GetSelectionRects() const
     endSelectionAnchor.y = (_coordSelectionAnchor.y == _srSelectionRect.top) ? _srSelectionRect.bottom : _srSelectionRect.top;
 
     const auto blockSelection = !IsLineSelection();
-    return screenInfo.GetTextBuffer().GetTextRects(_coordSelectionAnchor, endSelectionAnchor, blockSelection, false);
+    return screenInfo.GetTextBuffer().GetTextRects(_coordSelectionAnchor, endSelectionAnchor, blockSelection, false, rowBeg, rowEnd);
 }
 
 // Routine Description:
@@ -29,6 +29,7 @@ public:
     ~Selection() = default;
 
     std::vector<til::inclusive_rect> GetSelectionRects() const;
+    std::vector<til::inclusive_rect> GetSelectionRects(til::CoordType rowBeg, til::CoordType rowEnd) const;
 
     void ShowSelection();
     void HideSelection();
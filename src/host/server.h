@@ -102,6 +102,7 @@ public:
     til::recursive_ticket_lock_suspension SuspendLock() noexcept;
     bool IsConsoleLocked() const noexcept;
     ULONG GetCSRecursionCount() const noexcept;
+    static std::chrono::steady_clock::duration GetLockWaitTime() noexcept;
 
     Microsoft::Console::VirtualTerminal::VtIo* GetVtIo();
 
@@ -28,6 +28,7 @@ enum TraceKeywords
     UIA = 0x800,
     CookedRead = 0x1000,
     ConsoleAttachDetach = 0x2000,
+    ProcessStatistics = 0x4000,
     All = 0x1FFF
 };
 DEFINE_ENUM_FLAG_OPERATORS(TraceKeywords);
@@ -211,6 +212,34 @@ void Tracing::s_TraceConsoleAttachDetach(_In_ ConsoleProcessHandle* const pConso
     }
 }
 
+void Tracing::s_TraceConsoleProcessStatistics(_In_ ConsoleProcessHandle* const pConsoleProcessHandle)
+{
+    if (TraceLoggingProviderEnabled(g_hConhostV2EventTraceProvider, 0, TraceKeywords::ProcessStatistics))
+    {
+        using namespace std::chrono;
+        using duration = ConsoleProcessStatistics::duration;
+
+        const auto& statistics = pConsoleProcessHandle->Statistics;
+        const auto toMicroseconds = [](const std::atomic<duration::rep>& ticks) {
+            return gsl::narrow_cast<uint64_t>(duration_cast<microseconds>(duration{ ticks.load(std::memory_order_relaxed) }).count());
+        };
+
+        TraceLoggingWrite(
+            g_hConhostV2EventTraceProvider,
+            "ConsoleProcessStatistics",
+            TraceLoggingPid(pConsoleProcessHandle->dwProcessId, "ProcessId"),
+            TraceLoggingUInt64(statistics.apiCalls.load(std::memory_order_relaxed), "ApiCalls"),
+            TraceLoggingUInt64(statistics.bytesWritten.load(std::memory_order_relaxed), "BytesWritten"),
+            TraceLoggingUInt64(toMicroseconds(statistics.serviceTicks), "ServiceTimeUs"),
+            TraceLoggingUInt64(toMicroseconds(statistics.lockWaitTicks), "LockWaitTimeUs"),
+            TraceLoggingUInt64(statistics.waits.load(std::memory_order_relaxed), "Waits"),
+            TraceLoggingUInt64(toMicroseconds(statistics.waitTicks), "WaitTimeUs"),
+            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+            TraceLoggingKeyword(TIL_KEYWORD_TRACE),
+            TraceLoggingKeyword(TraceKeywords::ProcessStatistics));
+    }
+}
+
 void __stdcall Tracing::TraceFailure(const wil::FailureInfo& failure) noexcept
 {
     TraceLoggingWrite(
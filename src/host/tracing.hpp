@@ -54,6 +54,7 @@ public:
 
     static void s_TraceCookedRead(_In_ ConsoleProcessHandle* const pConsoleProcessHandle, const std::wstring_view& text);
     static void s_TraceConsoleAttachDetach(_In_ ConsoleProcessHandle* const pConsoleProcessHandle, _In_ bool bIsAttach);
+    static void s_TraceConsoleProcessStatistics(_In_ ConsoleProcessHandle* const pConsoleProcessHandle);
 
     static void __stdcall TraceFailure(const wil::FailureInfo& failure) noexcept;
 
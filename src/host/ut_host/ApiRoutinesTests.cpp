@@ -323,7 +323,7 @@ class ApiRoutinesTests
     {
         BEGIN_TEST_METHOD_PROPERTIES()
             TEST_METHOD_PROPERTY(L"Data:fInduceWait", L"{false, true}")
-            TEST_METHOD_PROPERTY(L"Data:dwCodePage", L"{437, 932, 65001}")
+            TEST_METHOD_PROPERTY(L"Data:dwCodePage", L"{437, 1252, 932, 65001}")
             TEST_METHOD_PROPERTY(L"Data:dwIncrement", L"{0, 1, 2}")
         END_TEST_METHOD_PROPERTIES();
 
@@ -353,6 +353,9 @@ class ApiRoutinesTests
         case CP_USA: // US English ANSI
             pszTestText = "Test Text";
             break;
+        case 1252: // Western European, which has non-ASCII characters in the single byte fast path
+            pszTestText = "Caf\xe9 \x80 Text";
+            break;
         case CP_JAPANESE: // Japanese Shift-JIS
             pszTestText = "J\x82\xa0\x82\xa2";
             break;
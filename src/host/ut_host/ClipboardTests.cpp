@@ -208,6 +208,19 @@ class ClipboardTests
         }
     }
 
+    TEST_METHOD(CanPrepareTextForPaste)
+    {
+        static constexpr std::wstring_view input{ L"a\r\nb\nc\x1b\0d", 9 };
+
+        // CR/LF pairs are collapsed into a single CR and everything after a null character is dropped.
+        const auto text = Clipboard::Instance().PrepareTextForPaste(input.data(), input.size());
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a\rb\nc\x1b" }, text);
+
+        // Bracketed pastes additionally must not contain any escape characters.
+        const auto bracketedText = Clipboard::Instance().PrepareTextForPaste(input.data(), input.size(), true);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"a\rb\nc" }, bracketedText);
+    }
+
     TEST_METHOD(CanConvertCharsRequiringAltGr)
     {
         const std::wstring wstr = L"\x20ac"; // € char U+20AC
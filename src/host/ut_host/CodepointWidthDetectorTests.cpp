@@ -50,6 +50,34 @@ class CodepointWidthDetectorTests
         }
     }
 
+    TEST_METHOD(CanGetWidthsAtRangeBoundaries)
+    {
+        // codepoint, expected width
+        static constexpr std::pair<char32_t, uint8_t> data[] = {
+            { 0xa0, 1 },
+            { 0xa1, 1 }, // ambiguous, narrow without a fallback
+            { 0x10ff, 1 },
+            { 0x1100, 2 },
+            { 0x115f, 2 },
+            { 0x1160, 1 },
+            { 0x1fabd, 2 },
+            { 0x1fabe, 1 },
+            { 0x1fabf, 2 },
+            { 0x20000, 2 },
+            { 0x2fffd, 2 },
+            { 0x2fffe, 1 },
+            { 0x10fffd, 1 }, // ambiguous
+            { 0x10ffff, 1 },
+        };
+
+        CodepointWidthDetector widthDetector;
+        for (const auto& [codepoint, expected] : data)
+        {
+            const auto actual = widthDetector._lookupGlyphWidth(codepoint, {});
+            VERIFY_ARE_EQUAL(expected, actual, NoThrowString().Format(L"U+%X", codepoint));
+        }
+    }
+
     static bool FallbackMethod(const std::wstring_view glyph)
     {
         if (glyph.size() < 1)
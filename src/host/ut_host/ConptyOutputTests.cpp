@@ -89,6 +89,7 @@ class ConptyOutputTests
                                                                initialViewport);
         auto pfn = std::bind(&ConptyOutputTests::_writeCallback, this, std::placeholders::_1, std::placeholders::_2);
         vtRenderEngine->SetTestCallback(pfn);
+        _vtRenderEngine = vtRenderEngine.get();
 
         g.pRender->AddRenderEngine(vtRenderEngine.get());
         gci.GetActiveOutputBuffer().SetTerminalConnection(vtRenderEngine.get());
@@ -122,11 +123,15 @@ class ConptyOutputTests
     TEST_METHOD(InvalidateUntilOneBeforeEnd);
     TEST_METHOD(SetConsoleTitleWithControlChars);
     TEST_METHOD(IncludeBackgroundColorChangesInFirstFrame);
+    TEST_METHOD(MergeConsecutiveSgrSequences);
+    TEST_METHOD(LimitParametersOfMergedSgrSequences);
 
 private:
     bool _writeCallback(const char* const pch, const size_t cch);
     void _flushFirstFrame();
+    std::string _paintFrameWithoutTestCallback();
     std::deque<std::string> expectedOutput;
+    Xterm256Engine* _vtRenderEngine = nullptr;
     std::unique_ptr<CommonState> m_state;
 };
 
@@ -166,6 +171,47 @@ void ConptyOutputTests::_flushFirstFrame()
     VERIFY_SUCCEEDED(renderer.PaintFrame());
 }
 
+// Function Description:
+// - Paints a frame and returns what the VT engine would've written to the pipe.
+//   Unlike the test callback, which receives every individual write, this
+//   includes the optimizations applied to the output buffer, like merging SGR sequences.
+std::string ConptyOutputTests::_paintFrameWithoutTestCallback()
+{
+    auto& renderer = *ServiceLocator::LocateGlobals().pRender;
+    auto& engine = *_vtRenderEngine;
+
+    // The engine doesn't have a pipe, so _flushImpl() leaves the buffer alone,
+    // but corking it makes sure that nothing gets flushed in the first place.
+    engine._usingTestCallback = false;
+    engine.Cork(true);
+    const auto cleanup = wil::scope_exit([&]() {
+        engine._buffer.clear();
+        engine._lastSgrEnd = 0;
+        engine._flushRequested = false;
+        engine.Cork(false);
+        engine._usingTestCallback = true;
+    });
+
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    return engine._buffer;
+}
+
+// Function Description:
+// - Returns all SGR sequences in the given VT output, in order.
+static std::vector<std::string_view> _findSgrSequences(const std::string_view output)
+{
+    std::vector<std::string_view> sequences;
+    for (auto beg = output.find("\x1b["); beg != std::string_view::npos; beg = output.find("\x1b[", beg + 1))
+    {
+        const auto end = output.find_first_not_of("0123456789;:", beg + 2);
+        if (end != std::string_view::npos && output[end] == 'm')
+        {
+            sequences.emplace_back(output.substr(beg, end + 1 - beg));
+        }
+    }
+    return sequences;
+}
+
 // Function Description:
 // - Helper function to validate that a number of characters in a row are all
 //   the same. Validates that the next end-start characters are all equal to the
@@ -428,3 +474,69 @@ void ConptyOutputTests::IncludeBackgroundColorChangesInFirstFrame()
 
     VERIFY_SUCCEEDED(renderer.PaintFrame());
 }
+
+void ConptyOutputTests::MergeConsecutiveSgrSequences()
+{
+    Log::Comment(L"The engine emits one SGR sequence per changed attribute. "
+                 L"Sequences that follow each other directly should reach the pipe as a single one.");
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& sm = si.GetStateMachine();
+
+    _flushFirstFrame();
+
+    sm.ProcessString(L"\x1b[1;3;4;38;2;1;2;3;48;5;100mX\x1b[m");
+
+    const auto output = _paintFrameWithoutTestCallback();
+    const std::string_view view{ output };
+    Log::Comment(NoThrowString().Format(L"Output =\t\"%hs\"", output.c_str()));
+
+    const auto x = view.find('X');
+    VERIFY_ARE_NOT_EQUAL(std::string_view::npos, x);
+
+    // Everything up to the "X" has to be a single SGR sequence carrying all the attributes.
+    const auto sequences = _findSgrSequences(view.substr(0, x));
+    VERIFY_ARE_EQUAL(1u, sequences.size());
+
+    const auto sgr = sequences.front();
+    VERIFY_ARE_EQUAL(x, gsl::narrow_cast<size_t>(sgr.data() + sgr.size() - view.data()));
+    VERIFY_ARE_NOT_EQUAL(std::string_view::npos, sgr.find("38;2;1;2;3"));
+    VERIFY_ARE_NOT_EQUAL(std::string_view::npos, sgr.find("48;5;100"));
+    VERIFY_ARE_EQUAL(11u, gsl::narrow_cast<size_t>(std::count(sgr.begin(), sgr.end(), ';')) + 1);
+}
+
+void ConptyOutputTests::LimitParametersOfMergedSgrSequences()
+{
+    Log::Comment(L"Merged SGR sequences must not exceed the number of parameters terminals support.");
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& sm = si.GetStateMachine();
+
+    _flushFirstFrame();
+
+    // 8 simple attributes and 2 RGB colors with 5 parameters each add up to 18 parameters.
+    sm.ProcessString(L"\x1b[1;3;4;5;7;8;9;53;38;2;1;2;3;48;2;4;5;6mX\x1b[m");
+
+    const auto output = _paintFrameWithoutTestCallback();
+    const std::string_view view{ output };
+    Log::Comment(NoThrowString().Format(L"Output =\t\"%hs\"", output.c_str()));
+
+    const auto x = view.find('X');
+    VERIFY_ARE_NOT_EQUAL(std::string_view::npos, x);
+
+    const auto sequences = _findSgrSequences(view.substr(0, x));
+    VERIFY_ARE_EQUAL(2u, sequences.size());
+
+    size_t parameters = 0;
+    for (const auto sgr : sequences)
+    {
+        const auto count = gsl::narrow_cast<size_t>(std::count(sgr.begin(), sgr.end(), ';')) + 1;
+        VERIFY_IS_LESS_THAN_OR_EQUAL(count, 16u);
+        parameters += count;
+    }
+    VERIFY_ARE_EQUAL(18u, parameters);
+}
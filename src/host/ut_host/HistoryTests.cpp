@@ -240,6 +240,8 @@ class HistoryTests
         VERIFY_SUCCEEDED(history->Add(L"dir", true));
 
         VERIFY_ARE_EQUAL(2, history->GetNumberOfCommands());
+        VERIFY_ARE_EQUAL(String(L"cd"), String(history->GetNth(0).data()));
+        VERIFY_ARE_EQUAL(String(L"dir"), String(history->GetNth(1).data()));
     }
 
 private:
@@ -642,4 +642,37 @@ class InputBufferTests
         VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount);
         VERIFY_ARE_EQUAL(outEvents.front().Event.KeyEvent.wRepeatCount, 1u);
     }
+
+    TEST_METHOD(PartialReadsPreserveOrderAcrossWrites)
+    {
+        InputBuffer inputBuffer;
+        std::wstring text;
+        for (auto i = 0; i < 5000; ++i)
+        {
+            text.push_back(static_cast<wchar_t>(L'A' + i % 26));
+        }
+
+        // Interleave large writes with small reads, so that the storage
+        // has to grow while its front has already been partially consumed.
+        inputBuffer.WriteString(text);
+        std::wstring actual;
+        InputEventQueue outEvents;
+        for (auto i = 0; i < 2 * 50; ++i)
+        {
+            if (i == 25)
+            {
+                inputBuffer.WriteString(text);
+            }
+
+            outEvents.clear();
+            VERIFY_NT_SUCCESS(inputBuffer.Read(outEvents, 100, false, false, true, false));
+            for (const auto& event : outEvents)
+            {
+                actual.push_back(event.Event.KeyEvent.uChar.UnicodeChar);
+            }
+        }
+
+        VERIFY_ARE_EQUAL(text + text, actual);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
 };
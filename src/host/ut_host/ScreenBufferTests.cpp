@@ -163,6 +163,7 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyControlCharAtAnyOffset);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -2974,6 +2975,33 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, renderSettings.GetAttributeColors(attrB).second);
 }
 
+void ScreenBufferTests::WriteCharsLegacyControlCharAtAnyOffset()
+{
+    // WriteCharsLegacy scans for control characters in blocks of 8. This ensures
+    // that they're found regardless of whether they're in a block or the remainder.
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const auto& tbi = si.GetTextBuffer();
+    auto& cursor = si.GetTextBuffer().GetCursor();
+
+    VERIFY_SUCCEEDED(si.SetViewportOrigin(true, til::point(0, 0), true));
+
+    for (til::CoordType n = 0; n < 25; n++)
+    {
+        std::wstring text(n, L'a');
+        text.append(L"\tX");
+
+        cursor.SetPosition({ 0, 0 });
+        WriteCharsLegacy(si, text, nullptr);
+
+        const auto tabStop = (n / 8 + 1) * 8;
+        const auto rowText = tbi.GetRowByOffset(0).GetText();
+        VERIFY_ARE_EQUAL(til::point(tabStop + 1, 0), cursor.GetPosition());
+        VERIFY_ARE_EQUAL(std::wstring_view{ text }.substr(0, n), rowText.substr(0, n));
+        VERIFY_ARE_EQUAL(L'X', rowText.at(tabStop));
+    }
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
@@ -8430,7 +8458,7 @@ void ScreenBufferTests::SimpleMarkCommand()
 
         stateMachine.ProcessString(FTCS_A L"A Prompt" FTCS_B L"my_command" FTCS_C L"\n");
 
-        VERIFY_IS_TRUE(currentRow.GetScrollbarData().has_value());
+        VERIFY_IS_NOT_NULL(currentRow.GetScrollbarData());
     }
 
     stateMachine.ProcessString(L"Two\n");
@@ -8476,13 +8504,13 @@ void ScreenBufferTests::SimpleWrappedCommand()
         VERIFY_ARE_NOT_EQUAL(originalRowOffset, secondRowOffset);
         auto& secondRow = tbi.GetRowByOffset(secondRowOffset);
 
-        VERIFY_IS_TRUE(originalRow.GetScrollbarData().has_value());
-        VERIFY_IS_FALSE(secondRow.GetScrollbarData().has_value());
+        VERIFY_IS_NOT_NULL(originalRow.GetScrollbarData());
+        VERIFY_IS_NULL(secondRow.GetScrollbarData());
 
         stateMachine.ProcessString(FTCS_C L"\n");
 
-        VERIFY_IS_TRUE(originalRow.GetScrollbarData().has_value());
-        VERIFY_IS_FALSE(secondRow.GetScrollbarData().has_value());
+        VERIFY_IS_NOT_NULL(originalRow.GetScrollbarData());
+        VERIFY_IS_NULL(secondRow.GetScrollbarData());
     }
 
     stateMachine.ProcessString(L"Two\n");
@@ -8552,8 +8580,8 @@ void ScreenBufferTests::SimplePromptRegions()
 
     const auto& row0 = tbi.GetRowByOffset(0);
     const auto& row4 = tbi.GetRowByOffset(4);
-    VERIFY_IS_TRUE(row0.GetScrollbarData().has_value());
-    VERIFY_IS_TRUE(row4.GetScrollbarData().has_value());
+    VERIFY_IS_NOT_NULL(row0.GetScrollbarData());
+    VERIFY_IS_NOT_NULL(row4.GetScrollbarData());
 
     const auto marks = tbi.GetMarkExtents();
     VERIFY_ARE_EQUAL(2u, marks.size());
@@ -158,4 +158,28 @@ class SearchTests
         s.Reset(gci.renderData, L"\x304b", true, true);
         DoFoundChecks(s, { 2, 3 }, -1, true);
     }
+
+    TEST_METHOD(IncrementalUpdate)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.renderData.GetTextBuffer();
+
+        Search s;
+        s.Reset(gci.renderData, L"AB", false, false);
+        VERIFY_ARE_EQUAL(4u, s.Results().size());
+
+        // Appending a row should only add the new match.
+        RowWriteState state{ .text = L"xxABxx" };
+        textBuffer.GetMutableRowByOffset(4).ReplaceText(state);
+        VERIFY_IS_TRUE(s.IsStale(gci.renderData, L"AB", false));
+        s.Reset(gci.renderData, L"AB", false, false);
+        VERIFY_ARE_EQUAL(5u, s.Results().size());
+        VERIFY_ARE_EQUAL(textBuffer.SearchText(L"AB", false), s.Results());
+
+        // Scrolling the first row out of the buffer should drop its match and shift the others up.
+        textBuffer.IncrementCircularBuffer();
+        s.Reset(gci.renderData, L"AB", false, false);
+        VERIFY_ARE_EQUAL(4u, s.Results().size());
+        VERIFY_ARE_EQUAL(textBuffer.SearchText(L"AB", false), s.Results());
+    }
 };
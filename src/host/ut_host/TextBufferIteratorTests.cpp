@@ -314,6 +314,8 @@ class TextBufferIteratorTests
 
     TEST_METHOD(ConstructedNoLimit);
     TEST_METHOD(ConstructedLimits);
+
+    TEST_METHOD(AttrRunLengthCell);
 };
 
 void TextBufferIteratorTests::BoolOperatorText()
@@ -581,3 +583,29 @@ void TextBufferIteratorTests::ConstructedLimits()
                            wil::ResultException,
                            [](wil::ResultException& e) { return e.GetErrorCode() == E_INVALIDARG; });
 }
+
+void TextBufferIteratorTests::AttrRunLengthCell()
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+    const auto width = textBuffer.GetSize().Width();
+
+    textBuffer.GetMutableRowByOffset(0).ReplaceAttributes(2, 5, TextAttribute{ FOREGROUND_RED });
+
+    auto it = textBuffer.GetCellDataAt({ 0, 0 });
+    VERIFY_ARE_EQUAL(2, it.AttrRunLength(), L"The default attribute spans columns [0, 2).");
+
+    it += 3;
+    VERIFY_ARE_EQUAL(2, it.AttrRunLength(), L"Starting in the middle of a run only counts the remaining columns.");
+
+    it += 2;
+    VERIFY_ARE_EQUAL(width - 5, it.AttrRunLength(), L"The last run extends to the end of the row.");
+
+    const auto limits = Viewport::FromInclusive({ 3, 0, 7, 0 });
+    TextBufferCellIterator limited{ textBuffer, { 6, 0 }, limits };
+    VERIFY_ARE_EQUAL(2, limited.AttrRunLength(), L"The run is clamped to the bounds of the iterator.");
+
+    limited += 2;
+    VERIFY_IS_FALSE(limited);
+    VERIFY_ARE_EQUAL(0, limited.AttrRunLength(), L"Invalid iterators have no run.");
+}
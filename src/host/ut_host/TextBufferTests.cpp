@@ -91,6 +91,7 @@ class TextBufferTests
     TEST_METHOD(TestBoundaryMeasuresFullString);
     TEST_METHOD(TestBoundaryMeasuresRegularString);
     TEST_METHOD(TestBoundaryMeasuresFloatingString);
+    TEST_METHOD(TestBoundaryMeasuresSingleChar);
 
     TEST_METHOD(TestCopyProperties);
 
@@ -141,12 +142,18 @@ class TextBufferTests
 
     TEST_METHOD(ResizeTraditionalRotationPreservesHighUnicode);
     TEST_METHOD(ScrollBufferRotationPreservesHighUnicode);
+    TEST_METHOD(RotateRowsSwapsRowStorage);
+    TEST_METHOD(ResetInPlaceClearsBuffer);
+    TEST_METHOD(ClearScrollbackDecommitsMemory);
+    TEST_METHOD(ClearScrollbackAfterRotateRows);
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
 
     TEST_METHOD(TestBurrito);
     TEST_METHOD(TestOverwriteChars);
+    TEST_METHOD(TestWriteCharInfos);
+    TEST_METHOD(TestWriteCellsFill);
     TEST_METHOD(TestReplace);
     TEST_METHOD(TestInsert);
 
@@ -154,6 +161,7 @@ class TextBufferTests
 
     void WriteLinesToBuffer(const std::vector<std::wstring>& text, TextBuffer& buffer);
     TEST_METHOD(GetWordBoundaries);
+    TEST_METHOD(GetWordBoundariesAcrossDelimiterClasses);
     TEST_METHOD(MoveByWord);
     TEST_METHOD(GetGlyphBoundaries);
 
@@ -362,6 +370,20 @@ void TextBufferTests::TestBoundaryMeasuresFloatingString()
     DoBoundaryTest(pwszOffsets, 14, csBufferWidth, 5, 9);
 }
 
+void TextBufferTests::TestBoundaryMeasuresSingleChar()
+{
+    const auto csBufferWidth = GetBufferWidth();
+
+    // The measurements scan 8 characters at a time, so place the character at
+    // every column to cover both the vectorized loops and the scalar remainder.
+    for (til::CoordType x = 0; x < csBufferWidth; ++x)
+    {
+        std::wstring str(csBufferWidth, L' ');
+        str[x] = L'X';
+        DoBoundaryTest(str.data(), csBufferWidth, csBufferWidth, x, x + 1);
+    }
+}
+
 void TextBufferTests::TestCopyProperties()
 {
     auto& otherTbi = GetTbi();
@@ -1869,6 +1891,153 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(fire), String(shouldBeFireText.data(), gsl::narrow<int>(shouldBeFireText.size())));
 }
 
+// This tests that RotateRows() moves the rows like ScrollRows() would, while the
+// rows that were scrolled over end up in the vacated rows instead of getting lost.
+void TextBufferTests::RotateRowsSwapsRowStorage()
+{
+    const til::size bufferSize{ 20, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    for (til::CoordType y = 0; y < 6; y++)
+    {
+        const wchar_t ch = L'A' + y;
+        _buffer->GetMutableRowByOffset(y).ReplaceCharacters(0, 1, { &ch, 1 });
+    }
+
+    const auto rowText = [&](const til::CoordType y) {
+        return std::wstring{ _buffer->GetRowByOffset(y).GetText().substr(0, 1) };
+    };
+
+    Log::Comment(L"Scroll rows 2 to 4 up by 2 rows");
+    _buffer->RotateRows(2, 3, -2);
+    VERIFY_ARE_EQUAL(L"C", rowText(0));
+    VERIFY_ARE_EQUAL(L"D", rowText(1));
+    VERIFY_ARE_EQUAL(L"E", rowText(2));
+    VERIFY_ARE_EQUAL(L"F", rowText(5));
+
+    Log::Comment(L"Scroll rows 0 to 2 back down by 2 rows");
+    _buffer->RotateRows(0, 3, 2);
+    VERIFY_ARE_EQUAL(L"C", rowText(2));
+    VERIFY_ARE_EQUAL(L"D", rowText(3));
+    VERIFY_ARE_EQUAL(L"E", rowText(4));
+    VERIFY_ARE_EQUAL(L"F", rowText(5));
+}
+
+void TextBufferTests::ResetInPlaceClearsBuffer()
+{
+    const til::size bufferSize{ 20, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    for (til::CoordType y = 0; y < bufferSize.height; y++)
+    {
+        _buffer->GetMutableRowByOffset(y).ReplaceCharacters(0, 3, L"abc");
+    }
+    _buffer->IncrementCircularBuffer(attr);
+    _buffer->GetCursor().SetPosition({ 3, 5 });
+    const auto mutationId = _buffer->GetLastMutationId();
+    std::vector<uint64_t> rowMutationIds;
+    for (til::CoordType y = 0; y < bufferSize.height; y++)
+    {
+        rowMutationIds.emplace_back(_buffer->GetRowByOffset(y).GetMutationId());
+    }
+
+    const TextAttribute newAttr{ 0x1e };
+    _buffer->ResetInPlace(newAttr);
+
+    Log::Comment(L"All rows are blank and use the new attributes");
+    for (til::CoordType y = 0; y < bufferSize.height; y++)
+    {
+        const auto& row = _buffer->GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(std::wstring(bufferSize.width, L' '), std::wstring{ row.GetText() });
+        VERIFY_ARE_EQUAL(newAttr, row.GetAttrByColumn(0));
+    }
+
+    Log::Comment(L"The buffer state is reset as well");
+    VERIFY_ARE_EQUAL(newAttr, _buffer->GetCurrentAttributes());
+    VERIFY_ARE_EQUAL(til::point{}, _buffer->GetCursor().GetPosition());
+    VERIFY_IS_FALSE(_buffer->CanTrackMutationsSince(mutationId));
+
+    Log::Comment(L"No row carries its previous mutation ID anymore");
+    for (til::CoordType y = 0; y < bufferSize.height; y++)
+    {
+        VERIFY_ARE_NOT_EQUAL(rowMutationIds[y], _buffer->GetRowByOffset(y).GetMutationId());
+    }
+}
+
+void TextBufferTests::ClearScrollbackDecommitsMemory()
+{
+    const til::size bufferSize{ 80, 1000 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    for (til::CoordType y = 0; y < bufferSize.height; y++)
+    {
+        _buffer->GetMutableRowByOffset(y).ReplaceCharacters(0, 3, L"abc");
+    }
+
+    const auto committedBefore = _buffer->GetCommittedBytes();
+    VERIFY_ARE_EQUAL(_buffer->GetReservedBytes(), committedBefore);
+
+    Log::Comment(L"Keep the last 10 rows and drop everything else");
+    _buffer->ClearScrollback(bufferSize.height - 10, 10);
+    VERIFY_IS_LESS_THAN(_buffer->GetCommittedBytes(), committedBefore / 10);
+
+    Log::Comment(L"The kept rows retain their contents and the rest reads back as blank");
+    for (til::CoordType y = 0; y < 10; y++)
+    {
+        VERIFY_ARE_EQUAL(L"abc", std::wstring{ _buffer->GetRowByOffset(y).GetText().substr(0, 3) });
+    }
+    for (til::CoordType y = 10; y < bufferSize.height; y++)
+    {
+        const auto& row = _buffer->GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(std::wstring(bufferSize.width, L' '), std::wstring{ row.GetText() });
+    }
+}
+
+// RotateRows() leaves ROWs referring to the storage of other slots. This tests that ClearScrollback()
+// doesn't decommit storage that the kept rows still use, and that recommitted rows don't alias them.
+void TextBufferTests::ClearScrollbackAfterRotateRows()
+{
+    const til::size bufferSize{ 80, 1000 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    for (til::CoordType y = 0; y < bufferSize.height; y++)
+    {
+        _buffer->GetMutableRowByOffset(y).ReplaceCharacters(0, 3, L"abc");
+    }
+
+    Log::Comment(L"Swap the ROWs of the first 10 rows with ones in the range that ClearScrollback() decommits");
+    _buffer->RotateRows(0, 10, 500);
+
+    _buffer->ClearScrollback(bufferSize.height - 10, 10);
+
+    Log::Comment(L"Write to the kept rows and to the recommitted rows that used to own their storage");
+    for (til::CoordType y = 0; y < 10; y++)
+    {
+        _buffer->GetMutableRowByOffset(y).ReplaceCharacters(3, 3, L"def");
+    }
+    for (til::CoordType y = 500; y < 510; y++)
+    {
+        _buffer->GetMutableRowByOffset(y).ReplaceCharacters(0, 3, L"xyz");
+    }
+
+    for (til::CoordType y = 0; y < 10; y++)
+    {
+        VERIFY_ARE_EQUAL(L"abcdef", std::wstring{ _buffer->GetRowByOffset(y).GetText().substr(0, 6) });
+    }
+    for (til::CoordType y = 500; y < 510; y++)
+    {
+        VERIFY_ARE_EQUAL(L"xyz   ", std::wstring{ _buffer->GetRowByOffset(y).GetText().substr(0, 6) });
+    }
+}
+
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
 // characters from the Unicode Storage buffer
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
@@ -1950,6 +2119,89 @@ void TextBufferTests::TestBurrito()
     VERIFY_IS_FALSE(afterBurritoIter);
 }
 
+void TextBufferTests::TestWriteCharInfos()
+{
+    til::size bufferSize{ 10, 3 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+    auto& row = buffer.GetMutableRowByOffset(0);
+
+    static constexpr CHAR_INFO ascii[]{
+        { L'a', 0x1f },
+        { L'b', 0x1f },
+        { L'c', 0x2e },
+        { L'd', 0x1f },
+    };
+    VERIFY_IS_TRUE(buffer.WriteCharInfos(ascii, { 6, 0 }, true));
+    VERIFY_ARE_EQUAL(L"      abcd", row.GetText());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7f }, row.GetAttrByColumn(5));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(6));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(7));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2e }, row.GetAttrByColumn(8));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(9));
+    VERIFY_IS_TRUE(row.WasWrapForced());
+
+    // Cells that don't fit into the row are rejected.
+    VERIFY_IS_FALSE(buffer.WriteCharInfos(ascii, { 7, 0 }, true));
+
+    // DBCS halves and non-ASCII characters aren't handled by the fast path
+    // and must not modify the row, so that the caller can fall back to WriteLine().
+    static constexpr CHAR_INFO dbcs[]{
+        { L'x', 0x1f },
+        { L'\x3042', 0x1f | COMMON_LVB_LEADING_BYTE },
+        { L'\x3042', 0x1f | COMMON_LVB_TRAILING_BYTE },
+    };
+    VERIFY_IS_FALSE(buffer.WriteCharInfos(dbcs, { 0, 0 }, true));
+    static constexpr CHAR_INFO unicode[]{
+        { L'x', 0x1f },
+        { L'\x00e4', 0x1f },
+    };
+    VERIFY_IS_FALSE(buffer.WriteCharInfos(unicode, { 0, 0 }, true));
+    VERIFY_ARE_EQUAL(L"      abcd", row.GetText());
+}
+
+void TextBufferTests::TestWriteCellsFill()
+{
+    til::size bufferSize{ 10, 3 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+    auto& row = buffer.GetMutableRowByOffset(0);
+
+    // Limited fills stop once they're exhausted and leave the remaining cells alone.
+    auto it = row.WriteCells(OutputCellIterator{ L'x', TextAttribute{ 0x1f }, 4 }, 2, true);
+    VERIFY_IS_FALSE(it);
+    VERIFY_ARE_EQUAL(L"  xxxx    ", row.GetText());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7f }, row.GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(5));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7f }, row.GetAttrByColumn(6));
+    VERIFY_IS_FALSE(row.WasWrapForced());
+
+    // Fills that don't fit are continued on the next row with the returned iterator.
+    it = row.WriteCells(OutputCellIterator{ L'y', 15 }, 4, true);
+    VERIFY_IS_TRUE(it);
+    VERIFY_ARE_EQUAL(6, it.GetCellDistance(OutputCellIterator{ L'y', 15 }));
+    VERIFY_ARE_EQUAL(L"  xxyyyyyy", row.GetText());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(4), L"Text-only fills keep the existing attributes.");
+    VERIFY_IS_TRUE(row.WasWrapForced());
+
+    // Attribute-only fills don't touch the text.
+    row.WriteCells(OutputCellIterator{ TextAttribute{ 0x2e }, 3 }, 1, false, 2);
+    VERIFY_ARE_EQUAL(L"  xxyyyyyy", row.GetText());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x7f }, row.GetAttrByColumn(0));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2e }, row.GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2e }, row.GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, row.GetAttrByColumn(3));
+    VERIFY_IS_TRUE(row.WasWrapForced());
+
+    // Overwriting half of a wide glyph pads the other half with whitespace, just like the regular path.
+    row.ReplaceCharacters(0, 2, L"\x3042");
+    row.WriteCells(OutputCellIterator{ L'z', 1 }, 1);
+    VERIFY_ARE_EQUAL(L" zxxyyyyyy", row.GetText());
+}
+
 void TextBufferTests::TestOverwriteChars()
 {
     til::size bufferSize{ 10, 3 };
@@ -2443,6 +2695,87 @@ void TextBufferTests::GetWordBoundaries()
     }
 }
 
+void TextBufferTests::GetWordBoundariesAcrossDelimiterClasses()
+{
+    til::size bufferSize{ 80, 3 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // Buffer looks like:
+    //   0         1
+    //   0123456789012345678
+    // 0|abc--def  ghi::jkl  ...
+    const std::vector<std::wstring> text = { L"abc--def  ghi::jkl" };
+    WriteLinesToBuffer(text, *_buffer);
+
+    struct ExpectedResult
+    {
+        til::point accessibilityModeDisabled;
+        til::point accessibilityModeEnabled;
+    };
+
+    struct Test
+    {
+        til::point startPos;
+        ExpectedResult expected;
+    };
+
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:accessibilityMode", L"{false, true}")
+    END_TEST_METHOD_PROPERTIES();
+
+    bool accessibilityMode;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"accessibilityMode", accessibilityMode), L"Get accessibility mode variant");
+
+    // clang-format off
+    std::vector<Test> testData = {
+        { {  2, 0 }, { {  0, 0 }, {  0, 0 } } },
+        { {  4, 0 }, { {  3, 0 }, {  0, 0 } } },
+        { {  7, 0 }, { {  5, 0 }, {  5, 0 } } },
+        { {  9, 0 }, { {  8, 0 }, {  5, 0 } } },
+        { { 14, 0 }, { { 13, 0 }, { 10, 0 } } },
+        { { 17, 0 }, { { 15, 0 }, { 15, 0 } } },
+        { { 40, 0 }, { { 18, 0 }, { 15, 0 } } },
+    };
+    // clang-format on
+
+    const std::wstring_view delimiters = L" -:";
+    for (const auto& test : testData)
+    {
+        Log::Comment(NoThrowString().Format(L"til::point (%hd, %hd)", test.startPos.x, test.startPos.y));
+        const auto result = _buffer->GetWordStart(test.startPos, delimiters, accessibilityMode);
+        const auto expected = accessibilityMode ? test.expected.accessibilityModeEnabled : test.expected.accessibilityModeDisabled;
+        VERIFY_ARE_EQUAL(expected, result);
+    }
+
+    // clang-format off
+    testData = {
+        { {  0, 0 }, { {  2, 0 }, {  5, 0 } } },
+        { {  3, 0 }, { {  4, 0 }, {  5, 0 } } },
+        { {  5, 0 }, { {  7, 0 }, { 10, 0 } } },
+        { {  8, 0 }, { {  9, 0 }, { 10, 0 } } },
+        { { 13, 0 }, { { 14, 0 }, { 15, 0 } } },
+        { { 15, 0 }, { { 17, 0 }, {  0, 3 } } },
+        { { 18, 0 }, { { 79, 0 }, {  0, 3 } } },
+    };
+    // clang-format on
+
+    for (const auto& test : testData)
+    {
+        Log::Comment(NoThrowString().Format(L"TestEnd til::point (%hd, %hd)", test.startPos.x, test.startPos.y));
+        const auto result = _buffer->GetWordEnd(test.startPos, delimiters, accessibilityMode);
+        const auto expected = accessibilityMode ? test.expected.accessibilityModeEnabled : test.expected.accessibilityModeDisabled;
+        VERIFY_ARE_EQUAL(expected, result);
+    }
+
+    if (accessibilityMode)
+    {
+        Log::Comment(L"A limit within a word stops the word end there.");
+        VERIFY_ARE_EQUAL((til::point{ 7, 0 }), _buffer->GetWordEnd({ 5, 0 }, delimiters, true, til::point{ 7, 0 }));
+    }
+}
+
 void TextBufferTests::MoveByWord()
 {
     til::size bufferSize{ 80, 9001 };
@@ -83,6 +83,8 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestWrapping);
 
+    TEST_METHOD(TestSkipUnchangedRuns);
+
     TEST_METHOD(TestResize);
 
     TEST_METHOD(TestCursorVisibility);
@@ -1588,6 +1590,58 @@ void VtRendererTest::TestWrapping()
     });
 }
 
+void VtRendererTest::TestSkipUnchangedRuns()
+{
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    VerifyFirstPaint(*engine);
+
+    const auto makeClusters = [](const wchar_t* line) {
+        std::vector<Cluster> clusters;
+        for (size_t i = 0; i < wcslen(line); i++)
+        {
+            clusters.emplace_back(std::wstring_view{ &line[i], 1 }, 1);
+        }
+        return clusters;
+    };
+    const auto line1 = makeClusters(L"asdfghjkl");
+    const auto line2 = makeClusters(L"asdfghjkL");
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Make sure the cursor is at 0,0, then paint a line.");
+        qExpectedInput.push_back("\x1b[H");
+        VERIFY_SUCCEEDED(engine->_MoveCursor({ 0, 0 }));
+
+        qExpectedInput.push_back("asdfghjkl");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line1.data(), line1.size() }, { 0, 0 }, false, false));
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Painting the same line in the same place again sends nothing.");
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line1.data(), line1.size() }, { 0, 0 }, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Painting different text in that place sends it.");
+        qExpectedInput.push_back("\r");
+        qExpectedInput.push_back("asdfghjkL");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line2.data(), line2.size() }, { 0, 0 }, false, false));
+    });
+
+    VERIFY_SUCCEEDED(engine->InvalidateAll());
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"When everything was invalidated, the same text is sent again.");
+        qExpectedInput.push_back("\r");
+        qExpectedInput.push_back("asdfghjkL");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line2.data(), line2.size() }, { 0, 0 }, false, false));
+    });
+}
+
 void VtRendererTest::TestResize()
 {
     auto view = SetUpViewport();
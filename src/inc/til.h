@@ -14,6 +14,7 @@
 
 #define _TIL_INLINEPREFIX __declspec(noinline) inline
 
+#include "til/alloc_tracking.h"
 #include "til/at.h"
 #include "til/bitmap.h"
 #include "til/coalesce.h"
@@ -52,6 +53,16 @@
 // as common flags for the entire Terminal team projects.
 #define TIL_KEYWORD_TRACE 0x0000000100000000 // bit 32
 
+// Emits a "StartupTimeline" event, marking a phase between launch and the first frame.
+// Record them with a WPR profile that covers TIL_KEYWORD_TRACE to see where startup time goes.
+#define TIL_TRACE_STARTUP_PHASE(provider, phase)                                          \
+    TraceLoggingWrite(provider,                                                           \
+                      "StartupTimeline",                                                  \
+                      TraceLoggingDescription("Emitted when a startup phase is reached"), \
+                      TraceLoggingString(phase, "phase"),                                 \
+                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),                          \
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE))
+
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
     template<typename T>
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+// Counts heap allocations per subsystem, so that tests can assert that hot paths don't allocate.
+//
+// Hot paths tag themselves with a til::alloc_tracking::scope. Outside of tests that's all that happens:
+// The scope stores the category in a thread-local and nothing is counted. A test binary opts in by
+// invoking TIL_ALLOC_TRACKING_DEFINE_OPERATORS() in exactly one of its translation units, which
+// replaces the global operator new of that binary. For instance:
+//
+//   til::alloc_tracking::reset();
+//   WriteSomeText();
+//   VERIFY_ARE_EQUAL(0u, til::alloc_tracking::get(til::alloc_tracking::category::buffer).allocations);
+namespace til::alloc_tracking
+{
+    enum class category : uint8_t
+    {
+        other,
+        parser,
+        buffer,
+        render,
+        conpty,
+    };
+
+    inline constexpr size_t category_count = 5;
+
+    struct counters
+    {
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    namespace details
+    {
+        inline thread_local category current = category::other;
+        inline std::atomic<size_t> allocations[category_count];
+        inline std::atomic<size_t> bytes[category_count];
+    }
+
+    // Attributes all allocations on this thread to the given category for as long as it exists.
+    // Scopes can be nested. Once the inner one is destroyed, the outer one's category applies again.
+    class scope
+    {
+    public:
+        explicit scope(const category c) noexcept :
+            _previous{ details::current }
+        {
+            details::current = c;
+        }
+
+        ~scope()
+        {
+            details::current = _previous;
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        category _previous;
+    };
+
+    // Called by the operator new defined by TIL_ALLOC_TRACKING_DEFINE_OPERATORS().
+    inline void record(const size_t size) noexcept
+    {
+        const auto i = static_cast<size_t>(details::current);
+        details::allocations[i].fetch_add(1, std::memory_order_relaxed);
+        details::bytes[i].fetch_add(size, std::memory_order_relaxed);
+    }
+
+    inline counters get(const category c) noexcept
+    {
+        const auto i = static_cast<size_t>(c);
+        return {
+            .allocations = details::allocations[i].load(std::memory_order_relaxed),
+            .bytes = details::bytes[i].load(std::memory_order_relaxed),
+        };
+    }
+
+    inline void reset() noexcept
+    {
+        for (size_t i = 0; i < category_count; ++i)
+        {
+            details::allocations[i].store(0, std::memory_order_relaxed);
+            details::bytes[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// The nothrow and array variants of operator new in the CRT are implemented on top of this one.
+#define TIL_ALLOC_TRACKING_DEFINE_OPERATORS()                   \
+    void* operator new(size_t size)                             \
+    {                                                           \
+        til::alloc_tracking::record(size);                      \
+        if (const auto p = malloc(size ? size : 1))             \
+        {                                                       \
+            return p;                                           \
+        }                                                       \
+        throw std::bad_alloc{};                                 \
+    }                                                           \
+    void operator delete(void* p) noexcept                      \
+    {                                                           \
+        free(p);                                                \
+    }                                                           \
+    void operator delete(void* p, size_t) noexcept              \
+    {                                                           \
+        free(p);                                                \
+    }
@@ -149,6 +149,88 @@ namespace til
             }
         }
 
+        // Removes the item matching the given key and returns true if it existed.
+        // NOTE: This invalidates pointers returned by lookup() and insert().
+        template<typename U>
+        bool erase(U&& key) noexcept
+        {
+            if (!_map)
+            {
+                return false;
+            }
+
+            auto hole = Traits::hash(key) >> _shift;
+
+            for (;; ++hole)
+            {
+                const auto& slot = _map[hole & _mask];
+                if (!Traits::occupied(slot))
+                {
+                    return false;
+                }
+                if (Traits::equals(slot, key))
+                {
+                    break;
+                }
+            }
+
+            // Instead of leaving a tombstone behind, we use "backward shift deletion":
+            // Any item following the hole within the same cluster is moved into the hole,
+            // unless that would move it in front of its ideal slot (= its hash).
+            // This keeps the invariant that lookup() can stop at the first unoccupied slot.
+            for (auto i = hole + 1;; ++i)
+            {
+                auto& slot = _map[i & _mask];
+                if (!Traits::occupied(slot))
+                {
+                    break;
+                }
+
+                // The distance from the ideal slot to the current one. If the hole is within
+                // that distance, the item is allowed to be moved into it. Since hole < i and
+                // both are only meaningful modulo the capacity, this works across wrap-arounds.
+                const auto ideal = Traits::hash(slot) >> _shift;
+                if (((i - ideal) & _mask) >= i - hole)
+                {
+                    _map[hole & _mask] = std::move(slot);
+                    hole = i;
+                }
+            }
+
+            _map[hole & _mask] = T{};
+            _load -= LoadFactor;
+            return true;
+        }
+
+        // Ensures that the set can hold at least the given number of items without
+        // growing. Unlike repeated calls to insert() this rehashes the items at most once.
+        void reserve(size_t count)
+        {
+            if (count > std::numeric_limits<size_t>::max() / LoadFactor)
+            {
+                throw std::bad_array_new_length{};
+            }
+
+            const auto load = count * LoadFactor;
+            if (load <= _capacity)
+            {
+                return;
+            }
+
+            auto newShift = _shift;
+            do
+            {
+                // Same as in _bumpSize().
+                if (newShift <= GrowthExponent)
+                {
+                    throw std::bad_array_new_length{};
+                }
+                newShift -= GrowthExponent;
+            } while ((size_t{ 1 } << (digits - newShift)) < load);
+
+            _rehash(newShift);
+        }
+
     private:
         __declspec(noinline) void _bumpSize()
         {
@@ -160,7 +242,11 @@ namespace til
                 throw std::bad_array_new_length{};
             }
 
-            const auto newShift = _shift - GrowthExponent;
+            _rehash(_shift - GrowthExponent);
+        }
+
+        void _rehash(const size_t newShift)
+        {
             const auto newCapacity = size_t{ 1 } << (digits - newShift);
             const auto newMask = newCapacity - 1;
             auto newMap = std::make_unique<T[]>(newCapacity);
@@ -0,0 +1,513 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "spsc.h"
+
+// til: Terminal Implementation Library. Also: "Today I Learned".
+// mpsc: Multi Producer Single Consumer. A MPSC queue/channel sends data from any number of senders to one receiver.
+namespace til::mpsc
+{
+    using size_type = spsc::size_type;
+
+    // mpsc shares its blocking policies with spsc. See push_n() and pop_n() for their meaning.
+    using spsc::block_forever;
+    using spsc::block_initially;
+
+    namespace details
+    {
+        using spsc::details::atomic_size_type;
+        using spsc::details::drop_flag;
+        using spsc::details::enable_if_wait_policy_t;
+
+        // The signed difference between two positions must fit into 31 bits.
+        inline constexpr size_type max_capacity = 1u << (std::numeric_limits<size_type>::digits - 2u);
+
+        struct acquisition
+        {
+            // The position of the slot that may be written to / read from.
+            // Only valid if acquired is true.
+            size_type position;
+
+            // True if a slot was successfully acquired.
+            bool acquired;
+
+            // If the other side of the queue hasn't been destroyed yet, alive will be true.
+            bool alive;
+
+            constexpr acquisition(size_type position, bool acquired, bool alive) :
+                position(position),
+                acquired(acquired),
+                alive(alive)
+            {
+            }
+        };
+
+        // arc implements the bounded queue by Dmitry Vyukov, where each slot in the ring buffer
+        // carries its own sequence number. In short, for the slot at position "pos":
+        // * sequence == pos
+        //   The slot is free and the producer that claims "pos" may write to it.
+        // * sequence == pos + 1
+        //   The slot has been written to and the consumer may read it.
+        // * sequence == pos + capacity
+        //   The slot has been read and is free again for the producer of the next revolution.
+        //
+        // Producers claim positions by incrementing _tail with a CAS and publish them by bumping
+        // the slot's sequence number. Since that happens in the order the producers finish writing,
+        // the consumer can't rely on a single producer position like spsc does. Instead it checks
+        // the sequence number of the slot at its own position (_head).
+        //
+        // Both positions wrap around at 2^32, which is why the capacity must be a power of two.
+        //
+        // Waiting is done on two separate counters which change whenever the other side made progress:
+        // * _producerSignal: Incremented whenever a producer published a slot or the last producer is dropped.
+        //   The consumer waits on it while the queue is empty.
+        // * _consumerSignal: Updated whenever the consumer has read a slot or it's dropped (drop_flag).
+        //   The producers wait on it while the queue is full.
+        // Each side reads the signal before checking the slot, so that any progress made in between
+        // results in a different value and thus in wait() returning immediately.
+        template<typename T>
+        struct arc
+        {
+            explicit arc(size_type capacity) :
+                _sequences(std::make_unique<std::atomic<size_type>[]>(capacity)),
+                _data(spsc::details::alloc_raw_memory<T>(static_cast<size_t>(capacity) * sizeof(T))),
+                _mask(capacity - 1)
+            {
+                for (size_type i = 0; i < capacity; ++i)
+                {
+                    _sequences[i].store(i, std::memory_order_relaxed);
+                }
+            }
+
+            ~arc()
+            {
+                // Both sides are gone at this point and thus every claimed slot has been published.
+                const auto tail = _tail.load(std::memory_order_relaxed);
+                for (auto pos = _head; pos != tail; ++pos)
+                {
+                    std::destroy_at(slot(pos));
+                }
+
+                spsc::details::free_raw_memory(_data);
+            }
+
+            void add_producer() noexcept
+            {
+                _producers.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void drop_producer()
+            {
+                if (_producers.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                {
+                    return;
+                }
+
+                // The last producer is gone. Wake up the consumer so that it notices once it drained the queue.
+                _producerSignal.fetch_add(1, std::memory_order_release);
+                _producerSignal.notify_one();
+                drop();
+            }
+
+            void drop_consumer()
+            {
+                // Signal the producers we're dropped. See producer_acquire() for the handling of the drop_flag.
+                const auto signal = _consumerSignal.load(std::memory_order_relaxed);
+                _consumerSignal.store(signal | drop_flag, std::memory_order_release);
+                _consumerSignal.notify_all();
+                drop();
+            }
+
+            acquisition producer_acquire(bool blocking) noexcept
+            {
+                auto pos = _tail.load(std::memory_order_relaxed);
+
+                while (true)
+                {
+                    // This acquire read synchronizes with the release write in consumer_release().
+                    const auto signal = _consumerSignal.load(std::memory_order_acquire);
+                    if ((signal & drop_flag) != 0)
+                    {
+                        return { 0, false, false };
+                    }
+
+                    const auto sequence = _sequences[pos & _mask].load(std::memory_order_acquire);
+                    const auto diff = static_cast<int32_t>(sequence - pos);
+
+                    if (diff == 0)
+                    {
+                        // On failure compare_exchange_weak() updates pos with the current _tail for us.
+                        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        {
+                            return { pos, true, true };
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        // The slot still contains an item from the previous revolution: The queue is full.
+                        if (!blocking)
+                        {
+                            return { 0, false, true };
+                        }
+
+                        _consumerSignal.wait(signal, std::memory_order_relaxed);
+                        pos = _tail.load(std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        // Another producer claimed pos in the meantime.
+                        pos = _tail.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            void producer_release(acquisition acquisition) noexcept
+            {
+                // This release write synchronizes with the acquire read in consumer_acquire().
+                _sequences[acquisition.position & _mask].store(acquisition.position + 1, std::memory_order_release);
+                _producerSignal.fetch_add(1, std::memory_order_release);
+                _producerSignal.notify_one();
+            }
+
+            acquisition consumer_acquire(bool blocking) noexcept
+            {
+                const auto pos = _head;
+
+                while (true)
+                {
+                    const auto signal = _producerSignal.load(std::memory_order_acquire);
+                    // This must be read before the sequence number: If it's 0, all producers are
+                    // gone and the acquire read ensures that we see all of their published slots.
+                    const auto alive = _producers.load(std::memory_order_acquire) != 0;
+
+                    const auto sequence = _sequences[pos & _mask].load(std::memory_order_acquire);
+                    if (sequence == pos + 1)
+                    {
+                        return { pos, true, true };
+                    }
+
+                    // The consumer only stops once all values have been consumed.
+                    if (!alive)
+                    {
+                        return { 0, false, false };
+                    }
+                    if (!blocking)
+                    {
+                        return { 0, false, true };
+                    }
+
+                    _producerSignal.wait(signal, std::memory_order_relaxed);
+                }
+            }
+
+            void consumer_release(acquisition acquisition) noexcept
+            {
+                // Mark the slot as free for the producer of the next revolution.
+                _sequences[acquisition.position & _mask].store(acquisition.position + _mask + 1, std::memory_order_release);
+                _head = acquisition.position + 1;
+
+                // This release write synchronizes with the acquire read in producer_acquire().
+                // All producers might be waiting for a free slot, which is why we need to wake all of them.
+                _consumerSignal.store(_head & ~drop_flag, std::memory_order_release);
+                _consumerSignal.notify_all();
+            }
+
+            T* slot(size_type position) const noexcept
+            {
+                return _data + (position & _mask);
+            }
+
+        private:
+            void drop()
+            {
+                // Just like with spsc, the contents are only deleted when both sides have been dropped.
+                // For the producer side that's the case once the last producer is gone.
+                if (_eitherSideDropped.exchange(true, std::memory_order_acq_rel))
+                {
+                    delete this;
+                }
+            }
+
+            const std::unique_ptr<std::atomic<size_type>[]> _sequences;
+            T* const _data;
+            const size_type _mask;
+
+            std::atomic<bool> _eitherSideDropped{ false };
+            std::atomic<size_type> _producers{ 1 };
+
+            std::atomic<size_type> _tail{ 0 };
+            // Only accessed by the consumer (and the destructor).
+            size_type _head = 0;
+
+            atomic_size_type _producerSignal;
+            atomic_size_type _consumerSignal;
+        };
+    }
+
+    // Unlike with spsc, producers can be copied. Each copy is another producer
+    // and the consumer will only stop after all of them have been destroyed.
+    template<typename T>
+    struct producer
+    {
+        // A claimed slot must be published or the consumer would wait for it forever. Items for which
+        // construction may throw are thus constructed up front and then moved into the slot.
+        static_assert(std::is_nothrow_move_constructible_v<T>, "mpsc requires nothrow move constructible items");
+
+        explicit producer(details::arc<T>* arc) noexcept :
+            _arc(arc) {}
+
+        producer(const producer<T>& other) noexcept :
+            _arc(other._arc)
+        {
+            if (_arc)
+            {
+                _arc->add_producer();
+            }
+        }
+
+        producer<T>& operator=(const producer<T>& other) noexcept
+        {
+            if (this != &other)
+            {
+                drop();
+                _arc = other._arc;
+                if (_arc)
+                {
+                    _arc->add_producer();
+                }
+            }
+            return *this;
+        }
+
+        producer(producer<T>&& other) noexcept
+        {
+            drop();
+            _arc = std::exchange(other._arc, nullptr);
+        }
+
+        producer<T>& operator=(producer<T>&& other) noexcept
+        {
+            drop();
+            _arc = std::exchange(other._arc, nullptr);
+            return *this;
+        }
+
+        ~producer()
+        {
+            drop();
+        }
+
+        // emplace constructs an item in-place at the end of the queue.
+        // It returns true, if the item was successfully placed within the queue.
+        // The return value will be false, if the consumer is gone.
+        template<typename... Args>
+        bool emplace(Args&&... args) const
+        {
+            return _emplace(true, std::forward<Args>(args)...).acquired;
+        }
+
+        template<typename InputIt>
+        std::pair<size_t, bool> push(InputIt first, InputIt last) const
+        {
+            return push_n(block_forever, first, std::distance(first, last));
+        }
+
+        // push writes the items between first and last into the queue.
+        // The amount of successfully written items is returned as the first pair field.
+        // The second pair field will be false if the consumer is gone.
+        template<typename WaitPolicy, typename InputIt, details::enable_if_wait_policy_t<WaitPolicy> = 0>
+        std::pair<size_t, bool> push(WaitPolicy&& policy, InputIt first, InputIt last) const
+        {
+            return push_n(std::forward<WaitPolicy>(policy), first, std::distance(first, last));
+        }
+
+        template<typename InputIt>
+        std::pair<size_t, bool> push_n(InputIt first, size_t count) const
+        {
+            return push_n(block_forever, first, count);
+        }
+
+        // push_n writes count items from first into the queue.
+        // The amount of successfully written items is returned as the first pair field.
+        // The second pair field will be false if the consumer is gone.
+        // NOTE: Items are written one by one and may thus be interleaved with those of other producers.
+        template<typename WaitPolicy, typename InputIt, details::enable_if_wait_policy_t<WaitPolicy> = 0>
+        std::pair<size_t, bool> push_n(WaitPolicy&&, InputIt first, size_t count) const
+        {
+            size_t pushed = 0;
+            auto blocking = true;
+            auto ok = true;
+
+            for (; pushed < count; ++pushed, ++first)
+            {
+                const auto acquisition = _emplace(blocking, *first);
+                if (!acquisition.acquired)
+                {
+                    ok = acquisition.alive;
+                    break;
+                }
+
+                if constexpr (!std::remove_reference_t<WaitPolicy>::_block_forever)
+                {
+                    blocking = false;
+                }
+            }
+
+            return { pushed, ok };
+        }
+
+    private:
+        template<typename... Args>
+        details::acquisition _emplace(bool blocking, Args&&... args) const
+        {
+            if constexpr (std::is_nothrow_constructible_v<T, Args&&...>)
+            {
+                const auto acquisition = _arc->producer_acquire(blocking);
+                if (acquisition.acquired)
+                {
+                    new (_arc->slot(acquisition.position)) T(std::forward<Args>(args)...);
+                    _arc->producer_release(acquisition);
+                }
+                return acquisition;
+            }
+            else
+            {
+                T item(std::forward<Args>(args)...);
+                return _emplace(blocking, std::move(item));
+            }
+        }
+
+        void drop()
+        {
+            if (_arc)
+            {
+                _arc->drop_producer();
+            }
+        }
+
+        details::arc<T>* _arc = nullptr;
+    };
+
+    template<typename T>
+    struct consumer
+    {
+        explicit consumer(details::arc<T>* arc) noexcept :
+            _arc(arc) {}
+
+        consumer(const consumer<T>&) = delete;
+        consumer& operator=(const consumer<T>&) = delete;
+
+        consumer(consumer<T>&& other) noexcept
+        {
+            drop();
+            _arc = std::exchange(other._arc, nullptr);
+        }
+
+        consumer<T>& operator=(consumer<T>&& other) noexcept
+        {
+            drop();
+            _arc = std::exchange(other._arc, nullptr);
+            return *this;
+        }
+
+        ~consumer()
+        {
+            drop();
+        }
+
+        // pop returns the next item in the queue, or std::nullopt if all producers are gone.
+        std::optional<T> pop() const
+        {
+            const auto acquisition = _arc->consumer_acquire(true);
+            if (!acquisition.acquired)
+            {
+                return std::nullopt;
+            }
+
+            const auto slot = _arc->slot(acquisition.position);
+            std::optional<T> item{ std::move(*slot) };
+            std::destroy_at(slot);
+
+            _arc->consumer_release(acquisition);
+            return item;
+        }
+
+        template<typename OutputIt>
+        std::pair<size_t, bool> pop_n(OutputIt first, size_t count) const
+        {
+            return pop_n(block_forever, first, count);
+        }
+
+        // pop_n reads up to count items into first.
+        // The amount of successfully read items is returned as the first pair field.
+        // The second pair field will be false if all producers are gone.
+        template<typename WaitPolicy, typename OutputIt, details::enable_if_wait_policy_t<WaitPolicy> = 0>
+        std::pair<size_t, bool> pop_n(WaitPolicy&&, OutputIt first, size_t count) const
+        {
+            size_t popped = 0;
+            auto blocking = true;
+            auto ok = true;
+
+            for (; popped < count; ++popped, ++first)
+            {
+                const auto acquisition = _arc->consumer_acquire(blocking);
+                if (!acquisition.acquired)
+                {
+                    ok = acquisition.alive;
+                    break;
+                }
+
+                const auto slot = _arc->slot(acquisition.position);
+                *first = std::move(*slot);
+                std::destroy_at(slot);
+
+                _arc->consumer_release(acquisition);
+
+                if constexpr (!std::remove_reference_t<WaitPolicy>::_block_forever)
+                {
+                    blocking = false;
+                }
+            }
+
+            return { popped, ok };
+        }
+
+    private:
+        void drop()
+        {
+            if (_arc)
+            {
+                _arc->drop_consumer();
+            }
+        }
+
+        details::arc<T>* _arc = nullptr;
+    };
+
+    // channel returns a bounded, lock-free, multi-producer, single-consumer
+    // FIFO queue ("channel") with the given maximum capacity.
+    // The capacity is rounded up to the next power of two (and at least 2).
+    template<typename T>
+    std::pair<producer<T>, consumer<T>> channel(uint32_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument{ "invalid capacity" };
+        }
+        if (capacity > details::max_capacity)
+        {
+            throw std::overflow_error{ "size too large for mpsc" };
+        }
+
+        size_type actual = 2;
+        while (actual < capacity)
+        {
+            actual <<= 1;
+        }
+
+        const auto arc = new details::arc<T>(actual);
+        return { std::piecewise_construct, std::forward_as_tuple(arc), std::forward_as_tuple(arc) };
+    }
+}
@@ -197,6 +197,13 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 return *operator+(offset);
             }
 
+            // Returns the number of times this iterator would continue yielding
+            // the current value with operator++(), including the current position.
+            [[nodiscard]] size_type remaining_run_length() const noexcept
+            {
+                return _it->length - _pos;
+            }
+
             [[nodiscard]] bool operator==(const rle_iterator& right) const noexcept
             {
                 return _it == right._it && _pos == right._pos;
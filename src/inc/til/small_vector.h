@@ -415,6 +415,8 @@ namespace til
         constexpr pointer data() noexcept { return _data; }
         constexpr const_pointer data() const noexcept { return _data; }
         constexpr size_type capacity() const noexcept { return _capacity; }
+        // Returns true if the items are stored in the inline buffer, as opposed to the heap.
+        constexpr bool is_small() const noexcept { return _capacity == N; }
         constexpr size_type size() const noexcept { return _size; }
         constexpr size_type empty() const noexcept { return _size == 0; }
 
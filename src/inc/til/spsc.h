@@ -65,6 +65,14 @@ namespace til::spsc
                 _value.store(desired, order);
             }
 
+            size_type fetch_add(size_type arg, std::memory_order order) noexcept
+            {
+#if _TIL_SPSC_DETAIL_POSITION_IMPL_FALLBACK
+                std::lock_guard<std::mutex> lock{ _m };
+#endif
+                return _value.fetch_add(arg, order);
+            }
+
             void wait(size_type old, [[maybe_unused]] std::memory_order order) const noexcept
             {
 #if _TIL_SPSC_DETAIL_POSITION_IMPL_WIN
@@ -89,6 +97,17 @@ namespace til::spsc
 #endif
             }
 
+            void notify_all() noexcept
+            {
+#if _TIL_SPSC_DETAIL_POSITION_IMPL_WIN
+                WakeByAddressAll(&_value);
+#elif _TIL_SPSC_DETAIL_POSITION_IMPL_LINUX
+                futex(FUTEX_WAKE_PRIVATE, INT_MAX);
+#elif _TIL_SPSC_DETAIL_POSITION_IMPL_FALLBACK
+                _cv.notify_all();
+#endif
+            }
+
         private:
 #if _TIL_SPSC_DETAIL_POSITION_IMPL_LINUX
             inline void futex(int futex_op, size_type val) const noexcept
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "mutex.h"
+
+namespace til
+{
+    // task_pool is a Win32 threadpool with a limited number of threads.
+    //
+    // The process-wide default threadpool allows up to 500 threads. If every pane
+    // ran its parallel work on it, we'd end up with far more threads than cores.
+    // All parallel work should thus run on task_pool::shared() instead, which
+    // is limited to the number of logical cores, so that it's naturally
+    // load-balanced no matter how many panes (or subsystems) submit work.
+    class task_pool
+    {
+    public:
+        explicit task_pool(DWORD maxThreads) :
+            _pool{ CreateThreadpool(nullptr) },
+            _concurrency{ std::max<DWORD>(1, maxThreads) }
+        {
+            THROW_LAST_ERROR_IF(!_pool);
+            SetThreadpoolThreadMaximum(_pool.get(), _concurrency);
+            THROW_IF_WIN32_BOOL_FALSE(SetThreadpoolThreadMinimum(_pool.get(), 1));
+
+            InitializeThreadpoolEnvironment(&_environment);
+            SetThreadpoolCallbackPool(&_environment, _pool.get());
+        }
+
+        task_pool(const task_pool&) = delete;
+        task_pool& operator=(const task_pool&) = delete;
+        task_pool(task_pool&&) = delete;
+        task_pool& operator=(task_pool&&) = delete;
+
+        ~task_pool()
+        {
+            DestroyThreadpoolEnvironment(&_environment);
+        }
+
+        // The pool shared by everything in this module, with one thread per logical core.
+        static task_pool& shared()
+        {
+            static task_pool pool{ std::thread::hardware_concurrency() };
+            return pool;
+        }
+
+        // The maximum number of tasks that run concurrently.
+        DWORD concurrency() const noexcept
+        {
+            return _concurrency;
+        }
+
+        PTP_CALLBACK_ENVIRON environment() noexcept
+        {
+            return &_environment;
+        }
+
+    private:
+        wil::unique_any<PTP_POOL, decltype(&::CloseThreadpool), ::CloseThreadpool> _pool;
+        DWORD _concurrency;
+        TP_CALLBACK_ENVIRON _environment{};
+    };
+
+    // task_group runs tasks on a task_pool and allows you to wait for or cancel all of them.
+    //
+    // Tasks can either be invocable as `void()` or as `void(std::stop_token)`. The latter allows
+    // long-running tasks to return early once cancel() has been called. Tasks that haven't
+    // started yet when cancel() is called won't run at all. A canceled task_group stays canceled.
+    //
+    // NOTE: Don't call wait() from within one of the group's own tasks.
+    class task_group
+    {
+    public:
+        explicit task_group(task_pool& pool = task_pool::shared()) :
+            _work{ _createWork(pool) }
+        {
+        }
+
+        // task_group uses its `this` pointer when creating _work.
+        // Since the work object cannot be recreated, instances cannot be moved either.
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+        task_group(task_group&&) = delete;
+        task_group& operator=(task_group&&) = delete;
+
+        // Cancels all remaining tasks and waits for the running ones to finish.
+        ~task_group()
+        {
+            cancel();
+            WaitForThreadpoolWorkCallbacks(_work.get(), TRUE);
+        }
+
+        template<typename F>
+        void run(F&& func)
+        {
+            if (_source.stop_requested())
+            {
+                return;
+            }
+
+            if constexpr (std::is_invocable_v<F&, std::stop_token>)
+            {
+                _state.lock()->tasks.emplace_back([func = std::forward<F>(func), token = _source.get_token()]() mutable {
+                    func(token);
+                });
+            }
+            else
+            {
+                _state.lock()->tasks.emplace_back(std::forward<F>(func));
+            }
+
+            // Each submission results in exactly one callback, which runs exactly one task, if any is left.
+            SubmitThreadpoolWork(_work.get());
+        }
+
+        // Requests all running tasks to stop via their std::stop_token and drops the ones that haven't started yet.
+        void cancel() noexcept
+        {
+            _source.request_stop();
+
+            // Destroy the tasks outside of the lock, in case their destructors are expensive.
+            std::deque<std::function<void()>> tasks;
+            std::swap(tasks, _state.lock()->tasks);
+        }
+
+        std::stop_token token() const noexcept
+        {
+            return _source.get_token();
+        }
+
+        // Waits for all tasks to finish. If any of them threw an exception, the first one is rethrown here.
+        void wait()
+        {
+            // Instead of blocking the calling thread while tasks are still queued, we help by running
+            // them ourselves. This also guarantees progress if all pool threads are busy (or blocked).
+            while (_runOne())
+            {
+            }
+
+            WaitForThreadpoolWorkCallbacks(_work.get(), FALSE);
+
+            if (auto exception = std::exchange(_state.lock()->exception, nullptr))
+            {
+                std::rethrow_exception(std::move(exception));
+            }
+        }
+
+    private:
+        struct state
+        {
+            std::deque<std::function<void()>> tasks;
+            std::exception_ptr exception;
+        };
+
+        static void __stdcall _workCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WORK /*work*/) noexcept
+        {
+            static_cast<task_group*>(context)->_runOne();
+        }
+
+        wil::unique_threadpool_work _createWork(task_pool& pool)
+        {
+            wil::unique_threadpool_work work{ CreateThreadpoolWork(&_workCallback, this, pool.environment()) };
+            THROW_LAST_ERROR_IF(!work);
+            return work;
+        }
+
+        // Runs the next queued task and returns true, or returns false if there was none.
+        bool _runOne() noexcept
+        {
+            std::function<void()> task;
+
+            {
+                const auto guard = _state.lock();
+                if (guard->tasks.empty())
+                {
+                    return false;
+                }
+                task = std::move(guard->tasks.front());
+                guard->tasks.pop_front();
+            }
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                // The remaining tasks are pointless now. This matches how
+                // parallel algorithms in the STL behave on exceptions.
+                _source.request_stop();
+
+                const auto guard = _state.lock();
+                if (!guard->exception)
+                {
+                    guard->exception = std::current_exception();
+                }
+            }
+
+            return true;
+        }
+
+        std::stop_source _source;
+        til::shared_mutex<state> _state;
+        wil::unique_threadpool_work _work;
+    };
+
+    // Splits [0, count) into chunks of at least `grain` items and calls func(begin, end) for each of them
+    // in parallel on the given task_pool. The calling thread processes the first chunk itself.
+    template<typename F>
+    void parallel_for(size_t count, size_t grain, F&& func, task_pool& pool = task_pool::shared())
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // More chunks than threads would only add overhead, since the pool is load-balanced already.
+        grain = std::max<size_t>(grain, 1);
+        const auto chunks = std::clamp<size_t>(count / grain, 1, pool.concurrency());
+        const auto chunkSize = (count + chunks - 1) / chunks;
+
+        if (chunks == 1)
+        {
+            func(size_t{ 0 }, count);
+            return;
+        }
+
+        task_group group{ pool };
+
+        for (auto beg = chunkSize; beg < count; beg += chunkSize)
+        {
+            const auto end = std::min(beg + chunkSize, count);
+            group.run([&func, beg, end]() {
+                func(beg, end);
+            });
+        }
+
+        func(size_t{ 0 }, chunkSize);
+        group.wait();
+    }
+}
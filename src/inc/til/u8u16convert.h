@@ -21,6 +21,10 @@ Author(s):
 
 #pragma once
 
+#if defined(TIL_SSE_INTRINSICS)
+#include <emmintrin.h>
+#endif
+
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
     // state structure for maintenance of UTF-8 partials
@@ -47,6 +51,74 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         }
     };
 
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26481 26490) // pointer arithmetic, reinterpret_cast
+        // Widens the leading run of ASCII characters in `in` into `out` and returns its length.
+        // Output from VT applications is mostly ASCII and this is several times faster than
+        // MultiByteToWideChar, which is then only called for the remainder, if any.
+        inline int u8u16AsciiPrefix(const char* in, const int length, wchar_t* out) noexcept
+        {
+            int i = 0;
+
+#if defined(TIL_SSE_INTRINSICS)
+            const auto z = _mm_setzero_si128();
+            for (; i + 16 <= length; i += 16)
+            {
+                const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                // Any byte with the high bit set isn't ASCII.
+                if (_mm_movemask_epi8(v))
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(v, z));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(v, z));
+            }
+#endif
+
+            for (; i < length && static_cast<uint8_t>(in[i]) < 0x80; ++i)
+            {
+                out[i] = static_cast<wchar_t>(in[i]);
+            }
+
+            return i;
+        }
+
+        // Narrows the leading run of ASCII characters in `in` into `out` and returns its length.
+        // This is the counterpart of u8u16AsciiPrefix for WideCharToMultiByte.
+        inline int u16u8AsciiPrefix(const wchar_t* in, const int length, char* out) noexcept
+        {
+            int i = 0;
+
+#if defined(TIL_SSE_INTRINSICS)
+            const auto z = _mm_setzero_si128();
+            const auto nonAscii = _mm_set1_epi16(static_cast<short>(0xff80));
+            for (; i + 16 <= length; i += 16)
+            {
+                const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+                // _mm_packus_epi16 treats its inputs as signed, so we can't use it to detect
+                // non-ASCII characters. Instead, check that no bits above 0x7F are set.
+                const auto high = _mm_and_si128(_mm_or_si128(a, b), nonAscii);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, z)) != 0xffff)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+            }
+#endif
+
+            for (; i < length && in[i] < 0x80; ++i)
+            {
+                out[i] = static_cast<char>(in[i]);
+            }
+
+            return i;
+        }
+#pragma warning(pop)
+    }
+
     // Routine Description:
     // - Takes a UTF-8 string and performs the conversion to UTF-16. NOTE: The function relies on getting complete UTF-8 characters at the string boundaries.
     // Arguments:
@@ -70,7 +142,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
             out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(CP_UTF8, 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
+            auto lengthOut = details::u8u16AsciiPrefix(in.data(), lengthRequired, out.data());
+            if (lengthOut < lengthRequired)
+            {
+                const auto remaining = lengthRequired - lengthOut;
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+                const auto convLen = MultiByteToWideChar(CP_UTF8, 0ul, in.data() + lengthOut, remaining, out.data() + lengthOut, remaining);
+                lengthOut = convLen == 0 ? 0 : lengthOut + convLen;
+            }
             out.resize(gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
@@ -156,6 +235,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
             }
 
+            if (len8)
+            {
+                const auto ascii = details::u8u16AsciiPrefix(cursor8, len8, out.data() + len16);
+                cursor8 += ascii;
+                len8 -= ascii;
+                len16 += ascii;
+                capa16 -= ascii;
+            }
+
             if (len8)
             {
                 const auto convLen{ MultiByteToWideChar(CP_UTF8, 0UL, cursor8, len8, out.data() + len16, capa16) };
@@ -197,7 +285,13 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // Thus, the worst ratio of UTF-16 code units to UTF-8 code units is 1 to 3.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthIn) || !base::CheckMul(lengthIn, 3).AssignIfValid(&lengthRequired));
             out.resize(gsl::narrow_cast<size_t>(lengthRequired)); // avoid to call WideCharToMultiByte twice only to get the required size
-            const int lengthOut = WideCharToMultiByte(CP_UTF8, 0ul, in.data(), lengthIn, out.data(), lengthRequired, nullptr, nullptr);
+            auto lengthOut = details::u16u8AsciiPrefix(in.data(), lengthIn, out.data());
+            if (lengthOut < lengthIn)
+            {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+                const auto convLen = WideCharToMultiByte(CP_UTF8, 0ul, in.data() + lengthOut, lengthIn - lengthOut, out.data() + lengthOut, lengthRequired - lengthOut, nullptr, nullptr);
+                lengthOut = convLen == 0 ? 0 : lengthOut + convLen;
+            }
             out.resize(gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
@@ -257,6 +351,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
             }
 
+            if (len16)
+            {
+                const auto ascii = details::u16u8AsciiPrefix(cursor16, len16, out.data() + len8);
+                cursor16 += ascii;
+                len16 -= ascii;
+                len8 += ascii;
+                capa8 -= ascii;
+            }
+
             if (len16)
             {
                 const auto convLen{ WideCharToMultiByte(CP_UTF8, 0UL, cursor16, len16, out.data() + len8, capa8, nullptr, nullptr) };
@@ -159,8 +159,25 @@ void Clipboard::StringPaste(_In_reads_(cchData) const wchar_t* const pData,
 
         const auto vtInputMode = gci.pInputBuffer->IsInVirtualTerminalInputMode();
         const auto bracketedPasteMode = gci.GetBracketedPasteMode();
-        auto inEvents = TextToKeyEvents(pData, cchData, vtInputMode && bracketedPasteMode);
-        gci.pInputBuffer->Write(inEvents);
+
+        // VT input mode clients and cooked reads only care about the characters and not about the keys
+        // that produced them. Synthesizing key events (at least 2 per character) is what makes pasting
+        // large amounts of text slow, so we skip that for them and write the text directly instead.
+        if (vtInputMode || gci.HasPendingCookedRead())
+        {
+            auto text = PrepareTextForPaste(pData, cchData, vtInputMode && bracketedPasteMode);
+            if (vtInputMode && bracketedPasteMode)
+            {
+                text.insert(0, L"\x1b[200~");
+                text.append(L"\x1b[201~");
+            }
+            gci.pInputBuffer->WriteString(text);
+        }
+        else
+        {
+            auto inEvents = TextToKeyEvents(pData, cchData, vtInputMode && bracketedPasteMode);
+            gci.pInputBuffer->Write(inEvents);
+        }
     }
     catch (...)
     {
@@ -219,36 +236,23 @@ void Clipboard::_copyToClipboardRegisteredFormat(const wchar_t* format, const vo
 }
 
 // Routine Description:
-// - converts a wchar_t* into a series of KeyEvents as if it was typed
-// from the keyboard
+// - Applies the paste filters (see FilterCharacterOnPaste) and line ending fixups to the given text.
 // Arguments:
-// - pData - the text to convert
+// - pData - the text to paste
 // - cchData - the size of pData, in wchars
-// - bracketedPaste - should this be bracketed with paste control sequences
+// - bracketedPaste - whether the text will be bracketed with paste control sequences
 // Return Value:
-// - deque of KeyEvents that represent the string passed in
+// - the text as it should be sent to the client
 // Note:
 // - will throw exception on error
-InputEventQueue Clipboard::TextToKeyEvents(_In_reads_(cchData) const wchar_t* const pData,
-                                           const size_t cchData,
-                                           const bool bracketedPaste)
+std::wstring Clipboard::PrepareTextForPaste(_In_reads_(cchData) const wchar_t* const pData,
+                                            const size_t cchData,
+                                            const bool bracketedPaste)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, pData);
 
-    InputEventQueue keyEvents;
-    const auto pushControlSequence = [&](const std::wstring_view sequence) {
-        std::for_each(sequence.begin(), sequence.end(), [&](const auto wch) {
-            keyEvents.push_back(SynthesizeKeyEvent(true, 1, 0, 0, wch, 0));
-            keyEvents.push_back(SynthesizeKeyEvent(false, 1, 0, 0, wch, 0));
-        });
-    };
-
-    // When a bracketed paste is requested, we need to wrap the text with
-    // control sequences which indicate that the content has been pasted.
-    if (bracketedPaste)
-    {
-        pushControlSequence(L"\x1b[200~");
-    }
+    std::wstring text;
+    text.reserve(cchData);
 
     for (size_t i = 0; i < cchData; ++i)
     {
@@ -288,8 +292,49 @@ InputEventQueue Clipboard::TextToKeyEvents(_In_reads_(cchData) const wchar_t* co
             currentChar = UNICODE_CARRIAGERETURN;
         }
 
-        const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
-        CharToKeyEvents(currentChar, codepage, keyEvents);
+        text.push_back(currentChar);
+    }
+
+    return text;
+}
+
+// Routine Description:
+// - converts a wchar_t* into a series of KeyEvents as if it was typed
+// from the keyboard
+// Arguments:
+// - pData - the text to convert
+// - cchData - the size of pData, in wchars
+// - bracketedPaste - should this be bracketed with paste control sequences
+// Return Value:
+// - deque of KeyEvents that represent the string passed in
+// Note:
+// - will throw exception on error
+InputEventQueue Clipboard::TextToKeyEvents(_In_reads_(cchData) const wchar_t* const pData,
+                                           const size_t cchData,
+                                           const bool bracketedPaste)
+{
+    THROW_HR_IF_NULL(E_INVALIDARG, pData);
+
+    InputEventQueue keyEvents;
+    const auto pushControlSequence = [&](const std::wstring_view sequence) {
+        std::for_each(sequence.begin(), sequence.end(), [&](const auto wch) {
+            keyEvents.push_back(SynthesizeKeyEvent(true, 1, 0, 0, wch, 0));
+            keyEvents.push_back(SynthesizeKeyEvent(false, 1, 0, 0, wch, 0));
+        });
+    };
+
+    // When a bracketed paste is requested, we need to wrap the text with
+    // control sequences which indicate that the content has been pasted.
+    if (bracketedPaste)
+    {
+        pushControlSequence(L"\x1b[200~");
+    }
+
+    const auto text = PrepareTextForPaste(pData, cchData, bracketedPaste);
+    const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+    for (const auto wch : text)
+    {
+        CharToKeyEvents(wch, codepage, keyEvents);
     }
 
     if (bracketedPaste)
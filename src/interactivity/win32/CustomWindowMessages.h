@@ -27,6 +27,7 @@
 #ifdef DBG
 #define CM_SET_KEY_STATE         (WM_USER+18)
 #define CM_SET_KEYBOARD_LAYOUT   (WM_USER+19)
+#define CM_TRACE_PROCESS_STATISTICS (WM_USER+20)
 #endif
 
 // clang-format on
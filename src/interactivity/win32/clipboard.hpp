@@ -39,6 +39,9 @@ namespace Microsoft::Console::Interactivity::Win32
         static void _copyToClipboardRegisteredFormat(const wchar_t* format, const void* src, size_t bytes);
 
         void StringPaste(_In_reads_(cchData) PCWCHAR pwchData, const size_t cchData);
+        std::wstring PrepareTextForPaste(_In_reads_(cchData) const wchar_t* const pData,
+                                         const size_t cchData,
+                                         const bool bracketedPaste = false);
         InputEventQueue TextToKeyEvents(_In_reads_(cchData) const wchar_t* const pData,
                                         const size_t cchData,
                                         const bool bracketedPaste = false);
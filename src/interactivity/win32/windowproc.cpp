@@ -808,6 +808,12 @@ static constexpr TsfDataProvider s_tsfDataProvider;
         }
         break;
     }
+
+    case CM_TRACE_PROCESS_STATISTICS:
+    {
+        gci.ProcessHandleList.TraceProcessStatistics();
+        break;
+    }
 #endif // DBG
 
     case EVENT_CONSOLE_CARET:
@@ -185,10 +185,21 @@ constexpr HRESULT vec2_narrow(U x, U y, vec2<T>& out) noexcept
 
 [[nodiscard]] HRESULT AtlasEngine::UpdateSoftFont(const std::span<const uint16_t> bitPattern, const til::size cellSize, const size_t centeringHint) noexcept
 {
+    const til::size clampedCellSize{ std::max(0, cellSize.width), std::max(0, cellSize.height) };
+
+    // Applications that rely on soft fonts tend to send the same DECDLD sequence every time they redraw
+    // their UI. Writing to the font settings resets the entire glyph atlas, so we only do so on changes.
+    {
+        const auto& font = *_api.s->font;
+        if (font.softFontCellSize == clampedCellSize && std::equal(font.softFontPattern.begin(), font.softFontPattern.end(), bitPattern.begin(), bitPattern.end()))
+        {
+            return S_OK;
+        }
+    }
+
     const auto softFont = _api.s.write()->font.write();
     softFont->softFontPattern.assign(bitPattern.begin(), bitPattern.end());
-    softFont->softFontCellSize.width = std::max(0, cellSize.width);
-    softFont->softFontCellSize.height = std::max(0, cellSize.height);
+    softFont->softFontCellSize = clampedCellSize;
     return S_OK;
 }
 
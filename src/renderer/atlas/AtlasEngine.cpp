@@ -4,11 +4,14 @@
 #include "pch.h"
 #include "AtlasEngine.h"
 
+#include <future>
+
 #include <til/unicode.h>
 
 #include "Backend.h"
 #include "BuiltinGlyphs.h"
 #include "DWriteTextAnalysis.h"
+#include "../base/FontCache.h"
 #include "../../interactivity/win32/CustomWindowMessages.h"
 
 // #### NOTE ####
@@ -29,6 +32,10 @@
 
 using namespace Microsoft::Console::Render::Atlas;
 
+// Concurrent shaping in _shapeBufferLines() only pays off if each thread gets a decent amount of lines.
+static constexpr size_t shapingMinLinesPerChunk = 32;
+static constexpr size_t shapingMaxChunks = 4;
+
 #pragma warning(suppress : 26455) // Default constructor may not throw. Declare it 'noexcept' (f.6).
 AtlasEngine::AtlasEngine()
 {
@@ -44,9 +51,16 @@ AtlasEngine::AtlasEngine()
 
     THROW_IF_FAILED(_p.dwriteFactory->GetSystemFontFallback(_api.systemFontFallback.addressof()));
 
-    wil::com_ptr<IDWriteTextAnalyzer> textAnalyzer;
-    THROW_IF_FAILED(_p.dwriteFactory->CreateTextAnalyzer(textAnalyzer.addressof()));
-    _p.textAnalyzer = textAnalyzer.query<IDWriteTextAnalyzer1>();
+    // The nearby font collection may be needed by the first UpdateFont() call. Enumerating and loading
+    // the font files takes a while, so we start doing that now, while the window is being set up.
+    if constexpr (Feature_NearbyFontLoading::IsEnabled())
+    {
+        try
+        {
+            FontCache::Prefetch();
+        }
+        CATCH_LOG();
+    }
 }
 
 #pragma region IRenderEngine
@@ -76,6 +90,12 @@ try
 
     if (ATLAS_DEBUG_DISABLE_PARTIAL_INVALIDATION || _hackTriggerRedrawAll)
     {
+        // The builtin glyphs toggle changes how lines get shaped. The cache is cleared here instead
+        // of in _recreateBackend(), because the latter is called by Present() without the lock.
+        if (_hackTriggerRedrawAll)
+        {
+            _api.shapingCache.clear();
+        }
         _hackTriggerRedrawAll = false;
         _api.invalidatedRows = invalidatedRowsAll;
         _api.scrollOffset = 0;
@@ -129,6 +149,10 @@ try
         til::CoordTypeMin,
     };
     _p.invalidatedRows = _api.invalidatedRows;
+    // Queuing up the lines costs an extra copy of their text, which is only worth it if
+    // _shapeBufferLines() can then shape them concurrently. Otherwise they're shaped right away.
+    _api.queueBufferLines = std::thread::hardware_concurrency() > 1 &&
+                            gsl::narrow_cast<size_t>(_api.invalidatedRows.end - _api.invalidatedRows.start) >= 2 * shapingMinLinesPerChunk;
     _p.cursorRect = {};
     _p.scrollOffset = _api.scrollOffset;
 
@@ -222,6 +246,8 @@ try
     {
         const til::CoordType targetSizeX = _p.s->targetSize.x;
         const til::CoordType targetSizeY = _p.s->targetSize.y;
+        // Same as the projectedTextSize in _recreateCellCountDependentResources(), with some headroom.
+        const auto glyphCapacityLimit = static_cast<size_t>(_p.s->viewportCellCount.x) * 4;
 
         _p.dirtyRectInPx.left = 0;
         _p.dirtyRectInPx.top = std::min(_p.dirtyRectInPx.top, _p.invalidatedRows.start * _p.s->font->cellSize.y);
@@ -240,7 +266,7 @@ try
                 _p.dirtyRectInPx.bottom = std::max(_p.dirtyRectInPx.bottom, clampedBottom);
             }
 
-            r->Clear(y, _p.s->font->cellSize.y);
+            r->Clear(y, _p.s->font->cellSize.y, glyphCapacityLimit);
         }
     }
 
@@ -256,6 +282,7 @@ CATCH_RETURN()
 try
 {
     _flushBufferLine();
+    _shapeBufferLines();
 
     // PaintCursor() is only called when the cursor is visible, but we need to invalidate the cursor area
     // even if it isn't. Otherwise a transition from a visible to an invisible cursor wouldn't be rendered.
@@ -521,6 +548,32 @@ try
 }
 CATCH_RETURN()
 
+[[nodiscard]] HRESULT AtlasEngine::PaintImageSlice(const ImageSlice& imageSlice, const til::CoordType targetRow, const til::CoordType viewportLeft) noexcept
+try
+{
+    const auto y = gsl::narrow_cast<u16>(clamp<til::CoordType>(targetRow, 0, _p.s->viewportCellCount.y - 1));
+    auto& bitmap = _p.rows[y]->bitmap;
+
+    // The ShapedRow and thus its bitmap survive scrolling, so we only need to copy the pixels if they changed.
+    if (bitmap.revision != imageSlice.Revision())
+    {
+        const auto pixels = imageSlice.Pixels();
+        bitmap.revision = imageSlice.Revision();
+        bitmap.source.assign(pixels.begin(), pixels.end());
+        bitmap.sourceSize = {
+            gsl::narrow_cast<u16>(imageSlice.PixelWidth()),
+            gsl::narrow_cast<u16>(imageSlice.CellSize().height),
+        };
+        bitmap.tiles.clear();
+    }
+
+    bitmap.targetOffset = imageSlice.ColumnOffset() - viewportLeft;
+    bitmap.targetWidth = imageSlice.ColumnEnd() - imageSlice.ColumnOffset();
+    bitmap.active = !bitmap.source.empty() && bitmap.targetWidth > 0;
+    return S_OK;
+}
+CATCH_RETURN()
+
 [[nodiscard]] HRESULT AtlasEngine::PaintSelection(const til::rect& rect) noexcept
 try
 {
@@ -663,6 +716,7 @@ void AtlasEngine::_recreateFontDependentResources()
     _api.replacementCharacterFontFace.reset();
     _api.replacementCharacterGlyphIndex = 0;
     _api.replacementCharacterLookedUp = false;
+    _api.shapingCache.clear();
 
     {
         wchar_t localeName[LOCALE_NAME_MAX_LENGTH];
@@ -705,27 +759,31 @@ void AtlasEngine::_recreateFontDependentResources()
     }
 
     _hackWantsBuiltinGlyphs = _p.s->font->builtinGlyphs && !_hackIsBackendD2D;
+
+    for (size_t i = 0; i < _api.fontFallbackCaches.size(); ++i)
+    {
+        _api.fontFallbackCaches[i] = _getFontFallbackCache(static_cast<FontRelevantAttributes>(i));
+    }
+    _prefillFontFallbackCache();
+    _resolveAsciiGlyphs();
 }
 
 void AtlasEngine::_recreateCellCountDependentResources()
 {
     // Let's guess that every cell consists of a surrogate pair.
     const auto projectedTextSize = static_cast<size_t>(_p.s->viewportCellCount.x) * 2;
-    // IDWriteTextAnalyzer::GetGlyphs says:
-    //   The recommended estimate for the per-glyph output buffers is (3 * textLength / 2 + 16).
-    const auto projectedGlyphSize = 3 * projectedTextSize / 2 + 16;
 
     _api.bufferLine = std::vector<wchar_t>{};
     _api.bufferLine.reserve(projectedTextSize);
     _api.bufferLineColumn.reserve(projectedTextSize + 1);
 
-    _api.analysisResults = std::vector<TextAnalysisSinkResult>{};
-    _api.clusterMap = Buffer<u16>{ projectedTextSize };
-    _api.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ projectedTextSize };
-    _api.glyphIndices = Buffer<u16>{ projectedGlyphSize };
-    _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ projectedGlyphSize };
-    _api.glyphAdvances = Buffer<f32>{ projectedGlyphSize };
-    _api.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ projectedGlyphSize };
+    for (auto& ctx : _api.shapingContexts)
+    {
+        _initializeShapingContext(ctx);
+    }
+
+    // Each row is split into multiple lines whenever the font-relevant attributes change.
+    _api.shapingCacheCapacity = std::max(_api.shapingCacheMinCapacity, _api.shapingCacheLinesPerRow * _p.s->viewportCellCount.y);
 
     _p.unorderedRows = Buffer<ShapedRow>(_p.s->viewportCellCount.y);
     _p.rowsScratch = Buffer<ShapedRow*>(_p.s->viewportCellCount.y);
@@ -765,15 +823,288 @@ void AtlasEngine::_flushBufferLine()
     // This would seriously blow us up otherwise.
     Expects(_api.bufferLineColumn.size() == _api.bufferLine.size() + 1);
 
-    const auto beg = _api.bufferLine.data();
-    const auto len = _api.bufferLine.size();
+    if (!_api.queueBufferLines)
+    {
+        if (_api.shapingContexts.empty())
+        {
+            _initializeShapingContext(_api.shapingContexts.emplace_back());
+        }
+
+        // Lend our buffers to the context instead of copying them. The cleanup above clears them afterwards.
+        auto& ctx = _api.shapingContexts[0];
+        ctx.bufferLine.swap(_api.bufferLine);
+        ctx.bufferLineColumn.swap(_api.bufferLineColumn);
+        const auto swapBack = wil::scope_exit([&]() noexcept {
+            ctx.bufferLine.swap(_api.bufferLine);
+            ctx.bufferLineColumn.swap(_api.bufferLineColumn);
+        });
+
+        ctx.y = _api.lastPaintBufferLineCoord.y;
+        ctx.attributes = _api.attributes;
+        ctx.deferCacheInserts = false;
+        _shapeBufferLine(ctx);
+        return;
+    }
+
+    auto& line = _api.pendingLines.emplace_back();
+    line.textBeg = _api.pendingLineText.size();
+    line.textEnd = line.textBeg + _api.bufferLine.size();
+    line.columnBeg = _api.pendingLineColumns.size();
+    line.y = _api.lastPaintBufferLineCoord.y;
+    line.attributes = _api.attributes;
+
+    _api.pendingLineText.insert(_api.pendingLineText.end(), _api.bufferLine.begin(), _api.bufferLine.end());
+    _api.pendingLineColumns.insert(_api.pendingLineColumns.end(), _api.bufferLineColumn.begin(), _api.bufferLineColumn.end());
+}
+
+// Shapes all the lines queued up by _flushBufferLine() during the last frame, if StartPaint() decided to queue them.
+// This is called by EndPaint() while the console lock is still held, because shaping depends on
+// the font fallback and shaping caches in _api, which UpdateFont() & co. modify concurrently.
+//
+// Every ShapedRow is independent of the others, so if there are enough lines (for instance during a full redraw)
+// they're split up into chunks at row boundaries and shaped concurrently, each chunk with its own ShapingContext.
+void AtlasEngine::_shapeBufferLines()
+{
+    const auto cleanup = wil::scope_exit([&]() noexcept {
+        _api.pendingLines.clear();
+        _api.pendingLineText.clear();
+        _api.pendingLineColumns.clear();
+    });
+
+    const auto& lines = _api.pendingLines;
+    if (lines.empty())
+    {
+        return;
+    }
+
+    // The replacement character is looked up lazily, but that would be racy during concurrent shaping.
+    if (!_api.replacementCharacterLookedUp)
+    {
+        _lookupReplacementCharacter();
+    }
+
+    auto chunkCount = std::min<size_t>(lines.size() / shapingMinLinesPerChunk, std::min<size_t>(std::thread::hardware_concurrency(), shapingMaxChunks));
+
+    // Lines belonging to the same row must be shaped in order, by the same thread. Renderer paints rows
+    // top to bottom and so that's what we expect here. If that's ever not the case, we shape serially.
+    for (size_t i = 1; chunkCount > 1 && i < lines.size(); ++i)
+    {
+        if (lines[i].y < lines[i - 1].y)
+        {
+            chunkCount = 1;
+        }
+    }
+
+    chunkCount = std::max<size_t>(chunkCount, 1);
+    while (_api.shapingContexts.size() < chunkCount)
+    {
+        _initializeShapingContext(_api.shapingContexts.emplace_back());
+    }
+
+    if (chunkCount == 1)
+    {
+        auto& ctx = _api.shapingContexts[0];
+        ctx.deferCacheInserts = false;
+        _shapeBufferLineRange(ctx, 0, lines.size());
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunkCount - 1);
+
+    size_t chunkBeg = 0;
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        auto chunkEnd = lines.size();
+        if (chunk + 1 < chunkCount)
+        {
+            // Move the boundary forward until it doesn't split up a row.
+            chunkEnd = std::max(chunkBeg + 1, lines.size() * (chunk + 1) / chunkCount);
+            while (chunkEnd < lines.size() && lines[chunkEnd].y == lines[chunkEnd - 1].y)
+            {
+                ++chunkEnd;
+            }
+        }
+
+        auto& ctx = _api.shapingContexts[chunk];
+        ctx.deferCacheInserts = true;
+
+        if (chunk + 1 < chunkCount)
+        {
+            futures.emplace_back(std::async(std::launch::async, [this, &ctx, chunkBeg, chunkEnd]() {
+                _shapeBufferLineRange(ctx, chunkBeg, chunkEnd);
+            }));
+        }
+        else
+        {
+            _shapeBufferLineRange(ctx, chunkBeg, chunkEnd);
+        }
+
+        chunkBeg = chunkEnd;
+    }
+
+    for (auto& future : futures)
+    {
+        future.get();
+    }
+
+    // The shaping cache is shared between all contexts and must not be modified during concurrent shaping.
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        auto& ctx = _api.shapingContexts[chunk];
+        for (auto& [hash, entry] : ctx.newCacheEntries)
+        {
+            _insertShapingCacheEntry(hash, std::move(entry));
+        }
+        ctx.newCacheEntries.clear();
+    }
+}
+
+void AtlasEngine::_shapeBufferLineRange(ShapingContext& ctx, size_t beg, size_t end)
+{
+    const auto textBeg = _api.pendingLineText.begin();
+
+    for (auto i = beg; i < end; ++i)
+    {
+        const auto& line = _api.pendingLines[i];
+        const auto columnBeg = _api.pendingLineColumns.begin() + line.columnBeg;
+
+        ctx.bufferLine.assign(textBeg + line.textBeg, textBeg + line.textEnd);
+        ctx.bufferLineColumn.assign(columnBeg, columnBeg + (line.textEnd - line.textBeg + 1));
+        ctx.y = line.y;
+        ctx.attributes = line.attributes;
+
+        _shapeBufferLine(ctx);
+    }
+}
+
+void AtlasEngine::_insertShapingCacheEntry(size_t hash, ShapingCacheEntry&& entry)
+{
+    if (_api.shapingCache.size() >= _api.shapingCacheCapacity)
+    {
+        _api.shapingCache.clear();
+    }
+
+    _api.shapingCache.insert_or_assign(hash, std::move(entry));
+}
+
+void AtlasEngine::_initializeShapingContext(ShapingContext& ctx)
+{
+    if (!ctx.textAnalyzer)
+    {
+        wil::com_ptr<IDWriteTextAnalyzer> textAnalyzer;
+        THROW_IF_FAILED(_p.dwriteFactory->CreateTextAnalyzer(textAnalyzer.addressof()));
+        ctx.textAnalyzer = textAnalyzer.query<IDWriteTextAnalyzer1>();
+    }
+
+    // Let's guess that every cell consists of a surrogate pair.
+    const auto projectedTextSize = static_cast<size_t>(_p.s->viewportCellCount.x) * 2;
+    // IDWriteTextAnalyzer::GetGlyphs says:
+    //   The recommended estimate for the per-glyph output buffers is (3 * textLength / 2 + 16).
+    const auto projectedGlyphSize = 3 * projectedTextSize / 2 + 16;
+
+    ctx.bufferLine = std::vector<wchar_t>{};
+    ctx.bufferLine.reserve(projectedTextSize);
+    ctx.bufferLineColumn = std::vector<u16>{};
+    ctx.bufferLineColumn.reserve(projectedTextSize + 1);
+
+    ctx.analysisResults = std::vector<TextAnalysisSinkResult>{};
+    ctx.clusterMap = Buffer<u16>{ projectedTextSize };
+    ctx.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ projectedTextSize };
+    ctx.glyphIndices = Buffer<u16>{ projectedGlyphSize };
+    ctx.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ projectedGlyphSize };
+    ctx.glyphAdvances = Buffer<f32>{ projectedGlyphSize };
+    ctx.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ projectedGlyphSize };
+}
+
+void AtlasEngine::_shapeBufferLine(ShapingContext& ctx)
+{
+    auto& row = *_p.rows[ctx.y];
+    const auto columnBeg = ctx.bufferLineColumn.front();
+
+    ctx.shapingCacheColumns.clear();
+    for (const auto c : ctx.bufferLineColumn)
+    {
+        ctx.shapingCacheColumns.emplace_back(gsl::narrow_cast<u16>(c - columnBeg));
+    }
+
+    til::hasher hasher;
+    hasher.write(ctx.attributes);
+    hasher.write(ctx.bufferLine.data(), ctx.bufferLine.size());
+    hasher.write(ctx.shapingCacheColumns.data(), ctx.shapingCacheColumns.size());
+    const auto hash = hasher.finalize();
+
+    const auto glyphsBeg = row.glyphIndices.size();
+    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
+    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * ctx.y;
+
+    if (const auto it = _api.shapingCache.find(hash); it != _api.shapingCache.end())
+    {
+        const auto& entry = it->second;
+        if (entry.attributes == ctx.attributes && entry.text == ctx.bufferLine && entry.columns == ctx.shapingCacheColumns)
+        {
+            row.glyphIndices.insert(row.glyphIndices.end(), entry.glyphIndices.begin(), entry.glyphIndices.end());
+            row.glyphAdvances.insert(row.glyphAdvances.end(), entry.glyphAdvances.begin(), entry.glyphAdvances.end());
+            row.glyphOffsets.insert(row.glyphOffsets.end(), entry.glyphOffsets.begin(), entry.glyphOffsets.end());
+            for (const auto col : entry.glyphColumns)
+            {
+                row.colors.emplace_back(colors[static_cast<size_t>(columnBeg + col) << shift]);
+            }
+            for (const auto& m : entry.mappings)
+            {
+                row.mappings.emplace_back(m.fontFace, glyphsBeg + m.glyphsFrom, glyphsBeg + m.glyphsTo);
+            }
+            return;
+        }
+    }
+
+    const auto mappingsBeg = row.mappings.size();
+    ctx.glyphColumns.clear();
+    _shapeBufferLineUncached(ctx);
+
+    ShapingCacheEntry entry;
+    entry.attributes = ctx.attributes;
+    entry.text = ctx.bufferLine;
+    entry.columns = ctx.shapingCacheColumns;
+    entry.glyphIndices.assign(row.glyphIndices.begin() + glyphsBeg, row.glyphIndices.end());
+    entry.glyphAdvances.assign(row.glyphAdvances.begin() + glyphsBeg, row.glyphAdvances.end());
+    entry.glyphOffsets.assign(row.glyphOffsets.begin() + glyphsBeg, row.glyphOffsets.end());
+    for (const auto col : ctx.glyphColumns)
+    {
+        entry.glyphColumns.emplace_back(gsl::narrow_cast<u16>(col - columnBeg));
+    }
+    // _mapRegularText() may have extended the last mapping of a previous line, if it used the same font face.
+    for (auto i = mappingsBeg ? mappingsBeg - 1 : 0; i < row.mappings.size(); ++i)
+    {
+        const auto& m = row.mappings[i];
+        const auto from = std::max(m.glyphsFrom, glyphsBeg);
+        if (from < m.glyphsTo)
+        {
+            entry.mappings.emplace_back(m.fontFace, from - glyphsBeg, m.glyphsTo - glyphsBeg);
+        }
+    }
+
+    if (ctx.deferCacheInserts)
+    {
+        ctx.newCacheEntries.emplace_back(hash, std::move(entry));
+    }
+    else
+    {
+        _insertShapingCacheEntry(hash, std::move(entry));
+    }
+}
+
+void AtlasEngine::_shapeBufferLineUncached(ShapingContext& ctx)
+{
+    const auto beg = ctx.bufferLine.data();
+    const auto len = ctx.bufferLine.size();
     size_t segmentBeg = 0;
     size_t segmentEnd = 0;
     bool custom = false;
 
     if (!_hackWantsBuiltinGlyphs)
     {
-        _mapRegularText(0, len);
+        _mapRegularText(ctx, 0, len);
         return;
     }
 
@@ -802,11 +1133,11 @@ void AtlasEngine::_flushBufferLine()
         {
             if (custom)
             {
-                _mapBuiltinGlyphs(segmentBeg, segmentEnd);
+                _mapBuiltinGlyphs(ctx, segmentBeg, segmentEnd);
             }
             else
             {
-                _mapRegularText(segmentBeg, segmentEnd);
+                _mapRegularText(ctx, segmentBeg, segmentEnd);
             }
         }
 
@@ -815,72 +1146,93 @@ void AtlasEngine::_flushBufferLine()
     }
 }
 
-void AtlasEngine::_mapRegularText(size_t offBeg, size_t offEnd)
+void AtlasEngine::_mapRegularText(ShapingContext& ctx, size_t offBeg, size_t offEnd)
 {
-    auto& row = *_p.rows[_api.lastPaintBufferLineCoord.y];
+    auto& row = *_p.rows[ctx.y];
+
+    const auto& ascii = _api.asciiGlyphs[static_cast<size_t>(ctx.attributes)];
 
     for (u32 idx = gsl::narrow_cast<u32>(offBeg), mappedEnd = 0; idx < offEnd; idx = mappedEnd)
     {
-        u32 mappedLength = 0;
+        const auto initialIndicesCount = row.glyphIndices.size();
         wil::com_ptr<IDWriteFontFace2> mappedFontFace;
-        _mapCharacters(_api.bufferLine.data() + idx, gsl::narrow_cast<u32>(offEnd - idx), &mappedLength, mappedFontFace.addressof());
-        mappedEnd = idx + mappedLength;
 
-        if (!mappedFontFace)
+        // The fast path for printable ASCII, if the font qualifies for it. See _resolveAsciiGlyphs().
+        u32 asciiLength = 0;
+        if (ascii.fontFace)
         {
-            _mapReplacementCharacter(idx, mappedEnd, row);
-            continue;
+            const auto maxLength = std::min<size_t>(offEnd - idx, ctx.glyphIndices.size());
+            while (asciiLength < maxLength)
+            {
+                const auto ch = ctx.bufferLine[idx + asciiLength];
+                if (ch < AsciiGlyphs::first || ch > AsciiGlyphs::last)
+                {
+                    break;
+                }
+                ctx.glyphIndices[asciiLength] = ascii.glyphIndices[ch - AsciiGlyphs::first];
+                asciiLength++;
+            }
+            // The last character may combine with whatever non-ASCII character follows
+            // it (e.g. a combining diacritic), so we leave it to the regular path.
+            if (asciiLength && idx + asciiLength < offEnd)
+            {
+                asciiLength--;
+            }
         }
 
-        const auto initialIndicesCount = row.glyphIndices.size();
-
-        // GetTextComplexity() returns as many glyph indices as its textLength parameter (here: mappedLength).
-        // This block ensures that the buffer has sufficient capacity. It also initializes the glyphProps buffer because it and
-        // glyphIndices sort of form a "pair" in the _mapComplex() code and are always simultaneously resized there as well.
-        if (mappedLength > _api.glyphIndices.size())
+        if (asciiLength)
         {
-            auto size = _api.glyphIndices.size();
-            size = size + (size >> 1);
-            size = std::max<size_t>(size, mappedLength);
-            Expects(size > _api.glyphIndices.size());
-            _api.glyphIndices = Buffer<u16>{ size };
-            _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
+            mappedFontFace = ascii.fontFace;
+            mappedEnd = idx + asciiLength;
+            _appendSimpleGlyphs(ctx, idx, asciiLength, row);
         }
-
-        if (_p.s->font->fontFeatures.empty())
+        else
         {
-            // We can reuse idx here, as it'll be reset to "idx = mappedEnd" in the outer loop anyways.
-            for (u32 complexityLength = 0; idx < mappedEnd; idx += complexityLength)
+            u32 mappedLength = 0;
+            _mapCharacters(ctx.bufferLine.data() + idx, gsl::narrow_cast<u32>(offEnd - idx), ctx.attributes, &mappedLength, mappedFontFace.addressof());
+            mappedEnd = idx + mappedLength;
+
+            if (!mappedFontFace)
+            {
+                _mapReplacementCharacter(ctx, idx, mappedEnd, row);
+                continue;
+            }
+
+            // GetTextComplexity() returns as many glyph indices as its textLength parameter (here: mappedLength).
+            // This block ensures that the buffer has sufficient capacity. It also initializes the glyphProps buffer because it and
+            // glyphIndices sort of form a "pair" in the _mapComplex() code and are always simultaneously resized there as well.
+            if (mappedLength > ctx.glyphIndices.size())
             {
-                BOOL isTextSimple = FALSE;
-                THROW_IF_FAILED(_p.textAnalyzer->GetTextComplexity(_api.bufferLine.data() + idx, mappedEnd - idx, mappedFontFace.get(), &isTextSimple, &complexityLength, _api.glyphIndices.data()));
+                auto size = ctx.glyphIndices.size();
+                size = size + (size >> 1);
+                size = std::max<size_t>(size, mappedLength);
+                Expects(size > ctx.glyphIndices.size());
+                ctx.glyphIndices = Buffer<u16>{ size };
+                ctx.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
+            }
 
-                if (isTextSimple)
+            if (_p.s->font->fontFeatures.empty())
+            {
+                // We can reuse idx here, as it'll be reset to "idx = mappedEnd" in the outer loop anyways.
+                for (u32 complexityLength = 0; idx < mappedEnd; idx += complexityLength)
                 {
-                    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-                    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
+                    BOOL isTextSimple = FALSE;
+                    THROW_IF_FAILED(ctx.textAnalyzer->GetTextComplexity(ctx.bufferLine.data() + idx, mappedEnd - idx, mappedFontFace.get(), &isTextSimple, &complexityLength, ctx.glyphIndices.data()));
 
-                    for (size_t i = 0; i < complexityLength; ++i)
+                    if (isTextSimple)
                     {
-                        const auto col1 = _api.bufferLineColumn[idx + i + 0];
-                        const auto col2 = _api.bufferLineColumn[idx + i + 1];
-                        const auto glyphAdvance = (col2 - col1) * _p.s->font->cellSize.x;
-                        const auto fg = colors[static_cast<size_t>(col1) << shift];
-                        row.glyphIndices.emplace_back(_api.glyphIndices[i]);
-                        row.glyphAdvances.emplace_back(static_cast<f32>(glyphAdvance));
-                        row.glyphOffsets.emplace_back();
-                        row.colors.emplace_back(fg);
+                        _appendSimpleGlyphs(ctx, idx, complexityLength, row);
+                    }
+                    else
+                    {
+                        _mapComplex(ctx, mappedFontFace.get(), idx, complexityLength, row);
                     }
-                }
-                else
-                {
-                    _mapComplex(mappedFontFace.get(), idx, complexityLength, row);
                 }
             }
-        }
-        else
-        {
-            _mapComplex(mappedFontFace.get(), idx, mappedLength, row);
+            else
+            {
+                _mapComplex(ctx, mappedFontFace.get(), idx, mappedLength, row);
+            }
         }
 
         const auto indicesCount = row.glyphIndices.size();
@@ -900,13 +1252,34 @@ void AtlasEngine::_mapRegularText(size_t offBeg, size_t offEnd)
     }
 }
 
-void AtlasEngine::_mapBuiltinGlyphs(size_t offBeg, size_t offEnd)
+// Appends the glyphs for text that doesn't need shaping. It expects the glyph indices
+// for the characters [idx, idx + length) in ctx.glyphIndices, starting at offset 0.
+void AtlasEngine::_appendSimpleGlyphs(ShapingContext& ctx, u32 idx, u32 length, ShapedRow& row)
+{
+    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
+    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * ctx.y;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        const auto col1 = ctx.bufferLineColumn[idx + i + 0];
+        const auto col2 = ctx.bufferLineColumn[idx + i + 1];
+        const auto glyphAdvance = (col2 - col1) * _p.s->font->cellSize.x;
+        const auto fg = colors[static_cast<size_t>(col1) << shift];
+        row.glyphIndices.emplace_back(ctx.glyphIndices[i]);
+        row.glyphAdvances.emplace_back(static_cast<f32>(glyphAdvance));
+        row.glyphOffsets.emplace_back();
+        row.colors.emplace_back(fg);
+        ctx.glyphColumns.emplace_back(col1);
+    }
+}
+
+void AtlasEngine::_mapBuiltinGlyphs(ShapingContext& ctx, size_t offBeg, size_t offEnd)
 {
-    auto& row = *_p.rows[_api.lastPaintBufferLineCoord.y];
+    auto& row = *_p.rows[ctx.y];
     auto initialIndicesCount = row.glyphIndices.size();
     const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
-    const auto base = reinterpret_cast<const u16*>(_api.bufferLine.data());
+    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * ctx.y;
+    const auto base = reinterpret_cast<const u16*>(ctx.bufferLine.data());
     const auto len = offEnd - offBeg;
 
     row.glyphIndices.insert(row.glyphIndices.end(), base + offBeg, base + offEnd);
@@ -915,17 +1288,335 @@ void AtlasEngine::_mapBuiltinGlyphs(size_t offBeg, size_t offEnd)
 
     for (size_t i = offBeg; i < offEnd; ++i)
     {
-        const auto col = _api.bufferLineColumn[i];
+        const auto col = ctx.bufferLineColumn[i];
         row.colors.emplace_back(colors[static_cast<size_t>(col) << shift]);
+        ctx.glyphColumns.emplace_back(col);
     }
 
     row.mappings.emplace_back(nullptr, gsl::narrow_cast<u32>(initialIndicesCount), gsl::narrow_cast<u32>(row.glyphIndices.size()));
 }
 
-void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
+// Returns the codepoint at text[idx] and the number of UTF-16 code units it consists of.
+static std::pair<char32_t, u32> decodeCodepoint(const wchar_t* text, const u32 textLength, const u32 idx) noexcept
+{
+    const auto lead = text[idx];
+    if (til::is_leading_surrogate(lead) && idx + 1 < textLength && til::is_trailing_surrogate(text[idx + 1]))
+    {
+        return { til::combine_surrogates(lead, text[idx + 1]), 2 };
+    }
+    return { lead, 1 };
+}
+
+// Returns true for codepoints for which MapCharacters() picks a font regardless of the surrounding text.
+// This intentionally excludes combining marks, variation selectors, joiners, regional indicators, emoji
+// modifiers, etc., because those are mapped together with the character they're attached to.
+static bool isContextFreeCodepoint(const char32_t ch) noexcept
+{
+    static constexpr std::array<std::pair<char32_t, char32_t>, 18> ranges{ {
+        { 0x0020, 0x02FF }, // Basic Latin through Spacing Modifier Letters
+        { 0x0370, 0x0482 }, // Greek, Cyrillic (without combining marks)
+        { 0x048A, 0x052F },
+        { 0x2010, 0x2027 }, // General Punctuation (without format characters)
+        { 0x2030, 0x205E },
+        { 0x2070, 0x20CF }, // Super/Subscripts, Currency Symbols
+        { 0x2100, 0x2BFF }, // Letterlike Symbols through Miscellaneous Symbols and Arrows (incl. box drawing)
+        { 0x2E80, 0x3029 }, // CJK Radicals through CJK Symbols and Punctuation (without tone marks)
+        { 0x3030, 0x3098 }, // Hiragana (without combining sound marks)
+        { 0x309B, 0x9FFF }, // Katakana through CJK Unified Ideographs
+        { 0xAC00, 0xD7A3 }, // Hangul Syllables
+        { 0xE000, 0xF8FF }, // Private Use Area (Powerline, Nerd Fonts, etc.)
+        { 0xF900, 0xFAFF }, // CJK Compatibility Ideographs
+        { 0xFF00, 0xFFEF }, // Halfwidth and Fullwidth Forms
+        { 0x1F000, 0x1F1E5 }, // Mahjong Tiles through Enclosed Alphanumeric Supplement (without regional indicators)
+        { 0x1F200, 0x1F3FA }, // Emoji (without skin tone modifiers)
+        { 0x1F400, 0x1FAFF },
+        { 0x20000, 0x3FFFF }, // CJK Unified Ideographs Extension B and later
+    } };
+    for (const auto& [beg, end] : ranges)
+    {
+        if (ch >= beg && ch <= end)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true for context-free codepoints that belong to a specific script. Characters of the Common and
+// Inherited scripts (spaces, digits, punctuation, symbols, emoji, etc.) are supported by most fonts, so
+// MapCharacters() assigns them to whatever font the surrounding text uses. Caching them would pin
+// them to the font of the first run they appeared in (for instance a CJK font), for every pane.
+static bool isCacheableCodepoint(const char32_t ch) noexcept
+{
+    static constexpr std::array<std::pair<char32_t, char32_t>, 30> ranges{ {
+        { 0x0041, 0x005A }, // Latin
+        { 0x0061, 0x007A },
+        { 0x00C0, 0x00D6 },
+        { 0x00D8, 0x00F6 },
+        { 0x00F8, 0x02AF },
+        { 0x0388, 0x03FF }, // Greek and Coptic
+        { 0x0400, 0x0482 }, // Cyrillic (without combining marks)
+        { 0x048A, 0x052F },
+        { 0x2E80, 0x2FD5 }, // CJK Radicals, Kangxi Radicals
+        { 0x3005, 0x3005 }, // Ideographic iteration mark
+        { 0x3007, 0x3007 }, // Ideographic number zero
+        { 0x3021, 0x3029 }, // Hangzhou numerals
+        { 0x3041, 0x3096 }, // Hiragana (without combining sound marks)
+        { 0x309D, 0x309F },
+        { 0x30A1, 0x30FA }, // Katakana
+        { 0x30FD, 0x30FF },
+        { 0x3105, 0x318E }, // Bopomofo, Hangul Compatibility Jamo
+        { 0x31A0, 0x31BF }, // Bopomofo Extended
+        { 0x31F0, 0x31FF }, // Katakana Phonetic Extensions
+        { 0x3400, 0x4DBF }, // CJK Unified Ideographs Extension A
+        { 0x4E00, 0x9FFF }, // CJK Unified Ideographs
+        { 0xAC00, 0xD7A3 }, // Hangul Syllables
+        { 0xE000, 0xF8FF }, // Private Use Area (Powerline, Nerd Fonts, etc.)
+        { 0xF900, 0xFAFF }, // CJK Compatibility Ideographs
+        { 0xFF21, 0xFF3A }, // Fullwidth Latin
+        { 0xFF41, 0xFF5A },
+        { 0xFF66, 0xFF6F }, // Halfwidth Katakana
+        { 0xFF71, 0xFF9D },
+        { 0xFFA0, 0xFFDC }, // Halfwidth Hangul
+        { 0x20000, 0x3FFFF }, // CJK Unified Ideographs Extension B and later
+    } };
+    for (const auto& [beg, end] : ranges)
+    {
+        if (ch >= beg && ch <= end)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the process-wide font fallback cache for the current font settings and the given attributes.
+std::shared_ptr<AtlasEngine::FontFallbackCache> AtlasEngine::_getFontFallbackCache(const FontRelevantAttributes attributes) const
+{
+    // The number of distinct font settings in a process is usually tiny.
+    // If it ever gets large we simply start from scratch.
+    static constexpr size_t maxCaches = 16;
+    static std::shared_mutex mutex;
+    static std::unordered_map<std::wstring, std::shared_ptr<FontFallbackCache>> caches;
+
+    const auto& font = *_p.s->font;
+    const auto bold = WI_IsFlagSet(attributes, FontRelevantAttributes::Bold);
+    const auto italic = WI_IsFlagSet(attributes, FontRelevantAttributes::Italic);
+
+    // The key consists of all the inputs to MapCharacters() besides the text itself. Each AtlasEngine
+    // has its own instance of the system font fallback, but they're all equivalent of course.
+    const auto fontFallback = font.fontFallback == _api.systemFontFallback ? 0 : reinterpret_cast<uintptr_t>(font.fontFallback.get());
+    auto key = fmt::format(
+        FMT_COMPILE(L"{:x}|{:x}|{}|{}|{}|{}"),
+        fontFallback,
+        reinterpret_cast<uintptr_t>(font.fontCollection.get()),
+        _p.userLocaleName,
+        font.fontName,
+        bold ? static_cast<u32>(DWRITE_FONT_WEIGHT_BOLD) : static_cast<u32>(font.fontWeight),
+        italic);
+    for (const auto& axis : _api.textFormatAxes[static_cast<size_t>(attributes)])
+    {
+        fmt::format_to(std::back_inserter(key), FMT_COMPILE(L"|{:x}={}"), static_cast<u32>(axis.axisTag), axis.value);
+    }
+
+    {
+        std::shared_lock lock{ mutex };
+        if (const auto it = caches.find(key); it != caches.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock{ mutex };
+    if (caches.size() >= maxCaches && caches.find(key) == caches.end())
+    {
+        caches.clear();
+    }
+
+    auto& cache = caches[std::move(key)];
+    if (!cache)
+    {
+        cache = std::make_shared<FontFallbackCache>();
+        cache->fontFallback = font.fontFallback;
+        cache->fontCollection = font.fontCollection;
+    }
+    return cache;
+}
+
+// The first appearance of a script in a pane would otherwise stall rendering for a moment,
+// because finding the fallback font for it is slow. This looks up the common ones in advance.
+// Since the cache is shared between AtlasEngine instances, this only happens once per process.
+void AtlasEngine::_prefillFontFallbackCache()
+{
+    const auto& cache = _api.fontFallbackCaches[static_cast<size_t>(FontRelevantAttributes::None)];
+    if (!cache)
+    {
+        return;
+    }
+
+    {
+        std::shared_lock lock{ cache->mutex };
+        if (!cache->faces.empty())
+        {
+            return;
+        }
+    }
+
+    static constexpr std::array<std::wstring_view, 10> samples{
+        L"A", // Latin
+        L"\u03B1", // Greek
+        L"\u0436", // Cyrillic
+        L"\u2500", // Box Drawing
+        L"\u3042", // Hiragana
+        L"\u30A2", // Katakana
+        L"\u4E2D", // CJK Unified Ideographs
+        L"\uD55C", // Hangul Syllables
+        L"\uE0B0", // Private Use Area (Powerline)
+        L"\U0001F600", // Emoji
+    };
+
+    for (const auto& sample : samples)
+    {
+        u32 mappedLength = 0;
+        wil::com_ptr<IDWriteFontFace2> mappedFontFace;
+        try
+        {
+            _mapCharacters(sample.data(), gsl::narrow_cast<u32>(sample.size()), FontRelevantAttributes::None, &mappedLength, mappedFontFace.addressof());
+        }
+        CATCH_LOG();
+    }
+}
+
+// Checks once per font whether printable ASCII can bypass shaping. That's the case if a single font face maps all
+// of it and GetTextComplexity() considers all of it simple, which means that the font has no GSUB/GPOS lookups
+// that would apply to these characters by default. Fonts with ligatures for ASCII (like Cascadia Code) shouldn't qualify.
+void AtlasEngine::_resolveAsciiGlyphs()
+{
+    static constexpr u32 count = AsciiGlyphs::last - AsciiGlyphs::first + 1;
+
+    wchar_t text[count];
+    for (u32 i = 0; i < count; ++i)
+    {
+        text[i] = static_cast<wchar_t>(AsciiGlyphs::first + i);
+    }
+
+    wil::com_ptr<IDWriteTextAnalyzer> textAnalyzer;
+    THROW_IF_FAILED(_p.dwriteFactory->CreateTextAnalyzer(textAnalyzer.addressof()));
+    const auto textAnalyzer1 = textAnalyzer.query<IDWriteTextAnalyzer1>();
+
+    for (size_t i = 0; i < _api.asciiGlyphs.size(); ++i)
+    {
+        auto& ascii = _api.asciiGlyphs[i];
+        ascii = {};
+
+        // Font features can enable substitutions that GetTextComplexity() doesn't know about.
+        if (!_p.s->font->fontFeatures.empty())
+        {
+            continue;
+        }
+
+        try
+        {
+            u32 mappedLength = 0;
+            wil::com_ptr<IDWriteFontFace2> fontFace;
+            _mapCharacters(&text[0], count, static_cast<FontRelevantAttributes>(i), &mappedLength, fontFace.addressof());
+            if (!fontFace || mappedLength != count)
+            {
+                continue;
+            }
+
+            BOOL isTextSimple = FALSE;
+            u32 complexityLength = 0;
+            THROW_IF_FAILED(textAnalyzer1->GetTextComplexity(&text[0], count, fontFace.get(), &isTextSimple, &complexityLength, ascii.glyphIndices.data()));
+            if (isTextSimple && complexityLength == count)
+            {
+                ascii.fontFace = std::move(fontFace);
+            }
+        }
+        CATCH_LOG();
+    }
+}
+
+// Maps as many characters at the start of the given text to a single font face as possible.
+// The results are cached per codepoint in the process-wide _api.fontFallbackCaches. Only the first codepoint
+// of each mapped run is cached, since the font of the remaining ones may depend on the run they're part of,
+// and only if it's cacheable (see isCacheableCodepoint()) and not followed by a codepoint that
+// would attach to it (e.g. a combining mark or variation selector, see isContextFreeCodepoint()).
+void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, const FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
+{
+    const auto& cache = _api.fontFallbackCaches[static_cast<size_t>(attributes)];
+    if (!cache)
+    {
+        _mapCharactersUncached(text, textLength, attributes, mappedLength, mappedFontFace);
+        return;
+    }
+
+    // Returns the length of the codepoint at idx if it's cacheable, or 0 otherwise.
+    const auto cacheableCodepoint = [&](const u32 idx, char32_t& ch) noexcept -> u32 {
+        const auto [cp, len] = decodeCodepoint(text, textLength, idx);
+        if (!isCacheableCodepoint(cp))
+        {
+            return 0;
+        }
+        if (idx + len < textLength && !isContextFreeCodepoint(decodeCodepoint(text, textLength, idx + len).first))
+        {
+            return 0;
+        }
+        ch = cp;
+        return len;
+    };
+
+    {
+        std::shared_lock lock{ cache->mutex };
+        IDWriteFontFace2* face = nullptr;
+        u32 idx = 0;
+
+        while (idx < textLength)
+        {
+            char32_t ch = 0;
+            const auto len = cacheableCodepoint(idx, ch);
+            if (!len)
+            {
+                break;
+            }
+
+            const auto it = cache->faces.find(ch);
+            if (it == cache->faces.end() || (face && it->second.get() != face))
+            {
+                break;
+            }
+
+            face = it->second.get();
+            idx += len;
+        }
+
+        if (idx)
+        {
+            face->AddRef();
+            *mappedFontFace = face;
+            *mappedLength = idx;
+            return;
+        }
+    }
+
+    _mapCharactersUncached(text, textLength, attributes, mappedLength, mappedFontFace);
+
+    // We don't cache unmapped codepoints (mappedFontFace == nullptr), since they're rare and would need special care.
+    if (const auto face = *mappedFontFace)
+    {
+        char32_t ch = 0;
+        if (const auto len = cacheableCodepoint(0, ch); len && len <= *mappedLength)
+        {
+            std::unique_lock lock{ cache->mutex };
+            cache->faces.emplace(ch, face);
+        }
+    }
+}
+
+void AtlasEngine::_mapCharactersUncached(const wchar_t* text, const u32 textLength, const FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
 {
     TextAnalysisSource analysisSource{ _p.userLocaleName.c_str(), text, textLength };
-    const auto& textFormatAxis = _api.textFormatAxes[static_cast<size_t>(_api.attributes)];
+    const auto& textFormatAxis = _api.textFormatAxes[static_cast<size_t>(attributes)];
 
     // We don't read from scale anyways.
 #pragma warning(suppress : 26494) // Variable 'scale' is uninitialized. Always initialize an object (type.5).
@@ -947,8 +1638,8 @@ void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, u32*
     }
     else
     {
-        const auto baseWeight = WI_IsFlagSet(_api.attributes, FontRelevantAttributes::Bold) ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_p.s->font->fontWeight);
-        const auto baseStyle = WI_IsFlagSet(_api.attributes, FontRelevantAttributes::Italic) ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
+        const auto baseWeight = WI_IsFlagSet(attributes, FontRelevantAttributes::Bold) ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_p.s->font->fontWeight);
+        const auto baseStyle = WI_IsFlagSet(attributes, FontRelevantAttributes::Italic) ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
         wil::com_ptr<IDWriteFont> font;
 
         THROW_IF_FAILED(_p.s->font->fontFallback->MapCharacters(
@@ -975,15 +1666,15 @@ void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, u32*
     assert(scale == 1);
 }
 
-void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row)
+void AtlasEngine::_mapComplex(ShapingContext& ctx, IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row)
 {
-    _api.analysisResults.clear();
+    ctx.analysisResults.clear();
 
-    TextAnalysisSource analysisSource{ _p.userLocaleName.c_str(), _api.bufferLine.data(), gsl::narrow<UINT32>(_api.bufferLine.size()) };
-    TextAnalysisSink analysisSink{ _api.analysisResults };
-    THROW_IF_FAILED(_p.textAnalyzer->AnalyzeScript(&analysisSource, idx, length, &analysisSink));
+    TextAnalysisSource analysisSource{ _p.userLocaleName.c_str(), ctx.bufferLine.data(), gsl::narrow<UINT32>(ctx.bufferLine.size()) };
+    TextAnalysisSink analysisSink{ ctx.analysisResults };
+    THROW_IF_FAILED(ctx.textAnalyzer->AnalyzeScript(&analysisSource, idx, length, &analysisSink));
 
-    for (const auto& a : _api.analysisResults)
+    for (const auto& a : ctx.analysisResults)
     {
         u32 actualGlyphCount = 0;
 
@@ -1009,16 +1700,16 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
             featureRanges = 1;
         }
 
-        if (_api.clusterMap.size() <= a.textLength)
+        if (ctx.clusterMap.size() <= a.textLength)
         {
-            _api.clusterMap = Buffer<u16>{ static_cast<size_t>(a.textLength) + 1 };
-            _api.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ a.textLength };
+            ctx.clusterMap = Buffer<u16>{ static_cast<size_t>(a.textLength) + 1 };
+            ctx.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ a.textLength };
         }
 
         for (auto retry = 0;;)
         {
-            const auto hr = _p.textAnalyzer->GetGlyphs(
-                /* textString          */ _api.bufferLine.data() + a.textPosition,
+            const auto hr = ctx.textAnalyzer->GetGlyphs(
+                /* textString          */ ctx.bufferLine.data() + a.textPosition,
                 /* textLength          */ a.textLength,
                 /* fontFace            */ mappedFontFace,
                 /* isSideways          */ false,
@@ -1029,22 +1720,22 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
                 /* features            */ &features,
                 /* featureRangeLengths */ &featureRangeLengths,
                 /* featureRanges       */ featureRanges,
-                /* maxGlyphCount       */ gsl::narrow_cast<u32>(_api.glyphIndices.size()),
-                /* clusterMap          */ _api.clusterMap.data(),
-                /* textProps           */ _api.textProps.data(),
-                /* glyphIndices        */ _api.glyphIndices.data(),
-                /* glyphProps          */ _api.glyphProps.data(),
+                /* maxGlyphCount       */ gsl::narrow_cast<u32>(ctx.glyphIndices.size()),
+                /* clusterMap          */ ctx.clusterMap.data(),
+                /* textProps           */ ctx.textProps.data(),
+                /* glyphIndices        */ ctx.glyphIndices.data(),
+                /* glyphProps          */ ctx.glyphProps.data(),
                 /* actualGlyphCount    */ &actualGlyphCount);
 
             if (hr == HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER) && ++retry < 8)
             {
                 // Grow factor 1.5x.
-                auto size = _api.glyphIndices.size();
+                auto size = ctx.glyphIndices.size();
                 size = size + (size >> 1);
                 // Overflow check.
-                Expects(size > _api.glyphIndices.size());
-                _api.glyphIndices = Buffer<u16>{ size };
-                _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
+                Expects(size > ctx.glyphIndices.size());
+                ctx.glyphIndices = Buffer<u16>{ size };
+                ctx.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
                 continue;
             }
 
@@ -1052,24 +1743,24 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
             break;
         }
 
-        if (_api.glyphAdvances.size() < actualGlyphCount)
+        if (ctx.glyphAdvances.size() < actualGlyphCount)
         {
             // Grow the buffer by at least 1.5x and at least of `actualGlyphCount` items.
             // The 1.5x growth ensures we don't reallocate every time we need 1 more slot.
-            auto size = _api.glyphAdvances.size();
+            auto size = ctx.glyphAdvances.size();
             size = size + (size >> 1);
             size = std::max<size_t>(size, actualGlyphCount);
-            _api.glyphAdvances = Buffer<f32>{ size };
-            _api.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ size };
+            ctx.glyphAdvances = Buffer<f32>{ size };
+            ctx.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ size };
         }
 
-        THROW_IF_FAILED(_p.textAnalyzer->GetGlyphPlacements(
-            /* textString          */ _api.bufferLine.data() + a.textPosition,
-            /* clusterMap          */ _api.clusterMap.data(),
-            /* textProps           */ _api.textProps.data(),
+        THROW_IF_FAILED(ctx.textAnalyzer->GetGlyphPlacements(
+            /* textString          */ ctx.bufferLine.data() + a.textPosition,
+            /* clusterMap          */ ctx.clusterMap.data(),
+            /* textProps           */ ctx.textProps.data(),
             /* textLength          */ a.textLength,
-            /* glyphIndices        */ _api.glyphIndices.data(),
-            /* glyphProps          */ _api.glyphProps.data(),
+            /* glyphIndices        */ ctx.glyphIndices.data(),
+            /* glyphProps          */ ctx.glyphProps.data(),
             /* glyphCount          */ actualGlyphCount,
             /* fontFace            */ mappedFontFace,
             /* fontEmSize          */ _p.s->font->fontSize,
@@ -1080,86 +1771,87 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
             /* features            */ &features,
             /* featureRangeLengths */ &featureRangeLengths,
             /* featureRanges       */ featureRanges,
-            /* glyphAdvances       */ _api.glyphAdvances.data(),
-            /* glyphOffsets        */ _api.glyphOffsets.data()));
+            /* glyphAdvances       */ ctx.glyphAdvances.data(),
+            /* glyphOffsets        */ ctx.glyphOffsets.data()));
 
-        _api.clusterMap[a.textLength] = gsl::narrow_cast<u16>(actualGlyphCount);
+        ctx.clusterMap[a.textLength] = gsl::narrow_cast<u16>(actualGlyphCount);
 
         const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-        const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
-        auto prevCluster = _api.clusterMap[0];
+        const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * ctx.y;
+        auto prevCluster = ctx.clusterMap[0];
         size_t beg = 0;
 
         for (size_t i = 1; i <= a.textLength; ++i)
         {
-            const auto nextCluster = _api.clusterMap[i];
+            const auto nextCluster = ctx.clusterMap[i];
             if (prevCluster == nextCluster)
             {
                 continue;
             }
 
-            const size_t col1 = _api.bufferLineColumn[a.textPosition + beg];
-            const size_t col2 = _api.bufferLineColumn[a.textPosition + i];
+            const size_t col1 = ctx.bufferLineColumn[a.textPosition + beg];
+            const size_t col2 = ctx.bufferLineColumn[a.textPosition + i];
             const auto fg = colors[col1 << shift];
 
             const auto expectedAdvance = (col2 - col1) * _p.s->font->cellSize.x;
             f32 actualAdvance = 0;
             for (auto j = prevCluster; j < nextCluster; ++j)
             {
-                actualAdvance += _api.glyphAdvances[j];
+                actualAdvance += ctx.glyphAdvances[j];
             }
-            _api.glyphAdvances[nextCluster - 1] += expectedAdvance - actualAdvance;
+            ctx.glyphAdvances[nextCluster - 1] += expectedAdvance - actualAdvance;
 
             row.colors.insert(row.colors.end(), nextCluster - prevCluster, fg);
+            ctx.glyphColumns.insert(ctx.glyphColumns.end(), nextCluster - prevCluster, gsl::narrow_cast<u16>(col1));
 
             prevCluster = nextCluster;
             beg = i;
         }
 
-        row.glyphIndices.insert(row.glyphIndices.end(), _api.glyphIndices.begin(), _api.glyphIndices.begin() + actualGlyphCount);
-        row.glyphAdvances.insert(row.glyphAdvances.end(), _api.glyphAdvances.begin(), _api.glyphAdvances.begin() + actualGlyphCount);
-        row.glyphOffsets.insert(row.glyphOffsets.end(), _api.glyphOffsets.begin(), _api.glyphOffsets.begin() + actualGlyphCount);
+        row.glyphIndices.insert(row.glyphIndices.end(), ctx.glyphIndices.begin(), ctx.glyphIndices.begin() + actualGlyphCount);
+        row.glyphAdvances.insert(row.glyphAdvances.end(), ctx.glyphAdvances.begin(), ctx.glyphAdvances.begin() + actualGlyphCount);
+        row.glyphOffsets.insert(row.glyphOffsets.end(), ctx.glyphOffsets.begin(), ctx.glyphOffsets.begin() + actualGlyphCount);
     }
 }
 
-void AtlasEngine::_mapReplacementCharacter(u32 from, u32 to, ShapedRow& row)
+void AtlasEngine::_lookupReplacementCharacter()
 {
-    if (!_api.replacementCharacterLookedUp)
-    {
-        bool succeeded = false;
+    bool succeeded = false;
 
-        u32 mappedLength = 0;
-        _mapCharacters(L"\uFFFD", 1, &mappedLength, _api.replacementCharacterFontFace.put());
+    u32 mappedLength = 0;
+    _mapCharacters(L"\uFFFD", 1, FontRelevantAttributes::None, &mappedLength, _api.replacementCharacterFontFace.put());
 
-        if (mappedLength == 1)
-        {
-            static constexpr u32 codepoint = 0xFFFD;
-            succeeded = SUCCEEDED(_api.replacementCharacterFontFace->GetGlyphIndicesW(&codepoint, 1, &_api.replacementCharacterGlyphIndex));
-        }
-
-        if (!succeeded)
-        {
-            _api.replacementCharacterFontFace.reset();
-            _api.replacementCharacterGlyphIndex = 0;
-        }
+    if (mappedLength == 1)
+    {
+        static constexpr u32 codepoint = 0xFFFD;
+        succeeded = SUCCEEDED(_api.replacementCharacterFontFace->GetGlyphIndicesW(&codepoint, 1, &_api.replacementCharacterGlyphIndex));
+    }
 
-        _api.replacementCharacterLookedUp = true;
+    if (!succeeded)
+    {
+        _api.replacementCharacterFontFace.reset();
+        _api.replacementCharacterGlyphIndex = 0;
     }
 
+    _api.replacementCharacterLookedUp = true;
+}
+
+void AtlasEngine::_mapReplacementCharacter(ShapingContext& ctx, u32 from, u32 to, ShapedRow& row)
+{
     if (!_api.replacementCharacterFontFace)
     {
         return;
     }
 
     auto pos = from;
-    auto col1 = _api.bufferLineColumn[from];
+    auto col1 = ctx.bufferLineColumn[from];
     auto initialIndicesCount = row.glyphIndices.size();
     const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
+    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * ctx.y;
 
     while (pos < to)
     {
-        const auto col2 = _api.bufferLineColumn[++pos];
+        const auto col2 = ctx.bufferLineColumn[++pos];
         if (col1 == col2)
         {
             continue;
@@ -1169,6 +1861,7 @@ void AtlasEngine::_mapReplacementCharacter(u32 from, u32 to, ShapedRow& row)
         row.glyphAdvances.emplace_back(static_cast<f32>((col2 - col1) * _p.s->font->cellSize.x));
         row.glyphOffsets.emplace_back();
         row.colors.emplace_back(colors[static_cast<size_t>(col1) << shift]);
+        ctx.glyphColumns.emplace_back(col1);
 
         col1 = col2;
     }
@@ -45,6 +45,7 @@ namespace Microsoft::Console::Render::Atlas
         [[nodiscard]] HRESULT PaintBackground() noexcept override;
         [[nodiscard]] HRESULT PaintBufferLine(std::span<const Cluster> clusters, til::point coord, bool fTrimLeft, bool lineWrapped) noexcept override;
         [[nodiscard]] HRESULT PaintBufferGridLines(const GridLineSet lines, const COLORREF gridlineColor, const COLORREF underlineColor, const size_t cchLine, const til::point coordTarget) noexcept override;
+        [[nodiscard]] HRESULT PaintImageSlice(const ImageSlice& imageSlice, til::CoordType targetRow, til::CoordType viewportLeft) noexcept override;
         [[nodiscard]] HRESULT PaintSelection(const til::rect& rect) noexcept override;
         [[nodiscard]] HRESULT PaintCursor(const CursorOptions& options) noexcept override;
         [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes, const RenderSettings& renderSettings, gsl::not_null<IRenderData*> pData, bool usingSoftFont, bool isSettingDefaultBrushes) noexcept override;
@@ -81,16 +82,95 @@ namespace Microsoft::Console::Render::Atlas
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& pfiFontInfoDesired, FontInfo& fiFontInfo, const std::unordered_map<std::wstring_view, float>& features, const std::unordered_map<std::wstring_view, float>& axes) noexcept;
 
     private:
+        // Prompts, progress bars, box drawing lines, etc. tend to repeat. _shapeBufferLine() caches the
+        // result of shaping a line, keyed by its text, its (relative) columns and the font attributes.
+        // All columns are relative to the first column of the line, so that a hit works regardless of
+        // where on the screen the line is. The cache is simply cleared whenever it gets too large.
+        struct ShapingCacheEntry
+        {
+            FontRelevantAttributes attributes = FontRelevantAttributes::None;
+            std::vector<wchar_t> text;
+            std::vector<u16> columns;
+            std::vector<u16> glyphIndices;
+            std::vector<f32> glyphAdvances;
+            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            std::vector<u16> glyphColumns;
+            std::vector<FontMapping> mappings;
+        };
+
+        // IDWriteFontFallback::MapCharacters() is very slow. This caches its results per codepoint, for all AtlasEngine
+        // instances (panes) in the process that use the same font settings. See _getFontFallbackCache().
+        // Since shaping may happen on multiple threads concurrently, access to the codepoints map is guarded by a lock.
+        struct FontFallbackCache
+        {
+            // These are part of the cache key. By holding a reference, their addresses can't be reused by other objects.
+            wil::com_ptr<IDWriteFontFallback> fontFallback;
+            wil::com_ptr<IDWriteFontCollection> fontCollection;
+
+            std::shared_mutex mutex;
+            std::unordered_map<char32_t, wil::com_ptr<IDWriteFontFace2>> faces;
+        };
+
+        // Most fonts map printable ASCII 1:1 to glyphs and have no lookups for them in their GSUB/GPOS tables.
+        // For those, _mapRegularText() can skip font fallback and GetTextComplexity() for ASCII entirely.
+        struct AsciiGlyphs
+        {
+            static constexpr wchar_t first = 0x20;
+            static constexpr wchar_t last = 0x7e;
+
+            wil::com_ptr<IDWriteFontFace2> fontFace;
+            std::array<u16, last - first + 1> glyphIndices{};
+        };
+
+        // The scratch state needed to shape a single line. _shapeBufferLines() may shape
+        // lines on multiple threads concurrently, each of which uses its own context.
+        struct ShapingContext
+        {
+            wil::com_ptr<IDWriteTextAnalyzer1> textAnalyzer;
+
+            std::vector<wchar_t> bufferLine;
+            std::vector<u16> bufferLineColumn;
+            FontRelevantAttributes attributes = FontRelevantAttributes::None;
+            u16 y = 0;
+
+            std::vector<TextAnalysisSinkResult> analysisResults;
+            Buffer<u16> clusterMap;
+            Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
+            Buffer<u16> glyphIndices;
+            Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES> glyphProps;
+            Buffer<f32> glyphAdvances;
+            Buffer<DWRITE_GLYPH_OFFSET> glyphOffsets;
+
+            // The column each glyph appended by the _map*() functions got its color from.
+            std::vector<u16> glyphColumns;
+            std::vector<u16> shapingCacheColumns;
+            // The shaping cache is read-only during concurrent shaping. New entries are collected here instead.
+            bool deferCacheInserts = false;
+            std::vector<std::pair<size_t, ShapingCacheEntry>> newCacheEntries;
+        };
+
         // AtlasEngine.cpp
         ATLAS_ATTR_COLD void _handleSettingsUpdate();
         void _recreateFontDependentResources();
         void _recreateCellCountDependentResources();
         void _flushBufferLine();
-        void _mapRegularText(size_t offBeg, size_t offEnd);
-        void _mapBuiltinGlyphs(size_t offBeg, size_t offEnd);
-        void _mapCharacters(const wchar_t* text, u32 textLength, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
-        void _mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row);
-        ATLAS_ATTR_COLD void _mapReplacementCharacter(u32 from, u32 to, ShapedRow& row);
+        void _shapeBufferLines();
+        void _shapeBufferLineRange(ShapingContext& ctx, size_t beg, size_t end);
+        void _insertShapingCacheEntry(size_t hash, ShapingCacheEntry&& entry);
+        void _initializeShapingContext(ShapingContext& ctx);
+        void _shapeBufferLine(ShapingContext& ctx);
+        void _shapeBufferLineUncached(ShapingContext& ctx);
+        void _mapRegularText(ShapingContext& ctx, size_t offBeg, size_t offEnd);
+        void _appendSimpleGlyphs(ShapingContext& ctx, u32 idx, u32 length, ShapedRow& row);
+        void _mapBuiltinGlyphs(ShapingContext& ctx, size_t offBeg, size_t offEnd);
+        void _mapCharacters(const wchar_t* text, u32 textLength, FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
+        void _mapCharactersUncached(const wchar_t* text, u32 textLength, FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
+        std::shared_ptr<FontFallbackCache> _getFontFallbackCache(FontRelevantAttributes attributes) const;
+        void _prefillFontFallbackCache();
+        void _resolveAsciiGlyphs();
+        void _mapComplex(ShapingContext& ctx, IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row);
+        ATLAS_ATTR_COLD void _lookupReplacementCharacter();
+        ATLAS_ATTR_COLD void _mapReplacementCharacter(ShapingContext& ctx, u32 from, u32 to, ShapedRow& row);
         void _fillColorBitmap(const size_t y, const size_t x1, const size_t x2, const u32 fgColor, const u32 bgColor) noexcept;
         [[nodiscard]] HRESULT _drawHighlighted(std::span<const til::point_span>& highlights, const u16 row, const u16 begX, const u16 endX, const u32 fgColor, const u32 bgColor) noexcept;
 
@@ -155,14 +235,40 @@ namespace Microsoft::Console::Render::Atlas
             std::vector<wchar_t> bufferLine;
             std::vector<u16> bufferLineColumn;
 
+            // On large redraws _flushBufferLine() queues up the text of each line here, so that
+            // _shapeBufferLines() can shape all of them at once in EndPaint(), concurrently.
+            // Otherwise each line is shaped right away and these stay empty.
+            bool queueBufferLines = false;
+            struct PendingBufferLine
+            {
+                size_t textBeg = 0;
+                size_t textEnd = 0;
+                size_t columnBeg = 0;
+                u16 y = 0;
+                FontRelevantAttributes attributes = FontRelevantAttributes::None;
+            };
+            std::vector<PendingBufferLine> pendingLines;
+            std::vector<wchar_t> pendingLineText;
+            std::vector<u16> pendingLineColumns;
+
+            // Scaled with the viewport height by _recreateCellCountDependentResources(), so that a
+            // full redraw which only changed colors (selection, hyperlink hover, etc.) stays cached.
+            // The cache and its capacity are owned by the render thread and only ever accessed from
+            // StartPaint() and EndPaint(), while the console lock is held. Never touch them in Present().
+            static constexpr size_t shapingCacheMinCapacity = 256;
+            static constexpr size_t shapingCacheLinesPerRow = 4;
+            size_t shapingCacheCapacity = shapingCacheMinCapacity;
+            std::unordered_map<size_t, ShapingCacheEntry> shapingCache;
+            // shapingContexts[0] is used for serial shaping, the others only by _shapeBufferLines() worker threads.
+            std::vector<ShapingContext> shapingContexts;
+
             std::array<Buffer<DWRITE_FONT_AXIS_VALUE>, 4> textFormatAxes;
-            std::vector<TextAnalysisSinkResult> analysisResults;
-            Buffer<u16> clusterMap;
-            Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
-            Buffer<u16> glyphIndices;
-            Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES> glyphProps;
-            Buffer<f32> glyphAdvances;
-            Buffer<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            // Indexed by FontRelevantAttributes, just like textFormatAxes.
+            std::array<std::shared_ptr<FontFallbackCache>, 4> fontFallbackCaches;
+
+            // The glyphs of printable ASCII, if the font renders all of them without shaping.
+            // Indexed by FontRelevantAttributes. See _resolveAsciiGlyphs().
+            std::array<AsciiGlyphs, 4> asciiGlyphs;
 
             wil::com_ptr<IDWriteFontFallback> systemFontFallback;
             wil::com_ptr<IDWriteFontFace2> replacementCharacterFontFace;
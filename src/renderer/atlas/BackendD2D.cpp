@@ -27,6 +27,7 @@ void BackendD2D::ReleaseResources() noexcept
 {
     _renderTarget.reset();
     _renderTarget4.reset();
+    _brushes.clear();
     // Ensure _handleSettingsUpdate() is called so that _renderTarget gets recreated.
     _generation = {};
 }
@@ -95,6 +96,8 @@ void BackendD2D::_handleSettingsUpdate(const RenderingPayload& p)
             THROW_IF_FAILED(_renderTarget->CreateSolidColorBrush(&color, nullptr, _emojiBrush.put()));
             THROW_IF_FAILED(_renderTarget->CreateSolidColorBrush(&color, nullptr, _brush.put()));
             _brushColor = 0;
+            _brushes.clear();
+            _brushes.emplace(0, _brush);
         }
     }
 
@@ -176,15 +179,27 @@ void BackendD2D::_drawText(RenderingPayload& p)
     // then blends it on the screen with the given bitmap brush. While this roughly doubles the performance
     // when drawing lots of colors, the extra latency drops performance by >10x when drawing fewer colors.
     // Since fewer colors are more common, I've chosen to go with regular solid-color brushes.
+    //
+    // Consecutive DECDWL rows all use the same transform, so we keep it set across them and only
+    // reset it once the run ends. This avoids 2 transform changes per row for banner-style output.
+    // DECDHL rows still need their own transform and clip rect, where the latter must be pushed
+    // while the identity transform is set, because D2D transforms clip rects as well.
+    auto activeLineRendition = LineRendition::SingleWidth;
     u16 y = 0;
     for (const auto row : p.rows)
     {
         auto baselineX = 0.0f;
         auto baselineY = static_cast<f32>(p.s->font->cellSize.y * y + p.s->font->baseline);
 
-        if (row->lineRendition != LineRendition::SingleWidth)
+        if (activeLineRendition != row->lineRendition && activeLineRendition != LineRendition::SingleWidth)
+        {
+            _drawTextResetLineRendition(activeLineRendition);
+            activeLineRendition = LineRendition::SingleWidth;
+        }
+        if (row->lineRendition != LineRendition::SingleWidth && activeLineRendition == LineRendition::SingleWidth)
         {
             baselineY = _drawTextPrepareLineRendition(p, row, baselineY);
+            activeLineRendition = row->lineRendition;
         }
 
         for (const auto& m : row->mappings)
@@ -269,9 +284,10 @@ void BackendD2D::_drawText(RenderingPayload& p)
             _drawGridlineRow(p, row, y);
         }
 
-        if (row->lineRendition != LineRendition::SingleWidth)
+        if (activeLineRendition >= LineRendition::DoubleHeightTop)
         {
-            _drawTextResetLineRendition(row);
+            _drawTextResetLineRendition(activeLineRendition);
+            activeLineRendition = LineRendition::SingleWidth;
         }
 
         if (p.invalidatedRows.contains(y))
@@ -283,6 +299,11 @@ void BackendD2D::_drawText(RenderingPayload& p)
         ++y;
     }
 
+    if (activeLineRendition != LineRendition::SingleWidth)
+    {
+        _drawTextResetLineRendition(activeLineRendition);
+    }
+
     if (dirtyTop < dirtyBottom)
     {
         p.dirtyRectInPx.top = std::min(p.dirtyRectInPx.top, dirtyTop);
@@ -327,12 +348,12 @@ f32 BackendD2D::_drawTextPrepareLineRendition(const RenderingPayload& p, const S
     return baselineY;
 }
 
-void BackendD2D::_drawTextResetLineRendition(const ShapedRow* row) const noexcept
+void BackendD2D::_drawTextResetLineRendition(LineRendition lineRendition) const noexcept
 {
     static constexpr D2D1_MATRIX_3X2_F identity{ .m11 = 1, .m22 = 1 };
     _renderTarget->SetTransform(&identity);
 
-    if (row->lineRendition >= LineRendition::DoubleHeightTop)
+    if (lineRendition >= LineRendition::DoubleHeightTop)
     {
         _renderTarget->PopAxisAlignedClip();
     }
@@ -679,8 +700,22 @@ ID2D1SolidColorBrush* BackendD2D::_brushWithColor(u32 color)
 
 ID2D1SolidColorBrush* BackendD2D::_brushWithColorUpdate(u32 color)
 {
-    const auto d2dColor = colorFromU32(color);
-    _brush->SetColor(&d2dColor);
+    auto it = _brushes.find(color);
+    if (it == _brushes.end())
+    {
+        // Applications that use lots of true colors (e.g. image viewers) could make this grow indefinitely.
+        if (_brushes.size() >= 256)
+        {
+            _brushes.clear();
+        }
+
+        const auto d2dColor = colorFromU32(color);
+        wil::com_ptr<ID2D1SolidColorBrush> brush;
+        THROW_IF_FAILED(_renderTarget->CreateSolidColorBrush(&d2dColor, nullptr, brush.addressof()));
+        it = _brushes.emplace(color, std::move(brush)).first;
+    }
+
+    _brush = it->second;
     _brushColor = color;
     return _brush.get();
 }
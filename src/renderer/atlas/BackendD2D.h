@@ -20,7 +20,7 @@ namespace Microsoft::Console::Render::Atlas
         void _drawBackground(const RenderingPayload& p);
         void _drawText(RenderingPayload& p);
         ATLAS_ATTR_COLD f32 _drawTextPrepareLineRendition(const RenderingPayload& p, const ShapedRow* row, f32 baselineY) const noexcept;
-        ATLAS_ATTR_COLD void _drawTextResetLineRendition(const ShapedRow* row) const noexcept;
+        ATLAS_ATTR_COLD void _drawTextResetLineRendition(LineRendition lineRendition) const noexcept;
         ATLAS_ATTR_COLD f32r _getGlyphRunDesignBounds(const DWRITE_GLYPH_RUN& glyphRun, f32 baselineX, f32 baselineY);
         ATLAS_ATTR_COLD void _drawGridlineRow(const RenderingPayload& p, const ShapedRow* row, u16 y);
         void _drawCursorPart1(const RenderingPayload& p);
@@ -47,6 +47,9 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID2D1SolidColorBrush> _emojiBrush;
         wil::com_ptr<ID2D1SolidColorBrush> _brush;
         u32 _brushColor = 0;
+        // Modifying a brush that's already been used in the current frame may force Direct2D to flush its
+        // batch of pending primitives. Using one brush per color allows it to batch them across colors.
+        std::unordered_map<u32, wil::com_ptr<ID2D1SolidColorBrush>> _brushes;
 
         Buffer<DWRITE_GLYPH_METRICS> _glyphMetrics;
 
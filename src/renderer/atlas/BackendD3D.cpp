@@ -47,6 +47,14 @@ using namespace Microsoft::Console::Render::Atlas;
 static constexpr D2D1_MATRIX_3X2_F identityTransform{ .m11 = 1, .m22 = 1 };
 static constexpr D2D1_COLOR_F whiteColor{ 1, 1, 1, 1 };
 
+// ImageBitmap tiles are stored in the ShapedRows and thus outlive any particular BackendD3D instance
+// or atlas texture. Drawing them from a process-wide counter ensures their generations never collide.
+static u64 nextGlyphAtlasGeneration() noexcept
+{
+    static std::atomic<u64> generation{ 0 };
+    return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 static u64 queryPerfFreq() noexcept
 {
     LARGE_INTEGER li;
@@ -61,6 +69,70 @@ static u64 queryPerfCount() noexcept
     return std::bit_cast<u64>(li.QuadPart);
 }
 
+// Every pane with a custom shader has its own BackendD3D and every change to the misc settings
+// recreates the custom shader. D3DCompile is easily the most expensive part of that, so we keep
+// the bytecode around process-wide. It's keyed by the path, the shader target and the last write
+// time of the file, just so that someone editing their shader still gets to see their changes.
+// NOTE: Files pulled in via #include aren't tracked. Touching the main file will recompile it.
+static HRESULT compileCustomShader(const wchar_t* path, const char* target, UINT flags, ID3DBlob** blob, ID3DBlob** error) noexcept
+try
+{
+    struct CacheEntry
+    {
+        std::wstring path;
+        std::string target;
+        FILETIME lastWriteTime{};
+        wil::com_ptr<ID3DBlob> blob;
+    };
+
+    static wil::srwlock lock;
+    static std::vector<CacheEntry> cache;
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes{};
+    const auto haveAttributes = GetFileAttributesExW(path, GetFileExInfoStandard, &attributes) != 0;
+
+    if (haveAttributes)
+    {
+        const auto guard = lock.lock_shared();
+        for (const auto& e : cache)
+        {
+            if (e.path == path && e.target == target && CompareFileTime(&e.lastWriteTime, &attributes.ftLastWriteTime) == 0)
+            {
+                *blob = wil::com_ptr<ID3DBlob>{ e.blob }.detach();
+                return S_OK;
+            }
+        }
+    }
+
+    wil::com_ptr<ID3DBlob> result;
+    const auto hr = D3DCompileFromFile(
+        /* pFileName   */ path,
+        /* pDefines    */ nullptr,
+        /* pInclude    */ D3D_COMPILE_STANDARD_FILE_INCLUDE,
+        /* pEntrypoint */ "main",
+        /* pTarget     */ target,
+        /* Flags1      */ flags,
+        /* Flags2      */ 0,
+        /* ppCode      */ result.addressof(),
+        /* ppErrorMsgs */ error);
+    if (FAILED(hr))
+    {
+        // The caller will log the error message.
+        return hr;
+    }
+
+    if (haveAttributes)
+    {
+        const auto guard = lock.lock_exclusive();
+        std::erase_if(cache, [&](const CacheEntry& e) { return e.path == path && e.target == target; });
+        cache.emplace_back(CacheEntry{ path, target, attributes.ftLastWriteTime, result });
+    }
+
+    *blob = result.detach();
+    return S_OK;
+}
+CATCH_RETURN()
+
 BackendD3D::BackendD3D(const RenderingPayload& p)
 {
     THROW_IF_FAILED(p.device->CreateVertexShader(&shader_vs[0], sizeof(shader_vs), nullptr, _vertexShader.addressof()));
@@ -171,6 +243,16 @@ BackendD3D::BackendD3D(const RenderingPayload& p)
         THROW_IF_FAILED(p.device->CreateBlendState(&desc, _blendState.addressof()));
     }
 
+    {
+        static constexpr D3D11_RASTERIZER_DESC desc{
+            .FillMode = D3D11_FILL_SOLID,
+            .CullMode = D3D11_CULL_BACK,
+            .DepthClipEnable = TRUE,
+            .ScissorEnable = TRUE,
+        };
+        THROW_IF_FAILED(p.device->CreateRasterizerState(&desc, _scissorRasterizerState.addressof()));
+    }
+
 #if ATLAS_DEBUG_SHADER_HOT_RELOAD
     _sourceDirectory = std::filesystem::path{ __FILE__ }.parent_path();
     _sourceCodeWatcher = wil::make_folder_change_reader_nothrow(_sourceDirectory.c_str(), false, wil::FolderChangeEvents::FileName | wil::FolderChangeEvents::LastWriteTime, [this](wil::FolderChangeEvent, PCWSTR path) {
@@ -217,7 +299,7 @@ void BackendD3D::Render(RenderingPayload& p)
     _drawText(p);
     _drawSelection(p);
     _debugShowDirty(p);
-    _flushQuads(p);
+    _flushQuadsScissored(p);
 
     if (_customPixelShader)
     {
@@ -392,16 +474,7 @@ void BackendD3D::_recreateCustomShader(const RenderingPayload& p)
 
         wil::com_ptr<ID3DBlob> error;
         wil::com_ptr<ID3DBlob> blob;
-        const auto hr = D3DCompileFromFile(
-            /* pFileName   */ p.s->misc->customPixelShaderPath.c_str(),
-            /* pDefines    */ nullptr,
-            /* pInclude    */ D3D_COMPILE_STANDARD_FILE_INCLUDE,
-            /* pEntrypoint */ "main",
-            /* pTarget     */ target,
-            /* Flags1      */ flags,
-            /* Flags2      */ 0,
-            /* ppCode      */ blob.addressof(),
-            /* ppErrorMsgs */ error.addressof());
+        const auto hr = compileCustomShader(p.s->misc->customPixelShaderPath.c_str(), target, flags, blob.addressof(), error.addressof());
 
         if (SUCCEEDED(hr))
         {
@@ -720,7 +793,7 @@ void BackendD3D::_d2dEndDrawing()
     }
 }
 
-void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p)
+u16x2 BackendD3D::_calculateGlyphAtlasSize(const RenderingPayload& p) const noexcept
 {
     // The index returned by _BitScanReverse is undefined when the input is 0. We can simultaneously guard
     // against that and avoid unreasonably small textures, by clamping the min. texture size to `minArea`.
@@ -732,7 +805,7 @@ void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p)
     const auto targetArea = static_cast<u32>(p.s->targetSize.x) * p.s->targetSize.y;
 
     const auto minAreaByFont = cellArea * 95; // Covers all printable ASCII characters
-    const auto minAreaByGrowth = static_cast<u32>(_rectPacker.width) * _rectPacker.height * 2;
+    const auto minAreaByGrowth = static_cast<u32>(_rectPacker->width) * _rectPacker->height * 2;
 
     // It's hard to say what the max. size of the cache should be. Optimally I think we should use as much
     // memory as is available, but the rendering code in this project is a big mess and so integrating
@@ -753,13 +826,21 @@ void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p)
     _BitScanReverse(&index, area - 1);
     const auto u = static_cast<u16>(1u << ((index + 2) / 2));
     const auto v = static_cast<u16>(1u << ((index + 1) / 2));
+    return { u, v };
+}
+
+void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p)
+{
+    const auto [u, v] = _calculateGlyphAtlasSize(p);
 
-    if (u != _rectPacker.width || v != _rectPacker.height)
+    if (u != _rectPacker->width || v != _rectPacker->height)
     {
         _resizeGlyphAtlas(p, u, v);
     }
 
-    stbrp_init_target(&_rectPacker, u, v, _rectPackerData.data(), _rectPackerData.size());
+    stbrp_init_target(_rectPacker.get(), u, v, _rectPackerData.data(), _rectPackerData.size());
+    _glyphAtlasFont = *p.s->font;
+    _glyphAtlasGeneration = nextGlyphAtlasGeneration();
 
     // This is a little imperfect, because it only releases the memory of the glyph mappings, not the memory held by
     // any DirectWrite fonts. On the other side, the amount of fonts on a system is always finite, where "finite"
@@ -783,8 +864,176 @@ void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p)
     _fontChangedResetGlyphAtlas = false;
 }
 
+// Called when the glyph atlas is full. Instead of throwing away all glyphs, like _resetGlyphAtlas() does, this moves all
+// glyphs that were drawn during the current frame into a new atlas texture and only evicts the rest. This avoids
+// re-rasterizing the entire viewport every frame when the output contains more unique glyphs than fit into the atlas.
+// Returns false if there was nothing worth keeping or if the hot glyphs don't fit, in which case the atlas must be reset.
+bool BackendD3D::_compactGlyphAtlas(const RenderingPayload& p)
+{
+    std::vector<AtlasGlyphEntry*> hotGlyphs;
+    std::vector<stbrp_rect> rects;
+
+    const auto collect = [&](AtlasFontFaceEntry& fontFaceEntry) {
+        for (auto& glyphs : fontFaceEntry.glyphs)
+        {
+            for (auto& entry : glyphs.container())
+            {
+                if (entry.occupied && entry.shadingType != ShadingType::Default && entry.lastUsedFrame == _glyphAtlasFrame)
+                {
+                    rects.emplace_back(stbrp_rect{
+                        .id = gsl::narrow_cast<int>(hotGlyphs.size()),
+                        .w = entry.size.x,
+                        .h = entry.size.y,
+                    });
+                    hotGlyphs.emplace_back(&entry);
+                }
+            }
+        }
+    };
+    for (auto& slot : _glyphAtlasMap.container())
+    {
+        if (slot.fontFace)
+        {
+            collect(slot);
+        }
+    }
+    collect(_builtinGlyphs);
+
+    if (rects.empty())
+    {
+        return false;
+    }
+
+    // Keep the old texture alive while we copy the hot glyphs over.
+    const auto oldGlyphAtlas = _glyphAtlas;
+    const auto [u, v] = _calculateGlyphAtlasSize(p);
+    _resizeGlyphAtlas(p, u, v);
+    stbrp_init_target(_rectPacker.get(), u, v, _rectPackerData.data(), _rectPackerData.size());
+    _glyphAtlasFont = *p.s->font;
+
+    _d2dBeginDrawing();
+    _d2dRenderTarget->Clear();
+    _d2dEndDrawing();
+
+    if (!stbrp_pack_rects(_rectPacker.get(), rects.data(), gsl::narrow<int>(rects.size())))
+    {
+        return false;
+    }
+
+    for (const auto& rect : rects)
+    {
+        const auto entry = hotGlyphs[rect.id];
+        const D3D11_BOX box{
+            .left = entry->texcoord.x,
+            .top = entry->texcoord.y,
+            .front = 0,
+            .right = static_cast<UINT>(entry->texcoord.x + entry->size.x),
+            .bottom = static_cast<UINT>(entry->texcoord.y + entry->size.y),
+            .back = 1,
+        };
+        p.deviceContext->CopySubresourceRegion(_glyphAtlas.get(), 0, rect.x, rect.y, 0, oldGlyphAtlas.get(), 0, &box);
+        entry->texcoord.x = gsl::narrow_cast<u16>(rect.x);
+        entry->texcoord.y = gsl::narrow_cast<u16>(rect.y);
+    }
+
+    // Finally, remove all glyphs that didn't make it into the new atlas. Whitespace glyphs don't occupy any space and can be kept.
+    const auto evict = [&](AtlasFontFaceEntry& fontFaceEntry) {
+        for (auto& glyphs : fontFaceEntry.glyphs)
+        {
+            til::linear_flat_set<AtlasGlyphEntry, AtlasGlyphEntryHashTrait> survivors;
+            survivors.reserve(glyphs.size());
+            for (const auto& entry : glyphs.container())
+            {
+                if (entry.occupied && (entry.shadingType == ShadingType::Default || entry.lastUsedFrame == _glyphAtlasFrame))
+                {
+                    *survivors.insert(entry.glyphIndex).first = entry;
+                }
+            }
+            glyphs = std::move(survivors);
+        }
+    };
+    for (auto& slot : _glyphAtlasMap.container())
+    {
+        if (slot.fontFace)
+        {
+            evict(slot);
+        }
+    }
+    evict(_builtinGlyphs);
+
+    return true;
+}
+
+// Called instead of _resetGlyphAtlas() when the font changed. The current atlas gets swapped with the stashed
+// atlas of the previous font. If the stash was rasterized with the new font we can just keep using it, otherwise
+// its resources get recycled and cleared by _resetGlyphAtlas().
+void BackendD3D::_swapGlyphAtlasForFontChange(const RenderingPayload& p)
+{
+    // The D2D render target belonging to the current atlas may still be inside a BeginDraw().
+    _d2dEndDrawing();
+
+    auto& s = _stashedGlyphAtlas;
+    std::swap(_glyphAtlasFont, s.font);
+    std::swap(_glyphAtlas, s.glyphAtlas);
+    std::swap(_glyphAtlasView, s.glyphAtlasView);
+    std::swap(_glyphAtlasMap, s.glyphAtlasMap);
+    std::swap(_builtinGlyphs, s.builtinGlyphs);
+    std::swap(_rectPackerData, s.rectPackerData);
+    std::swap(_rectPacker, s.rectPacker);
+    std::swap(_d2dRenderTarget, s.d2dRenderTarget);
+    std::swap(_d2dRenderTarget4, s.d2dRenderTarget4);
+    std::swap(_emojiBrush, s.emojiBrush);
+    std::swap(_brush, s.brush);
+    s.stashTime = std::chrono::steady_clock::now();
+    _glyphAtlasGeneration = nextGlyphAtlasGeneration();
+
+    // _updateFontDependents() updated the render target of the atlas we just stashed, not this one.
+    if (_d2dRenderTarget)
+    {
+        _d2dRenderTargetUpdateFontSettings(p);
+    }
+
+    if (!_glyphAtlas || !_glyphAtlasFontEquals(_glyphAtlasFont, *p.s->font))
+    {
+        _resetGlyphAtlas(p);
+        return;
+    }
+
+    ID3D11ShaderResourceView* resources[]{ _backgroundBitmapView.get(), _glyphAtlasView.get() };
+    p.deviceContext->PSSetShaderResources(0, 2, &resources[0]);
+
+    _fontChangedResetGlyphAtlas = false;
+}
+
+// Returns true if glyphs rasterized with font settings `a` look identical to those rasterized with `b`.
+bool BackendD3D::_glyphAtlasFontEquals(const FontSettings& a, const FontSettings& b) noexcept
+{
+    const auto spanEquals = [](const auto& x, const auto& y) noexcept {
+        return x.size() == y.size() && (x.empty() || memcmp(x.data(), y.data(), x.size() * sizeof(x[0])) == 0);
+    };
+
+    return a.fontCollection == b.fontCollection &&
+           a.fontName == b.fontName &&
+           spanEquals(a.fontFeatures, b.fontFeatures) &&
+           spanEquals(a.fontAxisValues, b.fontAxisValues) &&
+           a.fontSize == b.fontSize &&
+           a.cellSize == b.cellSize &&
+           a.fontWeight == b.fontWeight &&
+           a.advanceWidth == b.advanceWidth &&
+           a.baseline == b.baseline &&
+           a.descender == b.descender &&
+           a.thinLineWidth == b.thinLineWidth &&
+           a.dpi == b.dpi &&
+           a.antialiasingMode == b.antialiasingMode &&
+           a.builtinGlyphs == b.builtinGlyphs &&
+           a.colorGlyphs == b.colorGlyphs &&
+           spanEquals(a.softFontPattern, b.softFontPattern) &&
+           a.softFontCellSize == b.softFontCellSize;
+}
+
 void BackendD3D::_resizeGlyphAtlas(const RenderingPayload& p, const u16 u, const u16 v)
 {
+    _glyphAtlasGeneration = nextGlyphAtlasGeneration();
     _d2dRenderTarget.reset();
     _d2dRenderTarget4.reset();
     _glyphAtlas.reset();
@@ -880,6 +1129,62 @@ void BackendD3D::_bumpInstancesSize()
     _instances = std::move(newInstances);
 }
 
+// The final flush of a frame. When AtlasEngine presents with Present1() and dirty rects, our FLIP_SEQUENTIAL
+// swap chain retains the pixels outside of the dirty rect from the previous frame. Shading them again is a waste
+// of GPU time (and battery), which for instance makes a blinking cursor cost as much as a full redraw.
+// This is only safe if all quads of this frame are drawn with the same scissor rect, because the dirty rect
+// is only known once all quads have been generated. If _drawGlyphAtlasAllocate() had to flush early, we don't scissor.
+void BackendD3D::_flushQuadsScissored(const RenderingPayload& p)
+{
+    const auto flushedQuadsEarly = std::exchange(_flushedQuadsEarly, false);
+    const auto& r = p.dirtyRectInPx;
+    const auto fullRect = r.left <= 0 && r.top <= 0 && r.right >= p.s->targetSize.x && r.bottom >= p.s->targetSize.y;
+
+    if (ATLAS_DEBUG_SHOW_DIRTY || ATLAS_DEBUG_DUMP_RENDER_TARGET || p.s->target->disablePresent1 || _customPixelShader || p.scrollOffset || flushedQuadsEarly || fullRect)
+    {
+        _flushQuads(p);
+        return;
+    }
+
+    const D3D11_RECT scissor{
+        .left = std::max(r.left, 0),
+        .top = std::max(r.top, 0),
+        .right = std::min<LONG>(r.right, p.s->targetSize.x),
+        .bottom = std::min<LONG>(r.bottom, p.s->targetSize.y),
+    };
+
+    // Nothing is dirty and AtlasEngine::_present() won't present anything either.
+    if (scissor.left >= scissor.right || scissor.top >= scissor.bottom)
+    {
+        _instancesCount = 0;
+        return;
+    }
+
+    // Quads outside of the scissor rect would be discarded by the rasterizer anyway.
+    // During incremental output only a row or two are usually dirty, so by culling
+    // them here we avoid uploading and processing the quads for the entire viewport.
+    // The relative order of the remaining quads is preserved, and so is the blending.
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < _instancesCount; ++i)
+        {
+            const auto& it = _instances[i];
+            const auto top = static_cast<LONG>(it.position.y);
+            const auto bottom = top + it.size.y;
+            if (top < scissor.bottom && bottom > scissor.top)
+            {
+                _instances[count++] = it;
+            }
+        }
+        _instancesCount = count;
+    }
+
+    p.deviceContext->RSSetState(_scissorRasterizerState.get());
+    p.deviceContext->RSSetScissorRects(1, &scissor);
+    _flushQuads(p);
+    p.deviceContext->RSSetState(nullptr);
+}
+
 void BackendD3D::_flushQuads(const RenderingPayload& p)
 {
     if (!_instancesCount)
@@ -1000,9 +1305,15 @@ void BackendD3D::_drawText(RenderingPayload& p)
 {
     if (_fontChangedResetGlyphAtlas)
     {
-        _resetGlyphAtlas(p);
+        _swapGlyphAtlasForFontChange(p);
+    }
+    else if (_stashedGlyphAtlas.glyphAtlas && std::chrono::steady_clock::now() - _stashedGlyphAtlas.stashTime >= stashedGlyphAtlasLifetime)
+    {
+        _stashedGlyphAtlas = {};
     }
 
+    _glyphAtlasFrame++;
+
     til::CoordType dirtyTop = til::CoordTypeMax;
     til::CoordType dirtyBottom = til::CoordTypeMin;
 
@@ -1064,6 +1375,8 @@ void BackendD3D::_drawText(RenderingPayload& p)
                     glyphEntry = _drawGlyph(p, *row, *fontFaceEntry, glyphIndex);
                 }
 
+                glyphEntry->lastUsedFrame = _glyphAtlasFrame;
+
                 // A shadingType of 0 (ShadingType::Default) indicates a glyph that is whitespace.
                 if (glyphEntry->shadingType != ShadingType::Default)
                 {
@@ -1096,6 +1409,11 @@ void BackendD3D::_drawText(RenderingPayload& p)
             }
         }
 
+        if (row->bitmap.active)
+        {
+            _drawImage(p, *row, y);
+        }
+
         if (!row->gridLineRanges.empty())
         {
             _drawGridlines(p, y);
@@ -1578,16 +1896,23 @@ BackendD3D::ShadingType BackendD3D::_drawSoftFontGlyph(const RenderingPayload& p
 
 void BackendD3D::_drawGlyphAtlasAllocate(const RenderingPayload& p, stbrp_rect& rect)
 {
-    if (stbrp_pack_rects(&_rectPacker, &rect, 1))
+    if (stbrp_pack_rects(_rectPacker.get(), &rect, 1))
     {
         return;
     }
 
     _d2dEndDrawing();
     _flushQuads(p);
+    _flushedQuadsEarly = true;
+
+    if (_compactGlyphAtlas(p) && stbrp_pack_rects(_rectPacker.get(), &rect, 1))
+    {
+        return;
+    }
+
     _resetGlyphAtlas(p);
 
-    if (!stbrp_pack_rects(&_rectPacker, &rect, 1))
+    if (!stbrp_pack_rects(_rectPacker.get(), &rect, 1))
     {
         THROW_HR(HRESULT_FROM_WIN32(ERROR_POSSIBLE_DEADLOCK));
     }
@@ -1665,6 +1990,23 @@ void BackendD3D::_drawGridlines(const RenderingPayload& p, u16 y)
         auto posX = r.from * cellSize.x + offset;
         const auto end = r.to * cellSize.x;
 
+        // Instead of one quad per cell, draw all lines of the range with a single
+        // quad whose shader repeats the line every textCellWidth pixels.
+        // renditionScale.y is unused for vertical lines and carries the line width.
+        if (posX < end && width <= UINT8_MAX)
+        {
+            const auto count = (end - posX + textCellWidth - 1) / textCellWidth;
+            _appendQuad() = {
+                .shadingType = static_cast<u16>(ShadingType::VerticalGridlines),
+                .renditionScale = { static_cast<u8>(1 << horizontalShift), static_cast<u8>(width) },
+                .position = { static_cast<i16>(posX), rowTop },
+                .size = { static_cast<u16>((count - 1) * textCellWidth + width), p.s->font->cellSize.y },
+                .texcoord = { 0, 0 },
+                .color = r.gridlineColor,
+            };
+            return;
+        }
+
         for (; posX < end; posX += textCellWidth)
         {
             _appendQuad() = {
@@ -1751,6 +2093,87 @@ void BackendD3D::_drawGridlines(const RenderingPayload& p, u16 y)
     }
 }
 
+// Draws the image (sixel graphics) attached to a row. The bitmap is split into tiles of a few cells each, which
+// are scaled to the current cell size and uploaded into the glyph atlas. Glyph atlas quads are sampled 1:1, which
+// is why the scaling happens on the CPU. The tiles stay cached in the atlas until it gets reset or compacted,
+// so scrolling an image only costs a few quads. The tile width ensures that they always fit into the atlas,
+// whose minimum size is based on the cell size (see _calculateGlyphAtlasSize()).
+void BackendD3D::_drawImage(const RenderingPayload& p, ShapedRow& row, u16 y)
+{
+    static constexpr til::CoordType tileColumns = 8;
+
+    auto& bitmap = row.bitmap;
+    const auto cellWidth = static_cast<til::CoordType>(p.s->font->cellSize.x);
+    const auto cellHeight = static_cast<til::CoordType>(p.s->font->cellSize.y);
+    const auto sourceCellWidth = bitmap.sourceSize.x / bitmap.targetWidth;
+    const auto tileCount = gsl::narrow_cast<size_t>((bitmap.targetWidth + tileColumns - 1) / tileColumns);
+    std::vector<u32> scaled;
+
+    bitmap.tiles.resize(tileCount);
+
+    for (size_t i = 0; i < tileCount; ++i)
+    {
+        const auto column = gsl::narrow_cast<til::CoordType>(i) * tileColumns;
+        const auto columns = std::min(tileColumns, bitmap.targetWidth - column);
+        const auto left = (bitmap.targetOffset + column) * cellWidth;
+        const auto width = columns * cellWidth;
+
+        // Skip tiles that are scrolled out of view horizontally, or which can't possibly fit into the atlas.
+        if (left + width <= 0 || left >= p.s->targetSize.x || width > _rectPacker->width || cellHeight > _rectPacker->height)
+        {
+            continue;
+        }
+
+        auto& tile = bitmap.tiles[i];
+        if (tile.generation != _glyphAtlasGeneration)
+        {
+            stbrp_rect rect{
+                .w = width,
+                .h = cellHeight,
+            };
+            _drawGlyphAtlasAllocate(p, rect);
+            // Direct2D may still have drawing commands (including a Clear()) for the atlas queued up.
+            _d2dEndDrawing();
+
+            // Nearest neighbor scaling from the sixel resolution to the cell size.
+            scaled.resize(gsl::narrow_cast<size_t>(width) * cellHeight);
+            const auto sourceLeft = column * sourceCellWidth;
+            const auto sourceWidth = columns * sourceCellWidth;
+            auto dst = scaled.data();
+            for (til::CoordType ty = 0; ty < cellHeight; ++ty)
+            {
+                const auto sy = ty * bitmap.sourceSize.y / cellHeight;
+                const auto src = bitmap.source.data() + sy * bitmap.sourceSize.x + sourceLeft;
+                for (til::CoordType tx = 0; tx < width; ++tx)
+                {
+                    *dst++ = src[tx * sourceWidth / width];
+                }
+            }
+
+            const D3D11_BOX box{
+                .left = static_cast<UINT>(rect.x),
+                .top = static_cast<UINT>(rect.y),
+                .front = 0,
+                .right = static_cast<UINT>(rect.x + width),
+                .bottom = static_cast<UINT>(rect.y + cellHeight),
+                .back = 1,
+            };
+            p.deviceContext->UpdateSubresource(_glyphAtlas.get(), 0, &box, scaled.data(), width * sizeof(u32), 0);
+
+            tile.generation = _glyphAtlasGeneration;
+            tile.texcoord = { static_cast<u16>(rect.x), static_cast<u16>(rect.y) };
+        }
+
+        _appendQuad() = {
+            .shadingType = static_cast<u16>(ShadingType::TextPassthrough),
+            .renditionScale = { 1, 1 },
+            .position = { static_cast<i16>(left), static_cast<i16>(y * cellHeight) },
+            .size = { static_cast<u16>(width), static_cast<u16>(cellHeight) },
+            .texcoord = tile.texcoord,
+        };
+    }
+}
+
 void BackendD3D::_drawCursorBackground(const RenderingPayload& p)
 {
     _cursorRects.clear();
@@ -71,6 +71,7 @@ namespace Microsoft::Console::Render::Atlas
             DottedLine,
             DashedLine,
             CurlyLine,
+            VerticalGridlines,
             // All items starting here will be drawing as a solid RGBA color
             SolidLine,
 
@@ -109,6 +110,8 @@ namespace Microsoft::Console::Render::Atlas
             i16x2 offset;
             u16x2 size;
             u16x2 texcoord;
+            // The value of _glyphAtlasFrame when this glyph was last drawn. See _compactGlyphAtlas().
+            u32 lastUsedFrame;
         };
 
         struct AtlasGlyphEntryHashTrait
@@ -201,12 +204,17 @@ namespace Microsoft::Console::Render::Atlas
         void _debugDumpRenderTarget(const RenderingPayload& p);
         void _d2dBeginDrawing() noexcept;
         void _d2dEndDrawing();
+        u16x2 _calculateGlyphAtlasSize(const RenderingPayload& p) const noexcept;
         ATLAS_ATTR_COLD void _resetGlyphAtlas(const RenderingPayload& p);
+        ATLAS_ATTR_COLD bool _compactGlyphAtlas(const RenderingPayload& p);
+        ATLAS_ATTR_COLD void _swapGlyphAtlasForFontChange(const RenderingPayload& p);
+        static bool _glyphAtlasFontEquals(const FontSettings& a, const FontSettings& b) noexcept;
         ATLAS_ATTR_COLD void _resizeGlyphAtlas(const RenderingPayload& p, u16 u, u16 v);
         QuadInstance& _getLastQuad() noexcept;
         QuadInstance& _appendQuad();
         ATLAS_ATTR_COLD void _bumpInstancesSize();
         void _flushQuads(const RenderingPayload& p);
+        void _flushQuadsScissored(const RenderingPayload& p);
         ATLAS_ATTR_COLD void _recreateInstanceBuffers(const RenderingPayload& p);
         void _drawBackground(const RenderingPayload& p);
         void _uploadBackgroundBitmap(const RenderingPayload& p);
@@ -219,6 +227,7 @@ namespace Microsoft::Console::Render::Atlas
         static AtlasGlyphEntry* _drawGlyphAllocateEntry(const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, u32 glyphIndex);
         static void _splitDoubleHeightGlyph(const RenderingPayload& p, const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, AtlasGlyphEntry* glyphEntry);
         void _drawGridlines(const RenderingPayload& p, u16 y);
+        void _drawImage(const RenderingPayload& p, ShapedRow& row, u16 y);
         void _drawCursorBackground(const RenderingPayload& p);
         ATLAS_ATTR_COLD void _drawCursorForeground();
         ATLAS_ATTR_COLD size_t _drawCursorForegroundSlowPath(const CursorRect& c, size_t offset);
@@ -230,6 +239,7 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID3D11VertexShader> _vertexShader;
         wil::com_ptr<ID3D11PixelShader> _pixelShader;
         wil::com_ptr<ID3D11BlendState> _blendState;
+        wil::com_ptr<ID3D11RasterizerState> _scissorRasterizerState;
         wil::com_ptr<ID3D11Buffer> _vsConstantBuffer;
         wil::com_ptr<ID3D11Buffer> _psConstantBuffer;
         wil::com_ptr<ID3D11Buffer> _vertexBuffer;
@@ -255,12 +265,25 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID3D11ShaderResourceView> _backgroundBitmapView;
         til::generation_t _backgroundBitmapGeneration;
 
+        // The glyph atlas is owned by this backend and not shared with other AtlasEngine instances (panes, tabs), because
+        // each of them runs on its own render thread and uses its own D3D11_CREATE_DEVICE_SINGLETHREADED device.
+        // Textures can't be used across devices without shared handles and keyed mutexes and Direct2D, which we use
+        // to rasterize glyphs into the atlas, is bound to a single device as well. To limit the cost of having many
+        // panes, the atlas is sized relative to the swap chain (see _calculateGlyphAtlasSize()) and only grows on demand.
         wil::com_ptr<ID3D11Texture2D> _glyphAtlas;
         wil::com_ptr<ID3D11ShaderResourceView> _glyphAtlasView;
         til::linear_flat_set<AtlasFontFaceEntry, AtlasFontFaceEntryHashTrait> _glyphAtlasMap;
         AtlasFontFaceEntry _builtinGlyphs;
         Buffer<stbrp_node> _rectPackerData;
-        stbrp_context _rectPacker{};
+        // stbrp_context points into itself (stbrp_context::extra), which means it can't be moved or swapped.
+        // It's kept on the heap instead, so that _swapGlyphAtlasForFontChange() can swap the pointers.
+        std::unique_ptr<stbrp_context> _rectPacker = std::make_unique<stbrp_context>();
+        u32 _glyphAtlasFrame = 0;
+        // Changes whenever the contents of the atlas get thrown away. ImageBitmap tiles are only valid
+        // as long as this matches. See _drawImage().
+        u64 _glyphAtlasGeneration = 0;
+        // Set if quads had to be flushed before the dirty rect of the frame was known. See _flushQuadsScissored().
+        bool _flushedQuadsEarly = false;
         til::CoordType _ligatureOverhangTriggerLeft = 0;
         til::CoordType _ligatureOverhangTriggerRight = 0;
 
@@ -271,6 +294,29 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID2D1Bitmap1> _softFontBitmap;
         bool _d2dBeganDrawing = false;
         bool _fontChangedResetGlyphAtlas = false;
+        // The font settings the current glyph atlas was rasterized with.
+        FontSettings _glyphAtlasFont;
+
+        // Changing back and forth between 2 fonts is pretty common, for instance when dragging the window between
+        // two monitors with different DPIs or when zooming in and out again. Instead of rasterizing every glyph from
+        // scratch each time, we keep the atlas of the previous font around and swap it back in if the font matches.
+        // Since it costs as much VRAM as the active one, it's released if it wasn't swapped back in for a while.
+        static constexpr auto stashedGlyphAtlasLifetime = std::chrono::seconds{ 30 };
+        struct StashedGlyphAtlas
+        {
+            FontSettings font;
+            std::chrono::steady_clock::time_point stashTime;
+            wil::com_ptr<ID3D11Texture2D> glyphAtlas;
+            wil::com_ptr<ID3D11ShaderResourceView> glyphAtlasView;
+            til::linear_flat_set<AtlasFontFaceEntry, AtlasFontFaceEntryHashTrait> glyphAtlasMap;
+            AtlasFontFaceEntry builtinGlyphs;
+            Buffer<stbrp_node> rectPackerData;
+            std::unique_ptr<stbrp_context> rectPacker = std::make_unique<stbrp_context>();
+            wil::com_ptr<ID2D1DeviceContext> d2dRenderTarget;
+            wil::com_ptr<ID2D1DeviceContext4> d2dRenderTarget4;
+            wil::com_ptr<ID2D1SolidColorBrush> emojiBrush;
+            wil::com_ptr<ID2D1SolidColorBrush> brush;
+        } _stashedGlyphAtlas;
 
         float _gamma = 0;
         float _cleartypeEnhancedContrast = 0;
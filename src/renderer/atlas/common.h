@@ -448,19 +448,60 @@ namespace Microsoft::Console::Render::Atlas
         u16 to = 0;
     };
 
+    // A cached copy of the ImageSlice (sixel graphics) attached to a row.
+    struct ImageBitmap
+    {
+        // A slice of the bitmap as uploaded into a backend's texture atlas.
+        struct Tile
+        {
+            u64 generation = 0;
+            u16x2 texcoord{};
+        };
+
+        // The ImageSlice::Revision() the source pixels were copied from. The pixels get copied
+        // again only when this changes, which makes redrawing a scrolled image cheap.
+        u64 revision = 0;
+        // Premultiplied BGRA pixels of size sourceSize.x * sourceSize.y.
+        std::vector<u32> source;
+        u16x2 sourceSize{};
+        // The range of columns the image covers, relative to the left edge of the viewport.
+        til::CoordType targetOffset = 0;
+        til::CoordType targetWidth = 0;
+        // Whether the bitmap should be drawn during the current frame. Unlike the
+        // other members this is reset by ShapedRow::Clear(), because the image data
+        // is kept around in case the next PaintImageSlice() has the same revision.
+        bool active = false;
+        // Maintained by BackendD3D. Their generation is compared against that of the atlas.
+        std::vector<Tile> tiles;
+    };
+
     struct ShapedRow
     {
-        void Clear(u16 y, u16 cellHeight) noexcept
+        // glyphCapacityLimit is the number of glyphs a row is expected to hold at most. If a row
+        // ever (temporarily) held more than that, for instance lots of combining marks, its
+        // glyph storage is released instead of being kept around at that worst-case size.
+        void Clear(u16 y, u16 cellHeight, size_t glyphCapacityLimit) noexcept
         {
             mappings.clear();
-            glyphIndices.clear();
-            glyphAdvances.clear();
-            glyphOffsets.clear();
-            colors.clear();
+            if (glyphIndices.capacity() > glyphCapacityLimit)
+            {
+                glyphIndices = {};
+                glyphAdvances = {};
+                glyphOffsets = {};
+                colors = {};
+            }
+            else
+            {
+                glyphIndices.clear();
+                glyphAdvances.clear();
+                glyphOffsets.clear();
+                colors.clear();
+            }
             gridLineRanges.clear();
             lineRendition = LineRendition::SingleWidth;
             selectionFrom = 0;
             selectionTo = 0;
+            bitmap.active = false;
             dirtyTop = y * cellHeight;
             dirtyBottom = dirtyTop + cellHeight;
         }
@@ -478,6 +519,7 @@ namespace Microsoft::Console::Render::Atlas
         std::vector<u32> colors;
 
         std::vector<GridLineRange> gridLineRanges;
+        ImageBitmap bitmap;
         LineRendition lineRendition = LineRendition::SingleWidth;
         u16 selectionFrom = 0;
         u16 selectionTo = 0;
@@ -491,7 +533,6 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID2D1Factory> d2dFactory;
         wil::com_ptr<IDWriteFactory2> dwriteFactory;
         wil::com_ptr<IDWriteFactory4> dwriteFactory4; // optional, might be nullptr
-        wil::com_ptr<IDWriteTextAnalyzer1> textAnalyzer;
         std::function<void(HRESULT, wil::zwstring_view)> warningCallback;
         std::function<void(HANDLE)> swapChainChangedCallback;
 
@@ -14,9 +14,10 @@
 #define SHADING_TYPE_DOTTED_LINE        5
 #define SHADING_TYPE_DASHED_LINE        6
 #define SHADING_TYPE_CURLY_LINE         7
-#define SHADING_TYPE_SOLID_LINE         8
-#define SHADING_TYPE_CURSOR             9
-#define SHADING_TYPE_SELECTION          10
+#define SHADING_TYPE_VERTICAL_GRIDLINES 8
+#define SHADING_TYPE_SOLID_LINE         9
+#define SHADING_TYPE_CURSOR             10
+#define SHADING_TYPE_SELECTION          11
 
 struct VSData
 {
@@ -181,6 +181,16 @@ Output main(PSData data) : SV_Target
         weights = color.aaaa;
         break;
     }
+    case SHADING_TYPE_VERTICAL_GRIDLINES:
+    {
+        // A single quad covers a whole run of vertical gridlines, one per (possibly double-width) cell.
+        // The texcoord is the offset from the first line and renditionScale.y holds the line width.
+        const float period = backgroundCellSize.x * data.renditionScale.x;
+        const bool on = frac(data.texcoord.x / period) * period < data.renditionScale.y;
+        color = on * premultiplyColor(data.color);
+        weights = color.aaaa;
+        break;
+    }
     default:
     {
         color = premultiplyColor(data.color);
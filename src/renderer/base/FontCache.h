@@ -3,12 +3,36 @@
 
 #pragma once
 
+#include <future>
+
 #include <til/mutex.h>
 
 namespace Microsoft::Console::Render::FontCache
 {
     namespace details
     {
+        inline std::filesystem::path getNearbyFontsFolder()
+        {
+            const std::filesystem::path module{ wil::GetModuleFileNameW<std::wstring>(nullptr) };
+            return module.parent_path();
+        }
+
+        // The last write time of a directory changes whenever a file is added to or removed from it.
+        // GetCached() uses this to notice when the nearby fonts changed, without enumerating them.
+        inline std::filesystem::file_time_type getNearbyFontsTimestamp()
+        {
+            if constexpr (Feature_NearbyFontLoading::IsEnabled())
+            {
+                std::error_code ec;
+                const auto timestamp = std::filesystem::last_write_time(getNearbyFontsFolder(), ec);
+                return ec ? std::filesystem::file_time_type{} : timestamp;
+            }
+            else
+            {
+                return {};
+            }
+        }
+
         inline wil::com_ptr<IDWriteFontCollection> getFontCollection()
         {
             wil::com_ptr<IDWriteFactory> factory;
@@ -28,8 +52,7 @@ namespace Microsoft::Console::Render::FontCache
 
                 std::vector<wil::com_ptr<IDWriteFontFile>> nearbyFontFiles;
 
-                const std::filesystem::path module{ wil::GetModuleFileNameW<std::wstring>(nullptr) };
-                const auto folder{ module.parent_path() };
+                const auto folder{ getNearbyFontsFolder() };
 
                 for (const auto& p : std::filesystem::directory_iterator(folder))
                 {
@@ -77,17 +100,52 @@ namespace Microsoft::Console::Render::FontCache
                 return systemFontCollection;
             }
         }
+
+        struct CachedCollection
+        {
+            wil::com_ptr<IDWriteFontCollection> collection;
+            std::filesystem::file_time_type timestamp;
+            std::shared_future<wil::com_ptr<IDWriteFontCollection>> pending;
+        };
+
+        inline til::shared_mutex<CachedCollection>& getCachedCollection()
+        {
+            static til::shared_mutex<CachedCollection> cachedCollection;
+            return cachedCollection;
+        }
     }
 
+    // Starts loading the font collection on a background thread, so that
+    // a later call to GetCached() (hopefully) doesn't have to wait for it.
+    inline void Prefetch()
+    {
+        const auto guard = details::getCachedCollection().lock();
+        if (!guard->collection && !guard->pending.valid())
+        {
+            guard->timestamp = details::getNearbyFontsTimestamp();
+            guard->pending = std::async(std::launch::async, &details::getFontCollection).share();
+        }
+    }
+
+    // Returns the font collection including nearby fonts. It's loaded on first use (or by Prefetch())
+    // and reloaded whenever the folder containing the nearby fonts was modified since.
     inline wil::com_ptr<IDWriteFontCollection> GetCached()
     {
-        static til::shared_mutex<wil::com_ptr<IDWriteFontCollection>> cachedCollection;
+        const auto guard = details::getCachedCollection().lock();
+
+        if (guard->pending.valid())
+        {
+            const auto pending = std::move(guard->pending);
+            guard->collection = pending.get();
+        }
 
-        const auto guard = cachedCollection.lock();
-        if (!*guard)
+        const auto timestamp = details::getNearbyFontsTimestamp();
+        if (!guard->collection || guard->timestamp != timestamp)
         {
-            *guard = details::getFontCollection();
+            guard->collection = details::getFontCollection();
+            guard->timestamp = timestamp;
         }
-        return *guard;
+
+        return guard->collection;
     }
 }
@@ -64,6 +64,13 @@ HRESULT RenderEngineBase::PrepareLineTransform(const LineRendition /*lineRenditi
     return S_FALSE;
 }
 
+HRESULT RenderEngineBase::PaintImageSlice(const ImageSlice& /*imageSlice*/,
+                                          const til::CoordType /*targetRow*/,
+                                          const til::CoordType /*viewportLeft*/) noexcept
+{
+    return S_FALSE;
+}
+
 // Method Description:
 // - By default, no one should need continuous redraw. It ruins performance
 //   in terms of CPU, memory, and battery life to just paint forever.
@@ -182,7 +182,7 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttri
             fg != bg &&
             (_renderMode.test(Mode::AlwaysDistinguishableColors) || (fgTextColor.IsDefaultOrLegacy() && bgTextColor.IsDefaultOrLegacy())))
         {
-            fg = ColorFix::GetPerceivableColor(fg, bg, 0.5f * 0.5f);
+            fg = _getPerceivableColor(fg, bg);
         }
     }
 
@@ -246,13 +246,80 @@ COLORREF RenderSettings::GetAttributeUnderlineColor(const TextAttribute& attr) c
             (_renderMode.test(Mode::AlwaysDistinguishableColors) ||
              (_renderMode.test(Mode::IndexedDistinguishableColors) && ulTextColor.IsDefaultOrLegacy() && attr.GetBackground().IsDefaultOrLegacy())))
         {
-            ul = ColorFix::GetPerceivableColor(ul, bg, 0.5f * 0.5f);
+            ul = _getPerceivableColor(ul, bg);
         }
     }
 
     return ul;
 }
 
+// Routine Description:
+// - A memoizing wrapper around ColorFix::GetPerceivableColor(), which is too expensive to be
+//   called for every attribute run in every frame. Since the result only depends on the two
+//   colors, the cache doesn't need to be invalidated when the color table changes.
+// Arguments:
+// - color - The color that should be made distinguishable from the reference.
+// - reference - The color that it should be distinguishable from (usually the background).
+// Return Value:
+// - The adjusted color.
+COLORREF RenderSettings::_getPerceivableColor(const COLORREF color, const COLORREF reference) const noexcept
+{
+    auto& entry = _perceivableColorCacheEntry(color, reference);
+
+    if (entry.color != color || entry.reference != reference)
+    {
+        entry.color = color;
+        entry.reference = reference;
+        entry.result = ColorFix::GetPerceivableColor(color, reference, 0.5f * 0.5f);
+    }
+
+    return entry.result;
+}
+
+RenderSettings::PerceivableColorCacheEntry& RenderSettings::_perceivableColorCacheEntry(const COLORREF color, const COLORREF reference) const noexcept
+{
+    // The callers ensure that color != reference, so the INVALID_COLOR pair
+    // that unused entries are initialized with can never produce a false hit.
+    const auto key = static_cast<uint64_t>(color) << 32 | reference;
+    const auto hash = static_cast<size_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> 56);
+    return til::at(_perceivableColorCache, hash);
+}
+
+// Routine Description:
+// - Fills the perceivable color cache for the 16 indexed colors and the default foreground
+//   on the default background, which covers most of what the first frame after a color table
+//   change will ask for. ColorFix::GetPerceivableColors() processes all of them in one batch.
+void RenderSettings::PrecomputePerceivableColors() noexcept
+{
+    if constexpr (Feature_AdjustIndistinguishableText::IsEnabled())
+    {
+        if (!_renderMode.any(Mode::IndexedDistinguishableColors, Mode::AlwaysDistinguishableColors))
+        {
+            return;
+        }
+
+        const auto reference = til::at(_colorTable, GetColorAliasIndex(ColorAlias::DefaultBackground));
+        std::array<COLORREF, 17> colors;
+        std::copy_n(_colorTable.begin(), 16, colors.begin());
+        til::at(colors, 16) = til::at(_colorTable, GetColorAliasIndex(ColorAlias::DefaultForeground));
+
+        auto results = colors;
+        ColorFix::GetPerceivableColors(results, reference, 0.5f * 0.5f);
+
+        for (size_t i = 0; i < colors.size(); ++i)
+        {
+            const auto color = til::at(colors, i);
+            if (color != reference)
+            {
+                auto& entry = _perceivableColorCacheEntry(color, reference);
+                entry.color = color;
+                entry.reference = reference;
+                entry.result = til::at(results, i);
+            }
+        }
+    }
+}
+
 // Routine Description:
 // - Increments the position in the blink cycle, toggling the blink rendition
 //   state on every second call, potentially triggering a redraw of the given
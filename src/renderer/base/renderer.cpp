@@ -91,7 +91,7 @@ IRenderData* Renderer::GetRenderData() const noexcept
         if (--tries == 0)
         {
             // Stop trying.
-            _pThread->DisablePainting();
+            DisablePainting();
             if (_pfnRendererEnteredErrorState)
             {
                 _pfnRendererEnteredErrorState();
@@ -110,25 +110,53 @@ IRenderData* Renderer::GetRenderData() const noexcept
     return S_OK;
 }
 
+// Returns the number of microseconds between beg and end, saturated to fit in a uint32_t.
+static uint32_t elapsedMicroseconds(const std::chrono::steady_clock::time_point beg, const std::chrono::steady_clock::time_point end) noexcept
+{
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - beg).count();
+    return gsl::narrow_cast<uint32_t>(std::clamp<int64_t>(us, 0, UINT32_MAX));
+}
+
 [[nodiscard]] HRESULT Renderer::_PaintFrame() noexcept
 {
+    const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::render };
+    _currentFrameStatistics = {};
+
+    std::chrono::steady_clock::time_point lockHoldBeg;
+
     {
+        const auto lockWaitBeg = std::chrono::steady_clock::now();
         _pData->LockConsole();
+        lockHoldBeg = std::chrono::steady_clock::now();
+        _currentFrameStatistics.lockWaitTime = elapsedMicroseconds(lockWaitBeg, lockHoldBeg);
+
         auto unlock = wil::scope_exit([&]() {
             _pData->UnlockConsole();
+            _currentFrameStatistics.lockHoldTime = elapsedMicroseconds(lockHoldBeg, std::chrono::steady_clock::now());
         });
 
         // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
         _CheckViewportAndScroll();
 
+        // The engines are about to consume their invalidated regions. See TriggerRedraw().
+        _lastRedrawRegion = {};
+
+        // Frames get painted for all sorts of reasons while a composition is active, like
+        // output elsewhere in the viewport or the cursor blinking. Only if the composition
+        // actually changed do we need to invalidate (and reshape) the row it's on.
+        const auto compositionChanged = _compositionChanged();
+
         _invalidateCurrentCursor(); // Invalidate the previous cursor position.
-        _invalidateOldComposition();
+        if (compositionChanged)
+        {
+            _invalidateOldComposition();
+        }
 
         _updateCursorInfo();
         _compositionCache.reset();
 
         _invalidateCurrentCursor(); // Invalidate the new cursor position.
-        _prepareNewComposition();
+        _prepareNewComposition(compositionChanged);
 
         FOREACH_ENGINE(pEngine)
         {
@@ -136,14 +164,53 @@ IRenderData* Renderer::GetRenderData() const noexcept
         }
     }
 
+    const auto presentBeg = std::chrono::steady_clock::now();
+
     FOREACH_ENGINE(pEngine)
     {
         RETURN_IF_FAILED(pEngine->Present());
     }
 
+    _currentFrameStatistics.presentTime = elapsedMicroseconds(presentBeg, std::chrono::steady_clock::now());
+    _recordFrameStatistics();
+
+    if (_pfnFramePresented)
+    {
+        try
+        {
+            _pfnFramePresented(lockHoldBeg);
+        }
+        CATCH_LOG();
+    }
+
     return S_OK;
 }
 
+void Renderer::_recordFrameStatistics() noexcept
+{
+    const auto guard = _frameStatisticsLock.lock_exclusive();
+    til::at(_frameStatistics, _frameStatisticsCount % FrameStatisticsCapacity) = _currentFrameStatistics;
+    _frameStatisticsCount++;
+}
+
+// Routine Description:
+// - Returns the statistics of up to the last FrameStatisticsCapacity frames, oldest first.
+// - This is cheap enough to be polled regularly, for instance by a debug overlay.
+std::vector<Renderer::FrameStatistics> Renderer::GetFrameStatistics() const
+{
+    const auto guard = _frameStatisticsLock.lock_shared();
+    const auto count = std::min(_frameStatisticsCount, FrameStatisticsCapacity);
+    const auto first = _frameStatisticsCount - count;
+
+    std::vector<FrameStatistics> statistics;
+    statistics.reserve(count);
+    for (auto i = first; i < _frameStatisticsCount; ++i)
+    {
+        statistics.emplace_back(til::at(_frameStatistics, i % FrameStatisticsCapacity));
+    }
+    return statistics;
+}
+
 [[nodiscard]] HRESULT Renderer::_PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept
 try
 {
@@ -164,12 +231,12 @@ try
     auto endPaint = wil::scope_exit([&]() {
         LOG_IF_FAILED(pEngine->EndPaint());
 
-        // If the engine tells us it really wants to redraw immediately,
+        // If the engine tells us it really wants to redraw continuously,
         // tell the thread so it doesn't go to sleep and ticks again
-        // at the next opportunity.
-        if (pEngine->RequiresContinuousRedraw())
+        // at the next opportunity (capped to the animation frame rate).
+        if (pEngine->RequiresContinuousRedraw() && _pThread)
         {
-            NotifyPaintFrame();
+            _pThread->NotifyAnimationFrame();
         }
     });
 
@@ -215,6 +282,19 @@ void Renderer::NotifyPaintFrame() noexcept
     }
 }
 
+// Routine Description:
+// - Called whenever output was written into the text buffer. This lets the render thread
+//   detect floods of output and reduce the frame rate while they last. See RenderThread::_PaceFrame().
+// Arguments:
+// - characters - The number of characters that were written.
+void Renderer::NotifyOutput(const size_t characters) noexcept
+{
+    if (_pThread)
+    {
+        _pThread->NotifyOutput(characters);
+    }
+}
+
 // Routine Description:
 // - Called when the system has requested we redraw a portion of the console.
 // Arguments:
@@ -257,6 +337,16 @@ void Renderer::TriggerRedraw(const Viewport& region)
     if (view.TrimToViewport(&srUpdateRegion))
     {
         view.ConvertToOrigin(&srUpdateRegion);
+
+        // Applications that redraw a status or progress line with \r tend to invalidate the
+        // same cells many times between two frames. If the previous invalidation already covered
+        // this region, every engine knows about it already and we've already requested a frame.
+        if (_lastRedrawRegion.contains(srUpdateRegion))
+        {
+            return;
+        }
+        _lastRedrawRegion = srUpdateRegion;
+
         FOREACH_ENGINE(pEngine)
         {
             LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
@@ -349,7 +439,7 @@ void Renderer::TriggerSelection()
     try
     {
         // Get selection rectangles
-        auto rects = _GetSelectionRects();
+        const auto& rects = _GetSelectionRects();
 
         // Make a viewport representing the coordinates that are currently presentable.
         const til::rect viewport{ _pData->GetViewport().Dimensions() };
@@ -366,7 +456,8 @@ void Renderer::TriggerSelection()
             LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
         }
 
-        _previousSelection = std::move(rects);
+        // assign() instead of a move, so that both vectors keep their capacity.
+        _previousSelection.assign(rects.begin(), rects.end());
         NotifyPaintFrame();
     }
     CATCH_LOG();
@@ -416,6 +507,8 @@ bool Renderer::_CheckViewportAndScroll()
 
     _viewport = Viewport::FromInclusive(srNewViewport);
     _forceUpdateViewport = false;
+    // The engines shift (or reset) their invalidated regions, which means the remembered one isn't valid anymore.
+    _lastRedrawRegion = {};
 
     til::point coordDelta;
     coordDelta.x = srOldViewport.left - srNewViewport.left;
@@ -471,6 +564,8 @@ void Renderer::TriggerScroll()
 // - <none>
 void Renderer::TriggerScroll(const til::point* const pcoordDelta)
 {
+    _lastRedrawRegion = {};
+
     FOREACH_ENGINE(pEngine)
     {
         LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
@@ -490,9 +585,11 @@ void Renderer::TriggerScroll(const til::point* const pcoordDelta)
 // - <none>
 void Renderer::TriggerFlush(const bool circling)
 {
-    const auto rects = _GetSelectionRects();
+    const auto& rects = _GetSelectionRects();
     auto repaint = false;
 
+    _lastRedrawRegion = {};
+
     FOREACH_ENGINE(pEngine)
     {
         auto fEngineRequestsRepaint = false;
@@ -679,6 +776,17 @@ void Renderer::EnablePainting()
     }
 }
 
+// Routine Description:
+// - Pauses the render thread without waiting for an in-progress frame to complete.
+//   Invalidations keep accumulating and will be drawn once EnablePainting() is called.
+void Renderer::DisablePainting()
+{
+    if (_pThread)
+    {
+        _pThread->DisablePainting();
+    }
+}
+
 // Routine Description:
 // - Waits for the current paint operation to complete, if any, up to the specified timeout.
 // - Resets an event in the render thread that precludes it from advancing, thus disabling rendering.
@@ -826,11 +934,19 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
             const auto lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().y).WasWrapForced()) &&
                                      (bufferLine.RightExclusive() == buffer.GetSize().Width());
 
+            _currentFrameStatistics.rowsPainted++;
+
             // Prepare the appropriate line transform for the current row and viewport offset.
             LOG_IF_FAILED(pEngine->PrepareLineTransform(lineRendition, screenPosition.y, view.Left()));
 
             // Ask the helper to paint through this specific line.
             _PaintBufferOutputHelper(pEngine, it, screenPosition, lineWrapped);
+
+            // Images are painted on top of the text of the row they're attached to.
+            if (const auto imageSlice = r.GetImageSlice())
+            {
+                LOG_IF_FAILED(pEngine->PaintImageSlice(*imageSlice, screenPosition.y, view.Left()));
+            }
         }
     }
 }
@@ -974,13 +1090,14 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                     // exact column. The code above will condense two-column characters into one, but it is possible
                     // (like with the IME) that the line drawing characters will vary from the left to right half
                     // of a wider character.
-                    // We could theoretically pre-pass for this in the loop above to be more efficient about walking
-                    // the iterator, but I fear it would make the code even more confusing than it already is.
-                    // Do that in the future if some WPR trace points you to this spot as super bad.
-                    for (til::CoordType colsPainted = 0; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.x)
+                    // Since the attributes are stored as runs, we can still paint the lines one run at a time.
+                    for (til::CoordType colsPainted = 0; colsPainted < cols;)
                     {
-                        auto lines = lineIt->TextAttr();
-                        _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
+                        const auto runLength = std::clamp(lineIt.AttrRunLength(), 1, cols - colsPainted);
+                        _PaintBufferOutputGridLineHelper(pEngine, lineIt->TextAttr(), runLength, lineTarget);
+                        colsPainted += runLength;
+                        lineIt += runLength;
+                        lineTarget.x += runLength;
                     }
                 }
                 else
@@ -1193,6 +1310,39 @@ void Renderer::_invalidateCurrentCursor() const
     }
 }
 
+// Returns true if the active TSF composition or the position it's drawn at changed since the last frame.
+// Updates the state we compare against for the next frame.
+bool Renderer::_compositionChanged() noexcept
+try
+{
+    const auto& composition = _pData->activeComposition;
+    const auto cursor = _pData->GetCursorPosition();
+    const auto viewportOrigin = _pData->GetViewport().Origin();
+
+    const auto unchanged = composition.text == _lastComposition.text &&
+                           composition.cursorPos == _lastComposition.cursorPos &&
+                           std::equal(composition.attributes.begin(), composition.attributes.end(), _lastComposition.attributes.begin(), _lastComposition.attributes.end(), [](const auto& a, const auto& b) {
+                               return a.len == b.len && a.attr == b.attr;
+                           }) &&
+                           cursor == _lastCompositionCursor &&
+                           viewportOrigin == _lastCompositionViewportOrigin;
+    if (unchanged)
+    {
+        return false;
+    }
+
+    _lastComposition = composition;
+    _lastCompositionCursor = cursor;
+    _lastCompositionViewportOrigin = viewportOrigin;
+    return true;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    _lastComposition = {};
+    return true;
+}
+
 // If we had previously drawn a composition at the previous cursor position
 // we need to invalidate the entire line because who knows what changed.
 // (It's possible to figure that out, but not worth the effort right now.)
@@ -1219,7 +1369,7 @@ void Renderer::_invalidateOldComposition() const
 
 // Invalidate the line that the active TSF composition is on,
 // so that _PaintBufferOutput() actually gets a chance to draw it.
-void Renderer::_prepareNewComposition()
+void Renderer::_prepareNewComposition(const bool invalidate)
 {
     if (_pData->activeComposition.text.empty())
     {
@@ -1234,9 +1384,14 @@ void Renderer::_prepareNewComposition()
     {
         viewport.ConvertToOrigin(&line);
 
-        FOREACH_ENGINE(pEngine)
+        // Even if the composition didn't change, we still have to prepare it below,
+        // in case the row it's on got invalidated for another reason.
+        if (invalidate)
         {
-            LOG_IF_FAILED(pEngine->Invalidate(&line));
+            FOREACH_ENGINE(pEngine)
+            {
+                LOG_IF_FAILED(pEngine->Invalidate(&line));
+            }
         }
 
         auto& buffer = _pData->GetTextBuffer();
@@ -1316,9 +1471,8 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
         LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
 
         // Get selection rectangles
-        const auto rectangles = _GetSelectionRects();
+        const auto& rectangles = _GetSelectionRects();
 
-        std::vector<til::rect> dirtySearchRectangles;
         for (auto& dirtyRect : dirtyAreas)
         {
             for (const auto& rect : rectangles)
@@ -1372,15 +1526,17 @@ void Renderer::_PaintSelection(_In_ IRenderEngine* const pEngine)
 // - Helper to determine the selected region of the buffer.
 // Return Value:
 // - A vector of rectangles representing the regions to select, line by line.
-std::vector<til::rect> Renderer::_GetSelectionRects() const
+//   It's a reused buffer that remains valid until the next call.
+const std::vector<til::rect>& Renderer::_GetSelectionRects()
 {
     const auto& buffer = _pData->GetTextBuffer();
     auto rects = _pData->GetSelectionRects();
     // Adjust rectangles to viewport
     auto view = _pData->GetViewport();
 
-    std::vector<til::rect> result;
-    result.reserve(rects.size());
+    // This is called at least once per frame, so the buffer is reused to avoid reallocating it.
+    _selectionRects.clear();
+    _selectionRects.reserve(rects.size());
 
     for (auto rect : rects)
     {
@@ -1388,10 +1544,10 @@ std::vector<til::rect> Renderer::_GetSelectionRects() const
         // expected by callers, taking line rendition into account.
         const auto lineRendition = buffer.GetLineRendition(rect.Top());
         rect = Viewport::FromInclusive(BufferToScreenLine(rect.ToInclusive(), lineRendition));
-        result.emplace_back(view.ConvertToOrigin(rect).ToExclusive());
+        _selectionRects.emplace_back(view.ConvertToOrigin(rect).ToExclusive());
     }
 
-    return result;
+    return _selectionRects;
 }
 
 // Method Description:
@@ -1435,6 +1591,7 @@ void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
         {
             p = pEngine;
             _forceUpdateViewport = true;
+            _lastRedrawRegion = {};
             return;
         }
     }
@@ -1490,6 +1647,19 @@ void Renderer::SetRendererEnteredErrorStateCallback(std::function<void()> pfn)
     _pfnRendererEnteredErrorState = std::move(pfn);
 }
 
+// Method Description:
+// - Registers a callback that will be called on the render thread after each presented frame.
+//   It receives the time at which the frame acquired the console lock: Any change
+//   made to the buffer before that point in time is visible in the presented frame.
+// Arguments:
+// - pfn: the callback
+// Return Value:
+// - <none>
+void Renderer::SetFramePresentedCallback(std::function<void(std::chrono::steady_clock::time_point)> pfn)
+{
+    _pfnFramePresented = std::move(pfn);
+}
+
 // Method Description:
 // - Attempts to restart the renderer.
 void Renderer::ResetErrorStateAndResume()
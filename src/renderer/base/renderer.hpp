@@ -36,6 +36,17 @@ namespace Microsoft::Console::Render
     class Renderer
     {
     public:
+        // Timings of a single frame in microseconds, as recorded by _PaintFrame().
+        struct FrameStatistics
+        {
+            uint32_t lockWaitTime = 0;
+            uint32_t lockHoldTime = 0;
+            uint32_t presentTime = 0;
+            uint32_t rowsPainted = 0;
+        };
+
+        static constexpr size_t FrameStatisticsCapacity = 64;
+
         Renderer(const RenderSettings& renderSettings,
                  IRenderData* pData,
                  _In_reads_(cEngines) IRenderEngine** const pEngine,
@@ -49,6 +60,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT PaintFrame();
 
         void NotifyPaintFrame() noexcept;
+        void NotifyOutput(size_t characters) noexcept;
         void TriggerSystemRedraw(const til::rect* const prcDirtyClient);
         void TriggerRedraw(const Microsoft::Console::Types::Viewport& region);
         void TriggerRedraw(const til::point* const pcoord);
@@ -80,6 +92,7 @@ namespace Microsoft::Console::Render
         bool IsGlyphWideByFont(const std::wstring_view glyph);
 
         void EnablePainting();
+        void DisablePainting();
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs);
         void WaitUntilCanRender();
 
@@ -89,11 +102,14 @@ namespace Microsoft::Console::Render
         void SetBackgroundColorChangedCallback(std::function<void()> pfn);
         void SetFrameColorChangedCallback(std::function<void()> pfn);
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
+        void SetFramePresentedCallback(std::function<void(std::chrono::steady_clock::time_point)> pfn);
         void ResetErrorStateAndResume();
 
         void UpdateHyperlinkHoveredId(uint16_t id) noexcept;
         void UpdateLastHoveredInterval(const std::optional<interval_tree::IntervalTree<til::point, size_t>::interval>& newInterval);
 
+        std::vector<FrameStatistics> GetFrameStatistics() const;
+
     private:
         // Caches some essential information about the active composition.
         // This allows us to properly invalidate it between frames, etc.
@@ -118,15 +134,17 @@ namespace Microsoft::Console::Render
         void _PaintCursor(_In_ IRenderEngine* const pEngine);
         [[nodiscard]] HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const TextAttribute attr, const bool usingSoftFont, const bool isSettingDefaultBrushes);
         [[nodiscard]] HRESULT _PerformScrolling(_In_ IRenderEngine* const pEngine);
-        std::vector<til::rect> _GetSelectionRects() const;
+        const std::vector<til::rect>& _GetSelectionRects();
         void _ScrollPreviousSelection(const til::point delta);
         [[nodiscard]] HRESULT _PaintTitle(IRenderEngine* const pEngine);
         bool _isInHoveredInterval(til::point coordTarget) const noexcept;
         void _updateCursorInfo();
         void _invalidateCurrentCursor() const;
+        bool _compositionChanged() noexcept;
         void _invalidateOldComposition() const;
-        void _prepareNewComposition();
+        void _prepareNewComposition(bool invalidate);
         [[nodiscard]] HRESULT _PrepareRenderInfo(_In_ IRenderEngine* const pEngine);
+        void _recordFrameStatistics() noexcept;
 
         const RenderSettings& _renderSettings;
         std::array<IRenderEngine*, 2> _engines{};
@@ -139,14 +157,29 @@ namespace Microsoft::Console::Render
         Microsoft::Console::Types::Viewport _viewport;
         CursorOptions _currentCursorOptions;
         std::optional<CompositionCache> _compositionCache;
+        // The composition as of the last frame, and where it was drawn.
+        // As long as none of it changes, its row doesn't need to be invalidated again.
+        Composition _lastComposition;
+        til::point _lastCompositionCursor;
+        til::point _lastCompositionViewportOrigin;
         std::vector<Cluster> _clusterBuffer;
         std::vector<til::rect> _previousSelection;
+        std::vector<til::rect> _selectionRects; // scratch buffer for _GetSelectionRects()
+        til::rect _lastRedrawRegion; // the last region passed to IRenderEngine::Invalidate() since the last frame
         std::function<void()> _pfnBackgroundColorChanged;
         std::function<void()> _pfnFrameColorChanged;
         std::function<void()> _pfnRendererEnteredErrorState;
+        std::function<void(std::chrono::steady_clock::time_point)> _pfnFramePresented;
         bool _destructing = false;
         bool _forceUpdateViewport = false;
 
+        // The statistics of the last FrameStatisticsCapacity frames are stored in a ring buffer.
+        // The lock only guards the ring buffer, as GetFrameStatistics() may be called from any thread.
+        FrameStatistics _currentFrameStatistics;
+        mutable wil::srwlock _frameStatisticsLock;
+        std::array<FrameStatistics, FrameStatisticsCapacity> _frameStatistics{};
+        size_t _frameStatisticsCount = 0;
+
 #ifdef UNIT_TESTING
         friend class ConptyOutputTests;
         friend class TerminalCoreUnitTests::ConptyRoundtripTests;
@@ -213,6 +213,8 @@ DWORD WINAPI RenderThread::_ThreadProc()
             ResetEvent(_hEvent);
         }
 
+        _PaceFrame();
+
         ResetEvent(_hPaintCompletedEvent);
         LOG_IF_FAILED(_pRenderer->PaintFrame());
         SetEvent(_hPaintCompletedEvent);
@@ -221,6 +223,60 @@ DWORD WINAPI RenderThread::_ThreadProc()
     return S_OK;
 }
 
+// Method Description:
+// - Delays the next frame while the terminal is flooded with output, for instance during a `cat` of a large file.
+//   The frames we'd paint during such a flood are barely visible, but the time spent painting them (while holding
+//   the console lock) slows down the producer. Interactive output, like the echo of a keystroke, is short
+//   and arrives after a pause, so its throughput stays low and it's still painted immediately.
+void RenderThread::_PaceFrame() noexcept
+{
+    const auto characters = _outputCharacters.exchange(0, std::memory_order_relaxed);
+    const auto animationFrameRequested = _animationFrameRequested.exchange(false, std::memory_order_relaxed);
+    const auto elapsed = std::chrono::steady_clock::now() - _lastFrameTime;
+    std::chrono::steady_clock::duration interval{};
+
+    if (characters != 0 && elapsed < s_floodFrameInterval)
+    {
+        const auto elapsedUs = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        const auto charactersPerSecond = characters * 1'000'000 / gsl::narrow_cast<uint64_t>(elapsedUs);
+
+        if (charactersPerSecond >= s_floodCharactersPerSecond)
+        {
+            interval = s_floodFrameInterval;
+        }
+    }
+
+    // Animated frames don't need to be painted at the display refresh rate, which may be 144Hz or more.
+    // This applies even if some output arrived since the last frame, like a clock in a status line.
+    // If anything else requested this frame, it'll be slightly delayed, but never by more than one interval.
+    if (animationFrameRequested)
+    {
+        interval = std::max<std::chrono::steady_clock::duration>(interval, s_animationFrameInterval);
+    }
+
+    if (elapsed < interval)
+    {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(interval - elapsed);
+        Sleep(gsl::narrow_cast<DWORD>(remaining.count()));
+    }
+
+    _lastFrameTime = std::chrono::steady_clock::now();
+}
+
+void RenderThread::NotifyOutput(const size_t characters) noexcept
+{
+    _outputCharacters.fetch_add(characters, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Requests another frame on behalf of an engine that requires continuous redraws.
+//   Unlike NotifyPaint(), these frames are paced to s_animationFrameInterval.
+void RenderThread::NotifyAnimationFrame() noexcept
+{
+    _animationFrameRequested.store(true, std::memory_order_relaxed);
+    NotifyPaint();
+}
+
 void RenderThread::NotifyPaint() noexcept
 {
     if (_fWaiting.load(std::memory_order_acquire))
@@ -27,6 +27,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT Initialize(Renderer* const pRendererParent) noexcept;
 
         void NotifyPaint() noexcept;
+        void NotifyOutput(size_t characters) noexcept;
+        void NotifyAnimationFrame() noexcept;
         void EnablePainting() noexcept;
         void DisablePainting() noexcept;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) noexcept;
@@ -34,6 +36,15 @@ namespace Microsoft::Console::Render
     private:
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
+        void _PaceFrame() noexcept;
+
+        // While more than this many characters per second are being written, frames are painted at most every
+        // s_floodFrameInterval. This is well above what interactive applications produce, but far below a `cat`.
+        static constexpr uint64_t s_floodCharactersPerSecond = 1'000'000;
+        static constexpr std::chrono::milliseconds s_floodFrameInterval{ 33 };
+        // Engines that require continuous redraws (e.g. custom shaders that use the time uniform)
+        // are capped to this frame interval instead of redrawing at the display's refresh rate.
+        static constexpr std::chrono::milliseconds s_animationFrameInterval{ 16 };
 
         HANDLE _hThread;
         HANDLE _hEvent;
@@ -46,5 +57,9 @@ namespace Microsoft::Console::Render
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+
+        std::atomic<uint64_t> _outputCharacters{ 0 };
+        std::atomic<bool> _animationFrameRequested{ false };
+        std::chrono::steady_clock::time_point _lastFrameTime;
     };
 }
@@ -410,6 +410,30 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
         const auto topOffset = _currentLineRendition == LineRendition::DoubleHeightBottom ? halfHeight : 0;
         const auto bottomOffset = _currentLineRendition == LineRendition::DoubleHeightTop ? halfHeight : 0;
 
+        // If this run directly continues the previous one on the same row, we can simply append it,
+        // because UpdateDrawingBrushes() only flushes the pending runs if the brushes or font changed.
+        // This happens for instance if only the underline or hyperlink changed between two runs.
+        // (Raster fonts are excluded, because the codepage conversion above may change the string length.)
+        if (_cPolyText > 0 && _isTrueTypeFont && !trimLeft)
+        {
+            auto& prevPolyText = _pPolyText[_cPolyText - 1];
+            if (prevPolyText.y == ptDraw.y && prevPolyText.rcl.right == ptDraw.x && prevPolyText.rcl.top == ptDraw.y + topOffset)
+            {
+                auto& prevPolyString = _polyStrings[_cPolyText - 1];
+                auto& prevPolyWidth = _polyWidths[_cPolyText - 1];
+                prevPolyString += polyString;
+                prevPolyWidth += polyWidth;
+                _polyStrings.pop_back();
+                _polyWidths.pop_back();
+
+                prevPolyText.lpstr = prevPolyString.data();
+                prevPolyText.n = gsl::narrow<UINT>(prevPolyString.size());
+                prevPolyText.rcl.right += (til::CoordType)cchCharWidths;
+                prevPolyText.pdx = prevPolyWidth.data();
+                return S_OK;
+            }
+        }
+
         pPolyTextLine->lpstr = polyString.data();
         pPolyTextLine->n = gsl::narrow<UINT>(polyString.size());
         pPolyTextLine->x = ptDraw.x;
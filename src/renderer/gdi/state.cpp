@@ -42,6 +42,11 @@ GdiEngine::GdiEngine() :
 {
     ZeroMemory(_pPolyText, sizeof(POLYTEXTW) * s_cPolyTextCache);
 
+    // _pPolyText points into these strings. Reserving the max. number of entries up front ensures that
+    // the vectors never reallocate, which would invalidate the pointers of short (SSO) strings.
+    _polyStrings.reserve(s_cPolyTextCache);
+    _polyWidths.reserve(s_cPolyTextCache);
+
     _hdcMemoryContext = CreateCompatibleDC(nullptr);
     THROW_HR_IF_NULL(E_FAIL, _hdcMemoryContext);
 
@@ -269,13 +274,24 @@ GdiEngine::~GdiEngine()
                                                       const bool usingSoftFont,
                                                       const bool isSettingDefaultBrushes) noexcept
 {
-    RETURN_IF_FAILED(_FlushBufferLines());
-
-    RETURN_HR_IF_NULL(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), _hdcMemoryContext);
-
     // Set the colors for painting text
     const auto [colorForeground, colorBackground] = renderSettings.GetAttributeColors(textAttributes);
 
+    const auto usingItalicFont = textAttributes.IsItalic();
+    const auto fontType = usingSoftFont   ? FontType::Soft :
+                          usingItalicFont ? FontType::Italic :
+                                            FontType::Default;
+
+    // The pending runs are drawn with whatever DC state is current during _FlushBufferLines().
+    // As long as that state doesn't change, we can keep accumulating runs (even across rows)
+    // and draw them in one batch, instead of flushing for every single run.
+    if (colorForeground != _lastFg || colorBackground != _lastBg || fontType != _lastFontType)
+    {
+        RETURN_IF_FAILED(_FlushBufferLines());
+    }
+
+    RETURN_HR_IF_NULL(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), _hdcMemoryContext);
+
     if (colorForeground != _lastFg)
     {
         RETURN_HR_IF(E_FAIL, CLR_INVALID == SetTextColor(_hdcMemoryContext, colorForeground));
@@ -297,10 +313,6 @@ GdiEngine::~GdiEngine()
     }
 
     // If the font type has changed, select an appropriate font variant or soft font.
-    const auto usingItalicFont = textAttributes.IsItalic();
-    const auto fontType = usingSoftFont   ? FontType::Soft :
-                          usingItalicFont ? FontType::Italic :
-                                            FontType::Default;
     if (fontType != _lastFontType)
     {
         switch (fontType)
@@ -42,14 +42,26 @@ namespace Microsoft::Console::Render
         std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColorsWithAlpha(const TextAttribute& attr) const noexcept;
         COLORREF GetAttributeUnderlineColor(const TextAttribute& attr) const noexcept;
+        void PrecomputePerceivableColors() noexcept;
         void ToggleBlinkRendition(class Renderer& renderer) noexcept;
 
     private:
+        struct PerceivableColorCacheEntry
+        {
+            COLORREF color = INVALID_COLOR;
+            COLORREF reference = INVALID_COLOR;
+            COLORREF result = INVALID_COLOR;
+        };
+
+        COLORREF _getPerceivableColor(const COLORREF color, const COLORREF reference) const noexcept;
+        PerceivableColorCacheEntry& _perceivableColorCacheEntry(const COLORREF color, const COLORREF reference) const noexcept;
+
         til::enumset<Mode> _renderMode{ Mode::BlinkAllowed, Mode::IntenseIsBright };
         std::array<COLORREF, TextColor::TABLE_SIZE> _colorTable;
         std::array<size_t, static_cast<size_t>(ColorAlias::ENUM_COUNT)> _colorAliasIndices;
         size_t _blinkCycle = 0;
         mutable bool _blinkIsInUse = false;
         bool _blinkShouldBeFaint = false;
+        mutable std::array<PerceivableColorCacheEntry, 256> _perceivableColorCache;
     };
 }
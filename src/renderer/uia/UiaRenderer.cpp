@@ -10,6 +10,12 @@
 using namespace Microsoft::Console::Render;
 using namespace Microsoft::Console::Types;
 
+// Automation clients like Narrator can't keep up with an event for every frame of fast output
+// (for instance "dir /s"), and raising them that often throttles the terminal in turn.
+// Events are thus raised at most once per interval, unless enough output accumulated.
+static constexpr auto minSignalInterval = std::chrono::milliseconds(100);
+static constexpr size_t maxDeferredOutput = 16 * 1024;
+
 // Routine Description:
 // - Constructs a UIA engine for console text
 //   which primarily notifies automation clients of any activity
@@ -52,6 +58,7 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     // back around to actually paint, we will just no-op. No sense in keeping
     // the data buffered.
     _newOutput = std::wstring{};
+    _signalDeferred = false;
 
     return S_OK;
 }
@@ -142,8 +149,8 @@ CATCH_RETURN();
         CATCH_LOG_RETURN_HR(E_FAIL);
     }
 
-    // assume selection has not changed
-    _selectionChanged = false;
+    // The selection has not changed since the last call. Don't reset _selectionChanged
+    // however, because the previous change may not have been signaled yet. See EndPaint().
     return S_OK;
 }
 
@@ -236,6 +243,21 @@ CATCH_LOG_RETURN_HR(E_FAIL);
     RETURN_HR_IF(S_FALSE, !_isEnabled);
     RETURN_HR_IF(E_INVALIDARG, !_isPainting); // invalid to end paint when we're not painting
 
+    _isPainting = false;
+
+    // Coalesce the events of frames that follow each other in quick succession. The flags and
+    // the new output remain as they are and get picked up by the next frame after the interval.
+    const auto now = std::chrono::steady_clock::now();
+    if (now - _lastSignal < minSignalInterval && _newOutput.size() < maxDeferredOutput)
+    {
+        _signalDeferred = true;
+        return S_OK;
+    }
+
+    _signalDeferred = false;
+    _signalQueued = true;
+    _lastSignal = now;
+
     // Snap this now while we're still under lock
     // so present can work on the copy while another
     // thread might start filling the next "frame"
@@ -245,6 +267,18 @@ CATCH_LOG_RETURN_HR(E_FAIL);
     return S_OK;
 }
 
+// Routine Description:
+// - While events are being deferred by EndPaint() we need another frame
+//   to eventually raise them, even if no further output arrives.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if events are pending.
+[[nodiscard]] bool UiaEngine::RequiresContinuousRedraw() noexcept
+{
+    return _signalDeferred;
+}
+
 // RenderEngineBase defines a WaitUntilCanRender() that sleeps for 8ms to throttle rendering.
 // But UiaEngine is never the only engine running. Overriding this function prevents
 // us from sleeping 16ms per frame, when the other engine also sleeps for 8ms.
@@ -262,7 +296,7 @@ void UiaEngine::WaitUntilCanRender() noexcept
 // - S_FALSE since we do nothing.
 [[nodiscard]] HRESULT UiaEngine::Present() noexcept
 {
-    RETURN_HR_IF(S_FALSE, !_isEnabled);
+    RETURN_HR_IF(S_FALSE, !_isEnabled || !_signalQueued);
 
     // Fire UIA Events here
     if (_selectionChanged)
@@ -306,7 +340,7 @@ void UiaEngine::WaitUntilCanRender() noexcept
     _selectionChanged = false;
     _textBufferChanged = false;
     _cursorChanged = false;
-    _isPainting = false;
+    _signalQueued = false;
     _queuedOutput.clear();
 
     return S_OK;
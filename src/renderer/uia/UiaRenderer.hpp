@@ -36,6 +36,7 @@ namespace Microsoft::Console::Render
         // IRenderEngine Members
         [[nodiscard]] HRESULT StartPaint() noexcept override;
         [[nodiscard]] HRESULT EndPaint() noexcept override;
+        [[nodiscard]] bool RequiresContinuousRedraw() noexcept override;
         void WaitUntilCanRender() noexcept override;
         [[nodiscard]] HRESULT Present() noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
@@ -70,8 +71,11 @@ namespace Microsoft::Console::Render
         bool _selectionChanged;
         bool _textBufferChanged;
         bool _cursorChanged;
+        bool _signalDeferred = false;
+        bool _signalQueued = false;
         std::wstring _newOutput;
         std::wstring _queuedOutput;
+        std::chrono::steady_clock::time_point _lastSignal;
 
         Microsoft::Console::Types::IUiaEventDispatcher* _dispatcher;
 
@@ -60,6 +60,21 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
     _nextCursorIsVisible = false;
     _startOfFrameBufferIndex = _buffer.size();
 
+    // Whatever we remembered writing in previous frames only still matches
+    // the terminal's contents if nothing has moved them around since. When
+    // the entire viewport is invalid we're being asked to repaint everything,
+    // so we shouldn't assume anything either.
+    if (_firstPaint ||
+        _passthrough ||
+        _resized ||
+        _circled ||
+        _usingLineRenditions ||
+        _scrollDelta != til::point{ 0, 0 } ||
+        _AllIsInvalid())
+    {
+        _ForgetEmittedRuns();
+    }
+
     // Do not perform synchronization clearing in passthrough mode.
     // In passthrough, the terminal leads and we follow what it is
     // handling from the client application.
@@ -529,6 +544,9 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from either conversion or writing pipe.
 [[nodiscard]] HRESULT XtermEngine::WriteTerminalW(const std::wstring_view wstr, const bool flush) noexcept
 {
+    // We don't know what this sequence does to the terminal's contents.
+    _ForgetEmittedRuns();
+
     RETURN_IF_FAILED(_fUseAsciiOnly ?
                          VtEngine::_WriteTerminalAscii(wstr) :
                          VtEngine::_WriteTerminalUtf8(wstr));
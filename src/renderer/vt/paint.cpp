@@ -110,6 +110,26 @@ using namespace Microsoft::Console::Types;
     return S_OK;
 }
 
+// Method Description:
+// - Blocks the render thread before it starts the next frame. If our last
+//      write blocked on a backed up pipe, painting again right away would only
+//      queue another frame behind it. Instead we wait about as long as that
+//      write took, so that the output accumulates in the buffer, and the next
+//      frame contains only its final state.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::WaitUntilCanRender() noexcept
+{
+    RenderEngineBase::WaitUntilCanRender();
+
+    if (const auto delay = _backlogDelay.exchange(0, std::memory_order_relaxed))
+    {
+        Sleep(delay);
+    }
+}
+
 // Routine Description:
 // - Used to perform longer running presentation steps outside the lock so the
 //      other threads can continue.
@@ -146,6 +166,8 @@ using namespace Microsoft::Console::Types;
     // being a rendition switch.
     if (_usingLineRenditions && !_invalidMap.one())
     {
+        // The rendition changes the layout of the row on the terminal's end.
+        _ForgetEmittedRuns();
         RETURN_IF_FAILED(_MoveCursor({ _lastText.x, targetRow }));
         switch (lineRendition)
         {
@@ -515,6 +537,16 @@ using namespace Microsoft::Console::Types;
     //      cch-nonSpaceLength = 0
     const auto numSpaces = gsl::narrow_cast<til::CoordType>(cchLine - nonSpaceLength);
 
+    // If we already wrote this exact run to this position, and nothing has
+    // disturbed it since, the terminal is showing it already. This is common
+    // for things like progress bars, which redraw the entire line even if only
+    // a few cells have changed. Wrapped lines are always written, because the
+    // terminal only learns about the wrap when we print across it.
+    if (!lineWrapped && !_wrappedRow.has_value() && _WasRunEmitted(coord, totalWidth))
+    {
+        return S_OK;
+    }
+
     // Optimizations:
     // If there are lots of spaces at the end of the line, we can try to Erase
     //      Character that number of spaces, then move the cursor forward (to
@@ -695,9 +727,101 @@ using namespace Microsoft::Console::Types;
         _newBottomLineBG = std::nullopt;
     }
 
+    _RememberEmittedRun(coord, totalWidth, lineWrapped);
     return S_OK;
 }
 
+// Method Description:
+// - Checks whether the text currently in _bufferLine was already written to
+//      the given position with the current attributes.
+// Arguments:
+// - coord - the position of the run within the viewport
+// - width - the number of columns the run spans
+// Return Value:
+// - true if the terminal is already showing this run.
+bool VtEngine::_WasRunEmitted(const til::point coord, const til::CoordType width) const noexcept
+{
+    const auto row = coord.y - _lastViewport.Top();
+    if (row < 0 || gsl::narrow_cast<size_t>(row) >= _emittedRuns.size())
+    {
+        return false;
+    }
+
+    for (const auto& run : til::at(_emittedRuns, row))
+    {
+        if (run.x == coord.x && run.width == width && run.attributes == _lastTextAttributes && run.text == _bufferLine)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Method Description:
+// - Records that the text in _bufferLine was just written to the given
+//      position. Any runs we remembered for the cells it covered are dropped.
+// Arguments:
+// - coord - the position of the run within the viewport
+// - width - the number of columns the run spans
+// - lineWrapped - true if the run wrapped onto the next row
+// Return Value:
+// - <none>
+void VtEngine::_RememberEmittedRun(const til::point coord, const til::CoordType width, const bool lineWrapped) noexcept
+try
+{
+    // If we wrapped off the bottom of the viewport, the terminal scrolled
+    // its contents, and none of the rows are where we left them anymore.
+    if (lineWrapped && coord.y >= _lastViewport.BottomInclusive())
+    {
+        _ForgetEmittedRuns();
+        return;
+    }
+
+    const auto row = coord.y - _lastViewport.Top();
+    if (row < 0 || row >= _lastViewport.Height())
+    {
+        return;
+    }
+
+    if (gsl::narrow_cast<size_t>(row) >= _emittedRuns.size())
+    {
+        _emittedRuns.resize(gsl::narrow_cast<size_t>(_lastViewport.Height()));
+    }
+
+    auto& runs = til::at(_emittedRuns, row);
+    std::erase_if(runs, [&](const EmittedRun& run) {
+        return run.x < coord.x + width && coord.x < run.x + run.width;
+    });
+
+    // The terminal doesn't know about a wrap until we print past it, so we
+    // can't vouch for what a wrapped row looks like on the other end.
+    if (!lineWrapped)
+    {
+        runs.push_back({ coord.x, width, _lastTextAttributes, _bufferLine });
+    }
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    _ForgetEmittedRuns();
+}
+
+// Method Description:
+// - Discards every run we remembered writing. This needs to be called whenever
+//      the terminal's contents may have changed without us painting them,
+//      for instance after a scroll, a resize, or a passthrough sequence.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_ForgetEmittedRuns() noexcept
+{
+    for (auto& runs : _emittedRuns)
+    {
+        runs.clear();
+    }
+}
+
 // Method Description:
 // - Updates the window's title string. Emits the VT sequence to SetWindowTitle.
 //      Because wintelnet does not understand these sequences by default, we
@@ -126,6 +126,35 @@ CATCH_RETURN();
 
     try
     {
+        // UpdateDrawingBrushes() emits one SGR sequence per changed attribute. If we're writing an SGR sequence
+        // right after another one, we merge them into one, for instance "\x1b[1m\x1b[3m" into "\x1b[1;3m".
+        // This cuts down the size of the VT stream for colorful applications significantly.
+        // The number of parameters per sequence is limited, because terminals only support so many.
+        static constexpr size_t maxSgrParameters = 16;
+
+        const auto isSgr = str.size() >= 3 && str[0] == '\x1b' && str[1] == '[' && str.back() == 'm' &&
+                           str.find_first_not_of("0123456789;:", 2) == str.size() - 1;
+
+        if (isSgr)
+        {
+            const auto parameters = gsl::narrow_cast<size_t>(std::count(str.begin(), str.end(), ';')) + 1;
+
+            if (_lastSgrEnd != 0 && _lastSgrEnd == _buffer.size() && _lastSgrParameters + parameters <= maxSgrParameters)
+            {
+                _buffer.back() = ';';
+                _buffer.append(str.substr(2));
+                _lastSgrParameters += parameters;
+            }
+            else
+            {
+                _buffer.append(str);
+                _lastSgrParameters = parameters;
+            }
+
+            _lastSgrEnd = _buffer.size();
+            return S_OK;
+        }
+
         _buffer.append(str);
 
         return S_OK;
@@ -155,9 +184,18 @@ void VtEngine::_flushImpl() noexcept
 {
     if (_hFile)
     {
+        const auto start = _adaptiveFramePacing ? GetTickCount64() : 0;
         const auto fSuccess = WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
+        if (_adaptiveFramePacing)
+        {
+            // If the write blocked for a while, the other end of the pipe isn't
+            // keeping up with us (for instance because it's a slow network link).
+            const auto elapsed = GetTickCount64() - start;
+            _backlogDelay.store(elapsed >= BacklogThreshold ? gsl::narrow_cast<DWORD>(std::min(elapsed, MaxBacklogDelay)) : 0, std::memory_order_relaxed);
+        }
         _buffer.clear();
         _startOfFrameBufferIndex = 0;
+        _lastSgrEnd = 0;
         if (!fSuccess)
         {
             LOG_LAST_ERROR();
@@ -490,6 +528,20 @@ void VtEngine::SetResizeQuirk(const bool resizeQuirk)
     _resizeQuirk = resizeQuirk;
 }
 
+// Method Description:
+// - Configure the renderer to slow down while the output pipe is backed up, so
+//   that the connected terminal receives fewer, more up-to-date frames instead
+//   of falling further and further behind. This is meant for terminals that
+//   are connected to us through a slow link, like SSH.
+// Arguments:
+// - enabled - True if we were started with `--adaptiveFramePacing`.
+// Return Value:
+// - <none>
+void VtEngine::SetAdaptiveFramePacing(const bool enabled) noexcept
+{
+    _adaptiveFramePacing = enabled;
+}
+
 void VtEngine::SetLookingForDSRCallback(std::function<void(bool)> pfnLooking) noexcept
 {
     _pfnSetLookingForDSR = pfnLooking;
@@ -541,6 +593,7 @@ HRESULT VtEngine::RequestWin32Input() noexcept
 
 HRESULT VtEngine::SwitchScreenBuffer(const bool useAltBuffer) noexcept
 {
+    _ForgetEmittedRuns();
     RETURN_IF_FAILED(_SwitchScreenBuffer(useAltBuffer));
     _Flush();
     return S_OK;
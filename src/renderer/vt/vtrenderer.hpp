@@ -43,6 +43,9 @@ namespace Microsoft::Console::Render
         // See _PaintUtf8BufferLine for explanation of this value.
         static const size_t ERASE_CHARACTER_STRING_LENGTH = 8;
         static const til::point INVALID_COORDS;
+        // If a write to the pipe takes at least this long, we consider it backed up.
+        static constexpr ULONGLONG BacklogThreshold = 50;
+        static constexpr ULONGLONG MaxBacklogDelay = 1000;
 
         VtEngine(_In_ wil::unique_hfile hPipe,
                  const Microsoft::Console::Types::Viewport initialViewport);
@@ -50,6 +53,7 @@ namespace Microsoft::Console::Render
         // IRenderEngine
         [[nodiscard]] HRESULT StartPaint() noexcept override;
         [[nodiscard]] HRESULT EndPaint() noexcept override;
+        void WaitUntilCanRender() noexcept override;
         [[nodiscard]] HRESULT Present() noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept override;
         [[nodiscard]] HRESULT Invalidate(const til::rect* psrRegion) noexcept override;
@@ -81,6 +85,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT WriteTerminalW(const std::wstring_view str, const bool flush = false) noexcept = 0;
         void SetTerminalOwner(Microsoft::Console::VirtualTerminal::VtIo* const terminalOwner);
         void SetResizeQuirk(const bool resizeQuirk);
+        void SetAdaptiveFramePacing(const bool enabled) noexcept;
         void SetLookingForDSRCallback(std::function<void(bool)> pfnLooking) noexcept;
         void SetTerminalCursorTextPosition(const til::point coordCursor) noexcept;
         [[nodiscard]] virtual HRESULT ManuallyClearScrollback() noexcept;
@@ -94,6 +99,10 @@ namespace Microsoft::Console::Render
         wil::unique_hfile _hFile;
         std::string _buffer;
         size_t _startOfFrameBufferIndex = 0;
+        // If _buffer ends in an SGR sequence, this is the _buffer size right after it (0 otherwise)
+        // and how many parameters it contains. See _Write().
+        size_t _lastSgrEnd = 0;
+        size_t _lastSgrParameters = 0;
 
         std::string _formatBuffer;
         std::string _conversionBuffer;
@@ -136,12 +145,29 @@ namespace Microsoft::Console::Render
         bool _delayedEolWrap{ false };
 
         bool _resizeQuirk{ false };
+        bool _adaptiveFramePacing{ false };
+        // How long the render thread should wait before the next frame,
+        // because our last write blocked on a backed up pipe. In milliseconds.
+        std::atomic<DWORD> _backlogDelay{ 0 };
         bool _passthrough{ false };
         bool _noFlushOnEnd{ false };
         bool _corked{ false };
         bool _flushRequested{ false };
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
+        // The runs of text we've written to each row of the viewport since it
+        // was last cleared, scrolled or resized. If a run is repainted with the
+        // same text and attributes, the terminal already shows it, and we can
+        // avoid sending it over the pipe again.
+        struct EmittedRun
+        {
+            til::CoordType x;
+            til::CoordType width;
+            TextAttribute attributes;
+            std::wstring text;
+        };
+        std::vector<std::vector<EmittedRun>> _emittedRuns;
+
         [[nodiscard]] HRESULT _WriteFill(const size_t n, const char c) noexcept;
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
         void _Flush() noexcept;
@@ -221,6 +247,10 @@ namespace Microsoft::Console::Render
                                                    const til::point coord,
                                                    const bool lineWrapped) noexcept;
 
+        bool _WasRunEmitted(const til::point coord, const til::CoordType width) const noexcept;
+        void _RememberEmittedRun(const til::point coord, const til::CoordType width, const bool lineWrapped) noexcept;
+        void _ForgetEmittedRuns() noexcept;
+
         [[nodiscard]] HRESULT _PaintAsciiBufferLine(const std::span<const Cluster> clusters,
                                                     const til::point coord) noexcept;
 
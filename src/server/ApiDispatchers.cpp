@@ -415,6 +415,8 @@ constexpr T saturate(auto val)
     // We must return the byte length of the read data in the message.
     LOG_IF_FAILED(SizeTToULong(cbRead, &a->NumBytes));
 
+    m->GetProcessHandle()->Statistics.RecordBytesWritten(cbRead);
+
     if (nullptr != waiter.get())
     {
         // If we received a waiter, we need to queue the wait and not reply.
@@ -569,6 +569,7 @@ PCONSOLE_API_MSG IoDispatchers::ConsoleClientDisconnectRoutine(_In_ PCONSOLE_API
     }
 
     Tracing::s_TraceConsoleAttachDetach(pProcessData, false);
+    Tracing::s_TraceConsoleProcessStatistics(pProcessData);
 
     LOG_IF_FAILED(RemoveConsole(pProcessData));
 
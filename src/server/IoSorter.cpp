@@ -27,6 +27,12 @@ void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
 
     pMsg->Complete.Identifier = pMsg->Descriptor.Identifier;
 
+    // Connect and disconnect requests create and destroy the process handle respectively.
+    // Every other request is accounted to the statistics of the process that sent it.
+    const auto pProcessData = pMsg->Descriptor.Function == CONSOLE_IO_CONNECT || pMsg->Descriptor.Function == CONSOLE_IO_DISCONNECT ? nullptr : pMsg->GetProcessHandle();
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto startLockWaitTime = CONSOLE_INFORMATION::GetLockWaitTime();
+
     switch (pMsg->Descriptor.Function)
     {
     case CONSOLE_IO_USER_DEFINED:
@@ -97,4 +103,9 @@ void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
         pMsg->SetReplyStatus(STATUS_UNSUCCESSFUL);
         *ReplyMsg = pMsg;
     }
+
+    if (pProcessData)
+    {
+        pProcessData->Statistics.RecordApiCall(std::chrono::steady_clock::now() - startTime, CONSOLE_INFORMATION::GetLockWaitTime() - startLockWaitTime);
+    }
 }
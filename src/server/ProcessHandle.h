@@ -22,9 +22,47 @@ Revision History:
 #include "ProcessPolicy.h"
 #include "ConsoleShimPolicy.h"
 
+#include <chrono>
 #include <memory>
 #include <wil/resource.h>
 
+// Usage statistics of a single client process. They help finding out which of the many processes
+// sharing a console is responsible for most of the load (and thus the console lock contention).
+// The members are atomic, because waits may be completed on any thread.
+struct ConsoleProcessStatistics
+{
+    using duration = std::chrono::steady_clock::duration;
+
+    void RecordApiCall(const duration serviceTime, const duration lockWaitTime) noexcept
+    {
+        apiCalls.fetch_add(1, std::memory_order_relaxed);
+        serviceTicks.fetch_add(serviceTime.count(), std::memory_order_relaxed);
+        lockWaitTicks.fetch_add(lockWaitTime.count(), std::memory_order_relaxed);
+    }
+
+    void RecordBytesWritten(const size_t bytes) noexcept
+    {
+        bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void RecordWait(const duration waitTime) noexcept
+    {
+        waits.fetch_add(1, std::memory_order_relaxed);
+        waitTicks.fetch_add(waitTime.count(), std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> apiCalls{ 0 };
+    std::atomic<uint64_t> bytesWritten{ 0 };
+    std::atomic<uint64_t> waits{ 0 };
+    // The following are in duration::rep units:
+    // * The time the console server spent servicing the process' requests (including lock waits).
+    std::atomic<duration::rep> serviceTicks{ 0 };
+    // * The time spent waiting for the console lock while servicing them.
+    std::atomic<duration::rep> lockWaitTicks{ 0 };
+    // * The time requests spent blocked in an IWaitRoutine until they were completed.
+    std::atomic<duration::rep> waitTicks{ 0 };
+};
+
 class ConsoleProcessHandle
 {
 public:
@@ -46,6 +84,8 @@ public:
     DWORD const dwProcessId;
     DWORD const dwThreadId;
 
+    ConsoleProcessStatistics Statistics;
+
     const ConsoleProcessPolicy GetPolicy() const;
     const ConsoleShimPolicy GetShimPolicy() const;
 
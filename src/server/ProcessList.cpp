@@ -6,6 +6,7 @@
 #include "ProcessList.h"
 
 #include "../host/globals.h"
+#include "../host/tracing.hpp"
 #include "../interactivity/inc/ServiceLocator.hpp"
 
 using namespace Microsoft::Console::Interactivity;
@@ -270,6 +271,23 @@ void ConsoleProcessList::ModifyConsoleProcessFocus(const bool fForeground)
     _ModifyProcessForegroundRights(GetCurrentProcess(), fForeground);
 }
 
+// Routine Description:
+// - Writes the usage statistics of all attached client processes to ETW.
+// - This allows spotting the process responsible for most of the load, while the console is still in use.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void ConsoleProcessList::TraceProcessStatistics() const
+{
+    assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
+
+    for (const auto& pProcessHandle : _processes)
+    {
+        Tracing::s_TraceConsoleProcessStatistics(pProcessHandle);
+    }
+}
+
 // Routine Description:
 // - Specifies that there are no remaining processes
 // TODO: This should not be exposed, most likely. Whomever is calling it should join this class.
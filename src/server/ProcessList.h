@@ -54,6 +54,7 @@ public:
                                          _Inout_ size_t* const pcProcessList) const;
 
     void ModifyConsoleProcessFocus(const bool fForeground);
+    void TraceProcessStatistics() const;
 
     bool IsEmpty() const;
 
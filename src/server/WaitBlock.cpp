@@ -29,7 +29,8 @@ ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
     _pProcessQueue(THROW_HR_IF_NULL(E_INVALIDARG, pProcessQueue)),
     _pObjectQueue(THROW_HR_IF_NULL(E_INVALIDARG, pObjectQueue)),
     _WaitReplyMessage(*pWaitReplyMessage),
-    _pWaiter(THROW_HR_IF_NULL(E_INVALIDARG, pWaiter))
+    _pWaiter(THROW_HR_IF_NULL(E_INVALIDARG, pWaiter)),
+    _startTime(std::chrono::steady_clock::now())
 {
     // MSFT-33127449, GH#9692
     // Until there's a "Wait", there's only one API message inflight at a time. In our
@@ -177,6 +178,13 @@ bool ConsoleWaitBlock::Notify(const WaitTerminationReason TerminationReason)
         _WaitReplyMessage.SetReplyStatus(status);
         _WaitReplyMessage.SetReplyInformation(NumBytes);
 
+        // If the process is dying, its statistics are about to be destroyed along with it.
+        const auto pProcessData = WI_IsFlagSet(TerminationReason, WaitTerminationReason::ThreadDying) ? nullptr : _WaitReplyMessage.GetProcessHandle();
+        if (pProcessData)
+        {
+            pProcessData->Statistics.RecordWait(std::chrono::steady_clock::now() - _startTime);
+        }
+
         if (API_NUMBER_GETCONSOLEINPUT == _WaitReplyMessage.msgHeader.ApiNumber)
         {
             // ReadConsoleInput/PeekConsoleInput has this extra reply
@@ -221,6 +229,11 @@ bool ConsoleWaitBlock::Notify(const WaitTerminationReason TerminationReason)
         {
             auto a = &(_WaitReplyMessage.u.consoleMsgL1.WriteConsoleW);
             a->NumBytes = gsl::narrow<ULONG>(NumBytes);
+
+            if (pProcessData)
+            {
+                pProcessData->Statistics.RecordBytesWritten(NumBytes);
+            }
         }
 
         LOG_IF_FAILED(_WaitReplyMessage.ReleaseMessageBuffers());
@@ -50,4 +50,6 @@ private:
     CONSOLE_API_MSG _WaitReplyMessage;
 
     IWaitRoutine* const _pWaiter;
+
+    std::chrono::steady_clock::time_point const _startTime;
 };
@@ -656,6 +656,13 @@ namespace Microsoft::Console::VirtualTerminal::DispatchTypes
         HexPair = 1
     };
 
+    enum class SixelBackground : VTInt
+    {
+        Default = 0,
+        Transparent = 1,
+        Opaque = 2
+    };
+
     enum class ReportFormat : VTInt
     {
         TerminalStateReport = 1,
@@ -32,6 +32,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool WriteCtrlKey(const INPUT_RECORD& event) = 0;
 
+        virtual bool WriteCtrlKeys(const std::span<const INPUT_RECORD>& events) = 0;
+
         virtual bool WriteString(const std::wstring_view string) = 0;
 
         virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
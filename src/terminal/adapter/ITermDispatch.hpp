@@ -150,6 +150,9 @@ public:
                                        const VTParameter cellHeight,
                                        const DispatchTypes::CharsetSize charsetSize) = 0; // DECDLD
 
+    virtual StringHandler DefineSixelImage(const VTInt macroParameter,
+                                           const DispatchTypes::SixelBackground backgroundSelect) = 0; // DECSIXEL
+
     virtual bool RequestUserPreferenceCharset() = 0; // DECRQUPSS
     virtual StringHandler AssignUserPreferenceCharset(const DispatchTypes::CharsetSize charsetSize) = 0; // DECAUPSS
 
@@ -57,6 +57,17 @@ bool InteractDispatch::WriteCtrlKey(const INPUT_RECORD& event)
     return true;
 }
 
+// Method Description:
+// - Same as WriteCtrlKey, but for a batch of keys. Ordinary keys are written
+//   to the input buffer in runs, instead of waking up the readers for each key.
+// Arguments:
+// - events: The keys to send to the host.
+bool InteractDispatch::WriteCtrlKeys(const std::span<const INPUT_RECORD>& events)
+{
+    HandleGenericKeyEvents(events);
+    return true;
+}
+
 // Method Description:
 // - Writes a string of input to the host.
 // Arguments:
@@ -27,6 +27,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool WriteInput(const std::span<const INPUT_RECORD>& inputEvents) override;
         bool WriteCtrlKey(const INPUT_RECORD& event) override;
+        bool WriteCtrlKeys(const std::span<const INPUT_RECORD>& events) override;
         bool WriteString(const std::wstring_view string) override;
         bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
                                 const VTParameter parameter1,
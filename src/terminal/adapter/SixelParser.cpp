@@ -0,0 +1,294 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "SixelParser.hpp"
+#include "../parser/stateMachine.hpp"
+#include "../../types/inc/utils.hpp"
+
+using namespace Microsoft::Console::Utils;
+using namespace Microsoft::Console::VirtualTerminal;
+
+// The default color registers of the VT340, expressed in RGB percentages.
+static constexpr std::array<std::array<uint8_t, 3>, 16> s_defaultColors{ {
+    { 0, 0, 0 },
+    { 20, 20, 80 },
+    { 80, 13, 13 },
+    { 20, 80, 20 },
+    { 80, 20, 80 },
+    { 20, 80, 80 },
+    { 80, 80, 20 },
+    { 53, 53, 53 },
+    { 26, 26, 26 },
+    { 33, 33, 60 },
+    { 60, 26, 26 },
+    { 33, 60, 33 },
+    { 60, 33, 60 },
+    { 33, 60, 60 },
+    { 60, 60, 33 },
+    { 80, 80, 80 },
+} };
+
+static constexpr uint8_t _percentageToByte(const VTInt percentage) noexcept
+{
+    return gsl::narrow_cast<uint8_t>((std::clamp(percentage, 0, 100) * 255 + 50) / 100);
+}
+
+SixelParser::SixelParser(const VTInt macroParameter,
+                         const DispatchTypes::SixelBackground backgroundSelect,
+                         const til::CoordType maxWidth,
+                         const til::CoordType maxHeight) :
+    _transparentBackground{ backgroundSelect == DispatchTypes::SixelBackground::Transparent },
+    _maxWidth{ maxWidth },
+    _maxHeight{ maxHeight },
+    _aspectRatio{ _aspectRatioFromMacroParameter(macroParameter) }
+{
+    for (size_t i = 0; i < s_defaultColors.size(); i++)
+    {
+        const auto& rgb = til::at(s_defaultColors, i);
+        til::at(_colorTable, i) = _makePixel({ _percentageToByte(rgb[0]), _percentageToByte(rgb[1]), _percentageToByte(rgb[2]) });
+    }
+    // Until a color is selected, sixels are drawn with color register 0.
+    _foregroundPixel = _colorTable[0];
+}
+
+// Routine Description:
+// - Processes a single character of the sixel data string.
+// Arguments:
+// - ch - the character to process.
+// Return Value:
+// - <none>
+void SixelParser::AddData(const wchar_t ch)
+{
+    if (_state != State::Normal)
+    {
+        if (ch >= L'0' && ch <= L'9')
+        {
+            if (_parameterCount < _parameters.size())
+            {
+                auto& param = til::at(_parameters, _parameterCount);
+                param = std::min(param * 10 + (ch - L'0'), MAX_PARAMETER_VALUE);
+            }
+            _parameterPending = true;
+            return;
+        }
+        if (ch == L';')
+        {
+            _parameterCount++;
+            _parameterPending = false;
+            return;
+        }
+        // Any other character terminates the parameters of the current command.
+        _executeCommand();
+    }
+
+    if (ch >= L'?' && ch <= L'~')
+    {
+        _addSixelValue(ch - L'?');
+    }
+    else if (ch == L'!' || ch == L'#' || ch == L'"')
+    {
+        _state = ch == L'!' ? State::Repeat : ch == L'#' ? State::ColorIntroducer : State::RasterAttributes;
+        _parameters.fill(0);
+        _parameterCount = 0;
+        _parameterPending = false;
+    }
+    else if (ch == L'$')
+    {
+        _carriageReturn();
+    }
+    else if (ch == L'-')
+    {
+        _lineFeed();
+    }
+}
+
+// Routine Description:
+// - Completes the decoding once the data string has been terminated, cropping
+//   the bitmap to its final size and filling in the background if required.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void SixelParser::FinalizeImage()
+{
+    if (_state != State::Normal)
+    {
+        _executeCommand();
+    }
+
+    const auto backgroundPixel = _transparentBackground ? 0u : _colorTable[0];
+    std::vector<uint32_t> pixels(gsl::narrow_cast<size_t>(_width) * _height);
+    for (til::CoordType y = 0; y < _height; y++)
+    {
+        const auto src = _pixels.begin() + y * _maxWidth;
+        const auto dst = pixels.begin() + y * _width;
+        std::transform(src, src + _width, dst, [=](const auto pixel) {
+            return pixel ? pixel : backgroundPixel;
+        });
+    }
+    _pixels = std::move(pixels);
+}
+
+til::size SixelParser::GetImageSize() const noexcept
+{
+    return { _width, _height };
+}
+
+std::span<const uint32_t> SixelParser::GetPixels() const noexcept
+{
+    return _pixels;
+}
+
+VTInt SixelParser::_aspectRatioFromMacroParameter(const VTInt macroParameter) noexcept
+{
+    switch (macroParameter)
+    {
+    case 2:
+        return 5;
+    case 3:
+    case 4:
+        return 3;
+    case 7:
+    case 8:
+    case 9:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+uint32_t SixelParser::_makePixel(const til::color color) noexcept
+{
+    // Sixel colors are always opaque, which makes the premultiplication a no-op.
+    return 0xff000000u | (uint32_t{ color.r } << 16) | (uint32_t{ color.g } << 8) | color.b;
+}
+
+void SixelParser::_executeCommand()
+{
+    if (_parameterPending)
+    {
+        _parameterCount++;
+    }
+
+    switch (_state)
+    {
+    case State::Repeat:
+        _repeatCount = std::max(_parameters[0], 1);
+        break;
+    case State::ColorIntroducer:
+        _defineColor();
+        break;
+    case State::RasterAttributes:
+        _setRasterAttributes();
+        break;
+    default:
+        break;
+    }
+
+    _state = State::Normal;
+}
+
+// Routine Description:
+// - Handles the color introducer (#Pc;Pu;Px;Py;Pz), which selects the color
+//   register Pc, and if a color model Pu is given, also redefines it.
+void SixelParser::_defineColor() noexcept
+{
+    const auto colorNumber = gsl::narrow_cast<size_t>(_parameters[0]) % MAX_COLORS;
+    if (_parameterCount >= 5)
+    {
+        const auto colorModel = DispatchTypes::ColorModel{ _parameters[1] };
+        const auto x = _parameters[2];
+        const auto y = _parameters[3];
+        const auto z = _parameters[4];
+        if (colorModel == DispatchTypes::ColorModel::HLS)
+        {
+            til::at(_colorTable, colorNumber) = _makePixel(ColorFromHLS(x, y, z));
+        }
+        else if (colorModel == DispatchTypes::ColorModel::RGB)
+        {
+            til::at(_colorTable, colorNumber) = _makePixel({ _percentageToByte(x), _percentageToByte(y), _percentageToByte(z) });
+        }
+    }
+    _foregroundPixel = til::at(_colorTable, colorNumber);
+}
+
+// Routine Description:
+// - Handles the raster attributes ("Pan;Pad;Ph;Pv), which define the pixel
+//   aspect ratio and the size of the background area. These are only
+//   applicable before any sixel data has been received.
+void SixelParser::_setRasterAttributes()
+{
+    if (_seenSixelData)
+    {
+        return;
+    }
+
+    const auto numerator = _parameters[0];
+    const auto denominator = _parameters[1];
+    if (numerator > 0 && denominator > 0)
+    {
+        _aspectRatio = std::clamp((numerator + denominator / 2) / denominator, 1, 20);
+    }
+
+    if (!_transparentBackground && _parameterCount >= 4)
+    {
+        _width = std::min(_parameters[2], _maxWidth);
+        _ensureHeight(std::min(_parameters[3], _maxHeight));
+        _height = std::min(_parameters[3], _allocatedHeight);
+    }
+}
+
+void SixelParser::_addSixelValue(const VTInt value)
+{
+    _seenSixelData = true;
+
+    const auto repeatCount = std::exchange(_repeatCount, 1);
+    const auto columnBegin = _column;
+    const auto columnEnd = std::min(_column + repeatCount, _maxWidth);
+    _column = columnEnd;
+    _width = std::max(_width, columnEnd);
+
+    if (value == 0 || columnBegin >= columnEnd)
+    {
+        return;
+    }
+
+    _ensureHeight(_bandTop + std::bit_width(gsl::narrow_cast<unsigned int>(value)) * _aspectRatio);
+
+    for (auto bit = 0; bit < 6; bit++)
+    {
+        if (value & (1 << bit))
+        {
+            const auto top = _bandTop + bit * _aspectRatio;
+            const auto bottom = std::min(top + _aspectRatio, _allocatedHeight);
+            for (auto y = top; y < bottom; y++)
+            {
+                const auto row = _pixels.begin() + y * _maxWidth;
+                std::fill(row + columnBegin, row + columnEnd, _foregroundPixel);
+            }
+            _height = std::max(_height, bottom);
+        }
+    }
+}
+
+void SixelParser::_carriageReturn() noexcept
+{
+    _column = 0;
+}
+
+void SixelParser::_lineFeed() noexcept
+{
+    _column = 0;
+    _bandTop = std::min(_bandTop + 6 * _aspectRatio, _maxHeight);
+}
+
+void SixelParser::_ensureHeight(const til::CoordType height)
+{
+    const auto newHeight = std::min(height, _maxHeight);
+    if (newHeight > _allocatedHeight)
+    {
+        _pixels.resize(gsl::narrow_cast<size_t>(newHeight) * _maxWidth);
+        _allocatedHeight = newHeight;
+    }
+}
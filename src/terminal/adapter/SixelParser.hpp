@@ -0,0 +1,82 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SixelParser.hpp
+
+Abstract:
+- This decodes the data string of the DECSIXEL control sequence into a bitmap.
+- The pixels are produced in the premultiplied BGRA format used by ImageSlice,
+  with unset pixels left transparent when a transparent background is requested.
+--*/
+
+#pragma once
+
+#include "DispatchTypes.hpp"
+
+namespace Microsoft::Console::VirtualTerminal
+{
+    class SixelParser
+    {
+    public:
+        // Sixel coordinates are independent of the font, so images are laid
+        // out using the cell size of the VT340, which was 10x20 pixels.
+        static constexpr til::size CellSize{ 10, 20 };
+        static constexpr size_t MAX_COLORS = 256;
+
+        SixelParser(const VTInt macroParameter,
+                    const DispatchTypes::SixelBackground backgroundSelect,
+                    const til::CoordType maxWidth,
+                    const til::CoordType maxHeight);
+
+        void AddData(const wchar_t ch);
+        void FinalizeImage();
+
+        til::size GetImageSize() const noexcept;
+        std::span<const uint32_t> GetPixels() const noexcept;
+
+    private:
+        enum class State
+        {
+            Normal,
+            Repeat,
+            ColorIntroducer,
+            RasterAttributes
+        };
+
+        static VTInt _aspectRatioFromMacroParameter(const VTInt macroParameter) noexcept;
+        static uint32_t _makePixel(const til::color color) noexcept;
+
+        void _executeCommand();
+        void _defineColor() noexcept;
+        void _setRasterAttributes();
+        void _addSixelValue(const VTInt value);
+        void _carriageReturn() noexcept;
+        void _lineFeed() noexcept;
+        void _ensureHeight(const til::CoordType height);
+
+        State _state = State::Normal;
+        std::array<VTInt, 5> _parameters{};
+        size_t _parameterCount = 0;
+        bool _parameterPending = false;
+
+        std::array<uint32_t, MAX_COLORS> _colorTable{};
+        uint32_t _foregroundPixel = 0;
+        bool _transparentBackground = false;
+
+        til::CoordType _maxWidth = 0;
+        til::CoordType _maxHeight = 0;
+        VTInt _aspectRatio = 2;
+        bool _seenSixelData = false;
+
+        til::CoordType _column = 0;
+        til::CoordType _bandTop = 0;
+        VTInt _repeatCount = 1;
+
+        til::CoordType _width = 0;
+        til::CoordType _height = 0;
+        til::CoordType _allocatedHeight = 0;
+        std::vector<uint32_t> _pixels;
+    };
+}
@@ -18,6 +18,7 @@ Author(s):
 #include "ITerminalApi.hpp"
 #include "FontBuffer.hpp"
 #include "MacroBuffer.hpp"
+#include "SixelParser.hpp"
 #include "terminalOutput.hpp"
 #include "../input/terminalInput.hpp"
 #include "../../types/inc/sgrStack.hpp"
@@ -152,6 +153,9 @@ namespace Microsoft::Console::VirtualTerminal
                                    const VTParameter cellHeight,
                                    const DispatchTypes::CharsetSize charsetSize) override; // DECDLD
 
+        StringHandler DefineSixelImage(const VTInt macroParameter,
+                                       const DispatchTypes::SixelBackground backgroundSelect) override; // DECSIXEL
+
         bool RequestUserPreferenceCharset() override; // DECRQUPSS
         StringHandler AssignUserPreferenceCharset(const DispatchTypes::CharsetSize charsetSize) override; // DECAUPSS
 
@@ -223,6 +227,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _ChangeRectAttributes(TextBuffer& textBuffer, const til::rect& changeRect, const ChangeOps& changeOps);
         void _ChangeRectOrStreamAttributes(const til::rect& changeArea, const ChangeOps& changeOps);
         til::rect _CalculateRectArea(const VTInt top, const VTInt left, const VTInt bottom, const VTInt right, const til::size bufferSize);
+        static uint16_t _CalculateRowChecksum(const TextBuffer& textBuffer, const til::CoordType row, const til::CoordType left, const til::CoordType right, const size_t defaultFgIndex, const size_t defaultBgIndex);
         bool _EraseScrollback();
         bool _EraseAll();
         TextAttribute _GetEraseAttributes(const TextBuffer& textBuffer) const noexcept;
@@ -271,6 +276,7 @@ namespace Microsoft::Console::VirtualTerminal
         StringHandler _RestoreTabStops();
 
         StringHandler _CreateDrcsPassthroughHandler(const DispatchTypes::CharsetSize charsetSize);
+        void _WriteImageToBuffer(TextBuffer& textBuffer, const til::size imageSize, const std::span<const uint32_t> pixels, const bool transparent);
         StringHandler _CreatePassthroughHandler();
 
         std::vector<uint8_t> _tabStopColumns;
@@ -282,6 +288,22 @@ namespace Microsoft::Console::VirtualTerminal
         TerminalInput& _terminalInput;
         TerminalOutput _termOutput;
         std::unique_ptr<FontBuffer> _fontBuffer;
+        std::unique_ptr<SixelParser> _sixelParser;
+
+        // Per-row checksums for DECRQCRA. See RequestChecksumRectangularArea().
+        struct ChecksumCache
+        {
+            const TextBuffer* textBuffer = nullptr;
+            // The TextBuffer::GetLastMutationId() when the cache was last used. Resetting the buffer
+            // starts a new range of IDs, after which the cached row IDs can't be trusted anymore.
+            uint64_t lastMutationId = 0;
+            til::CoordType width = 0;
+            size_t defaultFgIndex = 0;
+            size_t defaultBgIndex = 0;
+            // The ROW mutation ID and the checksum of each row in the buffer.
+            std::vector<std::pair<uint64_t, uint16_t>> rows;
+        };
+        ChecksumCache _checksumCache;
         std::shared_ptr<MacroBuffer> _macroBuffer;
         std::optional<unsigned int> _initialCodePage;
 
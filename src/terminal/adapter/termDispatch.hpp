@@ -143,6 +143,9 @@ public:
                                const VTParameter /*cellHeight*/,
                                const DispatchTypes::CharsetSize /*charsetSize*/) override { return nullptr; } // DECDLD
 
+    StringHandler DefineSixelImage(const VTInt /*macroParameter*/,
+                                   const DispatchTypes::SixelBackground /*backgroundSelect*/) override { return nullptr; } // DECSIXEL
+
     bool RequestUserPreferenceCharset() override { return false; } // DECRQUPSS
     StringHandler AssignUserPreferenceCharset(const DispatchTypes::CharsetSize /*charsetSize*/) override { return nullptr; } // DECAUPSS
 
@@ -2123,6 +2123,74 @@ public:
         verifyChecksumReport(L"FF8B");
     }
 
+    TEST_METHOD(RequestChecksumReportCacheTests)
+    {
+        using namespace std::string_view_literals;
+
+        _testGetSet->PrepData();
+        const auto width = _testGetSet->_textBuffer->GetSize().Width();
+
+        const auto requestChecksum = [&](const auto left, const auto right) {
+            wchar_t checksumQuery[40];
+            swprintf_s(checksumQuery, ARRAYSIZE(checksumQuery), L"\033[99;1;1;%d;0;%d*y", left, right);
+            _testGetSet->_response.clear();
+            _stateMachine->ProcessString(checksumQuery);
+            const auto response = _testGetSet->_response;
+            VERIFY_IS_TRUE(til::starts_with(response, L"\x1bP99!~"sv));
+            return gsl::narrow_cast<uint16_t>(std::wcstoul(response.c_str() + 6, nullptr, 16));
+        };
+        // The full width checksums are cached per row, while the partial
+        // width checksums are always calculated from the buffer contents.
+        const auto fullChecksum = [&]() {
+            return requestChecksum(1, 0);
+        };
+        const auto splitChecksum = [&]() {
+            return gsl::narrow_cast<uint16_t>(requestChecksum(1, width / 2) + requestChecksum(width / 2 + 1, 0));
+        };
+
+        Log::Comment(L"Repeated requests on an unchanged page report the same checksum");
+        const auto initialChecksum = fullChecksum();
+        VERIFY_ARE_EQUAL(initialChecksum, fullChecksum());
+        VERIFY_ARE_EQUAL(initialChecksum, splitChecksum());
+
+        Log::Comment(L"Modifying a row invalidates its cached checksum");
+        _pDispatch->PrintString(L"ABC");
+        const auto modifiedChecksum = fullChecksum();
+        VERIFY_ARE_NOT_EQUAL(initialChecksum, modifiedChecksum);
+        VERIFY_ARE_EQUAL(modifiedChecksum, splitChecksum());
+
+        Log::Comment(L"Scrolling the page remaps the rows");
+        _pDispatch->ScrollUp(1);
+        VERIFY_ARE_EQUAL(splitChecksum(), fullChecksum());
+
+        Log::Comment(L"Resetting the buffer in place invalidates the cache");
+        _pDispatch->PrintString(L"ABC");
+        auto textChecksum = fullChecksum();
+        _testGetSet->_textBuffer->ResetInPlace(_testGetSet->_textBuffer->GetCurrentAttributes());
+        VERIFY_ARE_NOT_EQUAL(textChecksum, fullChecksum());
+        VERIFY_ARE_EQUAL(splitChecksum(), fullChecksum());
+
+        Log::Comment(L"A hard reset (RIS) doesn't report the checksum of the previous text");
+        _pDispatch->PrintString(L"ABC");
+        textChecksum = fullChecksum();
+        VERIFY_IS_TRUE(_pDispatch->HardReset());
+        VERIFY_ARE_NOT_EQUAL(textChecksum, fullChecksum());
+        VERIFY_ARE_EQUAL(splitChecksum(), fullChecksum());
+
+        Log::Comment(L"Rows kept by ClearScrollback share the same mutation ID, even after they scroll");
+        auto& textBuffer = *_testGetSet->_textBuffer;
+        const auto height = textBuffer.GetSize().Height();
+        for (til::CoordType y = 0; y < height; y++)
+        {
+            textBuffer.GetMutableRowByOffset(y).ReplaceCharacters(0, 4, std::to_wstring(1000 + y));
+        }
+        textBuffer.ClearScrollback(1, height - 1);
+        VERIFY_ARE_EQUAL(splitChecksum(), fullChecksum());
+        // This is what a linefeed at the bottom of the buffer does.
+        textBuffer.IncrementCircularBuffer(textBuffer.GetCurrentAttributes());
+        VERIFY_ARE_EQUAL(splitChecksum(), fullChecksum());
+    }
+
     TEST_METHOD(TabulationStopReportTests)
     {
         _testGetSet->PrepData();
@@ -2995,6 +3063,56 @@ public:
         VERIFY_IS_TRUE(decdld(CellMatrix::Default, 0, FontSet::Size132x24, FontUsage::FullCell, bitmapOf6x18));
     }
 
+    TEST_METHOD(SixelImageDefinition)
+    {
+        _testGetSet->PrepData();
+        auto& textBuffer = *_testGetSet->_textBuffer;
+        auto& cursor = textBuffer.GetCursor();
+
+        const auto decsixel = [&](const std::wstring_view data) {
+            const auto stringHandler = _pDispatch->DefineSixelImage(9, DispatchTypes::SixelBackground::Transparent);
+            VERIFY_IS_NOT_NULL(stringHandler);
+            for (auto ch : data)
+            {
+                stringHandler(ch);
+            }
+            stringHandler(L'\033');
+        };
+        const auto pixelAt = [&](const til::CoordType row, const til::CoordType x, const til::CoordType y) {
+            const auto slice = textBuffer.GetRowByOffset(row).GetImageSlice();
+            return slice->Pixels()[y * slice->PixelWidth() + x];
+        };
+        static constexpr uint32_t red = 0xffff0000;
+
+        Log::Comment(L"A red 15x25 image with a 1:1 aspect ratio covers 2x2 cells of 10x20 pixels");
+        cursor.SetPosition({ 2, 0 });
+        decsixel(L"#1;2;100;0;0!15~-!15~-!15~-!15~-!15@");
+        VERIFY_ARE_EQUAL(til::point(2, 1), cursor.GetPosition());
+
+        const auto slice = textBuffer.GetRowByOffset(0).GetImageSlice();
+        VERIFY_IS_NOT_NULL(slice);
+        VERIFY_IS_NOT_NULL(textBuffer.GetRowByOffset(1).GetImageSlice());
+        VERIFY_IS_NULL(textBuffer.GetRowByOffset(2).GetImageSlice());
+        VERIFY_ARE_EQUAL(2, slice->ColumnOffset());
+        VERIFY_ARE_EQUAL(4, slice->ColumnEnd());
+        VERIFY_ARE_EQUAL(20, slice->PixelWidth());
+
+        Log::Comment(L"Pixels outside the image are left transparent");
+        VERIFY_ARE_EQUAL(red, pixelAt(0, 0, 0));
+        VERIFY_ARE_EQUAL(red, pixelAt(0, 14, 19));
+        VERIFY_ARE_EQUAL(0u, pixelAt(0, 15, 0));
+        VERIFY_ARE_EQUAL(red, pixelAt(1, 14, 4));
+        VERIFY_ARE_EQUAL(0u, pixelAt(1, 14, 5));
+
+        Log::Comment(L"Writing text over the image erases the cells it covers");
+        textBuffer.GetMutableRowByOffset(0).ReplaceCharacters(2, 1, L"X");
+        VERIFY_ARE_EQUAL(0u, pixelAt(0, 0, 0));
+        VERIFY_ARE_EQUAL(red, pixelAt(0, 10, 0));
+        RowWriteState state{ .text = L"XY", .columnBegin = 2 };
+        textBuffer.GetMutableRowByOffset(0).ReplaceText(state);
+        VERIFY_IS_NULL(textBuffer.GetRowByOffset(0).GetImageSlice());
+    }
+
     TEST_METHOD(TogglingC1ParserMode)
     {
         _stateMachine->SetParserMode(StateMachine::Mode::AcceptC1, false);
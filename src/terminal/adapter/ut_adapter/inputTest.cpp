@@ -36,6 +36,7 @@ public:
     TEST_METHOD(CtrlNumTest);
     TEST_METHOD(BackarrowKeyModeTest);
     TEST_METHOD(AutoRepeatModeTest);
+    TEST_METHOD(KeyTrackingStateTest);
 
     wchar_t GetModifierChar(const bool fShift, const bool fAlt, const bool fCtrl)
     {
@@ -790,3 +791,26 @@ void InputTest::AutoRepeatModeTest()
     VERIFY_ARE_EQUAL(TerminalInput::MakeOutput(L"A"), input.HandleKey(down));
     VERIFY_ARE_EQUAL(TerminalInput::MakeOutput({}), input.HandleKey(up));
 }
+
+void InputTest::KeyTrackingStateTest()
+{
+    static constexpr auto down = SynthesizeKeyEvent(true, 1, 'A', 0, 'A', 0);
+    TerminalInput leader;
+    TerminalInput follower;
+
+    Log::Comment(L"Mouse modes don't affect key translation, key modes do.");
+    follower.SetInputMode(TerminalInput::Mode::SgrMouseEncoding, true);
+    VERIFY_ARE_EQUAL(leader.GetKeyModes(), follower.GetKeyModes());
+    follower.SetInputMode(TerminalInput::Mode::Win32, true);
+    VERIFY_ARE_NOT_EQUAL(leader.GetKeyModes(), follower.GetKeyModes());
+    follower.ForceDisableWin32InputMode(true);
+    VERIFY_ARE_EQUAL(leader.GetKeyModes(), follower.GetKeyModes());
+
+    Log::Comment(L"A follower that adopts the leader's tracking state suppresses the same repeats.");
+    leader.SetInputMode(TerminalInput::Mode::AutoRepeat, false);
+    follower.SetInputMode(TerminalInput::Mode::AutoRepeat, false);
+    VERIFY_ARE_EQUAL(TerminalInput::MakeOutput(L"A"), leader.HandleKey(down));
+    follower.SetKeyTrackingState(leader.GetKeyTrackingState());
+    VERIFY_ARE_EQUAL(TerminalInput::MakeOutput({}), leader.HandleKey(down));
+    VERIFY_ARE_EQUAL(TerminalInput::MakeOutput({}), follower.HandleKey(down));
+}
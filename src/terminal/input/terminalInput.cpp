@@ -78,6 +78,30 @@ void TerminalInput::ForceDisableWin32InputMode(const bool win32InputMode) noexce
     _forceDisableWin32InputMode = win32InputMode;
 }
 
+// Returns a bitmask of the modes that affect HandleKey(). Two instances with
+// the same mask and KeyTrackingState translate every key event identically.
+uint32_t TerminalInput::GetKeyModes() const noexcept
+{
+    static constexpr auto keyModes = til::enumset<Mode>{ Mode::LineFeed, Mode::Ansi, Mode::AutoRepeat, Mode::Keypad, Mode::CursorKey, Mode::BackarrowKey, Mode::Win32 };
+    auto modes = _inputMode;
+    modes.set(Mode::Win32, modes.test(Mode::Win32) && !_forceDisableWin32InputMode);
+    return gsl::narrow_cast<uint32_t>(modes.bits() & keyModes.bits());
+}
+
+TerminalInput::KeyTrackingState TerminalInput::GetKeyTrackingState() const noexcept
+{
+    return { _leadingSurrogate, _lastVirtualKeyCode, _lastControlKeyState, _lastLeftCtrlTime, _lastRightAltTime };
+}
+
+void TerminalInput::SetKeyTrackingState(const KeyTrackingState& state) noexcept
+{
+    _leadingSurrogate = state.leadingSurrogate;
+    _lastVirtualKeyCode = state.lastVirtualKeyCode;
+    _lastControlKeyState = state.lastControlKeyState;
+    _lastLeftCtrlTime = state.lastLeftCtrlTime;
+    _lastRightAltTime = state.lastRightAltTime;
+}
+
 TerminalInput::OutputType TerminalInput::MakeUnhandled() noexcept
 {
     return {};
@@ -224,10 +248,12 @@ TerminalInput::OutputType TerminalInput::HandleKey(const INPUT_RECORD& event)
     WI_SetFlagIf(keyCombo, Alt, altIsPressed);
     WI_SetFlagIf(keyCombo, Shift, shiftIsPressed);
     WI_SetFlagIf(keyCombo, Enhanced, enhancedReturnKey);
-    const auto keyMatch = _keyMap.find(keyCombo);
-    if (keyMatch != _keyMap.end())
+    if (keyCombo < _keyMap.size())
     {
-        return keyMatch->second;
+        if (const auto index = til::at(_keyMap, keyCombo))
+        {
+            return til::at(_keySequences, index);
+        }
     }
 
     // If it's not in the key map, we'll use the UnicodeChar, if provided,
@@ -327,31 +353,38 @@ TerminalInput::OutputType TerminalInput::HandleFocus(const bool focused) const
 void TerminalInput::_initKeyboardMap() noexcept
 try
 {
-    auto defineKeyWithUnusedModifiers = [this](const int keyCode, const std::wstring& sequence) {
+    auto defineKey = [this](const int keyCombo, std::wstring sequence) {
+        til::at(_keyMap, keyCombo) = gsl::narrow<uint16_t>(_keySequences.size());
+        _keySequences.emplace_back(std::move(sequence));
+    };
+    auto defineKeyWithUnusedModifiers = [&](const int keyCode, const std::wstring& sequence) {
         for (auto m = 0; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = sequence;
+            defineKey(VTModifier(m) + keyCode, sequence);
     };
-    auto defineKeyWithAltModifier = [this](const int keyCode, const std::wstring& sequence) {
-        _keyMap[keyCode] = sequence;
-        _keyMap[Alt + keyCode] = L"\x1B" + sequence;
+    auto defineKeyWithAltModifier = [&](const int keyCode, const std::wstring& sequence) {
+        defineKey(keyCode, sequence);
+        defineKey(Alt + keyCode, L"\x1B" + sequence);
     };
-    auto defineKeypadKey = [this](const int keyCode, const wchar_t* prefix, const wchar_t finalChar) {
-        _keyMap[keyCode] = fmt::format(FMT_COMPILE(L"{}{}"), prefix, finalChar);
+    auto defineKeypadKey = [&](const int keyCode, const wchar_t* prefix, const wchar_t finalChar) {
+        defineKey(keyCode, fmt::format(FMT_COMPILE(L"{}{}"), prefix, finalChar));
         for (auto m = 1; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = fmt::format(FMT_COMPILE(L"{}1;{}{}"), _csi, m + 1, finalChar);
+            defineKey(VTModifier(m) + keyCode, fmt::format(FMT_COMPILE(L"{}1;{}{}"), _csi, m + 1, finalChar));
     };
-    auto defineEditingKey = [this](const int keyCode, const int parm) {
-        _keyMap[keyCode] = fmt::format(FMT_COMPILE(L"{}{}~"), _csi, parm);
+    auto defineEditingKey = [&](const int keyCode, const int parm) {
+        defineKey(keyCode, fmt::format(FMT_COMPILE(L"{}{}~"), _csi, parm));
         for (auto m = 1; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = fmt::format(FMT_COMPILE(L"{}{};{}~"), _csi, parm, m + 1);
+            defineKey(VTModifier(m) + keyCode, fmt::format(FMT_COMPILE(L"{}{};{}~"), _csi, parm, m + 1));
     };
-    auto defineNumericKey = [this](const int keyCode, const wchar_t finalChar) {
-        _keyMap[keyCode] = fmt::format(FMT_COMPILE(L"{}{}"), _ss3, finalChar);
+    auto defineNumericKey = [&](const int keyCode, const wchar_t finalChar) {
+        defineKey(keyCode, fmt::format(FMT_COMPILE(L"{}{}"), _ss3, finalChar));
         for (auto m = 1; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = fmt::format(FMT_COMPILE(L"{}{}{}"), _ss3, m + 1, finalChar);
+            defineKey(VTModifier(m) + keyCode, fmt::format(FMT_COMPILE(L"{}{}{}"), _ss3, m + 1, finalChar));
     };
 
-    _keyMap.clear();
+    // Index 0 is reserved to indicate unmapped key combinations.
+    _keyMap.fill(0);
+    _keySequences.clear();
+    _keySequences.emplace_back();
 
     // PAUSE doesn't have a VT mapping, but traditionally we've mapped it to ^Z,
     // regardless of modifiers.
@@ -52,6 +52,21 @@ namespace Microsoft::Console::VirtualTerminal
         void ResetInputModes() noexcept;
         void ForceDisableWin32InputMode(const bool win32InputMode) noexcept;
 
+        // The bookkeeping HandleKey() does across calls. Broadcast input translates a key
+        // once per distinct GetKeyModes() and copies the resulting state to the other targets.
+        struct KeyTrackingState
+        {
+            wchar_t leadingSurrogate = 0;
+            std::optional<WORD> lastVirtualKeyCode;
+            DWORD lastControlKeyState = 0;
+            uint64_t lastLeftCtrlTime = 0;
+            uint64_t lastRightAltTime = 0;
+        };
+
+        uint32_t GetKeyModes() const noexcept;
+        KeyTrackingState GetKeyTrackingState() const noexcept;
+        void SetKeyTrackingState(const KeyTrackingState& state) noexcept;
+
 #pragma region MouseInput
         // These methods are defined in mouseInput.cpp
 
@@ -73,7 +88,11 @@ namespace Microsoft::Console::VirtualTerminal
         DWORD _lastControlKeyState = 0;
         uint64_t _lastLeftCtrlTime = 0;
         uint64_t _lastRightAltTime = 0;
-        std::unordered_map<int, std::wstring> _keyMap;
+        // A key combination (a virtual key code combined with the VTModifier flags)
+        // indexes into _keyMap, which holds the index of the sequence in _keySequences.
+        // Both are regenerated whenever one of the relevant input modes changes.
+        std::array<uint16_t, 0x1000> _keyMap{};
+        std::vector<std::wstring> _keySequences;
         std::wstring _focusInSequence;
         std::wstring _focusOutSequence;
 
@@ -121,6 +121,7 @@ void InputStateMachineEngine::SetLookingForDSR(const bool looking) noexcept
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionExecute(const wchar_t wch)
 {
+    _FlushWin32Keys();
     return _DoControlCharacter(wch, false);
 }
 
@@ -228,6 +229,7 @@ bool InputStateMachineEngine::_DoControlCharacter(const wchar_t wch, const bool
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 {
+    _FlushWin32Keys();
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
         return _pfnFlushToInputQueue();
@@ -245,6 +247,7 @@ bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
 {
+    _FlushWin32Keys();
     short vkey = 0;
     DWORD modifierState = 0;
     auto success = _GenerateKeyFromChar(wch, vkey, modifierState);
@@ -264,6 +267,7 @@ bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 {
+    _FlushWin32Keys();
     if (string.empty())
     {
         return true;
@@ -281,6 +285,7 @@ bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view string, const bool /*flush*/)
 {
+    _FlushWin32Keys();
     if (_pDispatch->IsVtInputEnabled())
     {
         // Synthesize string into key events that we'll write to the buffer
@@ -308,6 +313,7 @@ bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view st
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionEscDispatch(const VTID id)
 {
+    _FlushWin32Keys();
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
         return _pfnFlushToInputQueue();
@@ -366,6 +372,19 @@ bool InputStateMachineEngine::ActionVt52EscDispatch(const VTID /*id*/, const VTP
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    // Key repeat and pastes in win32-input-mode arrive as long runs of these
+    // sequences. Instead of dispatching them one by one, we collect them until
+    // anything else comes along (or the end of the string is reached), and
+    // then hand them to the dispatch in one go. See _FlushWin32Keys().
+    if (id == CsiActionCodes::Win32KeyboardInput)
+    {
+        _pendingWin32Keys.emplace_back(_GenerateWin32Key(parameters));
+        _encounteredWin32InputModeSequence = true;
+        return true;
+    }
+
+    _FlushWin32Keys();
+
     // GH#4999 - If the client was in VT input mode, but we received a
     // win32-input-mode sequence, then _don't_ passthrough the sequence to the
     // client. It's impossibly unlikely that the client actually wanted
@@ -447,16 +466,6 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
     case CsiActionCodes::FocusOut:
         success = _pDispatch->FocusChanged(false);
         break;
-    case CsiActionCodes::Win32KeyboardInput:
-    {
-        // Use WriteCtrlKey here, even for keys that _aren't_ control keys,
-        // because that will take extra steps to make sure things like
-        // Ctrl+C, Ctrl+Break are handled correctly.
-        const auto key = _GenerateWin32Key(parameters);
-        success = _pDispatch->WriteCtrlKey(key);
-        _encounteredWin32InputModeSequence = true;
-        break;
-    }
     default:
         success = false;
         break;
@@ -465,6 +474,40 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
     return success;
 }
 
+// Method Description:
+// - Called by the state machine once it reached the end of the string it
+//      was given. We use this to flush any pending win32-input-mode keys.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we successfully dispatched the pending keys.
+bool InputStateMachineEngine::ActionEndOfString()
+{
+    return _FlushWin32Keys();
+}
+
+// Method Description:
+// - Writes the win32-input-mode keys collected by ActionCsiDispatch to the
+//      dispatch in a single call.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we successfully dispatched the pending keys.
+bool InputStateMachineEngine::_FlushWin32Keys()
+{
+    if (_pendingWin32Keys.empty())
+    {
+        return true;
+    }
+
+    // Use WriteCtrlKeys here, even for keys that _aren't_ control keys,
+    // because that will take extra steps to make sure things like
+    // Ctrl+C, Ctrl+Break are handled correctly.
+    const auto success = _pDispatch->WriteCtrlKeys(_pendingWin32Keys);
+    _pendingWin32Keys.clear();
+    return success;
+}
+
 // Routine Description:
 // - Triggers the DcsDispatch action to indicate that the listener should handle
 //      a control sequence. Returns the handler function that is to be used to
@@ -491,6 +534,7 @@ IStateMachineEngine::StringHandler InputStateMachineEngine::ActionDcsDispatch(co
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch, const VTParameters /*parameters*/)
 {
+    _FlushWin32Keys();
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
         return _pfnFlushToInputQueue();
@@ -160,6 +160,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) override;
 
+        bool ActionEndOfString() override;
+
         void SetFlushToInputQueueCallback(std::function<bool()> pfnFlushToInputQueue);
 
     private:
@@ -167,6 +169,7 @@ namespace Microsoft::Console::VirtualTerminal
         std::function<bool()> _pfnFlushToInputQueue;
         bool _lookingForDSR;
         bool _encounteredWin32InputModeSequence = false;
+        std::vector<INPUT_RECORD> _pendingWin32Keys;
         DWORD _mouseButtonState = 0;
         std::chrono::milliseconds _doubleClickTime;
         std::optional<til::point> _lastMouseClickPos{};
@@ -210,6 +213,7 @@ namespace Microsoft::Console::VirtualTerminal
         static INPUT_RECORD _GenerateWin32Key(const VTParameters& parameters);
 
         bool _DoControlCharacter(const wchar_t wch, const bool writeAlt);
+        bool _FlushWin32Keys();
 
 #ifdef UNIT_TESTING
         friend class InputEngineTest;
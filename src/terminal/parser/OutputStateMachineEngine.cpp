@@ -431,6 +431,20 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTPara
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    // SGR makes up the vast majority of all CSI sequences in practice. Testing for it up front
+    // skips the subparameter validation (SGR accepts all subparameters) as well as the switch
+    // below, which compiles into a binary search, because VTIDs are sparse 64-bit values.
+    if (id == CsiActionCodes::SGR_SetGraphicsRendition) [[likely]]
+    {
+        auto success = _dispatch->SetGraphicsRendition(parameters);
+        if (_pfnFlushToTerminal != nullptr && !success)
+        {
+            success = _pfnFlushToTerminal();
+        }
+        _ClearLastChar();
+        return success;
+    }
+
     // Bail out if we receive subparameters, but we don't accept them in the sequence.
     if (parameters.hasSubParams() && !_CanSeqAcceptSubParam(id, parameters)) [[unlikely]]
     {
@@ -529,9 +543,6 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
             return _dispatch->ResetMode(DispatchTypes::DECPrivateMode(mode));
         });
         break;
-    case CsiActionCodes::SGR_SetGraphicsRendition:
-        success = _dispatch->SetGraphicsRendition(parameters);
-        break;
     case CsiActionCodes::DSR_DeviceStatusReport:
         success = _dispatch->DeviceStatusReport(DispatchTypes::ANSIStandardStatus(parameters.at(0)), parameters.at(1));
         break;
@@ -712,6 +723,9 @@ IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(c
                                           parameters.at(6),
                                           parameters.at(7));
         break;
+    case DcsActionCodes::DECSIXEL_SelectSixelData:
+        handler = _dispatch->DefineSixelImage(parameters.at(0), parameters.at(1));
+        break;
     case DcsActionCodes::DECAUPSS_AssignUserPreferenceSupplementalSet:
         handler = _dispatch->AssignUserPreferenceCharset(parameters.at(0));
         break;
@@ -929,6 +943,17 @@ bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/, const VT
     return false;
 }
 
+// Routine Description:
+// - Called once the state machine reached the end of the string it was given.
+// Arguments:
+// - <none>
+// Return Value:
+// - true (the output engine doesn't buffer anything).
+bool OutputStateMachineEngine::ActionEndOfString() noexcept
+{
+    return true;
+}
+
 // Routine Description:
 // - OSC 4 ; c ; spec ST
 //      c: the index of the ansi color table
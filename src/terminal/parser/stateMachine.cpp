@@ -5,8 +5,12 @@
 
 #include "stateMachine.hpp"
 
+#include <isa_availability.h>
+
 #include "ascii.hpp"
 
+extern "C" int __isa_available;
+
 using namespace Microsoft::Console::VirtualTerminal;
 
 //Takes ownership of the pEngine.
@@ -379,6 +383,7 @@ static constexpr bool _isApcIndicator(const wchar_t wch) noexcept
 void StateMachine::_ActionExecute(const wchar_t wch)
 {
     _trace.TraceOnExecute(wch);
+    _trace.CountSequence(ParserTracing::SequenceKind::Execute);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionExecute(wch);
     }));
@@ -395,6 +400,7 @@ void StateMachine::_ActionExecute(const wchar_t wch)
 void StateMachine::_ActionExecuteFromEscape(const wchar_t wch)
 {
     _trace.TraceOnExecuteFromEscape(wch);
+    _trace.CountSequence(ParserTracing::SequenceKind::Execute);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionExecuteFromEscape(wch);
     }));
@@ -409,6 +415,7 @@ void StateMachine::_ActionExecuteFromEscape(const wchar_t wch)
 void StateMachine::_ActionPrint(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Print");
+    _trace.CountSequence(ParserTracing::SequenceKind::Print);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionPrint(wch);
     }));
@@ -426,6 +433,7 @@ void StateMachine::_ActionPrintString(const std::wstring_view string)
         return _engine->ActionPrintString(string);
     });
     _trace.DispatchPrintRunTrace(string);
+    _trace.CountGroundChars(string.size());
 }
 
 // Routine Description:
@@ -438,6 +446,7 @@ void StateMachine::_ActionPrintString(const std::wstring_view string)
 void StateMachine::_ActionEscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"EscDispatch");
+    _trace.CountSequence(ParserTracing::SequenceKind::Esc);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionEscDispatch(_identifier.Finalize(wch));
     }));
@@ -453,6 +462,7 @@ void StateMachine::_ActionEscDispatch(const wchar_t wch)
 void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Vt52EscDispatch");
+    _trace.CountSequence(ParserTracing::SequenceKind::Vt52);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionVt52EscDispatch(_identifier.Finalize(wch), { _parameters.data(), _parameters.size() });
     }));
@@ -468,6 +478,7 @@ void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 void StateMachine::_ActionCsiDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"CsiDispatch");
+    _trace.CountSequence(ParserTracing::SequenceKind::Csi);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionCsiDispatch(_identifier.Finalize(wch),
                                           { _parameters, _subParameters, _subParameterRanges });
@@ -694,6 +705,7 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 void StateMachine::_ActionOscDispatch()
 {
     _trace.TraceOnAction(L"OscDispatch");
+    _trace.CountSequence(ParserTracing::SequenceKind::Osc);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionOscDispatch(_oscParameter, _oscString);
     }));
@@ -709,6 +721,7 @@ void StateMachine::_ActionOscDispatch()
 void StateMachine::_ActionSs3Dispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Ss3Dispatch");
+    _trace.CountSequence(ParserTracing::SequenceKind::Ss3);
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionSs3Dispatch(wch, { _parameters.data(), _parameters.size() });
     }));
@@ -724,6 +737,7 @@ void StateMachine::_ActionSs3Dispatch(const wchar_t wch)
 void StateMachine::_ActionDcsDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"DcsDispatch");
+    _trace.CountSequence(ParserTracing::SequenceKind::Dcs);
 
     const auto success = _SafeExecute([=]() {
         _dcsStringHandler = _engine->ActionDcsDispatch(_identifier.Finalize(wch), { _parameters.data(), _parameters.size() });
@@ -1999,6 +2013,34 @@ static size_t findActionableFromGround(const wchar_t* data, size_t count) noexce
 
     auto it = data;
 
+    // Printable runs (build logs, etc.) are usually long enough that it's worth scanning
+    // 16 characters at a time. The remainder falls through to the SSE2 loop below.
+    if (__isa_available >= __ISA_AVAILABLE_AVX2)
+    {
+        for (const auto end = data + (count & ~size_t{ 15 }); it < end; it += 16)
+        {
+            const auto wch = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+            const auto z = _mm256_setzero_si256();
+
+            // This is identical to the SSE2 loop below. See there for an explanation.
+            auto a = _mm256_subs_epu16(wch, _mm256_set1_epi16(0x1f));
+            auto b = _mm256_subs_epu16(_mm256_add_epi16(wch, _mm256_set1_epi16(static_cast<short>(0xff81))), _mm256_set1_epi16(0x20));
+            a = _mm256_cmpeq_epi16(a, z);
+            b = _mm256_cmpeq_epi16(b, z);
+
+            const auto c = _mm256_or_si256(a, b);
+            const auto mask = static_cast<unsigned long>(_mm256_movemask_epi8(c));
+
+            if (mask)
+            {
+                unsigned long offset;
+                _BitScanForward(&offset, mask);
+                it += offset / 2;
+                return it - data;
+            }
+        }
+    }
+
     for (const auto end = data + (count & ~size_t{ 7 }); it < end; it += 8)
     {
         const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
@@ -2068,7 +2110,7 @@ exitWithMask:
 
 #else
 
-    return findActionableFromGroundPlain(data, data + count, p);
+    return findActionableFromGroundPlain(data, data + count, data);
 
 #endif
 }
@@ -2086,6 +2128,7 @@ exitWithMask:
 // - <none>
 void StateMachine::ProcessString(const std::wstring_view string)
 {
+    const til::alloc_tracking::scope allocScope{ til::alloc_tracking::category::parser };
     size_t i = 0;
     _currentString = string;
     _runOffset = 0;
@@ -2124,6 +2167,46 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
         do
         {
+            // OSC strings can be very long (OSC 52 clipboard payloads for instance), and everything
+            // that isn't actionable from ground would just be appended to _oscString by _EventOscString.
+            // We can skip ProcessCharacter() for those and collect the entire run at once.
+            if (_state == VTStates::OscString)
+            {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).)
+                const auto oscRun = findActionableFromGround(string.data() + i, string.size() - i);
+                _oscString.append(string.substr(i, oscRun));
+                _runSize += oscRun;
+                i += oscRun;
+
+                if (i >= string.size())
+                {
+                    break;
+                }
+            }
+            // The same applies to DCS payloads (DECDLD soft fonts, macros, etc.). Valid pass-through
+            // characters are handed straight to the string handler until it asks us to stop.
+            else if (_state == VTStates::DcsPassThrough)
+            {
+                const auto dcsBeg = i;
+                for (; i < string.size() && _isDcsPassThroughValid(til::at(string, i)); ++i)
+                {
+                    // The pass-through handler relies on this to know when to flush its buffer.
+                    _processingLastCharacter = i + 1 >= string.size();
+                    if (!_dcsStringHandler(til::at(string, i)))
+                    {
+                        ++i;
+                        _EnterDcsIgnore();
+                        break;
+                    }
+                }
+                _runSize += i - dcsBeg;
+
+                if (i >= string.size())
+                {
+                    break;
+                }
+            }
+
             _runSize++;
             _processingLastCharacter = i + 1 >= string.size();
             // If we're processing characters individually, send it to the state machine.
@@ -2191,6 +2274,13 @@ void StateMachine::ProcessString(const std::wstring_view string)
             cachedSequence.append(run);
         }
     }
+
+    // Give the engine a chance to flush anything it batched up while processing the string.
+    _SafeExecute([=]() {
+        return _engine->ActionEndOfString();
+    });
+
+    _trace.FlushCounters();
 }
 
 // Routine Description:
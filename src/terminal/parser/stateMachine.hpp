@@ -199,10 +199,12 @@ namespace Microsoft::Console::VirtualTerminal
         }
 
         VTIDBuilder _identifier;
-        std::vector<VTParameter> _parameters;
+        // The parameter counts are capped by MAX_PARAMETER_COUNT and MAX_SUBPARAMETER_COUNT,
+        // so these never need to spill onto the heap, no matter the input.
+        til::small_vector<VTParameter, MAX_PARAMETER_COUNT> _parameters;
         bool _parameterLimitOverflowed;
-        std::vector<VTParameter> _subParameters;
-        std::vector<std::pair<BYTE /*range start*/, BYTE /*range end*/>> _subParameterRanges;
+        til::small_vector<VTParameter, MAX_PARAMETER_COUNT * MAX_SUBPARAMETER_COUNT> _subParameters;
+        til::small_vector<std::pair<BYTE /*range start*/, BYTE /*range end*/>, MAX_PARAMETER_COUNT> _subParameterRanges;
         bool _subParameterLimitOverflowed;
         BYTE _subParameterCounter;
 
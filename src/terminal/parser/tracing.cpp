@@ -23,7 +23,7 @@ static const auto cleanup = []() noexcept {
     });
 }();
 
-void ParserTracing::TraceStateChange(_In_z_ const wchar_t* name) const noexcept
+void ParserTracing::_traceStateChange(_In_z_ const wchar_t* name) const noexcept
 {
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_EnterState",
@@ -32,7 +32,7 @@ void ParserTracing::TraceStateChange(_In_z_ const wchar_t* name) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnAction(_In_z_ const wchar_t* name) const noexcept
+void ParserTracing::_traceOnAction(_In_z_ const wchar_t* name) const noexcept
 {
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_Action",
@@ -41,7 +41,7 @@ void ParserTracing::TraceOnAction(_In_z_ const wchar_t* name) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnExecute(const wchar_t wch) const noexcept
+void ParserTracing::_traceOnExecute(const wchar_t wch) const noexcept
 {
     const auto sch = gsl::narrow_cast<INT16>(wch);
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
@@ -52,7 +52,7 @@ void ParserTracing::TraceOnExecute(const wchar_t wch) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
+void ParserTracing::_traceOnExecuteFromEscape(const wchar_t wch) const noexcept
 {
     const auto sch = gsl::narrow_cast<INT16>(wch);
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
@@ -63,7 +63,7 @@ void ParserTracing::TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
+void ParserTracing::_traceOnEvent(_In_z_ const wchar_t* name) const noexcept
 {
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_Event",
@@ -72,9 +72,9 @@ void ParserTracing::TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::TraceCharInput(const wchar_t wch)
+void ParserTracing::_traceCharInput(const wchar_t wch)
 {
-    AddSequenceTrace(wch);
+    _addSequenceTrace(wch);
 
     TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
                       "StateMachine_NewChar",
@@ -84,7 +84,7 @@ void ParserTracing::TraceCharInput(const wchar_t wch)
                       TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 }
 
-void ParserTracing::AddSequenceTrace(const wchar_t wch)
+void ParserTracing::_addSequenceTrace(const wchar_t wch)
 {
     // Don't waste time storing this if no one is listening.
     if (TraceLoggingProviderEnabled(g_hConsoleVirtTermParserEventTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
@@ -93,7 +93,7 @@ void ParserTracing::AddSequenceTrace(const wchar_t wch)
     }
 }
 
-void ParserTracing::DispatchSequenceTrace(const bool fSuccess) noexcept
+void ParserTracing::_dispatchSequenceTrace(const bool fSuccess) noexcept
 {
     if (fSuccess)
     {
@@ -112,16 +112,11 @@ void ParserTracing::DispatchSequenceTrace(const bool fSuccess) noexcept
                           TraceLoggingKeyword(TIL_KEYWORD_TRACE));
     }
 
-    ClearSequenceTrace();
-}
-
-void ParserTracing::ClearSequenceTrace() noexcept
-{
     _sequenceTrace.clear();
 }
 
 // NOTE: I'm expecting this to not be null terminated
-void ParserTracing::DispatchPrintRunTrace(const std::wstring_view& string) const
+void ParserTracing::_dispatchPrintRunTrace(const std::wstring_view& string) const
 {
     if (string.size() == 1)
     {
@@ -147,4 +142,44 @@ void ParserTracing::DispatchPrintRunTrace(const std::wstring_view& string) const
     }
 }
 
+// Emits the counters as a single event and resets them, but only once enough work has accumulated.
+// This turns the event into a sample of the parser's workload (one per ~64Ki printed characters and sequences)
+// and keeps the cost of this function negligible for the many tiny writes a shell produces.
+void ParserTracing::FlushCounters() noexcept
+{
+    static constexpr uint64_t sampleSize = 64 * 1024;
+
+    uint64_t sequences = 0;
+    for (const auto count : _sequenceCounts)
+    {
+        sequences += count;
+    }
+    if (_groundChars + sequences < sampleSize)
+    {
+        return;
+    }
+
+    if (TraceLoggingProviderEnabled(g_hConsoleVirtTermParserEventTraceProvider, WINEVENT_LEVEL_INFO, TIL_KEYWORD_TRACE))
+    {
+        const auto& c = _sequenceCounts;
+        TraceLoggingWrite(g_hConsoleVirtTermParserEventTraceProvider,
+                          "StateMachine_Counters",
+                          TraceLoggingDescription("Number of dispatched sequences per type and characters printed from the ground state since the last sample"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Execute)), "execute"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Print)), "print"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Esc)), "esc"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Vt52)), "vt52"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Csi)), "csi"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Osc)), "osc"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Ss3)), "ss3"),
+                          TraceLoggingUInt32(til::at(c, static_cast<size_t>(SequenceKind::Dcs)), "dcs"),
+                          TraceLoggingUInt64(_groundChars, "groundChars"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
+    _sequenceCounts = {};
+    _groundChars = 0;
+}
+
 #pragma warning(pop)
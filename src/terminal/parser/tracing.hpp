@@ -18,11 +18,36 @@ Abstract:
 #include <winmeta.h>
 #include <TraceLoggingProvider.h>
 
+// The per-character hooks (state changes, events, actions, sequence strings) are only compiled into
+// debug builds, since even the "is anyone listening" check adds up when it runs for every character.
+// Define CON_PARSER_VERBOSE_TRACING to get them in release builds anyway.
+#if !defined(NDEBUG) || defined(CON_PARSER_VERBOSE_TRACING)
+#define CON_PARSER_VERBOSE_TRACING_ENABLED 1
+#else
+#define CON_PARSER_VERBOSE_TRACING_ENABLED 0
+#endif
+
 namespace Microsoft::Console::VirtualTerminal
 {
     class ParserTracing sealed
     {
     public:
+        static constexpr bool VerboseHooks = CON_PARSER_VERBOSE_TRACING_ENABLED;
+
+        // The types of sequences counted by the always-on counters. See FlushCounters().
+        enum class SequenceKind : uint8_t
+        {
+            Execute,
+            Print,
+            Esc,
+            Vt52,
+            Csi,
+            Osc,
+            Ss3,
+            Dcs,
+            Count,
+        };
+
         // NOTE: This code uses
         //   (_In_z_ const wchar_t* name)
         // as arguments instead of the more modern std::wstring_view
@@ -36,19 +61,104 @@ namespace Microsoft::Console::VirtualTerminal
         // C-strings is more ergonomic instead and fits the need for
         // high performance in this particular code.
 
-        void TraceStateChange(_In_z_ const wchar_t* name) const noexcept;
-        void TraceOnAction(_In_z_ const wchar_t* name) const noexcept;
-        void TraceOnExecute(const wchar_t wch) const noexcept;
-        void TraceOnExecuteFromEscape(const wchar_t wch) const noexcept;
-        void TraceOnEvent(_In_z_ const wchar_t* name) const noexcept;
-        void TraceCharInput(const wchar_t wch);
+        void TraceStateChange(_In_z_ const wchar_t* name) const noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _traceStateChange(name);
+            }
+        }
+        void TraceOnAction(_In_z_ const wchar_t* name) const noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _traceOnAction(name);
+            }
+        }
+        void TraceOnExecute(const wchar_t wch) const noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _traceOnExecute(wch);
+            }
+        }
+        void TraceOnExecuteFromEscape(const wchar_t wch) const noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _traceOnExecuteFromEscape(wch);
+            }
+        }
+        void TraceOnEvent(_In_z_ const wchar_t* name) const noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _traceOnEvent(name);
+            }
+        }
+        void TraceCharInput(const wchar_t wch)
+        {
+            if constexpr (VerboseHooks)
+            {
+                _traceCharInput(wch);
+            }
+        }
 
-        void AddSequenceTrace(const wchar_t wch);
-        void DispatchSequenceTrace(const bool fSuccess) noexcept;
-        void ClearSequenceTrace() noexcept;
-        void DispatchPrintRunTrace(const std::wstring_view& string) const;
+        void AddSequenceTrace(const wchar_t wch)
+        {
+            if constexpr (VerboseHooks)
+            {
+                _addSequenceTrace(wch);
+            }
+        }
+        void DispatchSequenceTrace(const bool fSuccess) noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _dispatchSequenceTrace(fSuccess);
+            }
+        }
+        void ClearSequenceTrace() noexcept
+        {
+            if constexpr (VerboseHooks)
+            {
+                _sequenceTrace.clear();
+            }
+        }
+        void DispatchPrintRunTrace(const std::wstring_view& string) const
+        {
+            if constexpr (VerboseHooks)
+            {
+                _dispatchPrintRunTrace(string);
+            }
+        }
+
+        // The counters are cheap enough to be always on: Each dispatched sequence
+        // costs an increment and the "is anyone listening" check happens in
+        // FlushCounters() only once per sample, instead of once per character.
+        void CountSequence(const SequenceKind kind) noexcept
+        {
+            til::at(_sequenceCounts, static_cast<size_t>(kind))++;
+        }
+        void CountGroundChars(const size_t count) noexcept
+        {
+            _groundChars += count;
+        }
+        void FlushCounters() noexcept;
 
     private:
+        void _traceStateChange(_In_z_ const wchar_t* name) const noexcept;
+        void _traceOnAction(_In_z_ const wchar_t* name) const noexcept;
+        void _traceOnExecute(const wchar_t wch) const noexcept;
+        void _traceOnExecuteFromEscape(const wchar_t wch) const noexcept;
+        void _traceOnEvent(_In_z_ const wchar_t* name) const noexcept;
+        void _traceCharInput(const wchar_t wch);
+        void _addSequenceTrace(const wchar_t wch);
+        void _dispatchSequenceTrace(const bool fSuccess) noexcept;
+        void _dispatchPrintRunTrace(const std::wstring_view& string) const;
+
         std::wstring _sequenceTrace;
+        std::array<uint32_t, static_cast<size_t>(SequenceKind::Count)> _sequenceCounts{};
+        uint64_t _groundChars = 0;
     };
 }
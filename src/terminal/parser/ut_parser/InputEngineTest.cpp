@@ -274,6 +274,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
 
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
+    TEST_METHOD(TestWin32InputBatching);
 
     friend class TestInteractDispatch;
 };
@@ -319,6 +320,7 @@ public:
     virtual bool WriteInput(_In_ const std::span<const INPUT_RECORD>& inputEvents) override;
 
     virtual bool WriteCtrlKey(const INPUT_RECORD& event) override;
+    virtual bool WriteCtrlKeys(const std::span<const INPUT_RECORD>& events) override;
     virtual bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
                                     const VTParameter parameter1,
                                     const VTParameter parameter2) override; // DTTERM_WindowManipulation
@@ -355,6 +357,12 @@ bool TestInteractDispatch::WriteCtrlKey(const INPUT_RECORD& event)
     return WriteInput({ &event, 1 });
 }
 
+bool TestInteractDispatch::WriteCtrlKeys(const std::span<const INPUT_RECORD>& events)
+{
+    VERIFY_IS_TRUE(_testState->_expectSendCtrlC);
+    return WriteInput(events);
+}
+
 bool TestInteractDispatch::WindowManipulation(const DispatchTypes::WindowManipulationType function,
                                               const VTParameter parameter1,
                                               const VTParameter parameter2)
@@ -1607,3 +1615,36 @@ void InputEngineTest::TestWin32InputOptionals()
         }
     }
 }
+
+void InputEngineTest::TestWin32InputBatching()
+{
+    std::vector<std::vector<INPUT_RECORD>> writes;
+    auto pfn = [&](const std::span<const INPUT_RECORD>& records) {
+        writes.emplace_back(records.begin(), records.end());
+    };
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    auto stateMachine = std::make_unique<StateMachine>(std::move(inputEngine));
+    testState._stateMachine = stateMachine.get();
+    testState._expectSendCtrlC = true;
+    auto restoreExpectation = wil::scope_exit([&] { testState._expectSendCtrlC = false; });
+
+    Log::Comment(L"A run of win32-input-mode sequences is written in a single batch");
+    stateMachine->ProcessString(L"\x1b[65;30;97;1;0;1_\x1b[65;30;97;0;0;1_\x1b[66;48;98;1;0;1_x\x1b[66;48;98;0;0;1_");
+    VERIFY_ARE_EQUAL(3u, writes.size());
+
+    VERIFY_ARE_EQUAL(3u, writes.at(0).size());
+    VERIFY_ARE_EQUAL(L'a', writes.at(0).at(0).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(TRUE, writes.at(0).at(0).Event.KeyEvent.bKeyDown);
+    VERIFY_ARE_EQUAL(L'a', writes.at(0).at(1).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(FALSE, writes.at(0).at(1).Event.KeyEvent.bKeyDown);
+    VERIFY_ARE_EQUAL(L'b', writes.at(0).at(2).Event.KeyEvent.uChar.UnicodeChar);
+
+    Log::Comment(L"Other input flushes the batch first, to keep the order intact");
+    VERIFY_ARE_EQUAL(L'x', writes.at(1).at(0).Event.KeyEvent.uChar.UnicodeChar);
+
+    Log::Comment(L"Keys pending at the end of the string are flushed as well");
+    VERIFY_ARE_EQUAL(1u, writes.at(2).size());
+    VERIFY_ARE_EQUAL(L'b', writes.at(2).at(0).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(FALSE, writes.at(2).at(0).Event.KeyEvent.bKeyDown);
+}
@@ -3261,6 +3261,13 @@ class StateMachineExternalTest final
 
         pDispatch->ClearState();
 
+        // A payload split across multiple writes works, and ignored C0 controls within it are dropped.
+        mach.ProcessString(L"\x1b]52;;Zm9vDQ");
+        mach.ProcessString(L"pi\x01YXI=\x07");
+        VERIFY_ARE_EQUAL(L"foo\r\nbar", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
         pDispatch->_copyContent = L"UNCHANGED";
         // Passing only base64 `Pd` param is illegal, won't change the content.
         mach.ProcessString(L"\x1b]52;Zm9v\x07");
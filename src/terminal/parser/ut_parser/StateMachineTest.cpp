@@ -38,6 +38,7 @@ public:
         dcsId = 0;
         dcsParams.clear();
         dcsDataString.clear();
+        dcsLastCharacterOffsets.clear();
     }
 
     bool EncounteredWin32InputModeSequence() const noexcept override
@@ -85,6 +86,8 @@ public:
 
     bool ActionSs3Dispatch(const wchar_t /* wch */, const VTParameters /* parameters */) override { return true; };
 
+    bool ActionEndOfString() override { return true; };
+
     // ActionCsiDispatch is the only method that's actually implemented.
     bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override
     {
@@ -113,7 +116,14 @@ public:
             dcsParams.push_back(parameters.at(i).value_or(0));
         }
         dcsDataString.clear();
-        return [=](const auto ch) { dcsDataString += ch; return true; };
+        return [=](const auto ch) {
+            dcsDataString += ch;
+            if (machine && machine->IsProcessingLastCharacter())
+            {
+                dcsLastCharacterOffsets.push_back(dcsDataString.size());
+            }
+            return true;
+        };
     }
 
     // These will only be populated if ActionCsiDispatch is called.
@@ -136,6 +146,11 @@ public:
     uint64_t dcsId = 0;
     std::vector<size_t> dcsParams;
     std::wstring dcsDataString;
+
+    // If set, the DCS handler records the length of dcsDataString
+    // whenever it's called for the last character of a ProcessString().
+    const StateMachine* machine = nullptr;
+    std::vector<size_t> dcsLastCharacterOffsets;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -157,9 +172,11 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandled);
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
+    TEST_METHOD(BulkTextPrintStopsAtControlCharacters);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+    TEST_METHOD(DcsDataStringSplitAcrossWritesReportsLastCharacter);
 
     TEST_METHOD(VtParameterSubspanTest);
 };
@@ -234,6 +251,34 @@ void StateMachineTest::BulkTextPrint()
     VERIFY_ARE_EQUAL(String(L"12345 Hello World"), String(engine.printed.c_str()));
 }
 
+void StateMachineTest::BulkTextPrintStopsAtControlCharacters()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // The printable run scanner is vectorized in 8 and 16 character wide chunks.
+    // Place a control character at every offset of a run that's longer than
+    // multiple chunks, so that we cover the vectorized loops and their tails.
+    for (const auto control : { L'\x07', L'\x7f', L'\x9c' })
+    {
+        for (size_t offset = 0; offset < 40; offset++)
+        {
+            std::wstring text(48, L'a');
+            text[offset] = control;
+
+            engine.ResetTestState();
+            machine.ProcessString(text);
+
+            auto expected = text;
+            expected.erase(offset, 1);
+            VERIFY_ARE_EQUAL(String(expected.c_str()), String(engine.printed.c_str()));
+            machine.ResetState();
+        }
+    }
+}
+
 void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
 {
     auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
@@ -343,6 +388,24 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
 
+void StateMachineTest::DcsDataStringSplitAcrossWritesReportsLastCharacter()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+    engine.machine = &machine;
+
+    // The ConPTY pass-through handler flushes its buffer when IsProcessingLastCharacter() returns true.
+    // The payload is handed to the handler in bulk, which must still keep that flag up to date.
+    machine.ProcessString(L"P1;2;3|ab");
+    machine.ProcessString(L"cd");
+    machine.ProcessString(L"ef\");
+
+    VERIFY_ARE_EQUAL(L"abcdef", engine.dcsDataString);
+    VERIFY_ARE_EQUAL(std::vector<size_t>({ 2, 4 }), engine.dcsLastCharacterOffsets);
+}
+
 void StateMachineTest::VtParameterSubspanTest()
 {
     const auto parameterList = std::vector<VTParameter>{ 12, 34, 56, 78 };
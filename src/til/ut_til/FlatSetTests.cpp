@@ -62,4 +62,70 @@ class FlatSetTests
         VERIFY_ARE_EQUAL(entry1, entry2);
         VERIFY_ARE_EQUAL(123u, entry2->value);
     }
+
+    TEST_METHOD(Erase)
+    {
+        til::linear_flat_set<Data, DataHashTrait> set;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            set.insert(i);
+        }
+
+        VERIFY_IS_FALSE(set.erase(1000));
+
+        // Erasing every other item results in lots of backward shifts within the clusters.
+        for (size_t i = 0; i < 1000; i += 2)
+        {
+            VERIFY_IS_TRUE(set.erase(i));
+        }
+        VERIFY_ARE_EQUAL(500u, set.size());
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            const auto entry = set.lookup(i);
+            if (i % 2)
+            {
+                VERIFY_IS_NOT_NULL(entry);
+                VERIFY_ARE_EQUAL(i, entry->value);
+            }
+            else
+            {
+                VERIFY_IS_NULL(entry);
+            }
+        }
+
+        // Erased items must not be found anymore, but they can be inserted again.
+        VERIFY_IS_FALSE(set.erase(0));
+        VERIFY_IS_TRUE(set.insert(0).second);
+        VERIFY_ARE_EQUAL(501u, set.size());
+    }
+
+    TEST_METHOD(Reserve)
+    {
+        til::linear_flat_set<Data, DataHashTrait> set;
+
+        set.reserve(100);
+        const auto capacity = set.container().size();
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(capacity, 200u);
+
+        // Reserving less than what we've already got is a no-op.
+        set.reserve(10);
+        VERIFY_ARE_EQUAL(capacity, set.container().size());
+
+        // Inserting up to the reserved amount of items must not grow the set.
+        for (size_t i = 0; i < 100; ++i)
+        {
+            set.insert(i);
+        }
+        VERIFY_ARE_EQUAL(capacity, set.container().size());
+
+        // Reserving more than that rehashes all existing items.
+        set.reserve(1000);
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(set.container().size(), 2000u);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            VERIFY_IS_NOT_NULL(set.lookup(i));
+        }
+    }
 };
@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+
+#include <til/mpsc.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    struct drop_indicator
+    {
+        explicit drop_indicator(int& counter) noexcept :
+            _counter(&counter) {}
+
+        drop_indicator(const drop_indicator&) = delete;
+        drop_indicator& operator=(const drop_indicator&) = delete;
+
+        drop_indicator(drop_indicator&& other) noexcept
+        {
+            _counter = std::exchange(other._counter, nullptr);
+        }
+
+        drop_indicator& operator=(drop_indicator&& other) noexcept
+        {
+            _counter = std::exchange(other._counter, nullptr);
+            return *this;
+        }
+
+        ~drop_indicator()
+        {
+            if (_counter)
+            {
+                ++*_counter;
+            }
+        }
+
+    private:
+        int* _counter = nullptr;
+    };
+
+    template<typename T>
+    void drop(T&& val)
+    {
+        auto _ = std::move(val);
+    }
+}
+
+class MPSCTests
+{
+    BEGIN_TEST_CLASS(MPSCTests)
+        TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:10") // 10s timeout
+    END_TEST_CLASS()
+
+    TEST_METHOD(SmokeTest);
+    TEST_METHOD(NonBlockingTest);
+    TEST_METHOD(DropTest);
+    TEST_METHOD(DropProducerCopiesTest);
+    TEST_METHOD(DropConsumerTest);
+    TEST_METHOD(IntegrationTest);
+};
+
+void MPSCTests::SmokeTest()
+{
+    // This test mostly ensures that the API wasn't broken.
+
+    // construction
+    auto [tx, rx] = til::mpsc::channel<int>(32);
+    std::array<int, 3> data{};
+
+    // copy constructor and copy assignment operator
+    auto tx2(tx);
+    tx2 = tx;
+
+    // move constructor
+    auto tx3(std::move(tx2));
+    auto rx2(std::move(rx));
+
+    // move assignment operator
+    tx2 = std::move(tx3);
+    rx = std::move(rx2);
+
+    // push
+    tx.emplace(0);
+    tx.push(data.begin(), data.end());
+    tx.push(til::mpsc::block_initially, data.begin(), data.end());
+    tx.push(til::mpsc::block_forever, data.begin(), data.end());
+    tx2.push_n(data.begin(), data.size());
+    tx2.push_n(til::mpsc::block_initially, data.begin(), data.size());
+    tx2.push_n(til::mpsc::block_forever, data.begin(), data.size());
+
+    // pop
+    auto x = rx.pop();
+    rx.pop_n(til::mpsc::block_initially, data.begin(), data.size());
+    rx.pop_n(til::mpsc::block_forever, data.begin(), data.size());
+}
+
+void MPSCTests::NonBlockingTest()
+{
+    // The capacity is rounded up to 4.
+    auto [tx, rx] = til::mpsc::channel<int>(3);
+    std::array<int, 6> data{ 0, 1, 2, 3, 4, 5 };
+
+    // block_initially only blocks until the first item has been written.
+    // The remaining ones are written as long as there's space.
+    const auto pushed = tx.push(til::mpsc::block_initially, data.begin(), data.end());
+    VERIFY_ARE_EQUAL(4u, pushed.first);
+    VERIFY_IS_TRUE(pushed.second);
+
+    std::array<int, 6> actual{};
+    const auto popped = rx.pop_n(til::mpsc::block_initially, actual.begin(), actual.size());
+    VERIFY_ARE_EQUAL(4u, popped.first);
+    VERIFY_IS_TRUE(popped.second);
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        VERIFY_ARE_EQUAL(i, til::at(actual, i));
+    }
+}
+
+void MPSCTests::DropTest()
+{
+    auto [tx, rx] = til::mpsc::channel<drop_indicator>(4);
+    auto counter = 0;
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        tx.emplace(counter);
+    }
+    VERIFY_ARE_EQUAL(counter, 0);
+
+    for (auto i = 0; i < 2; ++i)
+    {
+        rx.pop();
+    }
+    VERIFY_ARE_EQUAL(counter, 2);
+
+    // This wraps around the end of the ring buffer.
+    for (auto i = 0; i < 3; ++i)
+    {
+        tx.emplace(counter);
+    }
+    VERIFY_ARE_EQUAL(counter, 2);
+
+    drop(tx);
+    VERIFY_ARE_EQUAL(counter, 2);
+
+    rx.pop();
+    VERIFY_ARE_EQUAL(counter, 3);
+
+    // The arc<T> destructor must destroy the remaining 3 items.
+    drop(rx);
+    VERIFY_ARE_EQUAL(counter, 6);
+}
+
+void MPSCTests::DropProducerCopiesTest()
+{
+    auto [tx, rx] = til::mpsc::channel<int>(4);
+    auto tx2 = tx;
+
+    tx.emplace(1);
+    drop(tx);
+
+    // tx2 is still alive and so the consumer must not stop yet.
+    tx2.emplace(2);
+    VERIFY_ARE_EQUAL(1, rx.pop());
+    VERIFY_ARE_EQUAL(2, rx.pop());
+
+    std::array<int, 1> data{};
+    const auto popped = rx.pop_n(til::mpsc::block_initially, data.begin(), 0);
+    VERIFY_IS_TRUE(popped.second);
+
+    drop(tx2);
+    VERIFY_IS_FALSE(rx.pop().has_value());
+}
+
+void MPSCTests::DropConsumerTest()
+{
+    auto [tx, rx] = til::mpsc::channel<int>(2);
+
+    // The producer will block once the channel is full.
+    // Dropping the consumer must unblock it.
+    std::thread t([tx = std::move(tx)]() {
+        for (auto i = 0; tx.emplace(i); ++i)
+        {
+        }
+    });
+
+    VERIFY_ARE_EQUAL(0, rx.pop());
+    drop(rx);
+
+    t.join();
+}
+
+void MPSCTests::IntegrationTest()
+{
+    static constexpr auto producerCount = 4;
+    static constexpr auto itemCount = 1000;
+
+    auto [tx, rx] = til::mpsc::channel<int>(7);
+    std::vector<std::thread> threads;
+
+    for (auto p = 0; p < producerCount; ++p)
+    {
+        threads.emplace_back([tx, p]() {
+            std::array<int, 10> buffer{};
+
+            for (auto i = 0; i < itemCount; i += 10)
+            {
+                std::ranges::generate(buffer, [v = p * itemCount + i]() mutable { return v++; });
+                tx.push(buffer.begin(), buffer.end());
+            }
+        });
+    }
+
+    // The consumer only stops once all copies of the producer are gone.
+    drop(tx);
+
+    // Items of different producers may be interleaved, but
+    // the items of each individual producer must be in order.
+    std::array<int, producerCount> next{};
+    auto total = 0;
+
+    while (const auto item = rx.pop())
+    {
+        const auto p = *item / itemCount;
+        VERIFY_ARE_EQUAL(p * itemCount + til::at(next, p), *item);
+        ++til::at(next, p);
+        ++total;
+    }
+
+    VERIFY_ARE_EQUAL(producerCount * itemCount, total);
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
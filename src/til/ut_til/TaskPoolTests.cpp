@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/latch.h"
+#include "til/task_pool.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TaskPoolTests
+{
+    BEGIN_TEST_CLASS(TaskPoolTests)
+        TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:10") // 10s timeout
+    END_TEST_CLASS()
+
+    TEST_METHOD(Basic)
+    {
+        til::task_group group;
+        std::atomic<int> counter{ 0 };
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            group.run([&]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        group.wait();
+        VERIFY_ARE_EQUAL(100, counter.load());
+    }
+
+    TEST_METHOD(Cancel)
+    {
+        // A pool with a single thread, which we block with the first task.
+        // This ensures that the remaining tasks are still queued when we cancel the group.
+        til::task_pool pool{ 1 };
+        til::task_group group{ pool };
+        til::latch started{ 1 };
+        std::atomic<int> counter{ 0 };
+
+        group.run([&](std::stop_token token) {
+            started.count_down();
+            while (!token.stop_requested())
+            {
+                Sleep(1);
+            }
+        });
+        for (auto i = 0; i < 10; ++i)
+        {
+            group.run([&]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        started.wait();
+        group.cancel();
+        group.wait();
+        VERIFY_ARE_EQUAL(0, counter.load());
+
+        // Tasks that are added after cancellation are ignored.
+        group.run([&]() {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        });
+        group.wait();
+        VERIFY_ARE_EQUAL(0, counter.load());
+    }
+
+    TEST_METHOD(Exception)
+    {
+        til::task_group group;
+
+        group.run([]() {
+            throw std::runtime_error{ "test" };
+        });
+
+        VERIFY_THROWS(group.wait(), std::runtime_error);
+
+        // The exception is only rethrown once.
+        group.wait();
+    }
+
+    TEST_METHOD(ParallelFor)
+    {
+        static constexpr size_t count = 10000;
+        std::vector<int> values(count);
+
+        til::parallel_for(count, 100, [&](size_t beg, size_t end) {
+            for (auto i = beg; i < end; ++i)
+            {
+                values[i] += 1;
+            }
+        });
+
+        // Every item must have been visited exactly once.
+        VERIFY_ARE_EQUAL(count, static_cast<size_t>(std::ranges::count(values, 1)));
+    }
+};
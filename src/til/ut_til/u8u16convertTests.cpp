@@ -17,6 +17,8 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestU8ToU16LongAscii);
+    TEST_METHOD(TestU16ToU8LongAscii);
 };
 
 void Utf8Utf16ConvertTests::TestU8ToU16()
@@ -191,3 +193,43 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestU8ToU16LongAscii()
+{
+    // The leading ASCII characters are converted in blocks of 16. This ensures we
+    // correctly continue with non-ASCII characters in and after the first block.
+    const std::string u8String1{ "0123456789abcdefghij\xC3\xB6klmnopqrstuvwxyz0123456789\xE2\x82" };
+    const std::string u8String2{ "\xAC" };
+    const std::wstring u16StringComp1{ L"0123456789abcdefghij\u00f6klmnopqrstuvwxyz0123456789" };
+    const std::wstring u16StringComp2{ L"\u20ac" };
+
+    std::wstring u16Out{};
+    VERIFY_SUCCEEDED(til::u8u16(u8String1.substr(0, 32), u16Out));
+    VERIFY_ARE_EQUAL(u16StringComp1.substr(0, 31), u16Out);
+
+    til::u8state state{};
+    VERIFY_SUCCEEDED(til::u8u16(u8String1, u16Out, state));
+    VERIFY_ARE_EQUAL(u16StringComp1, u16Out);
+    VERIFY_SUCCEEDED(til::u8u16(u8String2, u16Out, state));
+    VERIFY_ARE_EQUAL(u16StringComp2, u16Out);
+}
+
+void Utf8Utf16ConvertTests::TestU16ToU8LongAscii()
+{
+    // Same as TestU8ToU16LongAscii, but in reverse. Surrogates in particular must not be
+    // mistaken for ASCII, as the SIMD comparison would if it treated them as signed.
+    const std::wstring u16String1{ L"0123456789abcdefghij\xD83D\xDE00klmnopqrstuvwxyz0123456789\xD83D" };
+    const std::wstring u16String2{ L"\xDE00" };
+    const std::string u8StringComp1{ "0123456789abcdefghij\xF0\x9F\x98\x80klmnopqrstuvwxyz0123456789" };
+    const std::string u8StringComp2{ "\xF0\x9F\x98\x80" };
+
+    std::string u8Out{};
+    VERIFY_SUCCEEDED(til::u16u8(u16String1.substr(0, 48), u8Out));
+    VERIFY_ARE_EQUAL(u8StringComp1, u8Out);
+
+    til::u16state state{};
+    VERIFY_SUCCEEDED(til::u16u8(u16String1, u8Out, state));
+    VERIFY_ARE_EQUAL(u8StringComp1, u8Out);
+    VERIFY_SUCCEEDED(til::u16u8(u16String2, u8Out, state));
+    VERIFY_ARE_EQUAL(u8StringComp2, u8Out);
+}
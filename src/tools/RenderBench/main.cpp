@@ -0,0 +1,536 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// RenderBench drives the Renderer and AtlasEngine against an offscreen swap chain
+// for a number of typical workloads and reports the per-frame timings recorded by
+// Renderer::GetFrameStatistics(). It complements VtBench, which stops at the TextBuffer.
+//
+// Usage: RenderBench.exe
+//
+// Each scenario is run against the Direct3D 11 backend on the default adapter and on WARP,
+// as well as against the Direct2D backend. All numbers are CPU-side wall clock times.
+// They include the time the CPU waits on the GPU (for instance inside Present()),
+// but the GPU's own execution time isn't measured separately.
+
+#include "precomp.h"
+
+#include <cstdio>
+#include <random>
+
+#include <DefaultSettings.h>
+
+#include "../../renderer/atlas/AtlasEngine.h"
+#include "../../renderer/base/renderer.hpp"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Render::Atlas;
+using namespace Microsoft::Console::Types;
+
+static constexpr til::CoordType viewportWidth = 120;
+static constexpr til::CoordType viewportHeight = 30;
+static constexpr til::CoordType scrollbackHeight = 1000;
+
+static constexpr size_t warmupFrames = 30;
+static constexpr size_t measuredFrames = 300;
+
+// The bare minimum of IRenderData around an active TextBuffer. The Renderer has no
+// RenderThread, so that each frame is painted synchronously by calling PaintFrame().
+class BenchRenderData final : public IRenderData
+{
+public:
+    BenchRenderData() :
+        _renderer{ _renderSettings, this, nullptr, 0, nullptr },
+        _textBuffer{ { viewportWidth, viewportHeight + scrollbackHeight }, TextAttribute{}, 25, true, _renderer }
+    {
+    }
+
+    Renderer& GetRenderer() noexcept
+    {
+        return _renderer;
+    }
+
+    void SetFontInfo(const FontInfo& fontInfo)
+    {
+        _fontInfo = fontInfo;
+    }
+
+    void SetViewportTop(const til::CoordType top) noexcept
+    {
+        _viewportTop = top;
+    }
+
+    til::CoordType GetViewportTop() const noexcept
+    {
+        return _viewportTop;
+    }
+
+    void SetSelection(const til::point start, const til::point end) noexcept
+    {
+        _selectionStart = start;
+        _selectionEnd = end;
+        _selectionActive = true;
+    }
+
+    Viewport GetViewport() noexcept override
+    {
+        return Viewport::FromDimensions({ 0, _viewportTop }, { viewportWidth, viewportHeight });
+    }
+
+    til::point GetTextBufferEndPosition() const noexcept override
+    {
+        return { viewportWidth - 1, _textBuffer.GetSize().BottomInclusive() };
+    }
+
+    TextBuffer& GetTextBuffer() const noexcept override
+    {
+        return _textBuffer;
+    }
+
+    const FontInfo& GetFontInfo() const noexcept override
+    {
+        return _fontInfo;
+    }
+
+    std::vector<Viewport> GetSelectionRects() noexcept override
+    try
+    {
+        std::vector<Viewport> result;
+
+        if (!_selectionActive)
+        {
+            return result;
+        }
+
+        const auto rects = _textBuffer.GetTextRects(_selectionStart, _selectionEnd, false, false, _viewportTop, _viewportTop + viewportHeight - 1);
+        result.reserve(rects.size());
+
+        for (const auto& lineRect : rects)
+        {
+            result.emplace_back(Viewport::FromInclusive(lineRect));
+        }
+
+        return result;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return {};
+    }
+
+    std::span<const til::point_span> GetSearchHighlights() const noexcept override
+    {
+        return {};
+    }
+
+    const til::point_span* GetSearchHighlightFocused() const noexcept override
+    {
+        return nullptr;
+    }
+
+    // Everything runs on a single thread.
+    void LockConsole() noexcept override
+    {
+    }
+
+    void UnlockConsole() noexcept override
+    {
+    }
+
+    til::point GetCursorPosition() const noexcept override
+    {
+        return _textBuffer.GetCursor().GetPosition();
+    }
+
+    bool IsCursorVisible() const noexcept override
+    {
+        return _textBuffer.GetCursor().IsVisible();
+    }
+
+    bool IsCursorOn() const noexcept override
+    {
+        return _textBuffer.GetCursor().IsOn();
+    }
+
+    ULONG GetCursorHeight() const noexcept override
+    {
+        return _textBuffer.GetCursor().GetSize();
+    }
+
+    CursorType GetCursorStyle() const noexcept override
+    {
+        return _textBuffer.GetCursor().GetType();
+    }
+
+    ULONG GetCursorPixelWidth() const noexcept override
+    {
+        return 1;
+    }
+
+    bool IsCursorDoubleWidth() const override
+    {
+        const auto position = _textBuffer.GetCursor().GetPosition();
+        return _textBuffer.GetRowByOffset(position.y).DbcsAttrAt(position.x) != DbcsAttribute::Single;
+    }
+
+    const bool IsGridLineDrawingAllowed() noexcept override
+    {
+        return true;
+    }
+
+    const std::wstring_view GetConsoleTitle() const noexcept override
+    {
+        return L"RenderBench";
+    }
+
+    const std::wstring GetHyperlinkUri(uint16_t id) const override
+    {
+        return _textBuffer.GetHyperlinkUriFromId(id);
+    }
+
+    const std::wstring GetHyperlinkCustomId(uint16_t id) const override
+    {
+        return _textBuffer.GetCustomIdFromId(id);
+    }
+
+    const std::vector<size_t> GetPatternId(const til::point /*location*/) const override
+    {
+        return {};
+    }
+
+    std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override
+    {
+        return _renderSettings.GetAttributeColors(attr);
+    }
+
+    const bool IsSelectionActive() const override
+    {
+        return _selectionActive;
+    }
+
+    const bool IsBlockSelection() const override
+    {
+        return false;
+    }
+
+    void ClearSelection() override
+    {
+        _selectionActive = false;
+    }
+
+    void SelectNewRegion(const til::point coordStart, const til::point coordEnd) override
+    {
+        SetSelection(coordStart, coordEnd);
+    }
+
+    const til::point GetSelectionAnchor() const noexcept override
+    {
+        return _selectionStart;
+    }
+
+    const til::point GetSelectionEnd() const noexcept override
+    {
+        return _selectionEnd;
+    }
+
+    const bool IsUiaDataInitialized() const noexcept override
+    {
+        return true;
+    }
+
+private:
+    RenderSettings _renderSettings;
+    Renderer _renderer;
+    mutable TextBuffer _textBuffer;
+    FontInfo _fontInfo{ DEFAULT_FONT_FACE, 0, DEFAULT_FONT_WEIGHT, { 0, DEFAULT_FONT_SIZE }, CP_UTF8, false };
+    til::CoordType _viewportTop = scrollbackHeight;
+    til::point _selectionStart;
+    til::point _selectionEnd;
+    bool _selectionActive = false;
+};
+
+struct Backend
+{
+    const char* name;
+    GraphicsAPI graphicsAPI;
+    bool softwareRendering;
+};
+
+static constexpr Backend backends[]{
+    { "d3d11", GraphicsAPI::Direct3D11, false },
+    { "d3d11-warp", GraphicsAPI::Direct3D11, true },
+    { "d2d", GraphicsAPI::Direct2D, false },
+};
+
+enum class Content
+{
+    Ascii,
+    Ligatures,
+    Emoji,
+};
+
+struct Scenario
+{
+    const char* name;
+    const wchar_t* fontFace;
+    Content content;
+    // Called before each frame to make the modification that's being measured.
+    void (*step)(BenchRenderData& data, std::mt19937& rng, size_t frame);
+};
+
+static constexpr std::wstring_view ligatures[]{
+    L"=>", L"!=", L"===", L"->", L"<=", L">=", L"&&", L"||", L"::", L"/*", L"*/", L"<!--", L"-->", L"|>", L"<$>", L"www",
+};
+
+static constexpr std::wstring_view emoji[]{
+    L"\U0001F600", L"\U0001F680", L"\U0001F4A9", L"\U0001F389", L"\U0001F308", L"\U0001F9EA", L"\u2764\uFE0F", L"\U0001F44D\U0001F3FD",
+};
+
+static void appendAsciiWord(std::wstring& str, std::mt19937& rng, const size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        str.push_back(static_cast<wchar_t>(L'a' + rng() % 26));
+    }
+}
+
+// Fills the given row with words of random colors, similar to the output of a syntax highlighter.
+static void writeLine(TextBuffer& textBuffer, const til::CoordType row, const Content content, std::mt19937& rng)
+{
+    std::wstring word;
+    til::CoordType column = 0;
+    const auto lineWidth = static_cast<til::CoordType>(viewportWidth / 2 + rng() % (viewportWidth / 2));
+
+    while (column < lineWidth)
+    {
+        word.clear();
+
+        switch (content)
+        {
+        case Content::Ligatures:
+            if (rng() % 2)
+            {
+                word.append(ligatures[rng() % std::size(ligatures)]);
+                break;
+            }
+            appendAsciiWord(word, rng, 1 + rng() % 8);
+            break;
+        case Content::Emoji:
+            if (rng() % 2)
+            {
+                word.append(emoji[rng() % std::size(emoji)]);
+                break;
+            }
+            appendAsciiWord(word, rng, 1 + rng() % 8);
+            break;
+        default:
+            appendAsciiWord(word, rng, 1 + rng() % 8);
+            break;
+        }
+
+        word.push_back(L' ');
+
+        TextAttribute attributes;
+        attributes.SetIndexedForeground256(static_cast<BYTE>(rng() % 256));
+
+        RowWriteState state{
+            .text = word,
+            .columnBegin = column,
+            .columnLimit = viewportWidth,
+        };
+        textBuffer.Replace(row, attributes, state);
+        column = state.columnEnd;
+
+        if (!state.text.empty())
+        {
+            break;
+        }
+    }
+}
+
+// Repaints the entire viewport, like after a resize or a change of the color scheme.
+static void stepRedrawAll(BenchRenderData& data, std::mt19937& /*rng*/, size_t /*frame*/)
+{
+    data.GetRenderer().TriggerRedrawAll();
+}
+
+// Prints one new line at the bottom of the viewport, which scrolls everything else up.
+static void stepAppendLine(BenchRenderData& data, std::mt19937& rng, size_t /*frame*/)
+{
+    auto& textBuffer = data.GetTextBuffer();
+    textBuffer.IncrementCircularBuffer();
+    writeLine(textBuffer, textBuffer.GetSize().BottomInclusive(), Content::Ascii, rng);
+    textBuffer.TriggerScroll({ 0, -1 });
+}
+
+// Scrolls through the history one row at a time, like when a user drags the scrollbar.
+static void stepScrollback(BenchRenderData& data, std::mt19937& /*rng*/, size_t frame)
+{
+    // Bounce back and forth between the top and bottom of the buffer, so that each frame scrolls by exactly 1 row.
+    const auto period = static_cast<size_t>(scrollbackHeight) * 2;
+    const auto position = static_cast<til::CoordType>(frame % period);
+    data.SetViewportTop(position < scrollbackHeight ? scrollbackHeight - position : position - scrollbackHeight);
+}
+
+// Extends the selection by one cell per frame, like when a user drags the mouse across the viewport.
+static void stepSelection(BenchRenderData& data, std::mt19937& /*rng*/, size_t frame)
+{
+    const auto top = data.GetViewportTop();
+    const auto cells = static_cast<til::CoordType>(frame % (viewportWidth * (viewportHeight - 4)));
+    data.SetSelection({ 10, top + 2 }, { cells % viewportWidth, top + 2 + cells / viewportWidth });
+    data.GetRenderer().TriggerSelection();
+}
+
+// Toggles the cursor, which should only invalidate a single cell.
+static void stepCursorBlink(BenchRenderData& data, std::mt19937& /*rng*/, size_t /*frame*/)
+{
+    auto& cursor = data.GetTextBuffer().GetCursor();
+    cursor.SetIsOn(!cursor.IsOn());
+}
+
+static constexpr Scenario scenarios[]{
+    { "redraw-all", L"Cascadia Mono", Content::Ascii, stepRedrawAll },
+    { "append-line", L"Cascadia Mono", Content::Ascii, stepAppendLine },
+    { "scrollback", L"Cascadia Mono", Content::Ascii, stepScrollback },
+    { "selection", L"Cascadia Mono", Content::Ascii, stepSelection },
+    { "cursor-blink", L"Cascadia Mono", Content::Ascii, stepCursorBlink },
+    { "ligatures", L"Cascadia Code", Content::Ligatures, stepRedrawAll },
+    { "emoji", L"Cascadia Mono", Content::Emoji, stepRedrawAll },
+};
+
+struct Percentiles
+{
+    uint32_t p50 = 0;
+    uint32_t p95 = 0;
+};
+
+static Percentiles percentiles(std::vector<uint32_t>& samples)
+{
+    if (samples.empty())
+    {
+        return {};
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return {
+        .p50 = samples[samples.size() / 2],
+        .p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)],
+    };
+}
+
+static void benchmark(const Backend& backend, const Scenario& scenario)
+{
+    // The engine must outlive the Renderer which refers to it.
+    AtlasEngine engine;
+    BenchRenderData data;
+    auto& renderer = data.GetRenderer();
+    std::mt19937 rng{ 0 };
+
+    engine.SetGraphicsAPI(backend.graphicsAPI);
+    engine.SetSoftwareRendering(backend.softwareRendering);
+    engine.SetSelectionBackground(RGB(0x44, 0x88, 0xcc));
+    renderer.AddRenderEngine(&engine);
+
+    FontInfoDesired fontInfoDesired{ scenario.fontFace, 0, DEFAULT_FONT_WEIGHT, static_cast<float>(DEFAULT_FONT_SIZE), CP_UTF8 };
+    FontInfo fontInfo{ scenario.fontFace, 0, DEFAULT_FONT_WEIGHT, fontInfoDesired.GetEngineSize(), CP_UTF8, false };
+    THROW_IF_FAILED(engine.UpdateDpi(USER_DEFAULT_SCREEN_DPI));
+    THROW_IF_FAILED(engine.UpdateFont(fontInfoDesired, fontInfo));
+    data.SetFontInfo(fontInfo);
+
+    const auto cellSize = fontInfo.GetSize();
+    THROW_IF_FAILED(engine.SetWindowSize({ cellSize.width * viewportWidth, cellSize.height * viewportHeight }));
+
+    auto& textBuffer = data.GetTextBuffer();
+    for (til::CoordType y = 0; y < textBuffer.GetSize().Height(); ++y)
+    {
+        writeLine(textBuffer, y, scenario.content, rng);
+    }
+    textBuffer.GetCursor().SetPosition({ 0, textBuffer.GetSize().BottomInclusive() });
+
+    renderer.EnablePainting();
+
+    std::vector<uint32_t> lockHoldTimes;
+    std::vector<uint32_t> presentTimes;
+    std::vector<uint32_t> frameTimes;
+    uint64_t rowsPainted = 0;
+
+    lockHoldTimes.reserve(measuredFrames);
+    presentTimes.reserve(measuredFrames);
+    frameTimes.reserve(measuredFrames);
+
+    for (size_t frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+    {
+        scenario.step(data, rng, frame);
+
+        // Like the RenderThread, wait for the swap chain to be ready before starting the frame.
+        // This isn't part of the measurement, as the RenderThread would be idle during that time.
+        renderer.WaitUntilCanRender();
+
+        const auto beg = std::chrono::steady_clock::now();
+        THROW_IF_FAILED(renderer.PaintFrame());
+        const auto end = std::chrono::steady_clock::now();
+
+        if (frame < warmupFrames)
+        {
+            continue;
+        }
+
+        const auto statistics = renderer.GetFrameStatistics();
+        if (statistics.empty())
+        {
+            continue;
+        }
+
+        const auto& last = statistics.back();
+        lockHoldTimes.emplace_back(last.lockHoldTime);
+        presentTimes.emplace_back(last.presentTime);
+        frameTimes.emplace_back(gsl::narrow_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - beg).count()));
+        rowsPainted += last.rowsPainted;
+    }
+
+    const auto paint = percentiles(lockHoldTimes);
+    const auto present = percentiles(presentTimes);
+    const auto total = percentiles(frameTimes);
+    const auto rows = frameTimes.empty() ? 0.0 : static_cast<double>(rowsPainted) / static_cast<double>(frameTimes.size());
+
+    printf("%-12s %-14s %8u %8u %8u %8u %8u %8u %8.1f\n", backend.name, scenario.name, paint.p50, paint.p95, present.p50, present.p95, total.p50, total.p95, rows);
+}
+
+int wmain(int /*argc*/, const wchar_t* /*argv*/[])
+try
+{
+    // Without a HWND the AtlasEngine creates its swap chain for a composition surface,
+    // which requires dcomp.dll to be loaded already. In Windows Terminal that's done by XAML.
+    THROW_LAST_ERROR_IF_NULL(LoadLibraryExW(L"dcomp.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32));
+
+    printf("%-12s %-14s %8s %8s %8s %8s %8s %8s %8s\n", "backend", "scenario", "paint50", "paint95", "pres50", "pres95", "total50", "total95", "rows");
+    printf("%-12s %-14s %8s %8s %8s %8s %8s %8s %8s\n", "", "", "[us]", "[us]", "[us]", "[us]", "[us]", "[us]", "/frame");
+
+    for (const auto& backend : backends)
+    {
+        for (const auto& scenario : scenarios)
+        {
+            try
+            {
+                benchmark(backend, scenario);
+            }
+            catch (...)
+            {
+                // A backend may be unavailable (e.g. no hardware adapter in a VM). Keep going with the others.
+                const auto hr = wil::ResultFromCaughtException();
+                printf("%-12s %-14s failed with 0x%08x\n", backend.name, scenario.name, static_cast<unsigned int>(hr));
+            }
+        }
+    }
+
+    return 0;
+}
+catch (const std::exception& e)
+{
+    fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
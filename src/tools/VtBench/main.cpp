@@ -0,0 +1,634 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// VtBench feeds VT output straight into StateMachine, AdaptDispatch and TextBuffer,
+// without a console window, pipe or renderer in between. Unlike ConsoleBench, whose
+// numbers include the entire console API roundtrip, this isolates the output hot path
+// and the results are stable enough to compare individual changes against each other.
+//
+// Usage: VtBench.exe [--save <file>] [--baseline <file>] [--threshold <percent>] [recording...]
+//
+// Without recordings a set of synthetic corpora is generated and measured.
+// Otherwise each given file is replayed as a recording of raw (UTF-8) VT output.
+// All throughput numbers are relative to the size of the UTF-8 input.
+//
+// --save writes the results to the given file, which can later be passed to --baseline.
+// With --baseline each result is printed with its delta to the baseline and the exit code
+// is 2 if any of them is slower by more than --threshold percent (default: 10%).
+// Since the numbers depend on the machine, baselines should only be compared on the machine they were recorded on.
+
+#include "precomp.h"
+
+#include <cstdio>
+#include <random>
+#include <sstream>
+
+#include "../../terminal/adapter/adaptDispatch.hpp"
+#include "../../terminal/adapter/termDispatch.hpp"
+#include "../../terminal/input/terminalInput.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::VirtualTerminal;
+
+static constexpr til::CoordType viewportWidth = 120;
+static constexpr til::CoordType viewportHeight = 30;
+// The default history size of Windows Terminal.
+static constexpr til::CoordType scrollbackHeight = 9001;
+// Output is fed in pieces, similar to how it arrives from a pipe.
+static constexpr size_t chunkSize = 128 * 1024;
+// The size of each synthetic corpus.
+static constexpr size_t corpusSize = 4 * 1024 * 1024;
+
+static constexpr auto minimumRunTime = std::chrono::seconds{ 1 };
+static constexpr size_t minimumIterations = 5;
+// The reflow stage resizes the buffer to this width, so that most rows need to be rewrapped.
+static constexpr til::CoordType reflowWidth = viewportWidth - 17;
+// Short enough to find many matches in the synthetic corpora.
+static constexpr std::wstring_view searchNeedle{ L"ab" };
+
+struct Corpus
+{
+    std::string name;
+    std::string utf8;
+    // The UTF-16 chunks as they're produced by the decode stage.
+    // They're what's passed to the StateMachine by the other stages.
+    std::vector<std::wstring> chunks;
+};
+
+// A dispatcher that does nothing, so that only the cost of the parser itself is measured.
+class NullDispatch final : public TermDispatch
+{
+public:
+    void Print(const wchar_t /*wchPrintable*/) override
+    {
+    }
+
+    void PrintString(const std::wstring_view /*string*/) override
+    {
+    }
+};
+
+// The bare minimum of a terminal around AdaptDispatch: A TextBuffer with
+// a viewport that follows the output, like it does in Windows Terminal.
+class BenchApi final : public ITerminalApi
+{
+public:
+    BenchApi() :
+        _textBuffer{ { viewportWidth, viewportHeight + scrollbackHeight }, TextAttribute{}, 0, false, _renderer }
+    {
+        auto dispatch = std::make_unique<AdaptDispatch>(*this, _renderer, _renderer._renderSettings, _terminalInput);
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        _stateMachine = std::make_unique<StateMachine>(std::move(engine));
+    }
+
+    void ReturnResponse(const std::wstring_view /*response*/) override
+    {
+    }
+
+    StateMachine& GetStateMachine() override
+    {
+        return *_stateMachine;
+    }
+
+    TextBuffer& GetTextBuffer() override
+    {
+        return _textBuffer;
+    }
+
+    til::rect GetViewport() const override
+    {
+        return _viewport;
+    }
+
+    void SetViewportPosition(const til::point position) override
+    {
+        _viewport = { position, til::size{ viewportWidth, viewportHeight } };
+    }
+
+    bool IsVtInputEnabled() const override
+    {
+        return false;
+    }
+
+    void SetTextAttributes(const TextAttribute& attrs) override
+    {
+        _textBuffer.SetCurrentAttributes(attrs);
+    }
+
+    void SetSystemMode(const Mode mode, const bool enabled) override
+    {
+        _systemMode.set(mode, enabled);
+    }
+
+    bool GetSystemMode(const Mode mode) const override
+    {
+        return _systemMode.test(mode);
+    }
+
+    void WarningBell() override
+    {
+    }
+
+    void SetWindowTitle(const std::wstring_view /*title*/) override
+    {
+    }
+
+    // TUIs are replayed into the main buffer. The cost of writing into either buffer is the same.
+    void UseAlternateScreenBuffer(const TextAttribute& /*attrs*/) override
+    {
+    }
+
+    void UseMainScreenBuffer() override
+    {
+    }
+
+    CursorType GetUserDefaultCursorStyle() const override
+    {
+        return CursorType::Legacy;
+    }
+
+    void ShowWindow(bool /*showOrHide*/) override
+    {
+    }
+
+    void SetConsoleOutputCP(const unsigned int /*codepage*/) override
+    {
+    }
+
+    unsigned int GetConsoleOutputCP() const override
+    {
+        return CP_UTF8;
+    }
+
+    void CopyToClipboard(const wil::zwstring_view /*content*/) override
+    {
+    }
+
+    void SetTaskbarProgress(const DispatchTypes::TaskbarState /*state*/, const size_t /*progress*/) override
+    {
+    }
+
+    void SetWorkingDirectory(const std::wstring_view /*uri*/) override
+    {
+    }
+
+    void PlayMidiNote(const int /*noteNumber*/, const int /*velocity*/, const std::chrono::microseconds /*duration*/) override
+    {
+    }
+
+    bool ResizeWindow(const til::CoordType /*width*/, const til::CoordType /*height*/) override
+    {
+        return false;
+    }
+
+    bool IsConsolePty() const override
+    {
+        return false;
+    }
+
+    void NotifyAccessibilityChange(const til::rect& /*changedRect*/) override
+    {
+    }
+
+    void NotifyBufferRotation(const int /*delta*/) override
+    {
+    }
+
+    void InvokeCompletions(std::wstring_view /*menuJson*/, unsigned int /*replaceLength*/) override
+    {
+    }
+
+private:
+    // The buffer is created as inactive, so that it doesn't call into the renderer, which has no IRenderData.
+    DummyRenderer _renderer;
+    TerminalInput _terminalInput;
+    TextBuffer _textBuffer;
+    std::unique_ptr<StateMachine> _stateMachine;
+    til::rect _viewport{ 0, 0, viewportWidth, viewportHeight };
+    til::enumset<Mode> _systemMode{ Mode::AutoWrap };
+};
+
+static void appendUtf8(std::string& str, const char32_t ch)
+{
+    if (ch < 0x80)
+    {
+        str.push_back(static_cast<char>(ch));
+    }
+    else if (ch < 0x800)
+    {
+        str.push_back(static_cast<char>(0xC0 | (ch >> 6)));
+        str.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+    }
+    else if (ch < 0x10000)
+    {
+        str.push_back(static_cast<char>(0xE0 | (ch >> 12)));
+        str.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+    }
+    else
+    {
+        str.push_back(static_cast<char>(0xF0 | (ch >> 18)));
+        str.push_back(static_cast<char>(0x80 | ((ch >> 12) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (ch & 0x3F)));
+    }
+}
+
+static void appendAsciiWord(std::string& str, std::mt19937& rng, const size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        str.push_back(static_cast<char>('a' + rng() % 26));
+    }
+}
+
+// Lines of printable ASCII, like the output of a compiler or `cat`.
+static std::string generateAscii()
+{
+    std::mt19937 rng{ 0 };
+    std::string str;
+    str.reserve(corpusSize + viewportWidth);
+
+    while (str.size() < corpusSize)
+    {
+        const auto length = rng() % viewportWidth;
+        for (size_t i = 0; i < length; ++i)
+        {
+            str.push_back(static_cast<char>(' ' + rng() % 95));
+        }
+        str.append("\r\n");
+    }
+
+    return str;
+}
+
+// Short words that each get their own colors, like the output of `ls --color` or a syntax highlighter.
+static std::string generateSgr()
+{
+    std::mt19937 rng{ 1 };
+    std::string str;
+    str.reserve(corpusSize + 4 * viewportWidth);
+
+    while (str.size() < corpusSize)
+    {
+        size_t column = 0;
+        while (column < viewportWidth - 16)
+        {
+            switch (rng() % 4)
+            {
+            case 0:
+                str.append(fmt::format(FMT_COMPILE("\x1b[38;5;{}m"), rng() % 256));
+                break;
+            case 1:
+                str.append(fmt::format(FMT_COMPILE("\x1b[1;{}m"), 31 + rng() % 7));
+                break;
+            case 2:
+                str.append(fmt::format(FMT_COMPILE("\x1b[4;38;2;{};{};{}m"), rng() % 256, rng() % 256, rng() % 256));
+                break;
+            default:
+                str.append(fmt::format(FMT_COMPILE("\x1b[0;48;2;{};{};{}m"), rng() % 256, rng() % 256, rng() % 256));
+                break;
+            }
+
+            const auto length = 1 + rng() % 8;
+            appendAsciiWord(str, rng, length);
+            str.push_back(' ');
+            column += length + 1;
+        }
+        str.append("\x1b[m\r\n");
+    }
+
+    return str;
+}
+
+// CJK ideographs (wide glyphs) interspersed with ASCII words.
+static std::string generateCjk()
+{
+    std::mt19937 rng{ 2 };
+    std::string str;
+    str.reserve(corpusSize + 4 * viewportWidth);
+
+    while (str.size() < corpusSize)
+    {
+        til::CoordType column = 0;
+        const auto lineWidth = static_cast<til::CoordType>(rng() % viewportWidth);
+        while (column < lineWidth - 1)
+        {
+            if (rng() % 4 == 0)
+            {
+                const auto length = 1 + rng() % 6;
+                appendAsciiWord(str, rng, length);
+                str.push_back(' ');
+                column += static_cast<til::CoordType>(length + 1);
+            }
+            else
+            {
+                appendUtf8(str, 0x4E00 + rng() % (0x9FFF - 0x4E00));
+                column += 2;
+            }
+        }
+        str.append("\r\n");
+    }
+
+    return str;
+}
+
+// A TUI like htop: Each frame repaints every row via absolute cursor positioning
+// and then updates a number of individual fields scattered across the screen.
+static std::string generateCursorAddressing()
+{
+    std::mt19937 rng{ 3 };
+    std::string str;
+    str.reserve(corpusSize + 64 * viewportWidth);
+
+    while (str.size() < corpusSize)
+    {
+        str.append("\x1b[H");
+
+        for (til::CoordType y = 1; y <= viewportHeight; ++y)
+        {
+            str.append(fmt::format(FMT_COMPILE("\x1b[{};1H\x1b[{}m"), y, y & 1 ? 7 : 0));
+            appendAsciiWord(str, rng, 8 + rng() % (viewportWidth - 8));
+            str.append("\x1b[m\x1b[K");
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto y = 1 + rng() % viewportHeight;
+            const auto x = 1 + rng() % (viewportWidth - 8);
+            str.append(fmt::format(FMT_COMPILE("\x1b[{};{}H\x1b[3{}m{:5}%"), y, x, 1 + rng() % 6, rng() % 1000));
+        }
+    }
+
+    return str;
+}
+
+// Lines containing OSC 8 hyperlinks, like the output of `ls --hyperlink` or a compiler with clickable diagnostics.
+static std::string generateHyperlinks()
+{
+    std::mt19937 rng{ 4 };
+    std::string str;
+    str.reserve(corpusSize + 4 * viewportWidth);
+
+    uint32_t id = 0;
+    while (str.size() < corpusSize)
+    {
+        appendAsciiWord(str, rng, 1 + rng() % 16);
+        str.append(fmt::format(FMT_COMPILE(" \x1b]8;;https://example.com/{}/{}\x1b\\"), id / 64, id));
+        appendAsciiWord(str, rng, 4 + rng() % 32);
+        str.append("\x1b]8;;\x1b\\ ");
+        appendAsciiWord(str, rng, rng() % 32);
+        str.append("\r\n");
+        ++id;
+    }
+
+    return str;
+}
+
+static std::string readFile(const wchar_t* path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    if (!file)
+    {
+        throw std::runtime_error{ "failed to open file" };
+    }
+    return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+static void decodeChunks(Corpus& corpus)
+{
+    til::u8state state;
+    std::wstring scratch;
+
+    corpus.chunks.clear();
+
+    for (size_t beg = 0; beg < corpus.utf8.size(); beg += chunkSize)
+    {
+        const auto chunk = std::string_view{ corpus.utf8 }.substr(beg, chunkSize);
+        THROW_IF_FAILED(til::u8u16(chunk, scratch, state));
+        corpus.chunks.emplace_back(scratch);
+    }
+}
+
+// Runs func repeatedly, for at least minimumRunTime and minimumIterations, and returns the median duration in seconds.
+template<typename T>
+static double measure(T&& func)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Warm up the caches and let the TextBuffer/StateMachine allocate their steady-state memory.
+    func();
+
+    std::vector<double> samples;
+    const auto deadline = clock::now() + minimumRunTime;
+
+    do
+    {
+        const auto beg = clock::now();
+        func();
+        const auto end = clock::now();
+        samples.emplace_back(std::chrono::duration<double>(end - beg).count());
+    } while (samples.size() < minimumIterations || clock::now() < deadline);
+
+    const auto mid = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), mid, samples.end());
+    return *mid;
+}
+
+// The results of a previous run, keyed by "<corpus>\t<stage>", in ns/byte.
+static std::unordered_map<std::string, double> s_baseline;
+// The results of this run in the order they were measured.
+static std::vector<std::pair<std::string, double>> s_results;
+static double s_threshold = 10.0;
+static bool s_regressed = false;
+
+static void loadBaseline(const wchar_t* path)
+{
+    std::istringstream stream{ readFile(path) };
+    std::string line;
+
+    // Each line is "<corpus>\t<stage>\t<ns/byte>". Corpus names are file names and may contain spaces.
+    while (std::getline(stream, line))
+    {
+        const auto tab = line.rfind('\t');
+        if (tab != std::string::npos)
+        {
+            s_baseline.insert_or_assign(line.substr(0, tab), std::stod(line.substr(tab + 1)));
+        }
+    }
+}
+
+static void saveResults(const wchar_t* path)
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+        throw std::runtime_error{ "failed to create file" };
+    }
+    for (const auto& [key, nsPerByte] : s_results)
+    {
+        file << key << '\t' << fmt::format(FMT_COMPILE("{:.4f}"), nsPerByte) << '\n';
+    }
+}
+
+static void report(const Corpus& corpus, const char* stage, const double seconds)
+{
+    const auto bytes = static_cast<double>(corpus.utf8.size());
+    const auto nsPerByte = seconds * 1e9 / bytes;
+    printf("%-20s %-8s %10.1f MB/s %8.2f ns/byte", corpus.name.c_str(), stage, bytes / seconds / 1e6, nsPerByte);
+
+    auto key = fmt::format(FMT_COMPILE("{}\t{}"), corpus.name, stage);
+
+    if (const auto it = s_baseline.find(key); it != s_baseline.end() && it->second > 0)
+    {
+        // Positive deltas mean that this run is slower than the baseline.
+        const auto delta = (nsPerByte / it->second - 1.0) * 100.0;
+        const auto regressed = delta > s_threshold;
+        s_regressed |= regressed;
+        printf(" %+7.1f%%%s", delta, regressed ? " REGRESSION" : "");
+    }
+
+    printf("\n");
+    s_results.emplace_back(std::move(key), nsPerByte);
+}
+
+static void benchmark(Corpus& corpus)
+{
+    {
+        const auto seconds = measure([&]() {
+            decodeChunks(corpus);
+        });
+        report(corpus, "decode", seconds);
+    }
+
+    {
+        StateMachine stateMachine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<NullDispatch>()) };
+        const auto seconds = measure([&]() {
+            for (const auto& chunk : corpus.chunks)
+            {
+                stateMachine.ProcessString(chunk);
+            }
+        });
+        report(corpus, "parse", seconds);
+    }
+
+    BenchApi api;
+    auto& stateMachine = api.GetStateMachine();
+    auto& textBuffer = api.GetTextBuffer();
+    const auto feed = [&]() {
+        for (const auto& chunk : corpus.chunks)
+        {
+            stateMachine.ProcessString(chunk);
+        }
+    };
+
+    {
+        const auto seconds = measure(feed);
+        report(corpus, "buffer", seconds);
+    }
+
+    // The same as "buffer", but the buffer's memory gets decommitted before each iteration,
+    // like it happens when clearing the scrollback. This measures the cost of (re)committing rows.
+    {
+        const auto seconds = measure([&]() {
+            textBuffer.Reset();
+            feed();
+        });
+        report(corpus, "recommit", seconds);
+    }
+
+    // At this point the buffer is full, including its scrollback.
+    {
+        const auto seconds = measure([&]() {
+            DummyRenderer renderer;
+            TextBuffer newBuffer{ { reflowWidth, textBuffer.GetSize().Height() }, TextAttribute{}, 0, false, renderer };
+            TextBuffer::Reflow(textBuffer, newBuffer);
+        });
+        report(corpus, "reflow", seconds);
+    }
+
+    {
+        size_t matches = 0;
+        const auto seconds = measure([&]() {
+            matches = textBuffer.SearchText(searchNeedle, true).size();
+        });
+        report(corpus, "search", seconds);
+    }
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    std::vector<Corpus> corpora;
+    const wchar_t* savePath = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        const auto hasValue = i + 1 < argc;
+
+        if (arg == L"--save" && hasValue)
+        {
+            savePath = argv[++i];
+        }
+        else if (arg == L"--baseline" && hasValue)
+        {
+            loadBaseline(argv[++i]);
+        }
+        else if (arg == L"--threshold" && hasValue)
+        {
+            s_threshold = std::stod(argv[++i]);
+        }
+        else
+        {
+            auto& corpus = corpora.emplace_back();
+            corpus.name = til::u16u8(std::filesystem::path{ argv[i] }.filename().native());
+            corpus.utf8 = readFile(argv[i]);
+        }
+    }
+
+    if (corpora.empty())
+    {
+        corpora.emplace_back(Corpus{ .name = "ascii", .utf8 = generateAscii() });
+        corpora.emplace_back(Corpus{ .name = "sgr", .utf8 = generateSgr() });
+        corpora.emplace_back(Corpus{ .name = "cjk", .utf8 = generateCjk() });
+        corpora.emplace_back(Corpus{ .name = "cursor-addressing", .utf8 = generateCursorAddressing() });
+        corpora.emplace_back(Corpus{ .name = "hyperlinks", .utf8 = generateHyperlinks() });
+    }
+
+    for (auto& corpus : corpora)
+    {
+        if (corpus.utf8.empty())
+        {
+            continue;
+        }
+
+        decodeChunks(corpus);
+        benchmark(corpus);
+    }
+
+    if (savePath)
+    {
+        saveResults(savePath);
+    }
+
+    if (s_regressed)
+    {
+        fprintf(stderr, "error: regressions beyond %.1f%% compared to the baseline\n", s_threshold);
+        return 2;
+    }
+
+    return 0;
+}
+catch (const std::exception& e)
+{
+    fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -325,8 +325,84 @@ enum class VtMode
     Color
 };
 
+enum class ReplayMode
+{
+    Off,
+    Fast,
+    Realtime,
+};
+
+// Must match DebugTapConnection::RecordingMagic in src/cascadia/TerminalApp.
+static constexpr char recording_magic[] = "WTVTREC1";
+static constexpr size_t recording_magic_size = sizeof(recording_magic) - 1;
+static constexpr size_t recording_header_size = sizeof(uint64_t) + sizeof(uint32_t);
+
+struct RecordingIterator
+{
+    const char* data;
+    const char* end;
+};
+
+struct Record
+{
+    uint64_t timestamp_us;
+    const char* data;
+    uint32_t size;
+};
+
+static bool is_recording(const char* data, size_t size) noexcept
+{
+    if (size < recording_magic_size)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < recording_magic_size; ++i)
+    {
+        if (data[i] != recording_magic[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns false once the end of the recording is reached. A truncated
+// trailing record, for instance if Windows Terminal crashed, is ignored.
+static bool recording_next(RecordingIterator& it, Record& record) noexcept
+{
+    if (static_cast<size_t>(it.end - it.data) < recording_header_size)
+    {
+        return false;
+    }
+
+    memcpy(&record.timestamp_us, it.data, sizeof(uint64_t));
+    memcpy(&record.size, it.data + sizeof(uint64_t), sizeof(uint32_t));
+
+    const auto payload = it.data + recording_header_size;
+    if (static_cast<size_t>(it.end - payload) < record.size)
+    {
+        return false;
+    }
+
+    record.data = payload;
+    it.data = payload + record.size;
+    return true;
+}
+
+enum class Transport
+{
+    Console,
+    Pipe,
+    Conpty,
+};
+
+// In the -pc mode we run a copy of ourselves inside a pseudoconsole. This environment
+// variable carries the handle of a pipe the child reports its results through.
+static constexpr wchar_t result_handle_variable[] = L"BENCHCAT_RESULT_HANDLE";
+
 static HANDLE g_stdout;
 static HANDLE g_stderr;
+static HANDLE g_result;
 static UINT g_console_cp_old;
 static DWORD g_console_mode_old;
 static size_t g_large_page_minimum;
@@ -408,6 +484,221 @@ static char* allocate(size_t size)
     print_last_error("allocate memory");
 }
 
+// The duration of each WriteFile() call in QPC ticks, for the latency percentiles.
+// If there are more chunks than fit, only the first ones are recorded.
+static LONGLONG* g_latencies;
+static size_t g_latencies_capacity;
+static size_t g_latencies_count;
+
+// The number of bytes read by drain_thread(). Only valid after the thread exited.
+static LONGLONG g_drained;
+
+static DWORD write_chunk(HANDLE out, const char* data, DWORD size) noexcept
+{
+    LARGE_INTEGER beg, end;
+    DWORD written = 0;
+
+    QueryPerformanceCounter(&beg);
+    if (!WriteFile(out, data, size, &written, nullptr))
+    {
+        print_last_error("write");
+    }
+    QueryPerformanceCounter(&end);
+
+    if (g_latencies_count < g_latencies_capacity)
+    {
+        g_latencies[g_latencies_count++] = end.QuadPart - beg.QuadPart;
+    }
+
+    return written;
+}
+
+// Returns the n-th smallest value (quickselect). Reorders the data.
+static LONGLONG select_nth(LONGLONG* data, size_t count, size_t n) noexcept
+{
+    size_t lo = 0;
+    size_t hi = count - 1;
+
+    while (lo < hi)
+    {
+        const auto pivot = data[lo + (hi - lo) / 2];
+        auto i = lo;
+        auto j = hi;
+
+        while (i <= j)
+        {
+            while (data[i] < pivot)
+            {
+                ++i;
+            }
+            while (data[j] > pivot)
+            {
+                --j;
+            }
+            if (i <= j)
+            {
+                const auto tmp = data[i];
+                data[i] = data[j];
+                data[j] = tmp;
+                ++i;
+                if (j == 0)
+                {
+                    break;
+                }
+                --j;
+            }
+        }
+
+        if (n <= j)
+        {
+            hi = j;
+        }
+        else if (n >= i)
+        {
+            lo = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return data[n];
+}
+
+static DWORD WINAPI drain_thread(LPVOID parameter)
+{
+    static char buffer[128 * 1024];
+    const auto pipe = static_cast<HANDLE>(parameter);
+    DWORD read = 0;
+
+    while (ReadFile(pipe, &buffer[0], sizeof(buffer), &read, nullptr) && read)
+    {
+        g_drained += read;
+    }
+
+    return 0;
+}
+
+// Runs a copy of ourselves inside a new pseudoconsole and drains its output, without any terminal
+// on the other side. This measures conhost and ConPTY without the cost of parsing and rendering in
+// Windows Terminal. The child reports its own statistics through an inherited pipe.
+[[noreturn]] static void run_conpty() noexcept
+{
+    COORD size{ 120, 30 };
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(g_stdout, &info))
+    {
+        size.X = static_cast<SHORT>(info.srWindow.Right - info.srWindow.Left + 1);
+        size.Y = static_cast<SHORT>(info.srWindow.Bottom - info.srWindow.Top + 1);
+    }
+
+    HANDLE in_read, in_write, out_read, out_write;
+    if (!CreatePipe(&in_read, &in_write, nullptr, 0) || !CreatePipe(&out_read, &out_write, nullptr, 0))
+    {
+        print_last_error("create pipe");
+    }
+
+    HPCON pseudo_console;
+    if (FAILED(CreatePseudoConsole(size, in_read, out_write, 0, &pseudo_console)))
+    {
+        eprintf("\r\nfailed to create pseudoconsole\r\n");
+    }
+
+    CloseHandle(in_read);
+    CloseHandle(out_write);
+
+    SECURITY_ATTRIBUTES sa{ sizeof(sa), nullptr, TRUE };
+    HANDLE result_read, result_write;
+    if (!CreatePipe(&result_read, &result_write, &sa, 0) || !SetHandleInformation(result_read, HANDLE_FLAG_INHERIT, 0))
+    {
+        print_last_error("create pipe");
+    }
+
+    {
+        // Handle values are guaranteed to fit into 32 bits.
+        wchar_t value[16];
+        wnsprintfW(&value[0], 16, L"%lu", static_cast<unsigned long>(reinterpret_cast<uintptr_t>(result_write)));
+        if (!SetEnvironmentVariableW(&result_handle_variable[0], &value[0]))
+        {
+            print_last_error("set environment variable");
+        }
+    }
+
+    STARTUPINFOEXW si{};
+    si.StartupInfo.cb = sizeof(si);
+
+    {
+        SIZE_T attribute_list_size = 0;
+        InitializeProcThreadAttributeList(nullptr, 2, 0, &attribute_list_size);
+        si.lpAttributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(allocate(attribute_list_size));
+
+        if (!InitializeProcThreadAttributeList(si.lpAttributeList, 2, 0, &attribute_list_size) ||
+            !UpdateProcThreadAttribute(si.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_PSEUDOCONSOLE, pseudo_console, sizeof(pseudo_console), nullptr, nullptr) ||
+            !UpdateProcThreadAttribute(si.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, &result_write, sizeof(result_write), nullptr, nullptr))
+        {
+            print_last_error("initialize attribute list");
+        }
+    }
+
+    // CreateProcessW() requires a mutable command line.
+    const auto command_line = GetCommandLineW();
+    const auto command_line_size = (static_cast<size_t>(lstrlenW(command_line)) + 1) * sizeof(wchar_t);
+    const auto command_line_copy = reinterpret_cast<wchar_t*>(allocate(command_line_size));
+    memcpy(command_line_copy, command_line, command_line_size);
+
+    const auto drain = CreateThread(nullptr, 0, drain_thread, out_read, 0, nullptr);
+    if (!drain)
+    {
+        print_last_error("create thread");
+    }
+
+    LARGE_INTEGER frequency, beg, end;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&beg);
+
+    PROCESS_INFORMATION pi;
+    if (!CreateProcessW(nullptr, command_line_copy, nullptr, nullptr, TRUE, EXTENDED_STARTUPINFO_PRESENT, nullptr, nullptr, &si.StartupInfo, &pi))
+    {
+        print_last_error("create process");
+    }
+
+    CloseHandle(result_write);
+    CloseHandle(pi.hThread);
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    QueryPerformanceCounter(&end);
+
+    DWORD exit_code = 1;
+    GetExitCodeProcess(pi.hProcess, &exit_code);
+
+    // Once conhost exits, the output pipe is broken and drain_thread() returns.
+    ClosePseudoConsole(pseudo_console);
+    WaitForSingleObject(drain, INFINITE);
+
+    char buffer[1024];
+    DWORD buffer_size = 0;
+    for (DWORD read = 0; buffer_size < sizeof(buffer) && ReadFile(result_read, &buffer[buffer_size], sizeof(buffer) - buffer_size, &read, nullptr) && read;)
+    {
+        buffer_size += read;
+    }
+
+    if (buffer_size)
+    {
+        WriteFile(g_stderr, &buffer[0], buffer_size, nullptr, nullptr);
+    }
+
+    const auto elapsed_ticks = max<LONGLONG>(1, end.QuadPart - beg.QuadPart);
+    const auto drained = format_size(g_drained);
+    const auto throughput = format_size((g_drained * frequency.QuadPart) / elapsed_ticks);
+    const auto length = format(&buffer[0], sizeof(buffer), "conpty output: " FORMAT_RESULT_FMT "B, " FORMAT_RESULT_FMT "B/s\r\n", FORMAT_RESULT_ARGS(drained), FORMAT_RESULT_ARGS(throughput));
+    if (length > 0)
+    {
+        WriteFile(g_stderr, &buffer[0], static_cast<DWORD>(length), nullptr, nullptr);
+    }
+
+    clean_exit(exit_code);
+}
+
 static BOOL WINAPI consoleCtrlHandler(DWORD)
 {
     CancelIoEx(g_stdout, nullptr);
@@ -427,6 +718,8 @@ int __stdcall main() noexcept
     uint32_t chunk_size = 128 * 1024;
     uint32_t repeat = 1;
     VtMode vt = VtMode::Off;
+    ReplayMode replay = ReplayMode::Off;
+    Transport transport = Transport::Console;
     uint64_t seed = 0;
     bool has_seed = false;
 
@@ -466,6 +759,30 @@ int __stdcall main() noexcept
                 seed = parse_number_with_suffix(suffix);
                 has_seed = true;
             }
+            else if (const auto suffix = split_prefix(argv[i], L"-p"))
+            {
+                transport = Transport::Pipe;
+                if (has_suffix(suffix, L"c"))
+                {
+                    transport = Transport::Conpty;
+                }
+                else if (*suffix)
+                {
+                    break;
+                }
+            }
+            else if (const auto suffix = split_prefix(argv[i], L"-t"))
+            {
+                replay = ReplayMode::Fast;
+                if (has_suffix(suffix, L"r"))
+                {
+                    replay = ReplayMode::Realtime;
+                }
+                else if (*suffix)
+                {
+                    break;
+                }
+            }
             else
             {
                 if (argc - i == 1)
@@ -487,10 +804,31 @@ int __stdcall main() noexcept
             "  -c{d}{u}  chunk size, defaults to 128Ki\r\n"
             "  -r{d}{u}  repeats, defaults to 1\r\n"
             "  -s{d}     RNG seed\r\n"
+            "  -t        replay a recording of the debug tap as fast as possible\r\n"
+            "  -tr       replay a recording with its original timing\r\n"
+            "            recordings are written in their original chunks, implying -v\r\n"
+            "            (set WT_DEBUGTAP_RECORDING=1 before launching WT to record)\r\n"
+            "  -p        write into a pipe instead of the console\r\n"
+            "  -pc       write into a new headless pseudoconsole\r\n"
             "{d} are base-10 digits\r\n"
             "{u} are suffix units k, Ki, M, Mi, G, Gi\r\n");
     }
 
+    {
+        wchar_t value[16];
+        if (GetEnvironmentVariableW(&result_handle_variable[0], &value[0], 16))
+        {
+            // We're the child of run_conpty().
+            g_result = reinterpret_cast<HANDLE>(static_cast<uintptr_t>(parse_number(&value[0], nullptr)));
+            transport = Transport::Console;
+        }
+    }
+
+    if (transport == Transport::Conpty)
+    {
+        run_conpty();
+    }
+
     if (!has_seed && vt == VtMode::Color)
     {
         const auto cryptbase = LoadLibraryExW(L"cryptbase.dll", nullptr, 0);
@@ -510,7 +848,7 @@ int __stdcall main() noexcept
 
     pcg_engines::oneseq_dxsm_64_32 rng{ seed };
 
-    const auto stdout = GetStdHandle(STD_OUTPUT_HANDLE);
+    auto stdout = GetStdHandle(STD_OUTPUT_HANDLE);
     const auto file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
     if (file == INVALID_HANDLE_VALUE)
     {
@@ -557,6 +895,25 @@ int __stdcall main() noexcept
         }
     }
 
+    if (replay != ReplayMode::Off)
+    {
+        if (!is_recording(file_data, file_size))
+        {
+            eprintf("\r\nnot a recording\r\n");
+        }
+
+        // The recording contains the VT output of ConPTY and can't be colorized/etc. by us.
+        vt = VtMode::On;
+        stdout_size = 0;
+
+        RecordingIterator it{ file_data + recording_magic_size, file_data + file_size };
+        Record record;
+        while (recording_next(it, record))
+        {
+            stdout_size += record.size;
+        }
+    }
+
     switch (vt)
     {
     case VtMode::Italic:
@@ -609,6 +966,7 @@ int __stdcall main() noexcept
         break;
     }
 
+    if (transport == Transport::Console)
     {
         DWORD mode = 0;
         if (!GetConsoleMode(g_stdout, &mode))
@@ -631,27 +989,119 @@ int __stdcall main() noexcept
         }
     }
 
+    HANDLE timer = nullptr;
+    if (replay == ReplayMode::Realtime)
+    {
+        timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer)
+        {
+            // CREATE_WAITABLE_TIMER_HIGH_RESOLUTION requires Windows 10 1803.
+            timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        }
+        if (!timer)
+        {
+            print_last_error("create timer");
+        }
+    }
+
+    HANDLE pipe_write = nullptr;
+    HANDLE drain = nullptr;
+    if (transport == Transport::Pipe)
+    {
+        HANDLE pipe_read;
+        if (!CreatePipe(&pipe_read, &pipe_write, nullptr, 0))
+        {
+            print_last_error("create pipe");
+        }
+
+        drain = CreateThread(nullptr, 0, drain_thread, pipe_read, 0, nullptr);
+        if (!drain)
+        {
+            print_last_error("create thread");
+        }
+
+        stdout = pipe_write;
+    }
+
+    {
+        size_t chunks = 0;
+        if (replay != ReplayMode::Off)
+        {
+            RecordingIterator it{ file_data + recording_magic_size, file_data + file_size };
+            Record record;
+            while (recording_next(it, record))
+            {
+                ++chunks;
+            }
+        }
+        else
+        {
+            chunks = (stdout_size + chunk_size - 1) / chunk_size;
+        }
+
+        // 16M chunks are plenty for stable percentiles and only take up 128MiB.
+        g_latencies_capacity = min<size_t>(max<size_t>(1, chunks * repeat), 16 * 1024 * 1024);
+        g_latencies = reinterpret_cast<LONGLONG*>(allocate(g_latencies_capacity * sizeof(LONGLONG)));
+    }
+
     LARGE_INTEGER frequency, beg, end;
     QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&beg);
 
     for (size_t iteration = 0; iteration < repeat; ++iteration)
     {
+        if (replay != ReplayMode::Off)
+        {
+            LARGE_INTEGER iteration_beg;
+            QueryPerformanceCounter(&iteration_beg);
+
+            RecordingIterator it{ file_data + recording_magic_size, file_data + file_size };
+            Record record;
+
+            while (recording_next(it, record))
+            {
+                if (timer)
+                {
+                    LARGE_INTEGER now;
+                    QueryPerformanceCounter(&now);
+
+                    const auto elapsed_us = static_cast<uint64_t>(((now.QuadPart - iteration_beg.QuadPart) * 1'000'000) / frequency.QuadPart);
+                    if (record.timestamp_us > elapsed_us)
+                    {
+                        // A negative due time is relative, in 100ns units.
+                        LARGE_INTEGER due;
+                        due.QuadPart = -static_cast<LONGLONG>((record.timestamp_us - elapsed_us) * 10);
+                        if (!SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE))
+                        {
+                            print_last_error("set timer");
+                        }
+                        WaitForSingleObject(timer, INFINITE);
+                    }
+                }
+
+                write_chunk(stdout, record.data, record.size);
+            }
+
+            continue;
+        }
+
         auto write_data = stdout_data;
         DWORD written = 0;
 
         for (auto remaining = stdout_size; remaining != 0; remaining -= written, write_data += written)
         {
-            written = static_cast<DWORD>(min<size_t>(remaining, chunk_size));
-            if (!WriteFile(stdout, write_data, written, &written, nullptr))
-            {
-                print_last_error("write");
-            }
+            written = write_chunk(stdout, write_data, static_cast<DWORD>(min<size_t>(remaining, chunk_size)));
         }
     }
 
     QueryPerformanceCounter(&end);
 
+    if (pipe_write)
+    {
+        CloseHandle(pipe_write);
+        WaitForSingleObject(drain, INFINITE);
+    }
+
     const auto elapsed_ticks = end.QuadPart - beg.QuadPart;
     const auto elapsed_us = (elapsed_ticks * 1'000'000) / frequency.QuadPart;
     LONGLONG total_size = static_cast<LONGLONG>(stdout_size) * repeat;
@@ -661,21 +1111,34 @@ int __stdcall main() noexcept
     const auto duration = format_duration(elapsed_us);
     const auto throughput = format_size(bytes_per_second);
 
-    char status[128];
+    LONGLONG p50_us = 0;
+    LONGLONG p99_us = 0;
+    if (g_latencies_count)
+    {
+        p50_us = (select_nth(g_latencies, g_latencies_count, g_latencies_count / 2) * 1'000'000) / frequency.QuadPart;
+        p99_us = (select_nth(g_latencies, g_latencies_count, g_latencies_count * 99 / 100) * 1'000'000) / frequency.QuadPart;
+    }
+
+    const auto p50 = format_duration(p50_us);
+    const auto p99 = format_duration(p99_us);
+
+    char status[256];
     const auto status_length = format(
         &status[0],
-        1024,
-        FORMAT_RESULT_FMT "B, " FORMAT_RESULT_FMT "s, " FORMAT_RESULT_FMT "B/s",
+        sizeof(status),
+        FORMAT_RESULT_FMT "B, " FORMAT_RESULT_FMT "s, " FORMAT_RESULT_FMT "B/s, chunk latency p50 " FORMAT_RESULT_FMT "s, p99 " FORMAT_RESULT_FMT "s",
         FORMAT_RESULT_ARGS(written),
         FORMAT_RESULT_ARGS(duration),
-        FORMAT_RESULT_ARGS(throughput));
+        FORMAT_RESULT_ARGS(throughput),
+        FORMAT_RESULT_ARGS(p50),
+        FORMAT_RESULT_ARGS(p99));
 
     if (status_length <= 0)
     {
         clean_exit(1);
     }
 
-    char buffer[256];
+    char buffer[2 * sizeof(status) + 8];
     char* buffer_end = &buffer[0];
 
     buffer_end = buffer_append_string(buffer_end, "\r\n");
@@ -687,6 +1150,6 @@ int __stdcall main() noexcept
     buffer_end = buffer_append_long(buffer_end, &status[0], static_cast<size_t>(status_length));
     buffer_end = buffer_append_string(buffer_end, "\r\n");
 
-    WriteFile(g_stderr, &buffer[0], static_cast<DWORD>(buffer_end - &buffer[0]), nullptr, nullptr);
+    WriteFile(g_result ? g_result : g_stderr, &buffer[0], static_cast<DWORD>(buffer_end - &buffer[0]), nullptr, nullptr);
     clean_exit(0);
 }
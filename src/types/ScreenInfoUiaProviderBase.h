@@ -49,6 +49,7 @@ namespace Microsoft::Console::Types
 
         [[nodiscard]] HRESULT Signal(_In_ EVENTID id);
         virtual void ChangeViewport(const til::inclusive_rect& NewWindow) = 0;
+        UiaTextValueCache& GetTextValueCache() noexcept { return _textValueCache; }
 
         // IRawElementProviderSimple methods
         IFACEMETHODIMP get_ProviderOptions(_Out_ ProviderOptions* pOptions) noexcept override;
@@ -122,6 +123,10 @@ namespace Microsoft::Console::Types
         // mechanism for multi-threaded code.
         std::unordered_map<EVENTID, bool> _signalFiringMapping{};
 
+        // Owned by the provider (and not shared process-wide), so that the cached
+        // text is released once the provider goes away and can't outlive its buffer.
+        UiaTextValueCache _textValueCache;
+
         til::size _getScreenBufferCoords() const noexcept;
         const TextBuffer& _getTextBuffer() const noexcept;
         Viewport _getViewport() const noexcept;
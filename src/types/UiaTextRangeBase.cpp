@@ -984,19 +984,36 @@ std::wstring UiaTextRangeBase::_getTextValue(til::CoordType maxLength) const
         // nvaccess/nvda#11428: Ensure our endpoints are in bounds
         THROW_HR_IF(E_FAIL, !bufferSize.IsInBounds(_start, true) || !bufferSize.IsInBounds(_end, true));
 
+        const auto mutationId = buffer.GetLastMutationId();
+        const auto scrollCount = buffer.GetScrollCount();
+        const gsl::not_null<ScreenInfoUiaProviderBase*> provider = static_cast<ScreenInfoUiaProviderBase*>(_pProvider);
+        auto& cache = provider->GetTextValueCache();
+        const std::lock_guard guard{ cache.lock };
+
         // convert _end to be inclusive
         auto inclusiveEnd = _end;
         bufferSize.DecrementInBounds(inclusiveEnd, true);
 
-        const auto req = TextBuffer::CopyRequest{ buffer, _start, inclusiveEnd, _blockRange, true, false, false, true };
-        auto plainText = buffer.GetPlainText(req);
+        const auto hit = cache.buffer == &buffer && cache.start == _start && cache.end == _end && cache.blockRange == _blockRange &&
+                         (cache.mutationId == mutationId ||
+                          // Output written below the range (for instance at the prompt) doesn't affect it.
+                          (cache.scrollCount == scrollCount &&
+                           buffer.CanTrackMutationsSince(cache.mutationId) &&
+                           buffer.GetFirstRowMutatedSince(cache.mutationId) > inclusiveEnd.y));
 
-        if (plainText.size() > maxLengthAsSize)
+        if (!hit)
         {
-            plainText.resize(maxLengthAsSize);
+            const auto req = TextBuffer::CopyRequest{ buffer, _start, inclusiveEnd, _blockRange, true, false, false, true };
+            cache.text = buffer.GetPlainText(req);
+            cache.buffer = &buffer;
+            cache.mutationId = mutationId;
+            cache.scrollCount = scrollCount;
+            cache.start = _start;
+            cache.end = _end;
+            cache.blockRange = _blockRange;
         }
 
-        textData = std::move(plainText);
+        textData.assign(cache.text, 0, std::min(cache.text.size(), maxLengthAsSize));
     }
 
     return textData;
@@ -30,6 +30,22 @@ class UiaTextRangeTests;
 
 namespace Microsoft::Console::Types
 {
+    // Automation clients tend to call GetText(-1) on the document range over and over,
+    // each time with a new range object. This caches the last text extracted by any range of a provider.
+    // The entry stays valid as long as none of the rows it covers were modified since, and the buffer didn't scroll.
+    // Ranges of the same provider may call this concurrently, hence the lock.
+    struct UiaTextValueCache
+    {
+        std::mutex lock;
+        const TextBuffer* buffer = nullptr;
+        uint64_t mutationId = 0;
+        uint64_t scrollCount = 0;
+        til::point start;
+        til::point end;
+        bool blockRange = false;
+        std::wstring text;
+    };
+
     class UiaTextRangeBase : public WRL::RuntimeClass<WRL::RuntimeClassFlags<WRL::ClassicCom | WRL::InhibitFtmBase>, ITextRangeProvider>, public IUiaTraceable
     {
     protected:
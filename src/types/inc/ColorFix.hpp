@@ -10,4 +10,5 @@
 namespace ColorFix
 {
     COLORREF GetPerceivableColor(COLORREF color, COLORREF reference, float minSquaredDistance) noexcept;
+    void GetPerceivableColors(std::span<COLORREF> colors, COLORREF reference, float minSquaredDistance) noexcept;
 }
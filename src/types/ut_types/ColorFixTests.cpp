@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../inc/ColorFix.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ColorFixTests
+{
+    TEST_CLASS(ColorFixTests);
+
+    TEST_METHOD(BatchedMatchesScalar)
+    {
+        // A 6x6x6 cube of colors plus one extra, so that the batched
+        // implementation also has to deal with a partial trailing chunk.
+        std::vector<COLORREF> colors;
+        for (auto r = 0; r < 256; r += 0x33)
+        {
+            for (auto g = 0; g < 256; g += 0x33)
+            {
+                for (auto b = 0; b < 256; b += 0x33)
+                {
+                    colors.emplace_back(RGB(r, g, b));
+                }
+            }
+        }
+        colors.emplace_back(RGB(0x0c, 0x0c, 0x0c));
+
+        static constexpr std::array references{
+            RGB(0x00, 0x00, 0x00),
+            RGB(0xff, 0xff, 0xff),
+            RGB(0x0c, 0x0c, 0x0c),
+            RGB(0x80, 0x80, 0x80),
+            RGB(0x33, 0x66, 0x99),
+            RGB(0xf2, 0xf2, 0xf2),
+        };
+        static constexpr std::array minSquaredDistances{ 0.25f * 0.25f, 0.5f * 0.5f };
+
+        for (const auto reference : references)
+        {
+            for (const auto minSquaredDistance : minSquaredDistances)
+            {
+                auto actual = colors;
+                ColorFix::GetPerceivableColors(actual, reference, minSquaredDistance);
+
+                for (size_t i = 0; i < colors.size(); ++i)
+                {
+                    const auto expected = ColorFix::GetPerceivableColor(colors[i], reference, minSquaredDistance);
+                    if (actual[i] != expected)
+                    {
+                        Log::Comment(NoThrowString().Format(L"color #%06x, reference #%06x, distance %f", colors[i], reference, minSquaredDistance));
+                    }
+                    VERIFY_ARE_EQUAL(expected, actual[i]);
+                }
+            }
+        }
+    }
+};
@@ -5,9 +5,9 @@
 # (we use the null coalescing operator)
 
 ################################################################################
-# This script generates the an array suitable for replacing the body of
-# src/types/CodepointWidthDetector.cpp from a Unicode UCD XML document[1]
-# compliant with UAX#42[2].
+# This script generates the two-stage lookup table suitable for replacing the
+# body of src/types/CodepointWidthDetector.cpp from a Unicode UCD XML
+# document[1] compliant with UAX#42[2].
 #
 # This script supports a quasi-mandatory "overrides" file, overrides.xml.
 # If you do not have overrides, supply the -NoOverrides parameter. This was
@@ -263,14 +263,49 @@ If (-not $NoOverrides) {
 "    // {0} (0x{0:X}) codepoints overridden." -f $overrideCount
 "    // Override path: {0}" -f $OverridePath
 }
-"    static constexpr std::array<UnicodeRange, {0}> s_wideAndAmbiguousTable{{" -f $ranges.Count
+
+# Flatten the ranges into one value per codepoint, using the values of the
+# C++ CodepointWidth enum: Ambiguous = 0, Narrow = 1, Wide = 2.
+$widths = [byte[]]::new(0x110000)
+[Array]::Fill($widths, [byte]1)
 ForEach($_ in $ranges) {
-    $isAmbiguous = $_.Width -eq [CodepointWidth]::Ambiguous
-    $comment = ""
-    if ($null -ne $_.Comment) {
-        # We only vend comments when we aren't packing tightly
-        $comment = " // {0}" -f $_.Comment
+    $w = $_.Width -eq [CodepointWidth]::Ambiguous ? 0 : 2
+    For($i = $_.Start; $i -le $_.End; $i++) {
+        $widths[$i] = $w
+    }
+}
+
+# Split them into blocks of 256 codepoints, packed into 2 bits each, and
+# deduplicate the blocks. Most of them are entirely narrow or wide.
+$stage1 = [System.Collections.Generic.List[int]]::New(0x1100)
+$stage2 = [System.Collections.Generic.List[byte[]]]::New()
+$blockIndices = @{}
+For($b = 0; $b -lt 0x110000; $b += 256) {
+    $packed = [byte[]]::new(64)
+    For($i = 0; $i -lt 256; $i++) {
+        $packed[$i -shr 2] = $packed[$i -shr 2] -bor ($widths[$b + $i] -shl (($i -band 3) * 2))
+    }
+    $key = [Convert]::ToHexString($packed)
+    If (-not $blockIndices.ContainsKey($key)) {
+        $blockIndices[$key] = $stage2.Count
+        $stage2.Add($packed)
+    }
+    $stage1.Add($blockIndices[$key])
+}
+
+"    //"
+"    // s_stage1 maps each block of 256 codepoints to a 64 byte block in s_stage2,"
+"    // which holds the CodepointWidth of each codepoint in the block packed into 2 bits."
+"    static constexpr std::array<uint8_t, {0}> s_stage1{{" -f $stage1.Count
+For($i = 0; $i -lt $stage1.Count; $i += 16) {
+    "        " + (($stage1.GetRange($i, 16) | ForEach-Object { "{0}," -f $_ }) -join " ")
+}
+"    };"
+"    static constexpr std::array<uint8_t, {0}> s_stage2{{" -f ($stage2.Count * 64)
+For($n = 0; $n -lt $stage2.Count; $n++) {
+    "        // {0}" -f $n
+    For($i = 0; $i -lt 64; $i += 16) {
+        "        " + (($stage2[$n][$i..($i + 15)] | ForEach-Object { "0x{0:x2}," -f $_ }) -join " ")
     }
-"        UnicodeRange{{ 0x{0:x}, 0x{1:x}, {2} }},{3}" -f $_.Start, $_.End, [int]$isAmbiguous, $comment
 }
 "    };"